@@ -23,9 +23,13 @@ public:
     size_t size() const { return m_size; }
     bool is_empty() const { return m_size == 0; }
 
+    using ConstIterator = SimpleIterator<SegmentedVector const, VisibleType const>;
     using Iterator = SimpleIterator<SegmentedVector, VisibleType>;
 
+    ConstIterator begin() const { return ConstIterator::begin(*this); }
     Iterator begin() { return Iterator::begin(*this); }
+
+    ConstIterator end() const { return ConstIterator::end(*this); }
     Iterator end() { return Iterator::end(*this); }
 
     ALWAYS_INLINE VisibleType const& at(size_t i) const
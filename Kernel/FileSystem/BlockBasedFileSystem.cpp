@@ -4,51 +4,106 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
 
+struct CacheChunk;
+
 struct CacheEntry {
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
+    CacheChunk* chunk { nullptr };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_mapped { false };
+};
+
+// The cache allocates its blocks a chunk at a time, so it can grow while there's memory to spare and give it back
+// in chunk-sized pieces once there isn't.
+struct CacheChunk {
+    CacheChunk(NonnullOwnPtr<KBuffer> data, FixedArray<CacheEntry> chunk_entries)
+        : block_data(move(data))
+        , entries(move(chunk_entries))
+    {
+    }
+
+    NonnullOwnPtr<KBuffer> block_data;
+    FixedArray<CacheEntry> entries;
+    u64 last_use { 0 };
+    // Only chunks without any dirty blocks can be given back, so we keep count rather than looking at every entry.
+    size_t dirty_count { 0 };
+    bool entries_released { false };
 };
 
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    static constexpr size_t ChunkSize = 256 * KiB;
+
+    // The largest read or write we issue to the device when moving several adjacent blocks at once.
+    static constexpr size_t MaxTransferSize = 256 * KiB;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(BlockBasedFileSystem& fs)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * fs.logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(fs.logical_block_size())));
+        TRY(cache->grow());
+        return cache;
     }
 
     ~DiskCache() = default;
 
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
     bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    size_t dirty_count() const { return m_dirty_list.size_slow(); }
+
+    bool has_data_for(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        auto it = m_hash.find(block_index);
+        return it != m_hash.end() && it->value->has_data;
+    }
+
+    size_t max_blocks_per_transfer() const { return max(MaxTransferSize / m_block_size, 1); }
+
+    ErrorOr<u8*> transfer_buffer()
+    {
+        if (!m_transfer_buffer)
+            m_transfer_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Transfer buffer"sv, max_blocks_per_transfer() * m_block_size));
+        return m_transfer_buffer->data();
+    }
+
+    size_t size_in_bytes() const { return m_chunks.size() * m_blocks_per_chunk * m_block_size; }
+
+    // How many more blocks the cache can take in without evicting any of the ones it holds.
+    size_t free_capacity_in_blocks() const
+    {
+        if (memory_allows_growth())
+            return NumericLimits<size_t>::max();
+        return m_unused_entry_count;
+    }
 
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+            mark_clean(*entry);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        if (!entry_is_dirty(entry))
+            ++entry.chunk->dirty_count;
         m_dirty_list.prepend(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
+        if (entry_is_dirty(entry))
+            --entry.chunk->dirty_count;
         m_clean_list.prepend(entry);
     }
 
@@ -63,6 +118,7 @@ public:
             // Cache hit! Promote the entry to the front of the list.
             m_clean_list.prepend(entry);
         }
+        entry.chunk->last_use = ++m_use_counter;
         return &entry;
     }
 
@@ -71,6 +127,12 @@ public:
         if (auto* entry = get(block_index))
             return entry;
 
+        // Rather than throwing out the least recently used block, make room while memory isn't scarce.
+        // Unused entries are at the back of the clean list, so they'll be picked before any cached block.
+        bool has_unused_entry = !m_clean_list.is_empty() && !m_clean_list.last()->is_mapped;
+        if (!has_unused_entry && memory_allows_growth())
+            (void)const_cast<DiskCache&>(*this).grow();
+
         if (m_clean_list.is_empty()) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
@@ -83,18 +145,20 @@ public:
         auto& new_entry = *m_clean_list.last();
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
+        if (new_entry.is_mapped)
+            m_hash.remove(new_entry.block_index);
         TRY(m_hash.try_set(block_index, &new_entry));
+        if (!new_entry.is_mapped)
+            --m_unused_entry_count;
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.is_mapped = true;
+        new_entry.chunk->last_use = ++m_use_counter;
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
-
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
     {
@@ -102,15 +166,93 @@ public:
             callback(entry);
     }
 
+    // Gives back up to chunk_count chunks that hold nothing but clean blocks, starting with the one used least
+    // recently. The cache never shrinks below a single chunk. Returns how many bytes were released.
+    size_t release_clean_chunks(size_t chunk_count)
+    {
+        if (m_chunks.size() <= 1)
+            return 0;
+        chunk_count = min(chunk_count, m_chunks.size() - 1);
+
+        Vector<CacheChunk*> clean_chunks;
+        if (clean_chunks.try_ensure_capacity(m_chunks.size()).is_error())
+            return 0;
+        for (auto& chunk : m_chunks) {
+            if (chunk->dirty_count == 0)
+                clean_chunks.unchecked_append(chunk.ptr());
+        }
+        if (clean_chunks.size() > chunk_count) {
+            quick_sort(clean_chunks, [](auto* a, auto* b) { return a->last_use < b->last_use; });
+            clean_chunks.shrink(chunk_count);
+        }
+
+        size_t released_bytes = 0;
+        for (auto* chunk : clean_chunks) {
+            for (auto& entry : chunk->entries) {
+                if (entry.is_mapped)
+                    m_hash.remove(entry.block_index);
+                else
+                    --m_unused_entry_count;
+                m_clean_list.remove(entry);
+            }
+            chunk->entries_released = true;
+            released_bytes += chunk->block_data->size();
+        }
+        m_chunks.remove_all_matching([](auto& chunk) { return chunk->entries_released; });
+        return released_bytes;
+    }
+
+    // The cache only grows while more than half of physical memory is uncommitted, and gets trimmed back once less
+    // than a quarter is. In between, blocks are recycled in least recently used order.
+    static bool memory_allows_growth()
+    {
+        auto info = MM.get_system_memory_info();
+        return info.physical_pages_uncommitted > info.physical_pages / 2;
+    }
+
+    static bool memory_is_low()
+    {
+        auto info = MM.get_system_memory_info();
+        return info.physical_pages_uncommitted < info.physical_pages / 4;
+    }
+
 private:
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
+    explicit DiskCache(size_t block_size)
+        : m_block_size(block_size)
+        , m_blocks_per_chunk(max(ChunkSize / block_size, 1))
+    {
+    }
 
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
+    ErrorOr<void> grow()
+    {
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, m_blocks_per_chunk * m_block_size));
+        auto entries = TRY(FixedArray<CacheEntry>::create(m_blocks_per_chunk));
+        TRY(m_chunks.try_ensure_capacity(m_chunks.size() + 1));
+        auto chunk = TRY(adopt_nonnull_own_or_enomem(new (nothrow) CacheChunk(move(block_data), move(entries))));
+        for (size_t i = 0; i < m_blocks_per_chunk; ++i) {
+            auto& entry = chunk->entries[i];
+            entry.chunk = chunk.ptr();
+            entry.data = chunk->block_data->data() + i * m_block_size;
+            m_clean_list.append(entry);
+        }
+        m_chunks.unchecked_append(move(chunk));
+        m_unused_entry_count += m_blocks_per_chunk;
+        dbgln_if(BBFS_DEBUG, "DiskCache: Grew to {} chunks ({} bytes)", m_chunks.size(), size_in_bytes());
+        return {};
+    }
+
+    size_t m_block_size { 0 };
+    size_t m_blocks_per_chunk { 0 };
+    OwnPtr<KBuffer> m_transfer_buffer;
+
+    // NOTE: m_chunks must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
+    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_chunks is destroyed.
+    Vector<NonnullOwnPtr<CacheChunk>> m_chunks;
     mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
     mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
     mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    mutable u64 m_use_counter { 0 };
+    mutable size_t m_unused_entry_count { 0 };
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -126,9 +268,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(*this));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -262,6 +402,57 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
+size_t BlockBasedFileSystem::free_cache_capacity_in_bytes() const
+{
+    return m_cache.with_exclusive([&](auto& cache) -> size_t {
+        auto free_blocks = cache->free_capacity_in_blocks();
+        if (free_blocks > NumericLimits<size_t>::max() / logical_block_size())
+            return NumericLimits<size_t>::max();
+        return free_blocks * logical_block_size();
+    });
+}
+
+ErrorOr<void> BlockBasedFileSystem::read_blocks_into_cache(ReadonlySpan<BlockIndex> blocks) const
+{
+    VERIFY(m_device_block_size);
+
+    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+        auto block_size = logical_block_size();
+        size_t i = 0;
+        while (i < blocks.size()) {
+            // Holes and blocks we already have don't need reading.
+            if (blocks[i].value() == 0 || cache->has_data_for(blocks[i])) {
+                ++i;
+                continue;
+            }
+
+            // Read as many missing blocks that sit next to each other on disk as we can in one go.
+            auto first_block = blocks[i];
+            size_t run_length = 1;
+            while (i + run_length < blocks.size()
+                && run_length < cache->max_blocks_per_transfer()
+                && blocks[i + run_length].value() == first_block.value() + run_length
+                && !cache->has_data_for(blocks[i + run_length]))
+                ++run_length;
+
+            auto* transfer_buffer = TRY(cache->transfer_buffer());
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(transfer_buffer);
+            auto nread = TRY(file_description().read(buffer, first_block.value() * block_size, run_length * block_size));
+            dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_blocks_into_cache {}, count={}", first_block, run_length);
+
+            for (size_t j = 0; j < nread / block_size; ++j) {
+                auto* entry = TRY(cache->ensure(BlockIndex { first_block.value() + j }, const_cast<BlockBasedFileSystem&>(*this)));
+                if (entry->has_data)
+                    continue;
+                memcpy(entry->data, transfer_buffer + j * block_size, block_size);
+                entry->has_data = true;
+            }
+            i += run_length;
+        }
+        return {};
+    });
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
     m_cache.with_exclusive([&](auto& cache) {
@@ -284,12 +475,46 @@ void BlockBasedFileSystem::flush_writes_impl()
     m_cache.with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
+
+        auto block_size = logical_block_size();
+        auto write_entry = [&](CacheEntry& entry) {
+            auto base_offset = entry.block_index.value() * block_size;
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
+            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size);
             ++count;
-        });
+        };
+
+        // Write the dirty blocks back in disk order, so that neighbors can go out in a single request.
+        Vector<CacheEntry*> dirty_entries;
+        auto transfer_buffer_or_error = cache->transfer_buffer();
+        if (transfer_buffer_or_error.is_error() || dirty_entries.try_ensure_capacity(cache->dirty_count()).is_error()) {
+            cache->for_each_dirty_entry(write_entry);
+        } else {
+            cache->for_each_dirty_entry([&](CacheEntry& entry) { dirty_entries.unchecked_append(&entry); });
+            quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+            auto* transfer_buffer = transfer_buffer_or_error.release_value();
+            size_t i = 0;
+            while (i < dirty_entries.size()) {
+                auto first_block = dirty_entries[i]->block_index;
+                size_t run_length = 1;
+                while (i + run_length < dirty_entries.size()
+                    && run_length < cache->max_blocks_per_transfer()
+                    && dirty_entries[i + run_length]->block_index.value() == first_block.value() + run_length)
+                    ++run_length;
+
+                if (run_length == 1) {
+                    write_entry(*dirty_entries[i]);
+                } else {
+                    for (size_t j = 0; j < run_length; ++j)
+                        memcpy(transfer_buffer + j * block_size, dirty_entries[i + j]->data, block_size);
+                    auto buffer = UserOrKernelBuffer::for_kernel_buffer(transfer_buffer);
+                    [[maybe_unused]] auto rc = file_description().write(first_block.value() * block_size, buffer, run_length * block_size);
+                    count += run_length;
+                }
+                i += run_length;
+            }
+        }
         cache->mark_all_clean();
         dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
@@ -298,7 +523,31 @@ void BlockBasedFileSystem::flush_writes_impl()
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
 {
     flush_writes_impl();
+
+    // This runs periodically, which makes it a good time to give memory back if it has become scarce.
+    if (DiskCache::memory_is_low()) {
+        m_cache.with_exclusive([&](auto& cache) {
+            while (DiskCache::memory_is_low()) {
+                if (cache->release_clean_chunks(1) == 0)
+                    break;
+            }
+        });
+    }
     return {};
 }
 
+size_t BlockBasedFileSystem::release_clean_cached_blocks()
+{
+    return m_cache.with_exclusive([&](auto& cache) {
+        return cache->release_clean_chunks(NumericLimits<size_t>::max()) / PAGE_SIZE;
+    });
+}
+
+size_t BlockBasedFileSystem::cache_size_in_bytes() const
+{
+    return m_cache.with_exclusive([&](auto& cache) -> size_t {
+        return cache ? cache->size_in_bytes() : 0;
+    });
+}
+
 }
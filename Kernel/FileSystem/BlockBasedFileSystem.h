@@ -22,6 +22,9 @@ public:
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    virtual size_t release_clean_cached_blocks() override;
+    virtual size_t cache_size_in_bytes() const override;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -30,6 +33,11 @@ protected:
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
 
+    // Makes sure the given blocks are cached, reading runs of them that are adjacent on disk with a single request.
+    ErrorOr<void> read_blocks_into_cache(ReadonlySpan<BlockIndex>) const;
+    // How much data can be read into the cache without evicting anything it holds.
+    size_t free_cache_capacity_in_bytes() const;
+
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
 
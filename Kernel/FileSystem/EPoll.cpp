@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr u32 epoll_mode_flags = EPOLLET | EPOLLONESHOT;
+
+static bool has_interest(u32 events)
+{
+    return (events & ~epoll_mode_flags) != 0;
+}
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    // Like poll(), we always want to hear about errors and hangups.
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 events_for_unblocked_flags(BlockFlags unblocked_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (has_flag(unblocked_flags, BlockFlags::Write) && !has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLOUT;
+    if (has_flag(unblocked_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    return events;
+}
+
+EPoll::Watch::Watch(EPoll& epoll, int fd, OpenFileDescription& description, epoll_event const& event)
+    : FileReadinessObserver(description)
+    , epoll(epoll)
+    , fd(fd)
+    , file(description.file())
+    , blocker_set(description.blocker_set())
+    , description(&description)
+    , events(event.events)
+    , data(event.data)
+{
+}
+
+void EPoll::Watch::file_state_may_have_changed()
+{
+    epoll.enqueue(*this);
+}
+
+void EPoll::Watch::observed_description_is_going_away()
+{
+    // NOTE: The FileBlockerSet is locked here, so we can't unregister the watch right away. The next call that changes
+    //       the set of watches will take care of it.
+    epoll.m_state.with([&](auto& state) {
+        if (!description)
+            return;
+        description = nullptr;
+        if (list_node.is_in_list())
+            list_node.remove();
+        state.dead_watches.append(*this);
+    });
+}
+
+ErrorOr<NonnullRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll() = default;
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_state.with([](auto& state) { return !state.ready_watches.is_empty(); });
+}
+
+ErrorOr<void> EPoll::close()
+{
+    MutexLocker locker(m_control_lock);
+    for (;;) {
+        auto watch = m_state.with([](auto& state) -> RefPtr<Watch> {
+            if (state.watches.is_empty())
+                return nullptr;
+            auto closed_watch = state.watches.take(state.watches.begin()->key).release_value();
+            closed_watch->description = nullptr;
+            if (closed_watch->list_node.is_in_list())
+                closed_watch->list_node.remove();
+            return closed_watch;
+        });
+        if (!watch)
+            break;
+        watch->blocker_set.remove_observer(*watch);
+    }
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return m_state.with([](auto& state) {
+        return KString::formatted("EPoll:({})", state.watches.size());
+    });
+}
+
+void EPoll::enqueue(Watch& watch)
+{
+    bool was_enqueued = m_state.with([&](auto& state) {
+        if (!watch.description || !has_interest(watch.events) || watch.list_node.is_in_list())
+            return false;
+        state.ready_watches.append(watch);
+        return true;
+    });
+    if (was_enqueued)
+        evaluate_block_conditions();
+}
+
+void EPoll::reap_dead_watches()
+{
+    VERIFY(m_control_lock.is_exclusively_locked_by_current_thread());
+    for (;;) {
+        auto watch = m_state.with([](auto& state) -> RefPtr<Watch> {
+            auto* dead_watch = state.dead_watches.take_first();
+            if (!dead_watch)
+                return nullptr;
+            VERIFY(state.watches.get(dead_watch->fd).value() == dead_watch);
+            return state.watches.take(dead_watch->fd).release_value();
+        });
+        if (!watch)
+            return;
+        // This waits for the FileBlockerSet to be done with the watch, which it may still be looking at.
+        watch->blocker_set.remove_observer(*watch);
+    }
+}
+
+ErrorOr<void> EPoll::add_watch(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    if (description.file().is_epoll())
+        return EINVAL;
+
+    MutexLocker locker(m_control_lock);
+    reap_dead_watches();
+
+    auto watch = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Watch(*this, fd, description, event)));
+    RefPtr<Watch> displaced_watch;
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        if (auto existing_watch = state.watches.get(fd); existing_watch.has_value()) {
+            // The fd may have been closed and reused since we last reaped dead watches.
+            if (existing_watch.value()->description)
+                return EEXIST;
+            displaced_watch = existing_watch.value();
+            displaced_watch->list_node.remove();
+        }
+        TRY(state.watches.try_set(fd, watch));
+        return {};
+    }));
+    if (displaced_watch)
+        displaced_watch->blocker_set.remove_observer(*displaced_watch);
+
+    watch->blocker_set.add_observer(*watch);
+    // The file may well be ready already, so let the next epoll_wait() find out.
+    enqueue(*watch);
+    return {};
+}
+
+ErrorOr<void> EPoll::modify_watch(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    MutexLocker locker(m_control_lock);
+    reap_dead_watches();
+
+    auto watch = TRY(m_state.with([&](auto& state) -> ErrorOr<NonnullRefPtr<Watch>> {
+        auto watch = state.watches.get(fd);
+        if (!watch.has_value() || watch.value()->description != &description)
+            return ENOENT;
+        watch.value()->events = event.events;
+        watch.value()->data = event.data;
+        if (!has_interest(event.events) && watch.value()->list_node.is_in_list())
+            watch.value()->list_node.remove();
+        return *watch.value();
+    }));
+    enqueue(*watch);
+    return {};
+}
+
+ErrorOr<void> EPoll::remove_watch(int fd, OpenFileDescription& description)
+{
+    MutexLocker locker(m_control_lock);
+    reap_dead_watches();
+
+    auto watch = TRY(m_state.with([&](auto& state) -> ErrorOr<NonnullRefPtr<Watch>> {
+        auto watch = state.watches.get(fd);
+        if (!watch.has_value() || watch.value()->description != &description)
+            return ENOENT;
+        auto removed_watch = state.watches.take(fd).release_value();
+        removed_watch->description = nullptr;
+        if (removed_watch->list_node.is_in_list())
+            removed_watch->list_node.remove();
+        return removed_watch;
+    }));
+    watch->blocker_set.remove_observer(*watch);
+    return {};
+}
+
+size_t EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    return m_state.with([&](auto& state) {
+        size_t count = 0;
+        // Level-triggered watches that are still ready go to the back of the list, so they can't starve the others.
+        IntrusiveList<&Watch::list_node> still_ready_watches;
+        while (count < events.size()) {
+            auto* watch = state.ready_watches.take_first();
+            if (!watch)
+                break;
+            VERIFY(watch->description);
+
+            auto unblocked_flags = watch->description->should_unblock(block_flags_for_events(watch->events));
+            auto ready_events = events_for_unblocked_flags(unblocked_flags);
+            if (ready_events == 0)
+                continue;
+
+            events[count++] = { ready_events, watch->data };
+            if (watch->events & EPOLLONESHOT)
+                watch->events &= epoll_mode_flags;
+            else if (!(watch->events & EPOLLET))
+                still_ready_watches.append(*watch);
+        }
+        while (auto* watch = still_ready_watches.take_first())
+            state.ready_watches.append(*watch);
+        return count;
+    });
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// A persistent set of file descriptions to watch for readiness, as created by epoll_create1().
+//
+// Every watch observes the FileBlockerSet of its file. When the file's state changes, the watch puts itself on the
+// ready list, so epoll_wait() only ever looks at the watches that may actually be ready instead of all of them.
+// Level-triggered watches stay on the ready list for as long as they are ready, edge-triggered (EPOLLET) ones have to
+// see another state change first, and EPOLLONESHOT watches are disabled until EPOLL_CTL_MOD after reporting once.
+//
+// NOTE: Unlike Linux, an EPoll can't watch another EPoll.
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+    ErrorOr<void> add_watch(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_watch(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_watch(int fd, OpenFileDescription&);
+
+    // Fills in events for up to events.size() ready watches without blocking, and returns how many there were.
+    size_t collect_ready_events(Span<epoll_event> events);
+
+private:
+    EPoll() = default;
+
+    class Watch final
+        : public AtomicRefCounted<Watch>
+        , public FileReadinessObserver {
+    public:
+        Watch(EPoll&, int fd, OpenFileDescription&, epoll_event const&);
+
+        virtual void file_state_may_have_changed() override;
+        virtual void observed_description_is_going_away() override;
+
+        EPoll& epoll;
+        int const fd;
+        NonnullRefPtr<File> const file;
+        FileBlockerSet& blocker_set;
+
+        // These are protected by the lock of the EPoll's state.
+        OpenFileDescription* description { nullptr };
+        u32 events { 0 };
+        epoll_data_t data {};
+        IntrusiveListNode<Watch> list_node;
+    };
+
+    void enqueue(Watch&);
+    void reap_dead_watches();
+
+    struct State {
+        HashMap<int, NonnullRefPtr<Watch>> watches;
+
+        // Watches that may be ready. A watch is on at most one of these two lists.
+        IntrusiveList<&Watch::list_node> ready_watches;
+        // Watches whose description has gone away, but that are still observing its file.
+        IntrusiveList<&Watch::list_node> dead_watches;
+    };
+    SpinlockProtected<State, LockRank::None> m_state {};
+
+    // Serializes changes to the set of watches, which have to drop the spinlock to (un)register with a FileBlockerSet.
+    Mutex m_control_lock { "EPoll"sv };
+};
+
+}
@@ -18,6 +18,8 @@
 namespace Kernel {
 
 static constexpr size_t max_inline_symlink_length = 60;
+// How much of a read we bring into the block cache at once, see read_bytes_locked().
+static constexpr size_t prefetch_batch_size = 256 * KiB;
 
 u8 Ext2FSInode::to_ext2_file_type(mode_t mode)
 {
@@ -488,6 +490,23 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
     return {};
 }
 
+void Ext2FSInode::prefetch_blocks(BlockBasedFileSystem::BlockIndex first_block_logical_index, BlockBasedFileSystem::BlockIndex end_block_logical_index) const
+{
+    if (end_block_logical_index.value() - first_block_logical_index.value() <= 1)
+        return;
+
+    // This is only an optimization, so stop collecting blocks at the first one we can't get rather than failing the
+    // read. The caller reports errors for the blocks that were actually asked for.
+    Vector<BlockBasedFileSystem::BlockIndex, 128> blocks;
+    for (auto logical_index = first_block_logical_index; logical_index < end_block_logical_index; logical_index = logical_index.value() + 1) {
+        auto block_index_or_error = m_block_view.get_block(logical_index);
+        if (block_index_or_error.is_error() || blocks.try_append(block_index_or_error.value()).is_error())
+            break;
+    }
+    if (auto result = fs().read_blocks_into_cache(blocks); result.is_error())
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::prefetch_blocks(): Failed to read ahead: {}", identifier(), result.error());
+}
+
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
 {
     VERIFY(m_inode_lock.is_locked());
@@ -521,7 +540,28 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
+    // Blocks that are next to each other on disk are brought into the cache with a single request before we copy them
+    // out, a batch at a time. Prefetching all of a large read at once could evict its first blocks before we get to
+    // them. The read-ahead window past the end of the read goes along with the last batch, but only as far as the
+    // cache has room for: Anything more would only evict blocks for others that may be evicted again before use.
+    BlockBasedFileSystem::BlockIndex end_block_logical_index = ceil_div(static_cast<u64>(offset + remaining_count), static_cast<u64>(block_size));
+    auto read_ahead_end_block_logical_index = end_block_logical_index;
+    if (allow_cache && description) {
+        size_t read_ahead_bytes = min(description->read_ahead_window_for_read(offset, remaining_count), fs().free_cache_capacity_in_bytes());
+        auto read_ahead_end_offset = min(size(), static_cast<u64>(offset + remaining_count) + read_ahead_bytes);
+        read_ahead_end_block_logical_index = max(end_block_logical_index.value(), ceil_div(read_ahead_end_offset, static_cast<u64>(block_size)));
+    }
+    auto prefetched_end_block_logical_index = first_block_logical_index;
+
     while (remaining_count) {
+        if (allow_cache && current_block_logical_index >= prefetched_end_block_logical_index) {
+            auto batch_end_block_logical_index = min(current_block_logical_index.value() + max(prefetch_batch_size / block_size, 1), end_block_logical_index.value());
+            if (batch_end_block_logical_index == end_block_logical_index.value())
+                batch_end_block_logical_index = read_ahead_end_block_logical_index.value();
+            prefetch_blocks(current_block_logical_index, batch_end_block_logical_index);
+            prefetched_end_block_logical_index = batch_end_block_logical_index;
+        }
+
         auto block_index = TRY(m_block_view.get_block(current_block_logical_index));
         size_t offset_into_block = (current_block_logical_index == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
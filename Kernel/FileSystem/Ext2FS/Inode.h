@@ -72,6 +72,8 @@ private:
     ErrorOr<void> write_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index);
 
     ErrorOr<Ext2FS::BlockList> compute_block_list(BlockBasedFileSystem::BlockIndex, BlockBasedFileSystem::BlockIndex) const;
+    // Brings the blocks backing the given logical block range into the cache, as best it can.
+    void prefetch_blocks(BlockBasedFileSystem::BlockIndex first_block_logical_index, BlockBasedFileSystem::BlockIndex end_block_logical_index) const;
 
     ErrorOr<void> free_all_blocks();
 
@@ -125,6 +125,16 @@ ErrorOr<size_t> FIFO::write(OpenFileDescription& fd, u64, UserOrKernelBuffer con
     return m_buffer->write(buffer, size);
 }
 
+ErrorOr<size_t> FIFO::write_from(OpenFileDescription& fd, TransferSource& source, size_t size)
+{
+    if (!m_readers)
+        return EPIPE;
+    if (!fd.is_blocking() && m_buffer->space_for_writing() == 0)
+        return EAGAIN;
+
+    return m_buffer->write_from(source, size);
+}
+
 ErrorOr<NonnullOwnPtr<KString>> FIFO::pseudo_path(OpenFileDescription const&) const
 {
     return KString::formatted("fifo:{}", m_fifo_id);
@@ -35,6 +35,7 @@ public:
 private:
     // ^File
     virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override;
+    virtual ErrorOr<size_t> write_from(OpenFileDescription&, TransferSource&, size_t) override;
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual ErrorOr<struct stat> stat() const override;
     virtual void detach(OpenFileDescription&) override;
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,6 +22,42 @@ namespace Kernel {
 
 class File;
 
+// Something that wants to hear about state changes of a file without having a thread blocked on it, like a watch in an
+// EPoll interest set. Observers are called with the FileBlockerSet locked, so they must not block.
+class FileReadinessObserver {
+public:
+    virtual ~FileReadinessObserver() = default;
+
+    // The file may have become readable, writable, or hung up. Observers work out the details themselves.
+    virtual void file_state_may_have_changed() = 0;
+
+    // The observed description is being destroyed. The observer has already been removed from the FileBlockerSet.
+    virtual void observed_description_is_going_away() = 0;
+
+protected:
+    explicit FileReadinessObserver(OpenFileDescription const& description)
+        : m_observed_description(&description)
+    {
+    }
+
+private:
+    friend class FileBlockerSet;
+
+    OpenFileDescription const* m_observed_description { nullptr };
+    IntrusiveListNode<FileReadinessObserver> m_observer_list_node;
+};
+
+// Where File::write_from() gets its data from. The file hands it a piece of its own buffers to fill, so the data is only
+// copied once on its way from one file to another.
+class TransferSource {
+public:
+    // Fills the start of destination, and returns how many bytes it filled. Returns 0 once there's nothing left.
+    virtual ErrorOr<size_t> read_into(Bytes destination) = 0;
+
+protected:
+    ~TransferSource() = default;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
@@ -40,7 +77,39 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_observers)
+            observer.file_state_may_have_changed();
     }
+
+    void add_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_observers.append(observer);
+    }
+
+    void remove_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        // NOTE: The observer may have been removed already because its description went away.
+        if (observer.m_observer_list_node.is_in_list())
+            m_observers.remove(observer);
+    }
+
+    void description_is_going_away(OpenFileDescription const& description)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto it = m_observers.begin(); it != m_observers.end();) {
+            auto& observer = *it;
+            ++it;
+            if (observer.m_observed_description != &description)
+                continue;
+            m_observers.remove(observer);
+            observer.observed_description_is_going_away();
+        }
+    }
+
+private:
+    IntrusiveList<&FileReadinessObserver::m_observer_list_node> m_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -58,6 +127,12 @@ public:
 //   - Note that can_read() should return true in EOF conditions,
 //     and a subsequent call to read() should return 0.
 //
+// write_from()
+//
+//   - Optional. If unimplemented, it fails with ENOTSUP and the caller has to bounce the data through write().
+//   - Like write(), but pulls the data from a TransferSource straight into the File's own buffers.
+//   - Only makes sense for files without a file offset, like pipes and sockets.
+//
 // ioctl()
 //
 //   - Optional. If unimplemented, ioctl() on this File will fail with -ENOTTY.
@@ -89,6 +164,7 @@ public:
     virtual void did_seek(OpenFileDescription&, off_t) { }
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) = 0;
     virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) = 0;
+    virtual ErrorOr<size_t> write_from(OpenFileDescription&, TransferSource&, size_t) { return ENOTSUP; }
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg);
     virtual ErrorOr<struct stat> stat() const { return EBADF; }
 
@@ -119,6 +195,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
@@ -58,6 +58,10 @@ public:
 
     virtual ErrorOr<void> flush_writes() { return {}; }
 
+    // Drops whatever clean data the file system keeps cached, returning the number of pages that were freed.
+    virtual size_t release_clean_cached_blocks() { return 0; }
+    virtual size_t cache_size_in_bytes() const { return 0; }
+
     u64 logical_block_size() const { return m_logical_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
@@ -53,6 +53,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    blocker_set().description_is_going_away(*this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -190,6 +191,14 @@ ErrorOr<size_t> OpenFileDescription::write(UserOrKernelBuffer const& data, size_
     return nwritten;
 }
 
+ErrorOr<size_t> OpenFileDescription::write_from(TransferSource& source, size_t size)
+{
+    VERIFY(!m_file->is_seekable());
+    auto nwritten = TRY(m_file->write_from(*this, source, size));
+    evaluate_block_conditions();
+    return nwritten;
+}
+
 bool OpenFileDescription::can_write() const
 {
     return m_file->can_write(*this, offset());
@@ -543,6 +552,21 @@ off_t OpenFileDescription::offset() const
     return m_state.with([](auto& state) { return state.current_offset; });
 }
 
+size_t OpenFileDescription::read_ahead_window_for_read(off_t offset, size_t count)
+{
+    static constexpr size_t minimum_read_ahead_window = 32 * KiB;
+    static constexpr size_t maximum_read_ahead_window = 512 * KiB;
+
+    return m_state.with([&](auto& state) {
+        if (offset == state.next_sequential_read_offset)
+            state.read_ahead_window = clamp(state.read_ahead_window * 2, minimum_read_ahead_window, maximum_read_ahead_window);
+        else
+            state.read_ahead_window = 0;
+        state.next_sequential_read_offset = offset + count;
+        return state.read_ahead_window;
+    });
+}
+
 RefPtr<Custody const> OpenFileDescription::custody() const
 {
     return m_state.with([](auto& state) { return state.custody; });
@@ -50,6 +50,7 @@ public:
     // NOTE: These ignore the current offset of this file description.
     ErrorOr<size_t> read(UserOrKernelBuffer&, u64 offset, size_t);
     ErrorOr<size_t> write(u64 offset, UserOrKernelBuffer const&, size_t);
+    ErrorOr<size_t> write_from(TransferSource&, size_t);
 
     ErrorOr<void> chmod(Credentials const& credentials, mode_t);
 
@@ -125,6 +126,10 @@ public:
 
     off_t offset() const;
 
+    // Notes a read of count bytes at offset, and returns how many bytes past its end are worth reading ahead.
+    // The window grows as long as reads keep picking up where the previous one left off, and closes on a seek.
+    size_t read_ahead_window_for_read(off_t offset, size_t count);
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
@@ -149,6 +154,8 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        off_t next_sequential_read_offset { 0 };
+        size_t read_ahead_window { 0 };
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
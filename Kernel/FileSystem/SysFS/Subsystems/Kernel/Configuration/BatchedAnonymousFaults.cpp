@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/BatchedAnonymousFaults.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSBatchedAnonymousFaults::SysFSBatchedAnonymousFaults(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSBatchedAnonymousFaults> SysFSBatchedAnonymousFaults::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSBatchedAnonymousFaults(parent_directory)).release_nonnull();
+}
+
+bool SysFSBatchedAnonymousFaults::value() const
+{
+    return Memory::g_batched_anonymous_faults;
+}
+void SysFSBatchedAnonymousFaults::set_value(bool new_value)
+{
+    Memory::g_batched_anonymous_faults = new_value;
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/BooleanVariable.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSBatchedAnonymousFaults final : public SysFSSystemBooleanVariable {
+public:
+    virtual StringView name() const override { return "batched_anonymous_faults"sv; }
+    static NonnullRefPtr<SysFSBatchedAnonymousFaults> must_create(SysFSDirectory const&);
+
+private:
+    virtual bool value() const override;
+    virtual void set_value(bool new_value) override;
+
+    explicit SysFSBatchedAnonymousFaults(SysFSDirectory const&);
+};
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/ForceMagazineDrains.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSForceMagazineDrains::SysFSForceMagazineDrains(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSForceMagazineDrains> SysFSForceMagazineDrains::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSForceMagazineDrains(parent_directory)).release_nonnull();
+}
+
+bool SysFSForceMagazineDrains::value() const
+{
+    return g_force_magazine_drains;
+}
+void SysFSForceMagazineDrains::set_value(bool new_value)
+{
+    g_force_magazine_drains = new_value;
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/LoopbackNetworkEmulation.h>
+#include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+// Anything smaller than this can't even fit the IPv4 and TCP headers with all their options.
+static constexpr u32 minimum_loopback_mtu = 68;
+
+static LoopbackAdapter& loopback_adapter()
+{
+    return static_cast<LoopbackAdapter&>(*NetworkingManagement::the().loopback_adapter());
+}
+
+UNMAP_AFTER_INIT SysFSLoopbackNetworkEmulation::SysFSLoopbackNetworkEmulation(SysFSDirectory const& parent_directory)
+    : SysFSSystemStringVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSLoopbackNetworkEmulation> SysFSLoopbackNetworkEmulation::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSLoopbackNetworkEmulation(parent_directory)).release_nonnull();
+}
+
+ErrorOr<NonnullOwnPtr<KString>> SysFSLoopbackNetworkEmulation::value() const
+{
+    auto& adapter = loopback_adapter();
+    auto network_emulation = adapter.network_emulation();
+    return KString::formatted("loss={} delay={} mtu={}", network_emulation.loss_percentage, network_emulation.delay_ms, adapter.mtu());
+}
+
+void SysFSLoopbackNetworkEmulation::set_value(NonnullOwnPtr<KString> new_value)
+{
+    LoopbackAdapter::NetworkEmulation network_emulation;
+    u32 mtu = LoopbackAdapter::default_mtu;
+
+    auto parts = new_value->view().split_view(' ');
+    for (auto part : parts) {
+        auto key_and_value = part.split_view('=');
+        Optional<u32> number;
+        if (key_and_value.size() == 2)
+            number = key_and_value[1].to_number<u32>();
+        if (!number.has_value()) {
+            dmesgln("SysFSLoopbackNetworkEmulation: Ignoring invalid setting '{}'", part);
+            return;
+        }
+
+        auto key = key_and_value[0];
+        if (key == "loss"sv && *number <= 100) {
+            network_emulation.loss_percentage = *number;
+        } else if (key == "delay"sv) {
+            network_emulation.delay_ms = *number;
+        } else if (key == "mtu"sv && *number >= minimum_loopback_mtu && *number <= LoopbackAdapter::default_mtu) {
+            mtu = *number;
+        } else {
+            dmesgln("SysFSLoopbackNetworkEmulation: Ignoring invalid setting '{}'", part);
+            return;
+        }
+    }
+
+    auto& adapter = loopback_adapter();
+    adapter.set_network_emulation(network_emulation);
+    adapter.set_mtu(mtu);
+}
+
+mode_t SysFSLoopbackNetworkEmulation::permissions() const
+{
+    // NOTE: Losing packets on purpose affects everyone using the loopback, so only root may do that.
+    return S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/StringVariable.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// Written as "loss=<percent> delay=<ms> mtu=<bytes>", where anything left out goes back to its default.
+class SysFSLoopbackNetworkEmulation final : public SysFSSystemStringVariable {
+public:
+    virtual StringView name() const override { return "loopback_network_emulation"sv; }
+    static NonnullRefPtr<SysFSLoopbackNetworkEmulation> must_create(SysFSDirectory const&);
+
+private:
+    virtual ErrorOr<NonnullOwnPtr<KString>> value() const override;
+    virtual void set_value(NonnullOwnPtr<KString> new_value) override;
+
+    explicit SysFSLoopbackNetworkEmulation(SysFSDirectory const&);
+
+    virtual mode_t permissions() const override;
+};
+
+}
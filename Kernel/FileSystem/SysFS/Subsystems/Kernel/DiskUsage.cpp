@@ -41,6 +41,7 @@ ErrorOr<void> SysFSDiskUsage::try_generate(KBufferBuilder& builder)
         TRY(fs_object.add("block_size"sv, static_cast<u64>(fs.logical_block_size())));
         TRY(fs_object.add("readonly"sv, fs.is_readonly()));
         TRY(fs_object.add("mount_flags"sv, mount.flags()));
+        TRY(fs_object.add("cache_size"sv, static_cast<u64>(fs.cache_size_in_bytes())));
 
         if (mount.flags() & MS_SRCHIDDEN) {
             TRY(fs_object.add("source"sv, "unknown"));
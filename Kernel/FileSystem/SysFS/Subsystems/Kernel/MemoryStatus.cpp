@@ -27,6 +27,7 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto physical_page_magazines = MM.get_physical_page_magazine_statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -37,6 +38,12 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("kmalloc_magazine_hits"sv, stats.magazine_hits));
+    TRY(json.add("kmalloc_magazine_misses"sv, stats.magazine_misses));
+    TRY(json.add("physical_page_magazine_hits"sv, physical_page_magazines.hits));
+    TRY(json.add("physical_page_magazine_misses"sv, physical_page_magazines.misses));
+    TRY(json.add("kmalloc_magazine_drains"sv, stats.magazine_drains));
+    TRY(json.add("physical_page_magazine_drains"sv, physical_page_magazines.drains));
     TRY(json.finish());
     return {};
 }
@@ -284,6 +284,20 @@ void VirtualFileSystem::sync_filesystems()
     }
 }
 
+size_t VirtualFileSystem::release_clean_file_system_caches()
+{
+    Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
+    s_details->file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    size_t released_page_count = 0;
+    for (auto& fs : file_systems)
+        released_page_count += fs->release_clean_cached_blocks();
+    return released_page_count;
+}
+
 ErrorOr<void> VirtualFileSystem::unmount(VFSRootContext& context, Custody& mountpoint_custody)
 {
     auto& guest_inode = mountpoint_custody.inode();
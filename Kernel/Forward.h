@@ -66,6 +66,7 @@ class TCPSocket;
 class TTY;
 class Thread;
 class ThreadTracer;
+class TransferSource;
 class RAMFSInode;
 class UDPSocket;
 class UserOrKernelBuffer;
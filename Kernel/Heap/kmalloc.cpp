@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -136,6 +137,8 @@ public:
 
     size_t slab_size() const { return m_slab_size; }
 
+    bool has_free_slabs() const { return !m_usable_blocks.is_empty(); }
+
     void* allocate(size_t requested_size, [[maybe_unused]] CallerWillInitializeMemory caller_will_initialize_memory)
     {
         if (m_usable_blocks.is_empty()) {
@@ -167,7 +170,12 @@ public:
 #ifndef HAS_ADDRESS_SANITIZER
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
 #endif
+        deallocate_scrubbed(ptr);
+    }
 
+    // For slabs that were already scrubbed when they were put into a magazine.
+    void deallocate_scrubbed(void* ptr)
+    {
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -223,6 +231,8 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static constexpr size_t slabheap_count = 6;
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -412,7 +422,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[slabheap_count] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -420,10 +430,166 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
+bool g_force_magazine_drains;
+
+// A few free slabs of one size, kept by a processor so that it doesn't have to take the heap lock for every
+// allocation. When a magazine runs empty or overflows, half of it is refilled from or returned to the slabheap at once.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 16;
+    static constexpr size_t batch_size = capacity / 2;
+
+    bool is_empty() const { return count == 0; }
+    bool is_full() const { return count == capacity; }
+
+    void* slabs[capacity] {};
+    size_t count { 0 };
+};
+
+// Everything in here is only ever touched by its own processor, with interrupts disabled. The exception are the
+// magazines, which any processor may empty when the heap runs out of memory. That's what the lock is for.
+// NOTE: Never wait for the kmalloc lock while holding a magazine lock. The kmalloc lock may be held while waiting for one.
+struct KmallocProcessorCache {
+    Spinlock<LockRank::None> magazine_lock {};
+    KmallocMagazine magazines[slabheap_count];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+    size_t magazine_hits { 0 };
+    size_t magazine_misses { 0 };
+    size_t magazine_drains { 0 };
+};
+
+static KmallocProcessorCache s_kmalloc_processor_caches[MAX_CPU_COUNT];
+
+static KmallocProcessorCache& current_kmalloc_processor_cache()
+{
+    VERIFY(!Processor::are_interrupts_enabled());
+    return s_kmalloc_processor_caches[Processor::current_id()];
+}
+
+// Returns the index of the slabheap (and magazine) that serves allocations of this size, if any.
+static Optional<size_t> slabheap_index_for(size_t size, size_t alignment)
+{
+    // NOTE: There's no need to take the kmalloc lock, as the kmalloc slab-heaps (and their sizes) are constant
+    for (size_t i = 0; i < slabheap_count; ++i) {
+        auto slab_size = g_kmalloc_global->slabheaps[i].slab_size();
+        if (size <= slab_size && alignment <= slab_size)
+            return i;
+    }
+    return {};
+}
+
+// Under KASAN, every slab has to go through the slabheap so that its shadow memory is kept up to date.
+#ifdef HAS_ADDRESS_SANITIZER
+static constexpr bool kmalloc_magazines_enabled = false;
+#else
+static constexpr bool kmalloc_magazines_enabled = true;
+#endif
+
+static void* allocate_from_magazine(KmallocProcessorCache& processor_cache, size_t slabheap_index, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    void* ptr = nullptr;
+    {
+        SpinlockLocker magazine_locker(processor_cache.magazine_lock);
+        auto& magazine = processor_cache.magazines[slabheap_index];
+        if (magazine.is_empty()) {
+            ++processor_cache.magazine_misses;
+            return nullptr;
+        }
+        ++processor_cache.magazine_hits;
+        ptr = magazine.slabs[--magazine.count];
+    }
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, g_kmalloc_global->slabheaps[slabheap_index].slab_size());
+    return ptr;
+}
+
+// NOTE: Must be called with the kmalloc lock held.
+static void refill_magazine(KmallocProcessorCache& processor_cache, size_t slabheap_index)
+{
+    auto& magazine = processor_cache.magazines[slabheap_index];
+    size_t wanted_slab_count = 0;
+    {
+        SpinlockLocker magazine_locker(processor_cache.magazine_lock);
+        if (magazine.count < KmallocMagazine::batch_size)
+            wanted_slab_count = KmallocMagazine::batch_size - magazine.count;
+    }
+
+    auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index];
+    // Don't grow the slabheap just to fill up the magazine.
+    void* slabs[KmallocMagazine::batch_size];
+    size_t slab_count = 0;
+    while (slab_count < wanted_slab_count && slabheap.has_free_slabs())
+        slabs[slab_count++] = slabheap.allocate(slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+
+    // Other processors only ever take slabs out of our magazine, so there's still room for these.
+    SpinlockLocker magazine_locker(processor_cache.magazine_lock);
+    VERIFY(magazine.count + slab_count <= KmallocMagazine::capacity);
+    for (size_t i = 0; i < slab_count; ++i)
+        magazine.slabs[magazine.count++] = slabs[i];
+}
+
+static bool deallocate_into_magazine(KmallocProcessorCache& processor_cache, void* ptr, size_t size)
+{
+    Optional<size_t> slabheap_index;
+    for (size_t i = 0; i < slabheap_count; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size()) {
+            slabheap_index = i;
+            break;
+        }
+    }
+    if (!slabheap_index.has_value())
+        return false;
+
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    void* overflowing_slabs[KmallocMagazine::batch_size];
+    size_t overflowing_slab_count = 0;
+    {
+        SpinlockLocker magazine_locker(processor_cache.magazine_lock);
+        auto& magazine = processor_cache.magazines[*slabheap_index];
+        if (magazine.is_full()) {
+            while (overflowing_slab_count < KmallocMagazine::batch_size)
+                overflowing_slabs[overflowing_slab_count++] = magazine.slabs[--magazine.count];
+        }
+        magazine.slabs[magazine.count++] = ptr;
+    }
+
+    if (overflowing_slab_count > 0) {
+        SpinlockLocker lock(s_lock);
+        for (size_t i = 0; i < overflowing_slab_count; ++i)
+            slabheap.deallocate_scrubbed(overflowing_slabs[i]);
+    }
+    return true;
+}
+
+// Gives the slabs in every processor's magazines back to the slabheaps, so that their slab blocks can be freed.
+static void drain_all_magazines()
+{
+    for (auto& processor_cache : s_kmalloc_processor_caches) {
+        for (size_t slabheap_index = 0; slabheap_index < slabheap_count; ++slabheap_index) {
+            void* slabs[KmallocMagazine::capacity];
+            size_t slab_count = 0;
+            {
+                SpinlockLocker magazine_locker(processor_cache.magazine_lock);
+                auto& magazine = processor_cache.magazines[slabheap_index];
+                while (!magazine.is_empty())
+                    slabs[slab_count++] = magazine.slabs[--magazine.count];
+            }
+            if (slab_count == 0)
+                continue;
+
+            SpinlockLocker lock(s_lock);
+            auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index];
+            for (size_t i = 0; i < slab_count; ++i)
+                slabheap.deallocate_scrubbed(slabs[i]);
+        }
+    }
+}
 
 void kmalloc_enable_expand()
 {
@@ -449,15 +615,39 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    InterruptDisabler disabler;
+    auto& processor_cache = current_kmalloc_processor_cache();
+    ++processor_cache.kmalloc_call_count;
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
+    void* ptr = nullptr;
+    Optional<size_t> slabheap_index;
+    if (kmalloc_magazines_enabled && !g_dump_kmalloc_stacks) {
+        slabheap_index = slabheap_index_for(size, alignment);
+        if (slabheap_index.has_value())
+            ptr = allocate_from_magazine(processor_cache, *slabheap_index, caller_will_initialize_memory);
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    if (!ptr && !(kmalloc_magazines_enabled && g_force_magazine_drains)) {
+        SpinlockLocker lock(s_lock);
+
+        if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
+            dbgln("kmalloc({})", size);
+            Kernel::dump_backtrace();
+        }
+
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+        if (ptr && slabheap_index.has_value())
+            refill_magazine(processor_cache, *slabheap_index);
+    }
+
+    if (!ptr && kmalloc_magazines_enabled) {
+        // The heap couldn't grow, but the slabs sitting in magazines may be keeping whole slab blocks from being reused.
+        dbgln_if(KMALLOC_DEBUG, "Draining all kmalloc magazines to allocate {}", size);
+        drain_all_magazines();
+        ++processor_cache.magazine_drains;
+        SpinlockLocker lock(s_lock);
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -500,11 +690,12 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& processor_cache = current_kmalloc_processor_cache();
+    ++processor_cache.kfree_call_count;
+    ++processor_cache.nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (processor_cache.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -514,8 +705,11 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (!kmalloc_magazines_enabled || !deallocate_into_magazine(processor_cache, ptr, size)) {
+        SpinlockLocker lock(s_lock);
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --processor_cache.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -602,6 +796,24 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     SpinlockLocker lock(s_lock);
     stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
     stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+    stats.kmalloc_call_count = 0;
+    stats.kfree_call_count = 0;
+    stats.magazine_hits = 0;
+    stats.magazine_misses = 0;
+    stats.magazine_drains = 0;
+
+    // NOTE: The other processors keep going while we look at their caches, so this is only a snapshot.
+    for (auto const& processor_cache : s_kmalloc_processor_caches) {
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            // The slabheaps think that slabs sitting in a magazine are allocated.
+            auto cached_bytes = processor_cache.magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
+            stats.bytes_allocated -= cached_bytes;
+            stats.bytes_free += cached_bytes;
+        }
+        stats.kmalloc_call_count += processor_cache.kmalloc_call_count;
+        stats.kfree_call_count += processor_cache.kfree_call_count;
+        stats.magazine_hits += processor_cache.magazine_hits;
+        stats.magazine_misses += processor_cache.magazine_misses;
+        stats.magazine_drains += processor_cache.magazine_drains;
+    }
 }
@@ -52,10 +52,16 @@ struct kmalloc_stats {
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    size_t magazine_hits;
+    size_t magazine_misses;
+    size_t magazine_drains;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
 extern bool g_dump_kmalloc_stacks;
+// Makes kmalloc and the physical page allocator act as if memory had run out whenever a magazine is empty, so that they
+// have to drain every processor's magazines and try again. Only useful for testing.
+extern bool g_force_magazine_drains;
 
 inline void* operator new(size_t, void* p) { return p; }
 inline void* operator new[](size_t, void* p) { return p; }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/StringView.h>
+#include <Kernel/FileSystem/File.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/DoubleBuffer.h>
 
@@ -60,6 +61,22 @@ ErrorOr<size_t> DoubleBuffer::write(UserOrKernelBuffer const& data, size_t size)
     return bytes_to_write;
 }
 
+ErrorOr<size_t> DoubleBuffer::write_from(TransferSource& source, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_lock);
+    size_t bytes_to_write = min(size, m_space_for_writing);
+    u8* write_ptr = m_write_buffer->data + m_write_buffer->size;
+    size_t nwritten = TRY(source.read_into({ write_ptr, bytes_to_write }));
+    VERIFY(nwritten <= bytes_to_write);
+    m_write_buffer->size += nwritten;
+    compute_lockfree_metadata();
+    if (m_unblock_callback && !m_empty)
+        m_unblock_callback();
+    return nwritten;
+}
+
 ErrorOr<size_t> DoubleBuffer::read_impl(UserOrKernelBuffer& data, size_t size, MutexLocker&, bool advance_buffer_index)
 {
     if (size == 0)
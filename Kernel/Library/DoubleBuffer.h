@@ -22,6 +22,8 @@ public:
     {
         return write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data)), size);
     }
+    // Has the source fill the free space directly instead of copying the data in from another buffer.
+    ErrorOr<size_t> write_from(TransferSource&, size_t);
     ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
     ErrorOr<size_t> read(u8* data, size_t size)
     {
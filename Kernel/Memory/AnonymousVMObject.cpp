@@ -267,6 +267,23 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_allocate_committed_pages_contiguously(Badge<Region>, size_t page_index, size_t page_count)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    // Purging frees pages one by one, so there's no point in keeping them together.
+    if (is_purgeable())
+        return false;
+    if (!m_unused_committed_pages.has_value() || m_unused_committed_pages->page_count() < page_count)
+        return false;
+
+    auto pages = physical_pages().slice(page_index, page_count);
+    for (auto const& page : pages) {
+        if (!page->is_lazy_committed_page())
+            return false;
+    }
+    return m_unused_committed_pages->take_contiguous(pages);
+}
+
 void AnonymousVMObject::reset_cow_map()
 {
     for (size_t i = 0; i < page_count(); ++i) {
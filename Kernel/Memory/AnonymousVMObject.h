@@ -26,6 +26,8 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> allocate_committed_page(Badge<Region>);
+    // Backs all of the given pages with one physically contiguous block, as long as none of them has been faulted in yet.
+    bool try_allocate_committed_pages_contiguously(Badge<Region>, size_t page_index, size_t page_count);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
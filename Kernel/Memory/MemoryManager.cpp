@@ -64,6 +64,8 @@ ErrorOr<FlatPtr> page_round_up(FlatPtr x)
 static MemoryManager* s_the;
 static SetOnce s_mm_initialized;
 
+bool g_batched_anonymous_faults { false };
+
 MemoryManager& MemoryManager::the()
 {
     return *s_the;
@@ -1277,16 +1279,25 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
 ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
-    auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
-        if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
-            dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
-            return ENOMEM;
-        }
+    auto try_to_commit = [&](bool is_last_attempt) {
+        return m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+            if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
+                if (is_last_attempt)
+                    dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
+                return ENOMEM;
+            }
 
-        global_data.system_memory_info.physical_pages_uncommitted -= page_count;
-        global_data.system_memory_info.physical_pages_committed += page_count;
-        return CommittedPhysicalPageSet { {}, page_count };
-    });
+            global_data.system_memory_info.physical_pages_uncommitted -= page_count;
+            global_data.system_memory_info.physical_pages_committed += page_count;
+            return CommittedPhysicalPageSet { {}, page_count };
+        });
+    };
+    auto result = g_force_magazine_drains ? ErrorOr<CommittedPhysicalPageSet> { ENOMEM } : try_to_commit(false);
+    if (result.is_error()) {
+        // The pages sitting in the processors' magazines might just be what's missing.
+        drain_all_physical_page_magazines();
+        result = try_to_commit(true);
+    }
     if (result.is_error()) {
         Process::for_each_ignoring_process_lists([&](Process const& process) {
             size_t amount_resident = 0;
@@ -1325,27 +1336,146 @@ void MemoryManager::uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, siz
 
 void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
 {
-    return m_global_data.with([&](auto& global_data) {
-        // Are we returning a user page?
+    InterruptDisabler disabler;
+    auto& magazine = current_physical_page_magazine();
+    SpinlockLocker magazine_locker(magazine.lock);
+    if (magazine.page_count == PhysicalPageMagazine::capacity) {
+        m_global_data.with([&](auto& global_data) {
+            drain_physical_page_magazine(global_data, magazine, PhysicalPageMagazine::batch_size);
+        });
+    }
+    magazine.pages[magazine.page_count++] = paddr;
+}
+
+void MemoryManager::return_physical_page(GlobalData& global_data, PhysicalAddress paddr)
+{
+    // Are we returning a user page?
+    for (auto& region : global_data.physical_regions) {
+        if (!region->contains(paddr))
+            continue;
+
+        region->return_page(paddr);
+        --global_data.system_memory_info.physical_pages_used;
+
+        // Always return pages to the uncommitted pool. Pages that were
+        // committed and allocated are only freed upon request. Once
+        // returned there is no guarantee being able to get them back.
+        ++global_data.system_memory_info.physical_pages_uncommitted;
+        return;
+    }
+    PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
+}
+
+MemoryManager::PhysicalPageMagazine& MemoryManager::current_physical_page_magazine()
+{
+    VERIFY(!Processor::are_interrupts_enabled());
+    return m_physical_page_magazines[Processor::current_id()];
+}
+
+RefPtr<PhysicalRAMPage> MemoryManager::take_physical_page_from_magazine(bool committed)
+{
+    InterruptDisabler disabler;
+    auto& magazine = current_physical_page_magazine();
+    SpinlockLocker magazine_locker(magazine.lock);
+    if (magazine.page_count == 0) {
+        ++magazine.misses;
+        return nullptr;
+    }
+    ++magazine.hits;
+    auto paddr = magazine.pages[--magazine.page_count];
+    if (committed && ++magazine.unsettled_commitments >= PhysicalPageMagazine::batch_size) {
+        m_global_data.with([&](auto& global_data) {
+            settle_physical_page_magazine_commitments(global_data, magazine);
+        });
+    }
+    magazine_locker.unlock();
+    return PhysicalRAMPage::create(paddr);
+}
+
+void MemoryManager::settle_physical_page_magazine_commitments(GlobalData& global_data, PhysicalPageMagazine& magazine)
+{
+    VERIFY(magazine.lock.is_locked());
+    // The pages already came out of the uncommitted pool when they were put into the magazine.
+    VERIFY(global_data.system_memory_info.physical_pages_committed >= magazine.unsettled_commitments);
+    global_data.system_memory_info.physical_pages_committed -= magazine.unsettled_commitments;
+    global_data.system_memory_info.physical_pages_uncommitted += magazine.unsettled_commitments;
+    magazine.unsettled_commitments = 0;
+}
+
+void MemoryManager::refill_physical_page_magazine(GlobalData& global_data, PhysicalPageMagazine& magazine)
+{
+    VERIFY(&magazine == &current_physical_page_magazine());
+    settle_physical_page_magazine_commitments(global_data, magazine);
+
+    // Leave enough for every other processor to refill its magazine as well, so that we don't hoard the last few pages.
+    static constexpr size_t minimum_uncommitted_pages = PhysicalPageMagazine::batch_size * MAX_CPU_COUNT;
+    while (magazine.page_count < PhysicalPageMagazine::batch_size && global_data.system_memory_info.physical_pages_uncommitted > minimum_uncommitted_pages) {
+        Optional<PhysicalAddress> paddr;
         for (auto& region : global_data.physical_regions) {
-            if (!region->contains(paddr))
-                continue;
+            paddr = region->take_free_page_address();
+            if (paddr.has_value())
+                break;
+        }
+        if (!paddr.has_value())
+            break;
+        global_data.system_memory_info.physical_pages_uncommitted--;
+        ++global_data.system_memory_info.physical_pages_used;
+        magazine.pages[magazine.page_count++] = *paddr;
+    }
+}
 
-            region->return_page(paddr);
-            --global_data.system_memory_info.physical_pages_used;
+void MemoryManager::drain_physical_page_magazine(GlobalData& global_data, PhysicalPageMagazine& magazine, size_t page_count)
+{
+    settle_physical_page_magazine_commitments(global_data, magazine);
+    for (; page_count > 0 && magazine.page_count > 0; --page_count)
+        return_physical_page(global_data, magazine.pages[--magazine.page_count]);
+}
 
-            // Always return pages to the uncommitted pool. Pages that were
-            // committed and allocated are only freed upon request. Once
-            // returned there is no guarantee being able to get them back.
-            ++global_data.system_memory_info.physical_pages_uncommitted;
-            return;
+void MemoryManager::drain_all_physical_page_magazines()
+{
+    ++m_physical_page_magazine_drains;
+
+    // See the note on PhysicalPageMagazine: We take the pages out first, and only then give them back to GlobalData.
+    for (auto& magazine : m_physical_page_magazines) {
+        PhysicalAddress pages[PhysicalPageMagazine::capacity];
+        size_t page_count = 0;
+        size_t unsettled_commitments = 0;
+        {
+            SpinlockLocker magazine_locker(magazine.lock);
+            page_count = exchange(magazine.page_count, 0);
+            for (size_t i = 0; i < page_count; ++i)
+                pages[i] = magazine.pages[i];
+            unsettled_commitments = exchange(magazine.unsettled_commitments, 0);
         }
-        PANIC("MM: deallocate_physical_page couldn't figure out region for page @ {}", paddr);
-    });
+        if (page_count == 0 && unsettled_commitments == 0)
+            continue;
+
+        m_global_data.with([&](auto& global_data) {
+            VERIFY(global_data.system_memory_info.physical_pages_committed >= unsettled_commitments);
+            global_data.system_memory_info.physical_pages_committed -= unsettled_commitments;
+            global_data.system_memory_info.physical_pages_uncommitted += unsettled_commitments;
+            for (size_t i = 0; i < page_count; ++i)
+                return_physical_page(global_data, pages[i]);
+        });
+    }
+}
+
+MemoryManager::PhysicalPageMagazineStatistics MemoryManager::get_physical_page_magazine_statistics() const
+{
+    PhysicalPageMagazineStatistics statistics;
+    for (auto const& magazine : m_physical_page_magazines) {
+        statistics.hits += magazine.hits;
+        statistics.misses += magazine.misses;
+    }
+    statistics.drains = m_physical_page_magazine_drains.load();
+    return statistics;
 }
 
 RefPtr<PhysicalRAMPage> MemoryManager::find_free_physical_page(bool committed)
 {
+    if (auto page = take_physical_page_from_magazine(committed))
+        return page;
+
     RefPtr<PhysicalRAMPage> page;
     m_global_data.with([&](auto& global_data) {
         if (committed) {
@@ -1365,6 +1495,13 @@ RefPtr<PhysicalRAMPage> MemoryManager::find_free_physical_page(bool committed)
                 break;
             }
         }
+
+        // Take a few more while we're here, so that the next allocations on this processor don't have to.
+        if (!page.is_null()) {
+            auto& magazine = current_physical_page_magazine();
+            SpinlockLocker magazine_locker(magazine.lock);
+            refill_physical_page_magazine(global_data, magazine);
+        }
     });
 
     if (page.is_null())
@@ -1388,63 +1525,106 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
     return page.release_nonnull();
 }
 
+bool MemoryManager::allocate_committed_contiguous_physical_pages(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalRAMPage>> pages)
+{
+    VERIFY(is_power_of_two(pages.size()));
+    auto page_base = m_global_data.with([&](auto& global_data) -> Optional<PhysicalAddress> {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= pages.size());
+        for (auto& region : global_data.physical_regions) {
+            auto page_base = region->take_contiguous_free_block(pages.size());
+            if (page_base.has_value()) {
+                global_data.system_memory_info.physical_pages_committed -= pages.size();
+                global_data.system_memory_info.physical_pages_used += pages.size();
+                return page_base;
+            }
+        }
+        return {};
+    });
+    if (!page_base.has_value())
+        return false;
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        pages[i] = PhysicalRAMPage::create(page_base->offset(i * PAGE_SIZE));
+        InterruptDisabler disabler;
+        // FIXME: See the comment in allocate_committed_physical_page about the memory type.
+        auto* ptr = quickmap_page(*pages[i]);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return true;
+}
+
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
-    return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
-        auto page = find_free_physical_page(false);
-        bool purged_pages = false;
+    // Usually there's a free page right away, so we only hold on to the global lock if we have to go looking for one.
+    RefPtr<PhysicalRAMPage> page;
+    if (!g_force_magazine_drains)
+        page = find_free_physical_page(false);
+    bool purged_pages = false;
+
+    if (!page) {
+        // Before we go and throw away anybody's data, get back the pages that other processors are keeping around.
+        drain_all_physical_page_magazines();
+        page = find_free_physical_page(false);
+    }
 
-        if (!page) {
-            // We didn't have a single free physical page. Let's try to free something up!
-            // First, we look for a purgeable VMObject in the volatile state.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_anonymous())
-                    return IterationDecision::Continue;
-                auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
-                if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
+    if (!page) {
+        m_global_data.with([&](auto&) {
+            // Somebody might have freed a page since we last looked.
+            page = find_free_physical_page(false);
+            if (!page) {
+                // We didn't have a single free physical page. Let's try to free something up!
+                // First, we look for a purgeable VMObject in the volatile state.
+                for_each_vmobject([&](auto& vmobject) {
+                    if (!vmobject.is_anonymous())
+                        return IterationDecision::Continue;
+                    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+                    if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
+                        return IterationDecision::Continue;
+                    if (auto purged_page_count = anonymous_vmobject.purge()) {
+                        dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
+                        page = find_free_physical_page(false);
+                        purged_pages = true;
+                        VERIFY(page);
+                        return IterationDecision::Break;
+                    }
                     return IterationDecision::Continue;
-                if (auto purged_page_count = anonymous_vmobject.purge()) {
-                    dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false);
-                    purged_pages = true;
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
-                return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            // Second, we look for a file-backed VMObject with clean pages.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_inode())
+                });
+            }
+            if (!page) {
+                // Second, we look for a file-backed VMObject with clean pages.
+                for_each_vmobject([&](auto& vmobject) {
+                    if (!vmobject.is_inode())
+                        return IterationDecision::Continue;
+                    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
+                    if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
+                        dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
+                        page = find_free_physical_page(false);
+                        VERIFY(page);
+                        return IterationDecision::Break;
+                    }
                     return IterationDecision::Continue;
-                auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
-                if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false);
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
-                return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            dmesgln("MM: no physical pages available");
-            return ENOMEM;
-        }
+                });
+            }
+        });
+    }
+    if (!page) {
+        dmesgln("MM: no physical pages available");
+        return ENOMEM;
+    }
 
-        if (should_zero_fill == ShouldZeroFill::Yes) {
-            // FIXME: To prevent aliasing memory with different memory types, this page should be mapped using the same memory type it will use later for the actual mapping.
-            //        (See the comment above the memset in allocate_contiguous_physical_pages.)
-            auto* ptr = quickmap_page(*page);
-            memset(ptr, 0, PAGE_SIZE);
-            unquickmap_page();
-        }
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        InterruptDisabler disabler;
+        // FIXME: To prevent aliasing memory with different memory types, this page should be mapped using the same memory type it will use later for the actual mapping.
+        //        (See the comment above the memset in allocate_contiguous_physical_pages.)
+        auto* ptr = quickmap_page(*page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
 
-        if (did_purge)
-            *did_purge = purged_pages;
-        return page.release_nonnull();
-    });
+    if (did_purge)
+        *did_purge = purged_pages;
+    return page.release_nonnull();
 }
 
 ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill)
@@ -1642,6 +1822,15 @@ NonnullRefPtr<PhysicalRAMPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+bool CommittedPhysicalPageSet::take_contiguous(Span<RefPtr<PhysicalRAMPage>> pages)
+{
+    VERIFY(m_page_count >= pages.size());
+    if (!MM.allocate_committed_contiguous_physical_pages({}, pages))
+        return false;
+    m_page_count -= pages.size();
+    return true;
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -1678,7 +1867,18 @@ MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
     return m_global_data.with([&](auto& global_data) {
         auto physical_pages_unused = global_data.system_memory_info.physical_pages_committed + global_data.system_memory_info.physical_pages_uncommitted;
         VERIFY(global_data.system_memory_info.physical_pages == (global_data.system_memory_info.physical_pages_used + physical_pages_unused));
-        return global_data.system_memory_info;
+
+        // Pages sitting in a magazine are really free, and nobody can commit to the ones already handed out again.
+        // NOTE: The other processors keep going while we look at their magazines, so this is only a snapshot.
+        auto system_memory_info = global_data.system_memory_info;
+        for (auto const& magazine : m_physical_page_magazines) {
+            auto page_count = AK::atomic_load(&magazine.page_count, AK::MemoryOrder::memory_order_relaxed);
+            auto unsettled_commitments = AK::atomic_load(&magazine.unsettled_commitments, AK::MemoryOrder::memory_order_relaxed);
+            system_memory_info.physical_pages_used -= page_count;
+            system_memory_info.physical_pages_committed -= unsettled_commitments;
+            system_memory_info.physical_pages_uncommitted += page_count + unsettled_commitments;
+        }
+        return system_memory_info;
     });
 }
 }
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
@@ -34,6 +36,12 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return x & ~(PAGE_SIZE - 1);
 }
 
+// How much memory a single page table maps. If enabled, large anonymous mappings are faulted in this much at a time.
+// NOTE: The batch is still mapped with individual 4 KiB page table entries, not as a single large page.
+constexpr size_t anonymous_fault_batch_size = 512 * PAGE_SIZE;
+// Off by default until it has been measured. Can be turned on through /sys/kernel/conf/batched_anonymous_faults.
+extern bool g_batched_anonymous_faults;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - g_boot_info.physical_to_virtual_offset;
@@ -116,6 +124,8 @@ public:
     size_t page_count() const { return m_page_count; }
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> take_one();
+    // Fills all the given slots with zeroed, physically contiguous pages. Returns false if there's no such block free.
+    [[nodiscard]] bool take_contiguous(Span<RefPtr<PhysicalRAMPage>>);
     void uncommit_one();
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
@@ -166,6 +176,7 @@ public:
     void uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, size_t page_count);
 
     NonnullRefPtr<PhysicalRAMPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    bool allocate_committed_contiguous_physical_pages(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalRAMPage>>);
     ErrorOr<NonnullRefPtr<PhysicalRAMPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill);
     void deallocate_physical_page(PhysicalAddress);
@@ -191,6 +202,14 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    struct PhysicalPageMagazineStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 drains { 0 };
+    };
+
+    PhysicalPageMagazineStatistics get_physical_page_magazine_statistics() const;
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -258,6 +277,34 @@ private:
         Vector<ContiguousReservedMemoryRange> reserved_memory_ranges;
     };
 
+    // Each processor keeps a few free pages around, so that allocating and freeing single pages usually doesn't have
+    // to take the global lock. As far as GlobalData is concerned, the pages in a magazine are used and uncommitted.
+    // Only its own processor puts pages into a magazine, but any processor may empty it when memory runs out.
+    // NOTE: A processor may take the global lock while holding the lock of its own magazine. So never wait for another
+    //       processor's magazine lock while holding the global lock, or the other way around.
+    struct PhysicalPageMagazine {
+        static constexpr size_t capacity = 32;
+        static constexpr size_t batch_size = capacity / 2;
+
+        Spinlock<LockRank::None> lock {};
+        PhysicalAddress pages[capacity];
+        size_t page_count { 0 };
+        // Committed pages that we handed out from the magazine. They still have to be moved from the committed to the
+        // uncommitted pool, which we do in batches as well.
+        size_t unsettled_commitments { 0 };
+
+        u64 hits { 0 };
+        u64 misses { 0 };
+    };
+
+    PhysicalPageMagazine& current_physical_page_magazine();
+    RefPtr<PhysicalRAMPage> take_physical_page_from_magazine(bool committed);
+    void refill_physical_page_magazine(GlobalData&, PhysicalPageMagazine&);
+    void drain_physical_page_magazine(GlobalData&, PhysicalPageMagazine&, size_t page_count);
+    void drain_all_physical_page_magazines();
+    void settle_physical_page_magazine_commitments(GlobalData&, PhysicalPageMagazine&);
+    void return_physical_page(GlobalData&, PhysicalAddress);
+
     void initialize_physical_pages();
     void register_reserved_ranges();
 
@@ -308,6 +355,10 @@ private:
     size_t m_physical_page_entries_count { 0 };
 
     RecursiveSpinlockProtected<GlobalData, LockRank::None> m_global_data;
+
+    // NOTE: Each of these is only ever changed by its own processor, with interrupts disabled.
+    Array<PhysicalPageMagazine, MAX_CPU_COUNT> m_physical_page_magazines;
+    Atomic<u64> m_physical_page_magazine_drains { 0 };
 };
 
 inline bool PhysicalRAMPage::is_shared_zero_page() const
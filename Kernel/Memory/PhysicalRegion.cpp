@@ -75,37 +75,49 @@ OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(size_t page
 }
 
 Vector<NonnullRefPtr<PhysicalRAMPage>> PhysicalRegion::take_contiguous_free_pages(size_t count)
+{
+    auto page_base = take_contiguous_free_block(count);
+    if (!page_base.has_value())
+        return {};
+
+    Vector<NonnullRefPtr<PhysicalRAMPage>> physical_pages;
+    physical_pages.ensure_capacity(count);
+
+    for (size_t i = 0; i < count; ++i)
+        physical_pages.append(PhysicalRAMPage::create(page_base.value().offset(i * PAGE_SIZE)));
+    return physical_pages;
+}
+
+Optional<PhysicalAddress> PhysicalRegion::take_contiguous_free_block(size_t count)
 {
     auto rounded_page_count = next_power_of_two(count);
     auto order = count_trailing_zeroes(rounded_page_count);
 
-    Optional<PhysicalAddress> page_base;
     for (auto& zone : m_usable_zones) {
-        page_base = zone.allocate_block(order);
+        auto page_base = zone.allocate_block(order);
         if (page_base.has_value()) {
             if (zone.is_empty()) {
                 // We've exhausted this zone, move it to the full zones list.
                 m_full_zones.append(zone);
             }
-            break;
+            return page_base;
         }
     }
-
-    if (!page_base.has_value())
-        return {};
-
-    Vector<NonnullRefPtr<PhysicalRAMPage>> physical_pages;
-    physical_pages.ensure_capacity(count);
-
-    for (size_t i = 0; i < count; ++i)
-        physical_pages.append(PhysicalRAMPage::create(page_base.value().offset(i * PAGE_SIZE)));
-    return physical_pages;
+    return {};
 }
 
 RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
 {
-    if (m_usable_zones.is_empty())
+    auto page = take_free_page_address();
+    if (!page.has_value())
         return nullptr;
+    return PhysicalRAMPage::create(page.value());
+}
+
+Optional<PhysicalAddress> PhysicalRegion::take_free_page_address()
+{
+    if (m_usable_zones.is_empty())
+        return {};
 
     auto& zone = *m_usable_zones.first();
     auto page = zone.allocate_block(0);
@@ -116,7 +128,7 @@ RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
         m_full_zones.append(zone);
     }
 
-    return PhysicalRAMPage::create(page.value());
+    return page.value();
 }
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
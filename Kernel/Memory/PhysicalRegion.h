@@ -35,7 +35,11 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(size_t);
 
     RefPtr<PhysicalRAMPage> take_free_page();
+    // Like take_free_page(), but for when nobody is going to use the page quite yet.
+    Optional<PhysicalAddress> take_free_page_address();
     Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count);
+    // Takes a block of next_power_of_two(count) pages, and leaves it to the caller to create the pages for it.
+    Optional<PhysicalAddress> take_contiguous_free_block(size_t count);
     void return_page(PhysicalAddress);
 
 private:
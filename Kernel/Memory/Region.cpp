@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/PageFault.h>
@@ -280,6 +282,42 @@ bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalRAMPag
     return success;
 }
 
+bool Region::try_fault_in_anonymous_batch(size_t page_index)
+{
+    VERIFY(vmobject().m_lock.is_locked_by_current_processor());
+    VERIFY(vmobject().is_anonymous());
+
+    if (!g_batched_anonymous_faults || !is_user() || m_shared || is_stack())
+        return false;
+
+    auto chunk_base = VirtualAddress { align_down_to(vaddr_from_page_index(page_index).get(), anonymous_fault_batch_size) };
+    if (chunk_base < vaddr() || chunk_base.get() + anonymous_fault_batch_size > vaddr().get() + size())
+        return false;
+
+    // All pages in the chunk share a single page table, so once that exists, mapping them can't fail anymore.
+    {
+        SpinlockLocker page_lock(m_page_directory->get_lock());
+        if (!MM.ensure_pte(*m_page_directory, chunk_base))
+            return false;
+    }
+
+    constexpr size_t chunk_page_count = anonymous_fault_batch_size / PAGE_SIZE;
+    auto first_page_index_in_region = page_index_from_address(chunk_base);
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index_in_region);
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_allocate_committed_pages_contiguously({}, first_page_index_in_vmobject, chunk_page_count))
+        return false;
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    auto pages = anonymous_vmobject.physical_pages().slice(first_page_index_in_vmobject, chunk_page_count);
+    for (size_t i = 0; i < chunk_page_count; ++i) {
+        bool success = map_individual_page_impl(first_page_index_in_region + i, pages[i]);
+        VERIFY(success);
+    }
+    MemoryManager::flush_tlb(m_page_directory, chunk_base, chunk_page_count);
+    return true;
+}
+
 void Region::unmap(ShouldFlushTLB should_flush_tlb)
 {
     if (!m_page_directory)
@@ -399,8 +437,10 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
         SpinlockLocker vmobject_locker(vmobject().m_lock);
         auto& page_slot = physical_page_slot(page_index_in_region);
         if (page_slot->is_lazy_committed_page()) {
-            auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             VERIFY(m_vmobject->is_anonymous());
+            if (try_fault_in_anonymous_batch(page_index_in_region))
+                return PageFaultResponse::Continue;
+            auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
             if (!remap_vmobject_page(page_index_in_vmobject, *page_slot))
                 return PageFaultResponse::OutOfMemory;
@@ -480,8 +520,10 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
     SpinlockLocker vmobject_locker(vmobject().m_lock);
     auto& page_slot = physical_page_slot(page_index_in_region);
     if (page_slot->is_lazy_committed_page()) {
-        auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
         VERIFY(m_vmobject->is_anonymous());
+        if (try_fault_in_anonymous_batch(page_index_in_region))
+            return PageFaultResponse::Continue;
+        auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
         page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
         if (!remap_vmobject_page(page_index_in_vmobject, *page_slot))
             return PageFaultResponse::OutOfMemory;
@@ -504,6 +546,12 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
+        SpinlockLocker locker(anonymous_vmobject.m_lock);
+        if (physical_page_slot(page_index_in_region)->is_lazy_committed_page() && try_fault_in_anonymous_batch(page_index_in_region))
+            return PageFaultResponse::Continue;
+    }
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -564,6 +612,26 @@ PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
     return response;
 }
 
+// Programs mostly read their executables and libraries front to back, so on every inode fault we map (and if necessary,
+// read in) this many pages around the faulting one, aligned to their offset in the file.
+static constexpr size_t fault_around_page_count = 16;
+
+bool Region::map_inode_pages(size_t first_page_index, size_t end_page_index)
+{
+    VERIFY(vmobject().m_lock.is_locked_by_current_processor());
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+
+    auto physical_pages = vmobject().physical_pages();
+    bool success = true;
+    for (size_t page_index = first_page_index; page_index < end_page_index; ++page_index) {
+        auto& page = physical_pages[translate_to_vmobject_page(page_index)];
+        if (!page.is_null() && !map_individual_page_impl(page_index, page))
+            success = false;
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index), end_page_index - first_page_index);
+    return success;
+}
+
 PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool mark_page_dirty)
 {
     VERIFY(vmobject().is_inode());
@@ -571,33 +639,59 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
 
     auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
-    auto& physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
+    auto physical_pages = inode_vmobject.physical_pages();
+
+    // These are Region page indices, clamped to the part of the VMObject that this region maps.
+    auto fault_around_base = align_down_to(page_index_in_vmobject, fault_around_page_count);
+    auto fault_around_first_page_index = max(fault_around_base, first_page_index()) - first_page_index();
+    auto fault_around_end_page_index = min(fault_around_base + fault_around_page_count, first_page_index() + page_count()) - first_page_index();
+
+    // The run of pages around the faulting one that nobody has read in yet, in VMObject page indices.
+    size_t first_page_index_to_read = page_index_in_vmobject;
+    size_t end_page_index_to_read = page_index_in_vmobject + 1;
 
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
 
-        if (!physical_page_slot.is_null()) {
+        if (!physical_pages[page_index_in_vmobject].is_null()) {
             dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else before reading, remapping.");
             if (mark_page_dirty)
                 inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
-            if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
+            if (!map_inode_pages(fault_around_first_page_index, fault_around_end_page_index))
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+
+        while (first_page_index_to_read > translate_to_vmobject_page(fault_around_first_page_index) && physical_pages[first_page_index_to_read - 1].is_null())
+            --first_page_index_to_read;
+        while (end_page_index_to_read < translate_to_vmobject_page(fault_around_end_page_index) && physical_pages[end_page_index_to_read].is_null())
+            ++end_page_index_to_read;
     }
 
-    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
+    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}, reading {} pages", name(), page_index_in_region, end_page_index_to_read - first_page_index_to_read);
 
     auto current_thread = Thread::current();
     if (current_thread)
         current_thread->did_inode_fault();
 
     u8 page_buffer[PAGE_SIZE];
-    auto& inode = inode_vmobject.inode();
+    ByteBuffer cluster_buffer;
+    if (end_page_index_to_read - first_page_index_to_read > 1) {
+        auto cluster_buffer_or_error = ByteBuffer::create_uninitialized((end_page_index_to_read - first_page_index_to_read) * PAGE_SIZE);
+        if (cluster_buffer_or_error.is_error()) {
+            // Reading the neighbors is only an optimization, so we can still make do with just the one page.
+            first_page_index_to_read = page_index_in_vmobject;
+            end_page_index_to_read = page_index_in_vmobject + 1;
+        } else {
+            cluster_buffer = cluster_buffer_or_error.release_value();
+        }
+    }
+    Bytes read_buffer = cluster_buffer.is_empty() ? Bytes { page_buffer, PAGE_SIZE } : cluster_buffer.bytes();
 
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    auto& inode = inode_vmobject.inode();
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(read_buffer.data());
+    auto result = inode.read_bytes(first_page_index_to_read * PAGE_SIZE, read_buffer.size(), buffer, nullptr);
 
     if (result.is_error()) {
         dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
@@ -605,26 +699,34 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     }
 
     auto nread = result.value();
-    // Note: If we received 0, it means we are at the end of file or after it,
+    // Note: If we didn't get anything for the faulting page, it means it's at the end of file or after it,
     // which means we should return bus error.
-    if (nread == 0)
+    if (nread <= (page_index_in_vmobject - first_page_index_to_read) * PAGE_SIZE)
         return PageFaultResponse::BusError;
 
+    // Pages past the end of file are left alone, so that touching them is still a bus error.
+    end_page_index_to_read = first_page_index_to_read + ceil_div(nread, static_cast<size_t>(PAGE_SIZE));
+
     // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-    if (nread < PAGE_SIZE)
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+    if (nread % PAGE_SIZE)
+        memset(read_buffer.data() + nread, 0, PAGE_SIZE - nread % PAGE_SIZE);
+
+    // Allocate new physical pages, and copy the read inode contents into them.
+    Array<RefPtr<PhysicalRAMPage>, fault_around_page_count> new_physical_pages;
+    for (size_t page_index = first_page_index_to_read; page_index < end_page_index_to_read; ++page_index) {
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error()) {
+            if (page_index != page_index_in_vmobject)
+                continue;
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
+        }
+        auto& new_physical_page = new_physical_pages[page_index - first_page_index_to_read];
+        new_physical_page = new_physical_page_or_error.release_value();
 
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
         InterruptDisabler disabler;
         u8* dest_ptr = MM.quickmap_page(*new_physical_page);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+        memcpy(dest_ptr, read_buffer.offset((page_index - first_page_index_to_read) * PAGE_SIZE), PAGE_SIZE);
 
         if (is_executable()) {
             // Some architectures require an explicit synchronization operation after writing to memory that will be executed.
@@ -640,18 +742,22 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     {
         SpinlockLocker locker(inode_vmobject.m_lock);
 
-        // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
-        if (physical_page_slot.is_null()) {
-            physical_page_slot = new_physical_page;
-            // Something went wrong if a newly loaded page is already marked dirty
-            VERIFY(!inode_vmobject.is_page_dirty(page_index_in_vmobject));
-        } else {
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
+        for (size_t page_index = first_page_index_to_read; page_index < end_page_index_to_read; ++page_index) {
+            auto& new_physical_page = new_physical_pages[page_index - first_page_index_to_read];
+            auto& physical_page_slot = physical_pages[page_index];
+            // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
+            if (physical_page_slot.is_null() && !new_physical_page.is_null()) {
+                physical_page_slot = move(new_physical_page);
+                // Something went wrong if a newly loaded page is already marked dirty
+                VERIFY(!inode_vmobject.is_page_dirty(page_index));
+            } else if (page_index == page_index_in_vmobject) {
+                dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
+            }
         }
 
         if (mark_page_dirty)
             inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
-        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
+        if (!map_inode_pages(fault_around_first_page_index, fault_around_end_page_index))
             return PageFaultResponse::OutOfMemory;
         return PageFaultResponse::Continue;
     }
@@ -243,8 +243,12 @@ private:
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index, bool mark_page_dirty = false);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalRAMPage& page_in_slot_at_time_of_fault);
+    // Faults in the whole anonymous_fault_batch_size chunk around the given page at once, if it's untouched and fully inside this region.
+    [[nodiscard]] bool try_fault_in_anonymous_batch(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_dirty_on_write_fault(size_t page_index);
 
+    // Maps all pages in the given range that the inode VMObject already has, with a single TLB flush.
+    [[nodiscard]] bool map_inode_pages(size_t first_page_index, size_t end_page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalRAMPage>);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, PhysicalAddress);
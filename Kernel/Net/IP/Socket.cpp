@@ -251,6 +251,21 @@ ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, UserOrKernelBuffer cons
     return nsent_or_error;
 }
 
+ErrorOr<size_t> IPv4Socket::send_from(OpenFileDescription&, TransferSource& source, size_t size)
+{
+    // Only connected streams are worth it. Everything else has to go through sendto() with a buffer.
+    if (type() != SOCK_STREAM)
+        return ENOTSUP;
+
+    MutexLocker locker(mutex());
+    if (!is_connected())
+        return set_so_error(EPIPE);
+
+    auto nsent = TRY(protocol_send_from(source, size));
+    Thread::current()->did_ipv4_socket_write(nsent);
+    return nsent;
+}
+
 ErrorOr<size_t> IPv4Socket::receive_byte_buffered(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, bool blocking)
 {
     MutexLocker locker(mutex());
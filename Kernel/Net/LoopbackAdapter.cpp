@@ -5,7 +5,11 @@
  */
 
 #include <AK/Singleton.h>
+#include <Kernel/Library/KBuffer.h>
 #include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Security/Random.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
 
@@ -21,19 +25,48 @@ LoopbackAdapter::LoopbackAdapter(StringView interface_name)
 {
     VERIFY(!s_loopback_initialized);
     s_loopback_initialized = true;
-    // The networking subsystem currently assumes all adapters are Ethernet adapters, including the LoopbackAdapter,
-    // so all packets are pre-pended with an Ethernet Frame header. Since the MTU must not include any overhead added
-    // by the data-link (Ethernet in this case) or physical layers, we need to subtract it from the MTU.
-    set_mtu(65536 - sizeof(EthernetFrameHeader));
+    set_mtu(default_mtu);
     set_mac_address({ 19, 85, 2, 9, 0x55, 0xaa });
 }
 
 LoopbackAdapter::~LoopbackAdapter() = default;
 
+LoopbackAdapter::NetworkEmulation LoopbackAdapter::network_emulation() const
+{
+    return m_network_emulation.with([](auto& network_emulation) { return network_emulation; });
+}
+
+void LoopbackAdapter::set_network_emulation(NetworkEmulation network_emulation)
+{
+    VERIFY(network_emulation.loss_percentage <= 100);
+    m_network_emulation.with([&](auto& current_network_emulation) { current_network_emulation = network_emulation; });
+}
+
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
-    dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
-    did_receive(payload);
+    auto network_emulation = this->network_emulation();
+    if (network_emulation.loss_percentage > 0 && get_fast_random<u32>() % 100 < network_emulation.loss_percentage) {
+        dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Losing {} byte(s) on purpose.", payload.size());
+        return;
+    }
+
+    if (network_emulation.delay_ms == 0) {
+        dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+        did_receive(payload);
+        return;
+    }
+
+    dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself in {} ms.", payload.size(), network_emulation.delay_ms);
+    auto packet_or_error = KBuffer::try_create_with_bytes("LoopbackAdapter: Delayed packet"sv, payload);
+    auto timer = adopt_ref_if_nonnull(new (nothrow) Timer);
+    if (packet_or_error.is_error() || !timer) {
+        dbgln("LoopbackAdapter: Dropping packet because we're out of memory");
+        return;
+    }
+    auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + Duration::from_milliseconds(network_emulation.delay_ms);
+    TimerQueue::the().add_timer_without_id(timer.release_nonnull(), CLOCK_MONOTONIC_COARSE, deadline, [this, packet = packet_or_error.release_value()]() {
+        did_receive(packet->bytes());
+    });
 }
 
 }
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/NetworkAdapter.h>
 
 namespace Kernel {
@@ -26,6 +28,22 @@ public:
     virtual bool link_up() override { return true; }
     virtual bool link_full_duplex() override { return true; }
     virtual int link_speed() override { return 1000; }
+
+    // The networking subsystem currently assumes all adapters are Ethernet adapters, including the LoopbackAdapter,
+    // so all packets are pre-pended with an Ethernet Frame header. Since the MTU must not include any overhead added
+    // by the data-link (Ethernet in this case) or physical layers, we need to subtract it from the MTU.
+    static constexpr u32 default_mtu = 65536 - sizeof(EthernetFrameHeader);
+
+    // Makes the loopback behave like a real network, so that we can see how the protocols above cope with one.
+    struct NetworkEmulation {
+        u32 loss_percentage { 0 };
+        u32 delay_ms { 0 };
+    };
+    NetworkEmulation network_emulation() const;
+    void set_network_emulation(NetworkEmulation);
+
+private:
+    SpinlockProtected<NetworkEmulation, LockRank::None> m_network_emulation {};
 };
 
 }
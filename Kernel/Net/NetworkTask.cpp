@@ -30,6 +30,7 @@
 
 namespace Kernel {
 
+static void handle_packet(u8 const* buffer, size_t packet_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size, RefPtr<NetworkAdapter> adapter);
 static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
@@ -37,13 +38,35 @@ static void handle_ipv6(EthernetFrameHeader const&, size_t frame_size, UnixDateT
 static void handle_icmpv6(EthernetFrameHeader const&, IPv6PacketHeader const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_udp(IPv4Packet const&, UnixDateTime const& packet_timestamp);
 static void handle_tcp(IPv4Packet const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
+static bool can_coalesce_tcp_segment(IPv4Packet const&);
+static void coalesce_tcp_segment(IPv4Packet const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
+static void flush_coalesced_tcp_segment();
 static void send_delayed_tcp_ack(TCPSocket& socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter);
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
+// How many packets we handle before flushing delayed ACKs and retransmitting again.
+// FIXME: All of this still happens on a single thread. Handing packets to per-processor contexts by flow hash would
+//        need the delayed ACK list, NetworkTask::is_current() (which keeps routing from blocking on ARP) and the
+//        listen/accept path to stop assuming that there is only one NetworkTask.
+static constexpr size_t maximum_packets_per_batch = 64;
+
+// Consecutive in-order data segments of a TCP connection are merged into one before they're handed to handle_tcp(),
+// so that a burst of them costs a single socket lookup and delivery. Only the NetworkTask touches this.
+struct CoalescedTCPSegment {
+    u8* buffer { nullptr };
+    UnixDateTime packet_timestamp;
+    RefPtr<NetworkAdapter> adapter;
+    bool is_pending { false };
+
+    IPv4Packet& ipv4_packet() { return *reinterpret_cast<IPv4Packet*>(buffer); }
+    TCPPacket& tcp_packet() { return *static_cast<TCPPacket*>(ipv4_packet().payload()); }
+};
+
 static Thread* network_task = nullptr;
 static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+static CoalescedTCPSegment* coalesced_tcp_segment;
 
 [[noreturn]] static void NetworkTask_main(void*);
 
@@ -84,59 +107,83 @@ void NetworkTask_main(void*)
         TODO();
     auto buffer_region = region_or_error.release_value();
 
-    struct {
-        u8* buffer;
-        UnixDateTime packet_timestamp;
-        RefPtr<NetworkAdapter> adapter;
-    } meta;
+    // The largest IPv4 packet is what a coalesced TCP segment can grow to.
+    auto coalesced_region_or_error = MM.allocate_kernel_region(64 * KiB, "Kernel Coalesced TCP Segment"sv, Memory::Region::Access::ReadWrite);
+    if (coalesced_region_or_error.is_error())
+        TODO();
+    auto coalesced_region = coalesced_region_or_error.release_value();
+    coalesced_tcp_segment = new CoalescedTCPSegment;
+    coalesced_tcp_segment->buffer = coalesced_region->vaddr().as_ptr();
 
-    meta.buffer = (u8*)buffer_region->vaddr().get();
+    u8* buffer = buffer_region->vaddr().as_ptr();
+    Vector<NonnullRefPtr<NetworkAdapter>> adapters;
 
     while (!Process::current().is_dying()) {
         flush_delayed_tcp_acks();
         retransmit_tcp_packets();
-        size_t packet_size = 0;
         if (!pending_packets) {
             auto timeout_time = Duration::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
             continue;
-        } else {
-            NetworkingManagement::the().for_each([&](auto& adapter) {
-                if (packet_size || !adapter.has_queued_packets()) {
-                    return;
-                }
-                packet_size = adapter.dequeue_packet(meta.buffer, buffer_size, meta.packet_timestamp);
-                pending_packets--;
-                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-                meta.adapter = adapter;
-            });
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)meta.buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size, meta.adapter);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        case EtherType::IPv6:
-            handle_ipv6(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+
+        // Drain a batch of packets before doing the per-wakeup work above again, taking one packet from each
+        // adapter in turn so that a busy adapter can't starve the others.
+        adapters.clear_with_capacity();
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            if (adapter.has_queued_packets())
+                adapters.append(adapter);
+        });
+
+        size_t packets_in_batch = 0;
+        bool dequeued_any = true;
+        while (dequeued_any && packets_in_batch < maximum_packets_per_batch) {
+            dequeued_any = false;
+            for (auto& adapter : adapters) {
+                UnixDateTime packet_timestamp;
+                size_t packet_size = adapter->dequeue_packet(buffer, buffer_size, packet_timestamp);
+                if (!packet_size)
+                    continue;
+                pending_packets--;
+                dequeued_any = true;
+                ++packets_in_batch;
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter->name(), packet_size);
+                handle_packet(buffer, packet_size, packet_timestamp, adapter);
+            }
         }
+
+        // Whatever we coalesced has to reach its socket before the delayed ACKs for it go out.
+        flush_coalesced_tcp_segment();
     }
     Process::current().sys$exit(0);
     VERIFY_NOT_REACHED();
 }
 
+void handle_packet(u8 const* buffer, size_t packet_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter)
+{
+    if (packet_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)buffer;
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, packet_size, adapter);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, packet_size, packet_timestamp, adapter);
+        break;
+    case EtherType::IPv6:
+        handle_ipv6(eth, packet_size, packet_timestamp, adapter);
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size, RefPtr<NetworkAdapter> adapter)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -219,6 +266,10 @@ void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, UnixDateTime
     case TransportProtocol::UDP:
         return handle_udp(packet, packet_timestamp);
     case TransportProtocol::TCP:
+        if (can_coalesce_tcp_segment(packet))
+            return coalesce_tcp_segment(packet, packet_timestamp, adapter);
+        // Anything else for this connection has to be handled after the data that came before it.
+        flush_coalesced_tcp_segment();
         return handle_tcp(packet, packet_timestamp, adapter);
     default:
         dbgln_if(IPV4_DEBUG, "handle_ipv4: Unhandled protocol {:#02x}", packet.protocol());
@@ -534,6 +585,63 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Re
     routing_decision.adapter->release_packet_buffer(*packet);
 }
 
+bool can_coalesce_tcp_segment(IPv4Packet const& ipv4_packet)
+{
+    // Only plain data segments qualify: anything with options or flags beyond ACK and PSH needs handle_tcp() to see it
+    // as it was sent.
+    if (ipv4_packet.internet_header_length() != 5 || ipv4_packet.is_a_fragment())
+        return false;
+    if (ipv4_packet.payload_size() <= sizeof(TCPPacket))
+        return false;
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    return tcp_packet.header_size() == sizeof(TCPPacket) && tcp_packet.has_ack() && (tcp_packet.flags() & ~(TCPFlags::ACK | TCPFlags::PSH)) == 0;
+}
+
+void coalesce_tcp_segment(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter)
+{
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    size_t payload_size = ipv4_packet.payload_size() - sizeof(TCPPacket);
+
+    auto& segment = *coalesced_tcp_segment;
+    if (segment.is_pending) {
+        auto& pending_ipv4_packet = segment.ipv4_packet();
+        auto& pending_tcp_packet = segment.tcp_packet();
+        size_t pending_payload_size = pending_ipv4_packet.payload_size() - sizeof(TCPPacket);
+        bool continues_pending_segment = segment.adapter == adapter
+            && pending_ipv4_packet.source() == ipv4_packet.source()
+            && pending_ipv4_packet.destination() == ipv4_packet.destination()
+            && pending_tcp_packet.source_port() == tcp_packet.source_port()
+            && pending_tcp_packet.destination_port() == tcp_packet.destination_port()
+            && static_cast<u32>(pending_tcp_packet.sequence_number() + pending_payload_size) == tcp_packet.sequence_number()
+            && pending_ipv4_packet.length() + payload_size <= NumericLimits<u16>::max();
+        if (continues_pending_segment) {
+            memcpy(segment.buffer + pending_ipv4_packet.length(), tcp_packet.payload(), payload_size);
+            pending_ipv4_packet.set_length(pending_ipv4_packet.length() + payload_size);
+            // The newest segment has the latest word on what the peer has seen and how much more it can take.
+            pending_tcp_packet.set_ack_number(tcp_packet.ack_number());
+            pending_tcp_packet.set_window_size(tcp_packet.window_size());
+            pending_tcp_packet.set_flags(pending_tcp_packet.flags() | tcp_packet.flags());
+            dbgln_if(TCP_DEBUG, "coalesce_tcp_segment: appended {} bytes, now {} bytes", payload_size, pending_payload_size + payload_size);
+            return;
+        }
+        flush_coalesced_tcp_segment();
+    }
+
+    memcpy(segment.buffer, &ipv4_packet, ipv4_packet.length());
+    segment.packet_timestamp = packet_timestamp;
+    segment.adapter = move(adapter);
+    segment.is_pending = true;
+}
+
+void flush_coalesced_tcp_segment()
+{
+    auto& segment = *coalesced_tcp_segment;
+    if (!segment.is_pending)
+        return;
+    segment.is_pending = false;
+    handle_tcp(segment.ipv4_packet(), segment.packet_timestamp, move(segment.adapter));
+}
+
 void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter)
 {
     if (ipv4_packet.payload_size() < sizeof(TCPPacket)) {
@@ -593,8 +701,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
     Optional<u8> send_window_scale;
+    bool sack_permitted = false;
     if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
+        tcp_packet.for_each_option([&send_window_scale, &sack_permitted](auto const& option) {
+            if (option.kind() == TCPOptionKind::SACKPermitted && option.length() == sizeof(TCPOptionSACKPermitted)) {
+                sack_permitted = true;
+                return;
+            }
             if (option.kind() != TCPOptionKind::WindowScale)
                 return;
             if (option.length() != sizeof(TCPOptionWindowScale))
@@ -637,6 +750,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->set_sack_permitted(sack_permitted);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
@@ -652,6 +766,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->set_sack_permitted(sack_permitted);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
@@ -659,6 +774,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->set_sack_permitted(sack_permitted);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -816,6 +932,11 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         }
 
         if (tcp_packet.sequence_number() != socket->ack_number()) {
+            if (payload_size && !tcp_packet.has_fin() && socket->queue_out_of_order_segment(ipv4_packet, tcp_packet, payload_size, packet_timestamp)) {
+                // RFC 5681, section 4.2: Out of order data is ACKed right away, so the sender finds out about the gap.
+                [[maybe_unused]] auto result = socket->send_ack(true);
+                return;
+            }
             dbgln_if(TCP_DEBUG, "Discarding out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
             if (socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
                 dbgln_if(TCP_DEBUG, "Sending ACK with same ack number to trigger fast retransmission");
@@ -843,7 +964,11 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(*socket);
+                // RFC 5681, section 4.2: Filling a gap is ACKed right away as well.
+                if (socket->deliver_out_of_order_segments())
+                    (void)socket->send_ack();
+                else
+                    send_delayed_tcp_ack(*socket);
             }
         }
     }
@@ -278,6 +278,13 @@ ErrorOr<size_t> Socket::write(OpenFileDescription& description, u64, UserOrKerne
     return sendto(description, data, size, 0, {}, 0);
 }
 
+ErrorOr<size_t> Socket::write_from(OpenFileDescription& description, TransferSource& source, size_t size)
+{
+    if (is_shut_down_for_writing())
+        return set_so_error(EPIPE);
+    return send_from(description, source, size);
+}
+
 ErrorOr<void> Socket::shutdown(int how)
 {
     MutexLocker locker(mutex());
@@ -74,7 +74,53 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    // Without timestamps, this many blocks fit into the 40 bytes of options.
+    static constexpr size_t maximum_blocks = 4;
+
+    explicit TCPOptionSACK(ReadonlySpan<TCPSACKBlock> blocks)
+        : TCPOption(TCPOptionKind::SACK, sizeof(TCPOption) + min(blocks.size(), maximum_blocks) * sizeof(TCPSACKBlock))
+    {
+        for (size_t i = 0; i < block_count(); ++i)
+            m_blocks[i] = blocks[i];
+    }
+
+    // NOTE: When parsing, only the first block_count() blocks are actually part of the packet.
+    size_t block_count() const { return (length() - sizeof(TCPOption)) / sizeof(TCPSACKBlock); }
+    TCPSACKBlock const& block(size_t index) const { return m_blocks[index]; }
+
+private:
+    TCPSACKBlock m_blocks[maximum_blocks];
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+static_assert(AssertSize<TCPOptionSACK, 34>());
+
+// Sequence numbers wrap around, so they can only be compared with ones that are less than 2^31 away (RFC 9293, section 3.4).
+constexpr bool tcp_sequence_number_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+constexpr bool tcp_sequence_number_after(u32 a, u32 b)
+{
+    return tcp_sequence_number_before(b, a);
+}
 
 class [[gnu::packed]] TCPPacket {
 public:
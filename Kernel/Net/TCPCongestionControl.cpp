@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+StringView TCPCongestionControl::name(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return "reno"sv;
+    case Algorithm::Cubic:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::Cubic;
+    return {};
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+{
+    m_congestion_window = initial_window();
+}
+
+u32 TCPCongestionControl::initial_window() const
+{
+    // RFC 5681, section 3.1
+    return min(4 * m_maximum_segment_size, max(2 * m_maximum_segment_size, 4380u));
+}
+
+void TCPCongestionControl::set_maximum_segment_size(u32 maximum_segment_size)
+{
+    if (maximum_segment_size == m_maximum_segment_size)
+        return;
+    m_maximum_segment_size = maximum_segment_size;
+    if (!m_window_was_adjusted)
+        m_congestion_window = initial_window();
+}
+
+void TCPCongestionControl::set_windows(u32 congestion_window, u32 slow_start_threshold)
+{
+    m_congestion_window = congestion_window;
+    m_slow_start_threshold = slow_start_threshold;
+    m_window_was_adjusted = true;
+}
+
+void TCPCongestionControl::on_ack(u32 acknowledged_bytes, Duration smoothed_rtt)
+{
+    m_window_was_adjusted = true;
+    if (is_in_slow_start()) {
+        // RFC 5681, section 3.1: "During slow start, a TCP increments cwnd by at most SMSS bytes for each ACK received
+        // that cumulatively acknowledges new data."
+        m_congestion_window = min(m_congestion_window + min(acknowledged_bytes, m_maximum_segment_size), maximum_congestion_window);
+        return;
+    }
+    grow_in_congestion_avoidance(acknowledged_bytes, smoothed_rtt);
+    m_congestion_window = min(m_congestion_window, maximum_congestion_window);
+}
+
+void TCPCongestionControl::on_loss(u32 bytes_in_flight)
+{
+    m_window_was_adjusted = true;
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight);
+    m_congestion_window = m_slow_start_threshold;
+}
+
+void TCPCongestionControl::on_recovery_exit(u32 bytes_in_flight)
+{
+    // RFC 6582, section 3.2, step 3: Deflate the window, but don't let that cause a burst of packets.
+    m_congestion_window = min(m_slow_start_threshold, max(bytes_in_flight, m_maximum_segment_size) + m_maximum_segment_size);
+}
+
+void TCPCongestionControl::on_retransmit_timeout(u32 bytes_in_flight)
+{
+    // RFC 5681, section 3.1: After a timeout, we start over from a single segment.
+    m_window_was_adjusted = true;
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight);
+    m_congestion_window = m_maximum_segment_size;
+}
+
+void TCPNewReno::grow_in_congestion_avoidance(u32 acknowledged_bytes, Duration)
+{
+    // RFC 5681, section 3.1: Add a segment for every window's worth of acknowledged data, which works out to one per
+    // round trip no matter how many ACKs the receiver sends.
+    m_bytes_acknowledged += acknowledged_bytes;
+    if (m_bytes_acknowledged >= m_congestion_window) {
+        m_bytes_acknowledged -= m_congestion_window;
+        m_congestion_window += m_maximum_segment_size;
+    }
+}
+
+u32 TCPNewReno::slow_start_threshold_after_loss(u32 bytes_in_flight)
+{
+    // RFC 5681, equation (4)
+    m_bytes_acknowledged = 0;
+    return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+// RFC 9438 uses C = 0.4 with windows in segments and time in seconds. We count time in milliseconds, so one segment
+// per second cubed is this many milliseconds cubed.
+static constexpr u64 cubic_scale = 2'500'000'000;
+// Keeps the cubed time from overflowing. At 30 seconds from the origin point, the window is already 10000 segments away.
+static constexpr u64 cubic_maximum_offset_ms = 30'000;
+
+static u64 integer_cube_root(u64 value)
+{
+    u64 low = 0;
+    u64 high = 2'642'245; // The cube root of 2^64, rounded down.
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+void TCPCubic::grow_in_congestion_avoidance(u32 acknowledged_bytes, Duration smoothed_rtt)
+{
+    auto now = TimeManagement::the().monotonic_time();
+    if (!m_epoch_start.has_value()) {
+        // RFC 9438, section 4.2: A new epoch starts with the first ACK in congestion avoidance after a loss.
+        m_epoch_start = now;
+        m_reno_window_estimate = m_congestion_window;
+        if (m_congestion_window < m_window_max) {
+            m_origin_point = m_window_max;
+            u64 segments_to_origin_point = static_cast<u64>(m_window_max - m_congestion_window) * cubic_scale / m_maximum_segment_size;
+            m_time_to_origin_point_ms = integer_cube_root(segments_to_origin_point);
+        } else {
+            m_origin_point = m_congestion_window;
+            m_time_to_origin_point_ms = 0;
+        }
+    }
+
+    // Aim for where the window should be a round trip from now, which is when this ACK's effect will be seen.
+    u64 elapsed_ms = (now - *m_epoch_start + smoothed_rtt).to_milliseconds();
+    u64 offset_ms = min(elapsed_ms > m_time_to_origin_point_ms ? elapsed_ms - m_time_to_origin_point_ms : m_time_to_origin_point_ms - elapsed_ms, cubic_maximum_offset_ms);
+    u64 delta = offset_ms * offset_ms * offset_ms * m_maximum_segment_size / cubic_scale;
+    u64 target;
+    if (elapsed_ms < m_time_to_origin_point_ms)
+        target = m_origin_point > delta ? m_origin_point - delta : 0;
+    else
+        target = m_origin_point + delta;
+    target = clamp(target, static_cast<u64>(m_congestion_window), static_cast<u64>(m_congestion_window) * 3 / 2);
+
+    // RFC 9438, section 4.3: Grow at least as fast as NewReno would, with alpha = 3 * (1 - beta) / (1 + beta).
+    m_reno_window_estimate += static_cast<u64>(acknowledged_bytes) * m_maximum_segment_size * 9 / (17 * static_cast<u64>(m_congestion_window));
+    if (m_reno_window_estimate > target) {
+        m_congestion_window = min(m_reno_window_estimate, static_cast<u64>(maximum_congestion_window));
+        return;
+    }
+
+    // RFC 9438, section 4.4: Close (target - cwnd) / cwnd of the gap per segment acknowledged.
+    m_congestion_window += (target - m_congestion_window) * acknowledged_bytes / m_congestion_window;
+}
+
+u32 TCPCubic::slow_start_threshold_after_loss(u32)
+{
+    m_epoch_start.clear();
+    // RFC 9438, section 4.7: If we didn't even get back to the last maximum, something else is taking up more of the
+    // bandwidth now, so we back off further to leave it room.
+    if (m_congestion_window < m_window_max)
+        m_window_max = static_cast<u64>(m_congestion_window) * 17 / 20;
+    else
+        m_window_max = m_congestion_window;
+    // RFC 9438, section 4.6: Multiplicative decrease with beta = 0.7.
+    return max(static_cast<u64>(m_congestion_window) * 7 / 10, 2 * static_cast<u64>(m_maximum_segment_size));
+}
+
+}
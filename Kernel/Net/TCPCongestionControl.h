@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The part of RFC 5681 congestion control that differs between algorithms: how the congestion window grows while data
+// is being acknowledged, and how far the slow start threshold drops when we find out the network is congested.
+// Detecting and recovering from loss works the same way for all of them, so that lives in TCPSocket.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        NewReno,
+        Cubic,
+    };
+
+    static constexpr Algorithm default_algorithm = Algorithm::Cubic;
+
+    // These are the names Linux uses for TCP_CONGESTION.
+    static StringView name(Algorithm);
+    static Optional<Algorithm> algorithm_from_name(StringView);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual Algorithm algorithm() const = 0;
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 maximum_segment_size() const { return m_maximum_segment_size; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+
+    // We only find out the real MSS once we know where the packets are going.
+    void set_maximum_segment_size(u32);
+    // Lets a newly chosen algorithm carry on where the previous one left off.
+    void set_windows(u32 congestion_window, u32 slow_start_threshold);
+
+    // New data was acknowledged while we're not recovering from a loss.
+    void on_ack(u32 acknowledged_bytes, Duration smoothed_rtt);
+    // Duplicate ACKs or SACK blocks say a segment was lost. The congestion window stays at the new slow start threshold
+    // for the rest of the recovery.
+    void on_loss(u32 bytes_in_flight);
+    void on_recovery_exit(u32 bytes_in_flight);
+    void on_retransmit_timeout(u32 bytes_in_flight);
+
+protected:
+    explicit TCPCongestionControl(u32 maximum_segment_size);
+
+    virtual void grow_in_congestion_avoidance(u32 acknowledged_bytes, Duration smoothed_rtt) = 0;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) = 0;
+
+    static constexpr u32 maximum_congestion_window = 1 * GiB;
+
+    u32 m_maximum_segment_size { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+
+private:
+    u32 initial_window() const;
+
+    bool m_window_was_adjusted { false };
+};
+
+// RFC 5681 and RFC 6582: Grow the window by a segment per round trip, and halve it on loss.
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    explicit TCPNewReno(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+private:
+    virtual void grow_in_congestion_avoidance(u32 acknowledged_bytes, Duration smoothed_rtt) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) override;
+
+    u32 m_bytes_acknowledged { 0 };
+};
+
+// RFC 9438: Grow the window along a cubic function of the time since the last loss, which quickly gets back to where
+// things went wrong and then carefully probes past it. That doesn't depend on the round trip time, so long fat
+// pipes get filled much faster than with NewReno.
+class TCPCubic final : public TCPCongestionControl {
+public:
+    explicit TCPCubic(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::Cubic; }
+
+private:
+    virtual void grow_in_congestion_avoidance(u32 acknowledged_bytes, Duration smoothed_rtt) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) override;
+
+    Optional<MonotonicTime> m_epoch_start;
+    // Where the window was when we last saw a loss, and where the cubic function is centered.
+    u32 m_window_max { 0 };
+    u32 m_origin_point { 0 };
+    u64 m_time_to_origin_point_ms { 0 };
+    // What NewReno would have grown the window to since the epoch started. CUBIC is never slower than that.
+    u64 m_reno_window_estimate { 0 };
+};
+
+}
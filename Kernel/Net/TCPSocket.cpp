@@ -161,6 +161,7 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const
         client->set_bound();
         client->set_direction(Direction::Incoming);
         client->set_originator(*this);
+        client->set_congestion_control_algorithm(congestion_control().algorithm());
 
         m_pending_release_for_accept.set(tuple, client);
         client->m_registered_socket_tuple = tuple;
@@ -187,8 +188,9 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
 
 TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+    , m_congestion_control(create_congestion_control(TCPCongestionControl::default_algorithm, default_maximum_segment_size))
+    , m_retransmit_deadline(TimeManagement::the().monotonic_time())
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
-    , m_last_retransmit_time(TimeManagement::the().monotonic_time())
     , m_timer(timer)
 {
 }
@@ -208,6 +210,38 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwn
     return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
 }
 
+TCPSocket::CongestionControl TCPSocket::create_congestion_control(TCPCongestionControl::Algorithm algorithm, u32 maximum_segment_size)
+{
+    switch (algorithm) {
+    case TCPCongestionControl::Algorithm::NewReno:
+        return TCPNewReno { maximum_segment_size };
+    case TCPCongestionControl::Algorithm::Cubic:
+        return TCPCubic { maximum_segment_size };
+    }
+    VERIFY_NOT_REACHED();
+}
+
+TCPCongestionControl& TCPSocket::congestion_control()
+{
+    return m_congestion_control.visit([](auto& congestion_control) -> TCPCongestionControl& { return congestion_control; });
+}
+
+TCPCongestionControl const& TCPSocket::congestion_control() const
+{
+    return m_congestion_control.visit([](auto const& congestion_control) -> TCPCongestionControl const& { return congestion_control; });
+}
+
+void TCPSocket::set_congestion_control_algorithm(TCPCongestionControl::Algorithm algorithm)
+{
+    auto& previous = congestion_control();
+    if (previous.algorithm() == algorithm)
+        return;
+    auto congestion_window = previous.congestion_window();
+    auto slow_start_threshold = previous.slow_start_threshold();
+    m_congestion_control = create_congestion_control(algorithm, previous.maximum_segment_size());
+    congestion_control().set_windows(congestion_window, slow_start_threshold);
+}
+
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
 {
     auto& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(raw_ipv4_packet.data());
@@ -226,13 +260,44 @@ ErrorOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, UserO
     return payload_size;
 }
 
+namespace {
+
+// Lets write() hand its buffer to the same packet-building code that sendfile() pulls file data into.
+class BufferTransferSource final : public TransferSource {
+public:
+    explicit BufferTransferSource(UserOrKernelBuffer const& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    virtual ErrorOr<size_t> read_into(Bytes destination) override
+    {
+        TRY(m_buffer.offset(m_offset).read(destination.data(), destination.size()));
+        m_offset += destination.size();
+        return destination.size();
+    }
+
+private:
+    UserOrKernelBuffer const& m_buffer;
+    size_t m_offset { 0 };
+};
+
+}
+
 ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t data_length)
+{
+    BufferTransferSource source { data };
+    return protocol_send_from(source, data_length);
+}
+
+ErrorOr<size_t> TCPSocket::protocol_send_from(TransferSource& source, size_t data_length)
 {
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    congestion_control().set_maximum_segment_size(mss);
 
     if (!m_no_delay) {
         // RFC 896 (Nagle’s algorithm): https://www.ietf.org/rfc/rfc0896
@@ -246,19 +311,24 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
             return set_so_error(EAGAIN);
     }
 
-    data_length = min(data_length, mss);
-    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
-    return data_length;
+    // RFC 5681: Never have more in flight than both the network and the peer can take.
+    auto budget = send_budget();
+    if (budget == 0)
+        return set_so_error(EAGAIN);
+
+    data_length = min(data_length, min(mss, budget));
+    return send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &source, data_length, &routing_decision);
 }
 
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
 {
     if (!allow_duplicate && m_last_ack_number_sent == m_ack_number)
         return {};
-    return send_tcp_packet(TCPFlags::ACK);
+    TRY(send_tcp_packet(TCPFlags::ACK));
+    return {};
 }
 
-ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* payload, size_t payload_size, RoutingDecision* user_routing_decision)
+ErrorOr<size_t> TCPSocket::send_tcp_packet(u16 flags, TransferSource* payload, size_t payload_size, RoutingDecision* user_routing_decision)
 {
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     RoutingDecision routing_decision = user_routing_decision ? *user_routing_decision : route_to(peer_address(), local_address(), adapter);
@@ -269,12 +339,38 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     bool const has_mss_option = flags & TCPFlags::SYN;
     bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    // We always offer SACK, but can only agree to it if the peer offered it first (RFC 2018, section 2).
+    bool const has_sack_permitted_option = (flags & TCPFlags::SYN) && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    Vector<TCPSACKBlock, TCPOptionSACK::maximum_blocks> sack_blocks;
+    if ((flags & TCPFlags::ACK) && !(flags & TCPFlags::SYN) && m_sack_permitted)
+        collect_sack_blocks(sack_blocks);
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0)
+        + (sack_blocks.is_empty() ? 0 : sizeof(TCPOption) + sack_blocks.size() * sizeof(TCPSACKBlock));
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
-    size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
+    size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
     if (!packet)
         return set_so_error(ENOMEM);
+
+    if (payload && payload_size > 0) {
+        // The payload goes straight into the packet. Sources reading from a file can come up short, so the packet is
+        // sized by what we actually got.
+        auto nread_or_error = payload->read_into({ packet->buffer->data() + ipv4_payload_offset + tcp_header_size, payload_size });
+        if (nread_or_error.is_error()) {
+            routing_decision.adapter->release_packet_buffer(*packet);
+            return set_so_error(nread_or_error.release_error());
+        }
+        if (nread_or_error.value() == 0) {
+            routing_decision.adapter->release_packet_buffer(*packet);
+            return 0;
+        }
+        payload_size = nread_or_error.value();
+        buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
+        packet->buffer->set_size(buffer_size);
+    }
+
     routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(),
         routing_decision.next_hop, peer_address(), TransportProtocol::TCP,
         buffer_size - ipv4_payload_offset, type_of_service(), ttl());
@@ -287,17 +383,11 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if ((flags & TCPFlags::SYN) == 0 && m_window_scaling_supported)
         window_size >>= receive_window_scale();
     tcp_packet.set_window_size(min(window_size, NumericLimits<u16>::max()));
-    tcp_packet.set_sequence_number(m_sequence_number);
+    u32 sequence_number = m_sequence_number;
+    tcp_packet.set_sequence_number(sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
 
-    if (payload) {
-        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error()) {
-            routing_decision.adapter->release_packet_buffer(*packet);
-            return set_so_error(result.release_error());
-        }
-    }
-
     if (flags & TCPFlags::ACK) {
         m_last_ack_number_sent = m_ack_number;
         m_last_ack_sent_time = TimeManagement::the().monotonic_time();
@@ -322,6 +412,16 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
+    if (!sack_blocks.is_empty()) {
+        TCPOptionSACK sack_option { sack_blocks.span() };
+        memcpy(next_option, &sack_option, sack_option.length());
+        next_option += sack_option.length();
+    }
     if ((options_size % 4) != 0)
         *next_option = to_underlying(TCPOptionKind::End);
 
@@ -331,7 +431,19 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            auto now = TimeManagement::the().monotonic_time();
+            // RFC 6298, section 5.1: The timer starts with the first packet that's waiting for an ACK.
+            if (unacked_packets.packets.is_empty())
+                m_retransmit_deadline = now + m_retransmission_timeout;
+            auto result = unacked_packets.packets.try_append({
+                .sequence_number = sequence_number,
+                .ack_number = m_sequence_number,
+                .payload_size = static_cast<u32>(payload_size),
+                .buffer = packet,
+                .ipv4_payload_offset = ipv4_payload_offset,
+                .adapter = *routing_decision.adapter,
+                .last_sent_time = now,
+            });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -350,52 +462,346 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if (!expect_ack)
         routing_decision.adapter->release_packet_buffer(*packet);
 
-    return {};
+    return payload_size;
 }
 
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    m_packets_in++;
+    m_bytes_in += packet.header_size() + size;
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+    if (!packet.has_ack())
+        return;
 
-        int removed = 0;
-        m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            while (!unacked_packets.packets.is_empty()) {
-                auto& packet = unacked_packets.packets.first();
+    u32 ack_number = packet.ack_number();
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
-                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+    // The window in a SYN is never scaled (RFC 7323, section 2.2).
+    u32 send_window_size = packet.has_syn() ? packet.window_size() : packet.window_size() << m_send_window_scale;
+    bool window_changed = send_window_size != m_send_window_size;
+    m_send_window_size = send_window_size;
 
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
-                    }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
-                } else {
+    size_t payload_size = size - packet.header_size();
+    bool should_retransmit = false;
+    bool should_retransmit_first_regardless_of_window = false;
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (m_sack_permitted)
+            mark_sacked_packets(packet, unacked_packets);
+
+        u32 send_unacknowledged = unacked_packets.packets.is_empty() ? m_sequence_number : unacked_packets.packets.first().sequence_number;
+        if (tcp_sequence_number_after(ack_number, send_unacknowledged)) {
+            auto now = TimeManagement::the().monotonic_time();
+            u32 acknowledged_bytes = 0;
+            Optional<Duration> rtt_sample;
+            int removed = 0;
+            while (!unacked_packets.packets.is_empty()) {
+                auto& outgoing_packet = unacked_packets.packets.first();
+                if (tcp_sequence_number_after(outgoing_packet.ack_number, ack_number))
                     break;
+                // Karn's algorithm: We can't tell which transmission an ACK for a retransmitted packet is for.
+                if (outgoing_packet.tx_counter == 0)
+                    rtt_sample = now - outgoing_packet.last_sent_time;
+                if (auto old_adapter = outgoing_packet.adapter.strong_ref())
+                    old_adapter->release_packet_buffer(*outgoing_packet.buffer);
+                unacked_packets.size -= outgoing_packet.payload_size;
+                acknowledged_bytes += outgoing_packet.payload_size;
+                unacked_packets.packets.take_first();
+                removed++;
+            }
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+
+            if (rtt_sample.has_value())
+                update_rtt(*rtt_sample);
+            m_duplicate_acks_received = 0;
+            m_retransmit_attempts = 0;
+
+            if (m_in_loss_recovery) {
+                if (!tcp_sequence_number_before(ack_number, m_recovery_point)) {
+                    m_in_loss_recovery = false;
+                    congestion_control().on_recovery_exit(bytes_in_flight(unacked_packets));
+                } else if (!unacked_packets.packets.is_empty()) {
+                    // RFC 6582, section 3.2, step 3: A partial ACK means the next packet was lost as well. With SACK,
+                    // we know better than to send it again if we already have.
+                    auto& first_packet = unacked_packets.packets.first();
+                    if (!m_sack_permitted || (!first_packet.is_sacked && !first_packet.was_retransmitted_in_recovery)) {
+                        first_packet.is_lost = true;
+                        should_retransmit_first_regardless_of_window = true;
+                    }
+                    mark_lost_packets(unacked_packets);
                 }
+            } else if (acknowledged_bytes > 0) {
+                congestion_control().on_ack(acknowledged_bytes, m_smoothed_rtt);
             }
 
             if (unacked_packets.packets.is_empty()) {
-                m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
+            } else {
+                // RFC 6298, section 5.3
+                m_retransmit_deadline = now + m_retransmission_timeout;
+            }
+            // Packets can still be waiting to go out again after a timeout.
+            should_retransmit = true;
+        } else if (ack_number == send_unacknowledged && payload_size == 0 && !window_changed && !packet.has_syn() && !packet.has_fin() && !unacked_packets.packets.is_empty()) {
+            // RFC 5681, section 2: A duplicate ACK means the peer got something that came after a missing packet.
+            ++m_duplicate_acks_received;
+            if (m_in_loss_recovery) {
+                mark_lost_packets(unacked_packets);
+                should_retransmit = true;
+                return;
             }
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
-        });
+            size_t sacked_packets = 0;
+            for (auto& outgoing_packet : unacked_packets.packets)
+                sacked_packets += outgoing_packet.is_sacked;
+            if (m_duplicate_acks_received < duplicate_ack_threshold && sacked_packets < duplicate_ack_threshold)
+                return;
+
+            // RFC 5681, section 3.2 and RFC 6675, section 5: Fast retransmit, then stay in recovery until everything
+            // we've sent so far has been acknowledged.
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering loss recovery at {}", this, send_unacknowledged);
+            m_in_loss_recovery = true;
+            m_recovery_point = m_sequence_number;
+            congestion_control().on_loss(bytes_in_flight(unacked_packets));
+            for (auto& outgoing_packet : unacked_packets.packets)
+                outgoing_packet.was_retransmitted_in_recovery = false;
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (!outgoing_packet.is_sacked) {
+                    outgoing_packet.is_lost = true;
+                    break;
+                }
+            }
+            mark_lost_packets(unacked_packets);
+            should_retransmit = true;
+            should_retransmit_first_regardless_of_window = true;
+        }
+    });
+
+    if (should_retransmit)
+        retransmit_lost_packets(should_retransmit_first_regardless_of_window);
+    evaluate_block_conditions();
+}
+
+u32 TCPSocket::bytes_in_flight(UnackedPackets const& unacked_packets) const
+{
+    // RFC 6675, section 4: What has been SACKed or is considered lost isn't in the network anymore.
+    u32 bytes = 0;
+    for (auto& outgoing_packet : unacked_packets.packets) {
+        if (!outgoing_packet.is_sacked && !outgoing_packet.is_lost)
+            bytes += outgoing_packet.payload_size;
     }
+    // Without SACK, all we know is that every duplicate ACK stands for a packet that has left the network.
+    if (m_in_loss_recovery && !m_sack_permitted)
+        bytes -= min(bytes, m_duplicate_acks_received * congestion_control().maximum_segment_size());
+    return bytes;
+}
 
-    m_packets_in++;
-    m_bytes_in += packet.header_size() + size;
+size_t TCPSocket::send_budget() const
+{
+    return m_unacked_packets.with_shared([&](auto const& unacked_packets) -> size_t {
+        // Sending into a closed window is how we find out that it has opened up again, since nothing else tells us.
+        if (unacked_packets.size == 0)
+            return max(m_send_window_size, congestion_control().maximum_segment_size());
+        if (unacked_packets.size >= m_send_window_size)
+            return 0;
+        // Retransmissions go first.
+        for (auto& outgoing_packet : unacked_packets.packets) {
+            if (outgoing_packet.is_lost)
+                return 0;
+        }
+        auto in_flight = bytes_in_flight(unacked_packets);
+        auto congestion_window = congestion_control().congestion_window();
+        if (in_flight >= congestion_window)
+            return 0;
+        return min<size_t>(m_send_window_size - unacked_packets.size, congestion_window - in_flight);
+    });
+}
+
+void TCPSocket::update_rtt(Duration sample)
+{
+    // RFC 6298, section 2
+    if (!m_has_rtt_sample) {
+        m_has_rtt_sample = true;
+        m_smoothed_rtt = sample;
+        m_rtt_variance = Duration::from_nanoseconds(sample.to_nanoseconds() / 2);
+    } else {
+        auto difference = m_smoothed_rtt > sample ? m_smoothed_rtt - sample : sample - m_smoothed_rtt;
+        m_rtt_variance = Duration::from_nanoseconds((3 * m_rtt_variance.to_nanoseconds() + difference.to_nanoseconds()) / 4);
+        m_smoothed_rtt = Duration::from_nanoseconds((7 * m_smoothed_rtt.to_nanoseconds() + sample.to_nanoseconds()) / 8);
+    }
+    auto retransmission_timeout = m_smoothed_rtt + Duration::from_nanoseconds(4 * m_rtt_variance.to_nanoseconds());
+    m_retransmission_timeout = clamp(retransmission_timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+}
+
+void TCPSocket::mark_sacked_packets(TCPPacket const& packet, UnackedPackets& unacked_packets)
+{
+    packet.for_each_option([&](auto const& option) {
+        if (option.kind() != TCPOptionKind::SACK || option.length() < sizeof(TCPOption) + sizeof(TCPSACKBlock))
+            return;
+        auto const& sack_option = static_cast<TCPOptionSACK const&>(option);
+        for (size_t i = 0; i < sack_option.block_count(); ++i) {
+            auto const& block = sack_option.block(i);
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.payload_size == 0)
+                    continue;
+                if (tcp_sequence_number_before(outgoing_packet.sequence_number, block.left_edge) || tcp_sequence_number_after(outgoing_packet.ack_number, block.right_edge))
+                    continue;
+                outgoing_packet.is_sacked = true;
+                outgoing_packet.is_lost = false;
+            }
+        }
+    });
+}
+
+void TCPSocket::mark_lost_packets(UnackedPackets& unacked_packets)
+{
+    if (!m_sack_permitted)
+        return;
+    // RFC 6675, section 4: A packet is lost once enough of the ones after it have made it. We only send every packet
+    // once more per recovery, after that it's up to the retransmission timer.
+    size_t sacked_packets_after = 0;
+    Vector<OutgoingPacket*, 64> packets;
+    for (auto& outgoing_packet : unacked_packets.packets) {
+        if (packets.try_append(&outgoing_packet).is_error())
+            return;
+    }
+    for (size_t i = packets.size(); i > 0; --i) {
+        auto& outgoing_packet = *packets[i - 1];
+        if (outgoing_packet.is_sacked) {
+            ++sacked_packets_after;
+            continue;
+        }
+        if (sacked_packets_after >= duplicate_ack_threshold && !outgoing_packet.was_retransmitted_in_recovery)
+            outgoing_packet.is_lost = true;
+    }
+}
+
+void TCPSocket::retransmit_lost_packets(bool retransmit_first_regardless_of_window)
+{
+    bool has_lost_packets = m_unacked_packets.with_shared([](auto const& unacked_packets) {
+        for (auto& outgoing_packet : unacked_packets.packets) {
+            if (outgoing_packet.is_lost)
+                return true;
+        }
+        return false;
+    });
+    if (!has_lost_packets)
+        return;
+
+    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+    auto routing_decision = route_to(peer_address(), local_address(), adapter);
+    if (routing_decision.is_zero())
+        return;
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        auto in_flight = bytes_in_flight(unacked_packets);
+        for (auto& outgoing_packet : unacked_packets.packets) {
+            if (!outgoing_packet.is_lost)
+                continue;
+            // RFC 6675, section 5: Only as much as the congestion window allows, except for the fast retransmit itself.
+            if (in_flight >= congestion_control().congestion_window() && !retransmit_first_regardless_of_window)
+                break;
+            retransmit_first_regardless_of_window = false;
+            outgoing_packet.is_lost = false;
+            if (m_in_loss_recovery)
+                outgoing_packet.was_retransmitted_in_recovery = true;
+            in_flight += outgoing_packet.payload_size;
+            retransmit_packet(outgoing_packet, routing_decision);
+        }
+    });
+}
+
+bool TCPSocket::queue_out_of_order_segment(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, size_t payload_size, UnixDateTime const& packet_timestamp)
+{
+    VERIFY(mutex().is_locked());
+    u32 sequence_number = tcp_packet.sequence_number();
+    if (!tcp_sequence_number_after(sequence_number, m_ack_number))
+        return false;
+    // It has to fit into the receive buffer once the gap before it has been filled.
+    if (sequence_number - m_ack_number + payload_size > available_space_in_receive_buffer())
+        return false;
+
+    size_t index = 0;
+    for (; index < m_out_of_order_segments.size(); ++index) {
+        auto& segment = m_out_of_order_segments[index];
+        if (segment.sequence_number == sequence_number)
+            return true;
+        if (tcp_sequence_number_after(segment.sequence_number, sequence_number))
+            break;
+    }
+    if (m_out_of_order_segments.size() >= maximum_out_of_order_segments)
+        return false;
+
+    auto packet_or_error = KBuffer::try_create_with_bytes("TCPSocket: Out of order segment"sv, { &ipv4_packet, ipv4_packet.length() });
+    if (packet_or_error.is_error())
+        return false;
+    if (m_out_of_order_segments.try_insert(index, { sequence_number, static_cast<u32>(payload_size), packet_or_error.release_value(), packet_timestamp }).is_error())
+        return false;
+    m_last_out_of_order_sequence_number = sequence_number;
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) queued out of order segment {} while waiting for {}", this, sequence_number, m_ack_number);
+    return true;
+}
+
+bool TCPSocket::deliver_out_of_order_segments()
+{
+    VERIFY(mutex().is_locked());
+    if (m_out_of_order_segments.is_empty())
+        return false;
+
+    while (!m_out_of_order_segments.is_empty()) {
+        auto& segment = m_out_of_order_segments.first();
+        if (tcp_sequence_number_after(segment.sequence_number, m_ack_number))
+            break;
+        auto taken_segment = m_out_of_order_segments.take_first();
+        // The peer resends packets the way it first sent them, so anything but an exact fit is a duplicate.
+        if (taken_segment.sequence_number != m_ack_number)
+            continue;
+        if (!did_receive(peer_address(), peer_port(), taken_segment.ipv4_packet->bytes(), taken_segment.packet_timestamp)) {
+            m_out_of_order_segments.clear();
+            break;
+        }
+        m_ack_number += taken_segment.payload_size;
+    }
+    return true;
+}
+
+void TCPSocket::collect_sack_blocks(Vector<TCPSACKBlock, TCPOptionSACK::maximum_blocks>& blocks) const
+{
+    // RFC 2018, section 4: The first block has to be the one with the most recently received segment in it, and the
+    // rest should be the ones that were reported most recently. We just fill up with the blocks closest to the gap.
+    Optional<TCPSACKBlock> newest_block;
+    Vector<TCPSACKBlock, TCPOptionSACK::maximum_blocks> other_blocks;
+    Optional<TCPSACKBlock> current_block;
+    bool current_block_is_newest = false;
+    auto finish_current_block = [&] {
+        if (!current_block.has_value())
+            return;
+        if (current_block_is_newest)
+            newest_block = current_block;
+        else if (other_blocks.size() < TCPOptionSACK::maximum_blocks - 1)
+            other_blocks.unchecked_append(*current_block);
+    };
+    for (auto& segment : m_out_of_order_segments) {
+        u32 segment_end = segment.sequence_number + segment.payload_size;
+        if (current_block.has_value() && !tcp_sequence_number_after(segment.sequence_number, current_block->right_edge)) {
+            if (tcp_sequence_number_after(segment_end, current_block->right_edge))
+                current_block->right_edge = segment_end;
+        } else {
+            finish_current_block();
+            current_block = TCPSACKBlock { segment.sequence_number, segment_end };
+            current_block_is_newest = false;
+        }
+        if (segment.sequence_number == m_last_out_of_order_sequence_number)
+            current_block_is_newest = true;
+    }
+    finish_current_block();
+
+    if (newest_block.has_value())
+        blocks.unchecked_append(*newest_block);
+    for (auto& block : other_blocks) {
+        if (blocks.size() == TCPOptionSACK::maximum_blocks)
+            break;
+        blocks.unchecked_append(block);
+    }
 }
 
 bool TCPSocket::should_delay_next_ack() const
@@ -480,6 +886,15 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
             return EINVAL;
         m_no_delay = value;
         return {};
+    case TCP_CONGESTION: {
+        auto user_string = static_ptr_cast<char const*>(user_value);
+        auto name = TRY(Process::get_syscall_name_string_fixed_buffer<TCP_CA_NAME_MAX>(user_string, min<size_t>(user_value_size, TCP_CA_NAME_MAX)));
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name.representable_view());
+        if (!algorithm.has_value())
+            return ENOENT;
+        set_congestion_control_algorithm(*algorithm);
+        return {};
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -505,6 +920,16 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
         size = sizeof(nodelay);
         return copy_to_user(value_size, &size);
     }
+    case TCP_CONGESTION: {
+        auto name = TCPCongestionControl::name(congestion_control().algorithm());
+        if (size <= name.length())
+            return EINVAL;
+        char buffer[TCP_CA_NAME_MAX] {};
+        name.bytes().copy_to({ buffer, sizeof(buffer) - 1 });
+        TRY(copy_to_user(static_ptr_cast<char*>(value), buffer, name.length() + 1));
+        size = name.length() + 1;
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -702,19 +1127,13 @@ void TCPSocket::dequeue_for_retransmit()
 void TCPSocket::retransmit_packets()
 {
     auto now = TimeManagement::the().monotonic_time();
-
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
-
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (now < m_retransmit_deadline)
+        return;
+    if (m_unacked_packets.with_shared([](auto const& unacked_packets) { return unacked_packets.packets.is_empty(); }))
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
     ++m_retransmit_attempts;
 
     if (m_retransmit_attempts > maximum_retransmits) {
@@ -724,47 +1143,61 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
-    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
-    auto routing_decision = route_to(peer_address(), local_address(), adapter);
-    if (routing_decision.is_zero())
-        return;
-
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+        // RFC 5681, section 3.1: Start over with a single packet, and send the rest again as the ACKs come in. The
+        // peer is allowed to forget what it SACKed, so that can't be trusted anymore either (RFC 2018, section 8).
+        congestion_control().on_retransmit_timeout(bytes_in_flight(unacked_packets));
+        m_in_loss_recovery = false;
+        m_duplicate_acks_received = 0;
+        for (auto& outgoing_packet : unacked_packets.packets) {
+            outgoing_packet.is_sacked = false;
+            outgoing_packet.is_lost = true;
+        }
+    });
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+    // RFC 6298, section 5.5 and 5.6: Back off, and give the retransmission as long as that to get through.
+    m_retransmission_timeout = min(m_retransmission_timeout + m_retransmission_timeout, maximum_retransmission_timeout);
+    m_retransmit_deadline = now + m_retransmission_timeout;
 
-            auto packet_buffer = packet.buffer->bytes();
+    retransmit_lost_packets(false);
+}
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
-        }
-    });
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+    packet.last_sent_time = TimeManagement::the().monotonic_time();
+    m_retransmitted_packets++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -775,11 +1208,7 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
-    return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
-    });
+    // This has to agree with protocol_send_from(), or writers would spin on EAGAIN.
+    return send_budget() > 0;
 }
 }
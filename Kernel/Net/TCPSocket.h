@@ -12,9 +12,12 @@
 #include <AK/IntegralMath.h>
 #include <AK/SinglyLinkedList.h>
 #include <AK/Time.h>
+#include <AK/Variant.h>
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IP/Socket.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -143,15 +146,31 @@ public:
         m_send_window_scale = scale;
     }
 
+    void set_sack_permitted(bool sack_permitted) { m_sack_permitted = sack_permitted; }
+    bool sack_permitted() const { return m_sack_permitted; }
+
+    TCPCongestionControl const& congestion_control() const;
+    void set_congestion_control_algorithm(TCPCongestionControl::Algorithm);
+
+    Duration smoothed_rtt() const { return m_smoothed_rtt; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
     u32 duplicate_acks() const { return m_duplicate_acks; }
 
     ErrorOr<void> send_ack(bool allow_duplicate = false);
-    ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
+    // Returns how much of the payload went out with the packet.
+    ErrorOr<size_t> send_tcp_packet(u16 flags, TransferSource* payload = nullptr, size_t payload_size = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
 
+    // Data that arrives past a gap is held on to, so that the peer only has to retransmit what's actually missing.
+    bool queue_out_of_order_segment(IPv4Packet const&, TCPPacket const&, size_t payload_size, UnixDateTime const& packet_timestamp);
+    // Returns whether any segments were waiting for the gap to be filled, in which case the peer should hear about it right away.
+    bool deliver_out_of_order_segments();
+
     bool should_delay_next_ack() const;
 
     static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
@@ -187,6 +206,7 @@ private:
 
     virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
+    virtual ErrorOr<size_t> protocol_send_from(TransferSource&, size_t) override;
     virtual ErrorOr<void> protocol_connect(OpenFileDescription&) override;
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes raw_ipv4_packet) override;
     virtual bool protocol_is_disconnected() const override;
@@ -220,11 +240,19 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
+        u32 payload_size { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        MonotonicTime last_sent_time;
+        // The peer told us it has this one (RFC 2018).
+        bool is_sacked { false };
+        // We think this one is gone, and it should go out again as soon as the congestion window allows.
+        bool is_lost { false };
+        bool was_retransmitted_in_recovery { false };
     };
 
     struct UnackedPackets {
@@ -234,6 +262,54 @@ private:
 
     MutexProtected<UnackedPackets> m_unacked_packets;
 
+    u32 bytes_in_flight(UnackedPackets const&) const;
+    size_t send_budget() const;
+    void update_rtt(Duration sample);
+    void mark_sacked_packets(TCPPacket const&, UnackedPackets&);
+    void mark_lost_packets(UnackedPackets&);
+    void retransmit_lost_packets(bool retransmit_first_regardless_of_window);
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+    void collect_sack_blocks(Vector<TCPSACKBlock, TCPOptionSACK::maximum_blocks>&) const;
+
+    using CongestionControl = Variant<TCPNewReno, TCPCubic>;
+    static CongestionControl create_congestion_control(TCPCongestionControl::Algorithm, u32 maximum_segment_size);
+    TCPCongestionControl& congestion_control();
+
+    // RFC 9293 says to assume this until we know better.
+    static constexpr u32 default_maximum_segment_size = 536;
+    CongestionControl m_congestion_control;
+
+    // RFC 5681, section 3.2
+    static constexpr u32 duplicate_ack_threshold = 3;
+    u32 m_duplicate_acks_received { 0 };
+    bool m_in_loss_recovery { false };
+    // Recovery is over once everything that was outstanding when it started has been acknowledged (RFC 6582).
+    u32 m_recovery_point { 0 };
+
+    bool m_sack_permitted { false };
+
+    // RFC 6298
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_seconds(1);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    bool m_has_rtt_sample { false };
+    Duration m_smoothed_rtt;
+    Duration m_rtt_variance;
+    Duration m_retransmission_timeout { minimum_retransmission_timeout };
+    MonotonicTime m_retransmit_deadline;
+    u32 m_retransmitted_packets { 0 };
+
+    struct OutOfOrderSegment {
+        u32 sequence_number { 0 };
+        u32 payload_size { 0 };
+        NonnullOwnPtr<KBuffer> ipv4_packet;
+        UnixDateTime packet_timestamp;
+    };
+    static constexpr size_t maximum_out_of_order_segments = 256;
+    // Sorted by sequence number.
+    Vector<OutOfOrderSegment> m_out_of_order_segments;
+    // RFC 2018 wants the block with the most recently received segment to come first.
+    u32 m_last_out_of_order_sequence_number { 0 };
+
     u32 m_duplicate_acks { 0 };
 
     u32 m_last_ack_number_sent { 0 };
@@ -243,7 +319,6 @@ private:
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
-    MonotonicTime m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
     // Default to maximum window size. receive_tcp_packet() will update from the
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static ErrorOr<EPoll*> epoll_for_description(OpenFileDescription& description)
+{
+    if (!description.file().is_epoll())
+        return EINVAL;
+    return static_cast<EPoll*>(&description.file());
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if ((flags & EPOLL_CLOEXEC) != flags)
+        return EINVAL;
+
+    auto epoll = TRY(EPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(epoll)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), (flags & EPOLL_CLOEXEC) ? FD_CLOEXEC : 0);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(int epfd, int op, int fd, Userspace<epoll_event const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto epoll_description = TRY(open_file_description(epfd));
+    auto* epoll = TRY(epoll_for_description(*epoll_description));
+    auto description = TRY(open_file_description(fd));
+
+    switch (op) {
+    case EPOLL_CTL_ADD: {
+        auto event = TRY(copy_typed_from_user(user_event));
+        TRY(epoll->add_watch(fd, *description, event));
+        return 0;
+    }
+    case EPOLL_CTL_MOD: {
+        auto event = TRY(copy_typed_from_user(user_event));
+        TRY(epoll->modify_watch(fd, *description, event));
+        return 0;
+    }
+    case EPOLL_CTL_DEL:
+        TRY(epoll->remove_watch(fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(int epfd, Userspace<epoll_event*> user_events, int max_events, int timeout_ms)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (max_events <= 0)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(epfd));
+    auto* epoll = TRY(epoll_for_description(*description));
+
+    // Every watch is for an fd, so there's never a reason to collect more events than that at once.
+    Vector<epoll_event> events;
+    TRY(events.try_resize(min(static_cast<size_t>(max_events), OpenFileDescriptions::max_open())));
+
+    Thread::BlockTimeout timeout;
+    if (timeout_ms >= 0) {
+        auto relative_timeout = Duration::from_milliseconds(timeout_ms);
+        timeout = Thread::BlockTimeout(false, &relative_timeout);
+    }
+
+    for (;;) {
+        auto event_count = epoll->collect_ready_events(events.span());
+        if (event_count > 0) {
+            TRY(copy_n_to_user(user_events, events.data(), event_count));
+            return event_count;
+        }
+        if (timeout_ms == 0)
+            return 0;
+
+        // The EPoll is readable whenever it has watches that may be ready, so we just wait for that. Watches that turn
+        // out not to be ready after all are dropped from the ready list by collect_ready_events(), so this terminates.
+        auto unblocked_flags = BlockFlags::None;
+        auto result = Thread::current()->block<Thread::ReadBlocker>(timeout, *description, unblocked_flags);
+        if (!has_flag(unblocked_flags, BlockFlags::Read)) {
+            if (result.was_interrupted())
+                return EINTR;
+            return 0;
+        }
+    }
+}
+
+}
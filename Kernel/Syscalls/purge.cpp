@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -64,6 +65,7 @@ ErrorOr<FlatPtr> Process::sys$purge(int mode)
         for (auto& vmobject : vmobjects) {
             purged_page_count += vmobject->release_all_clean_pages();
         }
+        purged_page_count += VirtualFileSystem::release_clean_file_system_caches();
     }
     return purged_page_count;
 }
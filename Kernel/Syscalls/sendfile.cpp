@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t bounce_buffer_size = 64 * KiB;
+
+namespace {
+
+// Reads from a file at an offset of our own, without moving the file offset of its description.
+class FileTransferSource final : public TransferSource {
+public:
+    FileTransferSource(OpenFileDescription& description, off_t offset)
+        : m_description(description)
+        , m_offset(offset)
+    {
+    }
+
+    virtual ErrorOr<size_t> read_into(Bytes destination) override
+    {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(destination.data());
+        auto nread = TRY(m_description.read(buffer, m_offset, destination.size()));
+        m_offset += nread;
+        return nread;
+    }
+
+private:
+    OpenFileDescription& m_description;
+    off_t m_offset { 0 };
+};
+
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    // Like on Linux, the data has to come from a file. That's what lets us read it straight out of the cache.
+    if (!in_description->file().is_inode() || in_description->is_directory())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset = 0;
+    if (user_offset) {
+        offset = TRY(copy_typed_from_user(user_offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+    if (Checked<off_t>::addition_would_overflow(offset, count))
+        return EOVERFLOW;
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, offset, count);
+
+    auto transfer = [&]() -> ErrorOr<FlatPtr> {
+        if (count == 0)
+            return 0;
+
+        // Pipes and sockets can take the data straight from the file into their own buffers.
+        if (!out_description->file().is_seekable()) {
+            FileTransferSource source { *in_description, offset };
+            auto nwritten_or_error = do_write_from(*out_description, source, count);
+            if (!nwritten_or_error.is_error() || nwritten_or_error.error().code() != ENOTSUP)
+                return nwritten_or_error;
+        }
+
+        // Everything else gets the data copied through a kernel buffer, which still saves the trip through userspace.
+        auto buffer = TRY(KBuffer::try_create_with_size("sendfile"sv, min(count, bounce_buffer_size), Memory::Region::Access::ReadWrite));
+        auto chunk = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+        size_t total_nsent = 0;
+        while (total_nsent < count) {
+            auto nread_or_error = in_description->read(chunk, offset + total_nsent, min(count - total_nsent, buffer->size()));
+            if (nread_or_error.is_error()) {
+                if (total_nsent > 0)
+                    return total_nsent;
+                return nread_or_error.release_error();
+            }
+            if (nread_or_error.value() == 0)
+                break;
+
+            auto nwritten_or_error = do_write(*out_description, chunk, nread_or_error.value());
+            if (nwritten_or_error.is_error()) {
+                if (total_nsent > 0)
+                    return total_nsent;
+                return nwritten_or_error.release_error();
+            }
+            total_nsent += nwritten_or_error.value();
+            if (nwritten_or_error.value() < nread_or_error.value())
+                break;
+        }
+        return total_nsent;
+    };
+    auto nsent = TRY(transfer());
+
+    if (user_offset) {
+        off_t new_offset = offset + nsent;
+        TRY(copy_to_user(user_offset, &new_offset));
+    } else {
+        TRY(in_description->seek(offset + nsent, SEEK_SET));
+    }
+    return nsent;
+}
+
+}
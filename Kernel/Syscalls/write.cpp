@@ -95,6 +95,41 @@ ErrorOr<FlatPtr> Process::do_write(OpenFileDescription& description, UserOrKerne
     return total_nwritten;
 }
 
+ErrorOr<FlatPtr> Process::do_write_from(OpenFileDescription& description, TransferSource& source, size_t size)
+{
+    size_t total_nwritten = 0;
+
+    while (total_nwritten < size) {
+        while (!description.can_write()) {
+            if (!description.is_blocking()) {
+                if (total_nwritten > 0)
+                    return total_nwritten;
+                return EAGAIN;
+            }
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted()) {
+                if (total_nwritten == 0)
+                    return EINTR;
+            }
+        }
+        auto nwritten_or_error = description.write_from(source, size - total_nwritten);
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten > 0)
+                return total_nwritten;
+            if (nwritten_or_error.error().code() == EAGAIN)
+                continue;
+            if (nwritten_or_error.error().code() == EPIPE)
+                Thread::current()->send_signal(SIGPIPE, &Process::current());
+            return nwritten_or_error.release_error();
+        }
+        // The source has run dry.
+        if (nwritten_or_error.value() == 0)
+            break;
+        total_nwritten += nwritten_or_error.value();
+    }
+    return total_nwritten;
+}
+
 ErrorOr<FlatPtr> Process::sys$write(int fd, Userspace<u8 const*> data, size_t size)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
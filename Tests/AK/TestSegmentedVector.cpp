@@ -26,3 +26,17 @@ TEST_CASE(at)
     EXPECT_EQ(segmented_vector[1], 2);
     EXPECT_EQ(segmented_vector[2], 3);
 }
+
+TEST_CASE(iterate_const)
+{
+    AK::SegmentedVector<int, 2> segmented_vector;
+    segmented_vector.append(1);
+    segmented_vector.append(2);
+    segmented_vector.append(3);
+
+    auto const& const_segmented_vector = segmented_vector;
+    int sum = 0;
+    for (auto value : const_segmented_vector)
+        sum += value;
+    EXPECT_EQ(sum, 6);
+}
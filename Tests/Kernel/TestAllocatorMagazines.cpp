@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr size_t page_count = 256;
+
+static JsonObject read_memory_status()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/memstat"sv, Core::File::OpenMode::Read));
+    auto file_contents = MUST(file->read_until_eof());
+    auto json = MUST(JsonValue::from_string(file_contents));
+    VERIFY(json.is_object());
+    return json.as_object();
+}
+
+static u64 get_counter(JsonObject const& memory_status, StringView name)
+{
+    auto value = memory_status.get_u64(name);
+    EXPECT(value.has_value());
+    return value.value_or(0);
+}
+
+// Faults in a bunch of fresh pages and gives them back, which is exactly what the page magazines are there for.
+static void churn_pages()
+{
+    for (int round = 0; round < 8; ++round) {
+        auto* pages = static_cast<u8*>(mmap(nullptr, page_count * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+        VERIFY(pages != MAP_FAILED);
+        for (size_t i = 0; i < page_count; ++i)
+            pages[i * PAGE_SIZE] = static_cast<u8>(i);
+        EXPECT_EQ(munmap(pages, page_count * PAGE_SIZE), 0);
+    }
+}
+
+TEST_CASE(magazines_are_used)
+{
+    auto before = read_memory_status();
+    churn_pages();
+    auto after = read_memory_status();
+
+    EXPECT(get_counter(after, "physical_page_magazine_hits"sv) > get_counter(before, "physical_page_magazine_hits"sv));
+    // Reading memstat alone allocates plenty of small objects.
+    EXPECT(get_counter(after, "kmalloc_magazine_hits"sv) > get_counter(before, "kmalloc_magazine_hits"sv));
+}
+
+TEST_CASE(cached_pages_are_counted_as_available)
+{
+    churn_pages();
+    auto memory_status = read_memory_status();
+
+    // The pages sitting in a magazine are free, so the usual bookkeeping still has to add up.
+    auto available = get_counter(memory_status, "physical_available"sv);
+    auto committed = get_counter(memory_status, "physical_committed"sv);
+    auto uncommitted = get_counter(memory_status, "physical_uncommitted"sv);
+    EXPECT_EQ(committed + uncommitted, available);
+}
+
+static bool set_force_magazine_drains(bool enabled)
+{
+    int fd = open("/sys/kernel/conf/force_magazine_drains", O_WRONLY);
+    if (fd < 0)
+        return false;
+    auto nwritten = write(fd, enabled ? "1" : "0", 1);
+    close(fd);
+    return nwritten == 1;
+}
+
+TEST_CASE(allocations_survive_forced_drains)
+{
+    if (!set_force_magazine_drains(true)) {
+        warnln("Skipping: magazine drains can't be forced");
+        return;
+    }
+    ScopeGuard stop_forcing_drains = [] { set_force_magazine_drains(false); };
+
+    auto before = read_memory_status();
+
+    // Every mmap() commits its pages up front, and every pipe buffer and file descriptor comes out of kmalloc.
+    for (int round = 0; round < 8; ++round) {
+        auto* pages = static_cast<u8*>(mmap(nullptr, page_count * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+        VERIFY(pages != MAP_FAILED);
+        for (size_t i = 0; i < page_count; ++i)
+            pages[i * PAGE_SIZE] = static_cast<u8>(i + round);
+
+        int fds[2];
+        EXPECT_EQ(pipe(fds), 0);
+        EXPECT_EQ(write(fds[1], pages, PAGE_SIZE), static_cast<ssize_t>(PAGE_SIZE));
+        u8 buffer[PAGE_SIZE];
+        EXPECT_EQ(read(fds[0], buffer, sizeof(buffer)), static_cast<ssize_t>(PAGE_SIZE));
+        EXPECT_EQ(buffer[0], static_cast<u8>(round));
+        close(fds[0]);
+        close(fds[1]);
+
+        for (size_t i = 0; i < page_count; ++i)
+            EXPECT_EQ(pages[i * PAGE_SIZE], static_cast<u8>(i + round));
+        EXPECT_EQ(munmap(pages, page_count * PAGE_SIZE), 0);
+    }
+
+    auto after = read_memory_status();
+    EXPECT(get_counter(after, "physical_page_magazine_drains"sv) > get_counter(before, "physical_page_magazine_drains"sv));
+    EXPECT(get_counter(after, "kmalloc_magazine_drains"sv) > get_counter(before, "kmalloc_magazine_drains"sv));
+
+    // Nothing may get lost on the way back from the magazines.
+    auto available = get_counter(after, "physical_available"sv);
+    auto committed = get_counter(after, "physical_committed"sv);
+    auto uncommitted = get_counter(after, "physical_uncommitted"sv);
+    EXPECT_EQ(committed + uncommitted, available);
+}
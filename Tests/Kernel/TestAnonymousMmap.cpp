@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
+#include <LibCore/ProcessStatisticsReader.h>
 #include <LibTest/TestCase.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
@@ -17,6 +20,18 @@ static void check_if_page_zeroed(char* ptr, size_t page)
         EXPECT(ptr[page * PAGE_SIZE + j] == 0);
 }
 
+static unsigned zero_faults_of_current_thread()
+{
+    auto statistics = MUST(Core::ProcessStatisticsReader::get_all(false));
+    for (auto& process : statistics.processes) {
+        for (auto& thread : process.threads) {
+            if (thread.tid == gettid())
+                return thread.zero_faults;
+        }
+    }
+    VERIFY_NOT_REACHED();
+}
+
 TEST_CASE(shared_anonymous_mmap)
 {
     size_t pages = 100;
@@ -113,3 +128,97 @@ TEST_CASE(test_that_partial_munmap_does_not_break_cow)
         EXPECT(map[2 * PAGE_SIZE] == 'C');
     }
 }
+
+// Only root can turn batched faults on, so this returns false if we're not allowed to.
+static bool set_batched_anonymous_faults(bool enabled)
+{
+    int fd = open("/sys/kernel/conf/batched_anonymous_faults", O_WRONLY);
+    if (fd < 0)
+        return false;
+    auto nwritten = write(fd, enabled ? "1" : "0", 1);
+    close(fd);
+    return nwritten == 1;
+}
+
+// Batches are only faulted in for whole 2 MiB chunks, and mmap() doesn't align anonymous mappings to them.
+static constexpr size_t chunk_size = 2 * MiB;
+
+static char* first_whole_chunk(char* map)
+{
+    return reinterpret_cast<char*>(align_up_to(reinterpret_cast<FlatPtr>(map), chunk_size));
+}
+
+TEST_CASE(large_private_anonymous_mmap_is_faulted_in_chunks)
+{
+    if (!set_batched_anonymous_faults(true)) {
+        warnln("Skipping: batched anonymous faults can't be turned on");
+        return;
+    }
+    ScopeGuard turn_batched_faults_off = [] { set_batched_anonymous_faults(false); };
+
+    size_t pages = 2048;
+    size_t len = pages * PAGE_SIZE;
+    char* map = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    EXPECT(map != MAP_FAILED);
+
+    auto zero_faults_before = zero_faults_of_current_thread();
+    for (size_t i = 0; i < pages; ++i)
+        map[i * PAGE_SIZE] = (char)i;
+    auto zero_faults_after = zero_faults_of_current_thread();
+
+    // The mapping spans at least three whole 2 MiB chunks, each of which should only fault once (unless we're short on
+    // contiguous memory).
+    EXPECT(zero_faults_after - zero_faults_before < pages / 2);
+    for (size_t i = 0; i < pages; ++i)
+        EXPECT_EQ(map[i * PAGE_SIZE], (char)i);
+    for (size_t i = 0; i < pages; i += 97)
+        EXPECT_EQ(map[i * PAGE_SIZE + 1], 0);
+    EXPECT_EQ(munmap(map, len), 0);
+}
+
+TEST_CASE(partial_mprotect_and_munmap_of_faulted_in_chunk)
+{
+    if (!set_batched_anonymous_faults(true)) {
+        warnln("Skipping: batched anonymous faults can't be turned on");
+        return;
+    }
+    ScopeGuard turn_batched_faults_off = [] { set_batched_anonymous_faults(false); };
+
+    size_t pages = 1024;
+    size_t len = pages * PAGE_SIZE;
+    char* map = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    EXPECT(map != MAP_FAILED);
+    for (size_t i = 0; i < pages; ++i)
+        map[i * PAGE_SIZE] = '$';
+
+    // Carve single pages out of the middle of what is now backed by one contiguous chunk.
+    size_t chunk_page = (first_whole_chunk(map) - map) / PAGE_SIZE;
+    size_t protected_page = chunk_page + 100;
+    size_t unmapped_page = chunk_page + 200;
+    EXPECT(unmapped_page < pages);
+    EXPECT_EQ(mprotect(map + protected_page * PAGE_SIZE, PAGE_SIZE, PROT_READ), 0);
+    EXPECT_EQ(munmap(map + unmapped_page * PAGE_SIZE, PAGE_SIZE), 0);
+
+    EXPECT(map[protected_page * PAGE_SIZE] == '$');
+    for (size_t i = 0; i < pages; ++i) {
+        if (i == protected_page || i == unmapped_page)
+            continue;
+        EXPECT(map[i * PAGE_SIZE] == '$');
+        map[i * PAGE_SIZE] = '!';
+    }
+
+    pid_t pid = fork();
+    VERIFY(pid != -1);
+    if (pid == 0) {
+        // Writing in the child must not show up in the parent, even though the pages started out together.
+        for (size_t i = unmapped_page + 1; i < pages; ++i)
+            map[i * PAGE_SIZE] = '#';
+        exit(EXIT_SUCCESS);
+    }
+    wait(NULL);
+    for (size_t i = unmapped_page + 1; i < pages; ++i)
+        EXPECT(map[i * PAGE_SIZE] == '!');
+
+    EXPECT_EQ(munmap(map, unmapped_page * PAGE_SIZE), 0);
+    EXPECT_EQ(munmap(map + (unmapped_page + 1) * PAGE_SIZE, len - (unmapped_page + 1) * PAGE_SIZE), 0);
+}
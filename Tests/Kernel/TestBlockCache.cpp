@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <serenity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static constexpr auto TEST_FILE_PATH = "/home/anon/.block_cache_test";
+static constexpr size_t file_size = 4 * MiB;
+
+static u64 cache_size_of_root_file_system()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/df"sv, Core::File::OpenMode::Read));
+    auto file_contents = MUST(file->read_until_eof());
+    auto json = MUST(JsonValue::from_string(file_contents));
+    VERIFY(json.is_array());
+
+    Optional<u64> cache_size;
+    json.as_array().for_each([&](JsonValue const& value) {
+        auto const& file_system = value.as_object();
+        if (file_system.get_byte_string("mount_point"sv) == "/"sv)
+            cache_size = file_system.get_u64("cache_size"sv);
+    });
+    EXPECT(cache_size.has_value());
+    return cache_size.value_or(0);
+}
+
+static void fill_pattern(u8* buffer, u8 seed)
+{
+    for (size_t i = 0; i < file_size; ++i)
+        buffer[i] = static_cast<u8>((i >> 9) + seed);
+}
+
+static void write_test_file(u8 const* data)
+{
+    auto fd = open(TEST_FILE_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    VERIFY(fd != -1);
+    EXPECT_EQ(write(fd, data, file_size), static_cast<ssize_t>(file_size));
+    close(fd);
+}
+
+static void read_test_file(u8* data)
+{
+    auto fd = open(TEST_FILE_PATH, O_RDONLY);
+    VERIFY(fd != -1);
+    size_t offset = 0;
+    while (offset < file_size) {
+        auto nread = read(fd, data + offset, file_size - offset);
+        EXPECT(nread > 0);
+        if (nread <= 0)
+            break;
+        offset += nread;
+    }
+    close(fd);
+}
+
+// NOTE: The cache only grows while more than half of physical memory is uncommitted, which the test machine is
+//       expected to have.
+TEST_CASE(cache_grows_on_reads_and_purge_gives_clean_blocks_back)
+{
+    auto expected = static_cast<u8*>(malloc(file_size));
+    auto actual = static_cast<u8*>(malloc(file_size));
+    ScopeGuard cleanup_guard = [&] {
+        free(expected);
+        free(actual);
+        unlink(TEST_FILE_PATH);
+    };
+
+    fill_pattern(expected, 1);
+    write_test_file(expected);
+    sync();
+
+    // Start out with as small a cache as we can get.
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) >= 0);
+    auto size_after_first_purge = cache_size_of_root_file_system();
+
+    read_test_file(actual);
+    EXPECT_EQ(memcmp(actual, expected, file_size), 0);
+    auto size_after_read = cache_size_of_root_file_system();
+    EXPECT(size_after_read > size_after_first_purge);
+
+    // Everything that was read is clean, so it can all be given back.
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) > 0);
+    auto size_after_second_purge = cache_size_of_root_file_system();
+    EXPECT(size_after_second_purge < size_after_read);
+
+    // Whatever was given back has to be read from disk again.
+    memset(actual, 0, file_size);
+    read_test_file(actual);
+    EXPECT_EQ(memcmp(actual, expected, file_size), 0);
+}
+
+TEST_CASE(purge_keeps_dirty_blocks)
+{
+    auto expected = static_cast<u8*>(malloc(file_size));
+    auto actual = static_cast<u8*>(malloc(file_size));
+    ScopeGuard cleanup_guard = [&] {
+        free(expected);
+        free(actual);
+        unlink(TEST_FILE_PATH);
+    };
+
+    fill_pattern(expected, 1);
+    write_test_file(expected);
+    sync();
+
+    // Overwrite the file without syncing, so the new contents only exist in dirty cache blocks.
+    fill_pattern(expected, 2);
+    write_test_file(expected);
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) >= 0);
+    EXPECT(cache_size_of_root_file_system() > 0);
+
+    read_test_file(actual);
+    EXPECT_EQ(memcmp(actual, expected, file_size), 0);
+
+    sync();
+    read_test_file(actual);
+    EXPECT_EQ(memcmp(actual, expected, file_size), 0);
+}
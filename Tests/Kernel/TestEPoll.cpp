@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Pipe {
+    Pipe()
+    {
+        int fds[2];
+        VERIFY(pipe2(fds, O_CLOEXEC | O_NONBLOCK) == 0);
+        read_fd = fds[0];
+        write_fd = fds[1];
+    }
+
+    ~Pipe()
+    {
+        if (read_fd != -1)
+            close(read_fd);
+        if (write_fd != -1)
+            close(write_fd);
+    }
+
+    void write_byte() const { EXPECT_EQ(write(write_fd, "x", 1), 1); }
+
+    void drain() const
+    {
+        char buffer[64];
+        while (read(read_fd, buffer, sizeof(buffer)) > 0)
+            ;
+    }
+
+    int read_fd { -1 };
+    int write_fd { -1 };
+};
+
+static void watch(int epoll_fd, int fd, u32 events, int op = EPOLL_CTL_ADD)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    EXPECT_EQ(epoll_ctl(epoll_fd, op, fd, &event), 0);
+}
+
+static int wait_for_events(int epoll_fd, epoll_event* events, int max_events, int timeout = 0)
+{
+    int rc;
+    do {
+        rc = epoll_wait(epoll_fd, events, max_events, timeout);
+    } while (rc < 0 && errno == EINTR);
+    return rc;
+}
+
+TEST_CASE(level_triggered_reports_until_drained)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipe;
+    watch(epoll_fd, pipe.read_fd, EPOLLIN);
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    pipe.write_byte();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+        EXPECT_EQ(events[0].data.fd, pipe.read_fd);
+        EXPECT(events[0].events & EPOLLIN);
+    }
+
+    pipe.drain();
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+    close(epoll_fd);
+}
+
+TEST_CASE(edge_triggered_reports_once_per_change)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipe;
+    watch(epoll_fd, pipe.read_fd, EPOLLIN | EPOLLET);
+
+    epoll_event events[4];
+    pipe.write_byte();
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    pipe.write_byte();
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    close(epoll_fd);
+}
+
+TEST_CASE(oneshot_needs_rearming)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipe;
+    watch(epoll_fd, pipe.read_fd, EPOLLIN | EPOLLONESHOT);
+
+    epoll_event events[4];
+    pipe.write_byte();
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    watch(epoll_fd, pipe.read_fd, EPOLLIN | EPOLLONESHOT, EPOLL_CTL_MOD);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    close(epoll_fd);
+}
+
+TEST_CASE(only_ready_fds_are_reported)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipes[16];
+    for (auto& pipe : pipes)
+        watch(epoll_fd, pipe.read_fd, EPOLLIN);
+
+    pipes[3].write_byte();
+    pipes[11].write_byte();
+
+    epoll_event events[16];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 16), 2);
+    bool saw_3 = false;
+    bool saw_11 = false;
+    for (int i = 0; i < 2; ++i) {
+        saw_3 |= events[i].data.fd == pipes[3].read_fd;
+        saw_11 |= events[i].data.fd == pipes[11].read_fd;
+    }
+    EXPECT(saw_3);
+    EXPECT(saw_11);
+
+    // Only as many events as asked for, and the rest are still there afterwards.
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 1), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 16), 2);
+    close(epoll_fd);
+}
+
+TEST_CASE(wait_wakes_up_on_write)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipe;
+    watch(epoll_fd, pipe.read_fd, EPOLLIN);
+
+    // Writing to our own pipe from a child means that the wait below has to actually block and be woken up.
+    pid_t pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        usleep(50'000);
+        pipe.write_byte();
+        _exit(0);
+    }
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4, 5000), 1);
+    EXPECT_EQ(events[0].data.fd, pipe.read_fd);
+    EXPECT_EQ(waitpid(pid, nullptr, 0), pid);
+    close(epoll_fd);
+}
+
+TEST_CASE(closed_fds_are_forgotten)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    {
+        Pipe pipe;
+        watch(epoll_fd, pipe.read_fd, EPOLLIN);
+        pipe.write_byte();
+    }
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    // The fd can be watched again once it's been reused.
+    Pipe pipe;
+    watch(epoll_fd, pipe.read_fd, EPOLLIN);
+    pipe.write_byte();
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    close(epoll_fd);
+}
+
+TEST_CASE(control_errors)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+
+    Pipe pipe;
+    epoll_event event {};
+    event.events = EPOLLIN;
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe.read_fd, &event), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe.read_fd, &event), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe.read_fd, &event), -1);
+    EXPECT_EQ(errno, EEXIST);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe.read_fd, &event), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event), -1);
+    EXPECT_EQ(errno, EINVAL);
+    close(epoll_fd);
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibTest/TestCase.h>
 #include <fcntl.h>
 #include <math.h>
@@ -106,3 +107,64 @@ TEST_CASE(test_ext2_writes_and_reads_to_block_ranges)
     write_then_read_block(doubly_indirect_blocks_capacity);
     write_then_read_block(triply_indirect_blocks_capacity - 1);
 }
+
+TEST_CASE(test_ext2_sequential_reads_with_read_ahead)
+{
+    static constexpr auto TEST_FILE_PATH = "/home/anon/.ext2_test";
+    static constexpr size_t file_size = 3 * MiB + 123;
+    static constexpr size_t hole_offset = 1 * MiB;
+    static constexpr size_t hole_size = 256 * KiB;
+
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    VERIFY(fd != -1);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // Fill the file with a pattern that differs from block to block, but leave a hole in the middle.
+    auto expected = (u8*)malloc(file_size);
+    auto actual = (u8*)malloc(file_size);
+    auto malloc_cleanup_guard = ScopeGuard([&] {
+        free(expected);
+        free(actual);
+    });
+    for (size_t i = 0; i < file_size; ++i)
+        expected[i] = (i >= hole_offset && i < hole_offset + hole_size) ? 0 : static_cast<u8>((i / 7) ^ (i >> 12));
+
+    EXPECT_EQ(pwrite(fd, expected, hole_offset, 0), static_cast<ssize_t>(hole_offset));
+    auto tail_offset = hole_offset + hole_size;
+    EXPECT_EQ(pwrite(fd, expected + tail_offset, file_size - tail_offset, tail_offset), static_cast<ssize_t>(file_size - tail_offset));
+
+    auto read_sequentially = [&](size_t start_offset, size_t chunk_size) {
+        memset(actual, 0xaa, file_size);
+        EXPECT_EQ(lseek(fd, start_offset, SEEK_SET), static_cast<off_t>(start_offset));
+        size_t offset = start_offset;
+        while (offset < file_size) {
+            auto nread = read(fd, actual + offset, chunk_size);
+            EXPECT(nread > 0);
+            if (nread <= 0)
+                return;
+            offset += nread;
+        }
+        EXPECT_EQ(offset, file_size);
+        EXPECT_EQ(read(fd, actual, chunk_size), 0);
+        EXPECT_EQ(memcmp(actual + start_offset, expected + start_offset, file_size - start_offset), 0);
+    };
+
+    // Sequential reads grow the read-ahead window until it runs past holes and the end of the file.
+    read_sequentially(0, 4 * KiB);
+    read_sequentially(0, 64 * KiB);
+    read_sequentially(0, 1000);
+
+    // Starting in the middle of a block and of the hole.
+    read_sequentially(hole_offset + 1234, 4 * KiB);
+
+    // Seeking around closes the window again; every read must still return the right data.
+    for (size_t offset : Array<size_t, 5> { 2 * MiB, 100 * KiB, 3 * MiB, 0, hole_offset - 10 }) {
+        u8 buffer[8 * KiB];
+        auto count = min(sizeof(buffer), file_size - offset);
+        EXPECT_EQ(pread(fd, buffer, count, offset), static_cast<ssize_t>(count));
+        EXPECT_EQ(memcmp(buffer, expected + offset, count), 0);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibCore/ProcessStatisticsReader.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr size_t page_count = 64;
+// Ends in the middle of a page, so the last one has to be partially zeroed.
+static constexpr size_t test_file_size = page_count * PAGE_SIZE - 1000;
+
+static u8 test_byte_at(size_t offset)
+{
+    return static_cast<u8>((offset * 11) ^ (offset >> 12));
+}
+
+static int create_test_file(char const* path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    Array<u8, PAGE_SIZE> chunk;
+    for (size_t offset = 0; offset < test_file_size; offset += chunk.size()) {
+        auto chunk_size = min(chunk.size(), test_file_size - offset);
+        for (size_t i = 0; i < chunk_size; ++i)
+            chunk[i] = test_byte_at(offset + i);
+        VERIFY(write(fd, chunk.data(), chunk_size) == static_cast<ssize_t>(chunk_size));
+    }
+    return fd;
+}
+
+static unsigned inode_faults_of_current_thread()
+{
+    auto statistics = MUST(Core::ProcessStatisticsReader::get_all(false));
+    for (auto& process : statistics.processes) {
+        for (auto& thread : process.threads) {
+            if (thread.tid == gettid())
+                return thread.inode_faults;
+        }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static void read_and_verify(u8 const* map)
+{
+    for (size_t page = 0; page < page_count; ++page) {
+        size_t offset = page * PAGE_SIZE;
+        if (map[offset] != test_byte_at(offset)) {
+            FAIL("Data mismatch");
+            return;
+        }
+    }
+    for (size_t offset = test_file_size; offset < page_count * PAGE_SIZE; ++offset)
+        EXPECT_EQ(map[offset], 0);
+}
+
+TEST_CASE(sequential_reads_are_clustered)
+{
+    int fd = create_test_file("/tmp/fault_around_test_sequential");
+    auto* map = static_cast<u8*>(mmap(nullptr, page_count * PAGE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0));
+    EXPECT(map != MAP_FAILED);
+
+    auto inode_faults_before = inode_faults_of_current_thread();
+    read_and_verify(map);
+    auto inode_faults_after = inode_faults_of_current_thread();
+
+    // Each fault reads in the pages around it, so only a fraction of the pages should have faulted.
+    EXPECT(inode_faults_after - inode_faults_before <= page_count / 4);
+
+    EXPECT_EQ(munmap(map, page_count * PAGE_SIZE), 0);
+    close(fd);
+    unlink("/tmp/fault_around_test_sequential");
+}
+
+TEST_CASE(cached_pages_are_mapped_around_fault)
+{
+    int fd = create_test_file("/tmp/fault_around_test_shared");
+    auto* first_map = static_cast<u8*>(mmap(nullptr, page_count * PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0));
+    EXPECT(first_map != MAP_FAILED);
+    auto* second_map = static_cast<u8*>(mmap(nullptr, page_count * PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0));
+    EXPECT(second_map != MAP_FAILED);
+
+    // Read backwards through the first mapping, then forwards through the second one, which already has all the pages.
+    for (size_t page = page_count; page-- > 0;)
+        EXPECT_EQ(first_map[page * PAGE_SIZE], test_byte_at(page * PAGE_SIZE));
+    auto inode_faults_before = inode_faults_of_current_thread();
+    read_and_verify(second_map);
+    EXPECT_EQ(inode_faults_of_current_thread(), inode_faults_before);
+
+    EXPECT_EQ(munmap(first_map, page_count * PAGE_SIZE), 0);
+    EXPECT_EQ(munmap(second_map, page_count * PAGE_SIZE), 0);
+    close(fd);
+    unlink("/tmp/fault_around_test_shared");
+}
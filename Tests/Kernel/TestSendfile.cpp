@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Bigger than a pipe's buffer, so the transfer has to block and pick up where it left off.
+static constexpr size_t test_file_size = 200 * KiB;
+
+static u8 test_byte_at(size_t offset)
+{
+    return static_cast<u8>((offset * 7) ^ (offset >> 8));
+}
+
+static int create_test_file(char const* path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    Array<u8, 4096> chunk;
+    for (size_t offset = 0; offset < test_file_size; offset += chunk.size()) {
+        for (size_t i = 0; i < chunk.size(); ++i)
+            chunk[i] = test_byte_at(offset + i);
+        VERIFY(write(fd, chunk.data(), chunk.size()) == static_cast<ssize_t>(chunk.size()));
+    }
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+// Reads everything from fd until EOF, and checks that it's the test file's contents starting at offset.
+static size_t read_and_verify(int fd, size_t offset)
+{
+    Array<u8, 4096> buffer;
+    size_t total_nread = 0;
+    for (;;) {
+        auto nread = read(fd, buffer.data(), buffer.size());
+        EXPECT(nread >= 0);
+        if (nread <= 0)
+            break;
+        for (ssize_t i = 0; i < nread; ++i) {
+            if (buffer[i] != test_byte_at(offset + total_nread + i)) {
+                FAIL("Data mismatch");
+                return total_nread;
+            }
+        }
+        total_nread += nread;
+    }
+    return total_nread;
+}
+
+static void send_through(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    pid_t pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        size_t total_nsent = 0;
+        while (total_nsent < count) {
+            auto nsent = sendfile(out_fd, in_fd, offset, count - total_nsent);
+            if (nsent <= 0)
+                _exit(1);
+            total_nsent += nsent;
+        }
+        _exit(0);
+    }
+    close(out_fd);
+    close(in_fd);
+}
+
+static void expect_child_succeeded()
+{
+    int status = 0;
+    EXPECT(wait(&status) > 0);
+    EXPECT(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST_CASE(file_to_pipe)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_pipe");
+    int fds[2];
+    VERIFY(pipe(fds) == 0);
+
+    send_through(fds[1], file_fd, nullptr, test_file_size);
+    EXPECT_EQ(read_and_verify(fds[0], 0), test_file_size);
+    close(fds[0]);
+    expect_child_succeeded();
+    unlink("/tmp/sendfile_test_pipe");
+}
+
+TEST_CASE(file_to_socket)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_socket");
+    int fds[2];
+    VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+
+    send_through(fds[1], file_fd, nullptr, test_file_size);
+    EXPECT_EQ(read_and_verify(fds[0], 0), test_file_size);
+    close(fds[0]);
+    expect_child_succeeded();
+    unlink("/tmp/sendfile_test_socket");
+}
+
+TEST_CASE(file_to_nonblocking_tcp_socket)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_tcp");
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(listen_fd >= 0);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    VERIFY(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    socklen_t address_length = sizeof(address);
+    VERIFY(getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0);
+    VERIFY(listen(listen_fd, 1) == 0);
+
+    int send_fd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(send_fd >= 0);
+    VERIFY(connect(send_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    int receive_fd = accept(listen_fd, nullptr, nullptr);
+    VERIFY(receive_fd >= 0);
+    close(listen_fd);
+    VERIFY(fcntl(send_fd, F_SETFL, fcntl(send_fd, F_GETFL) | O_NONBLOCK) == 0);
+
+    // Keep sending the file over and over until the socket is full. How much it takes depends on the buffer sizes, so
+    // this is only a bound.
+    constexpr size_t maximum_rounds = 256;
+    size_t total_size = maximum_rounds * test_file_size;
+    size_t total_nsent = 0;
+
+    auto send_some = [&] {
+        for (;;) {
+            if (total_nsent == total_size)
+                return true;
+            off_t offset = total_nsent % test_file_size;
+            size_t count = min(test_file_size - offset, total_size - total_nsent);
+            auto nsent = sendfile(send_fd, file_fd, &offset, count);
+            if (nsent < 0) {
+                EXPECT_EQ(errno, EAGAIN);
+                return false;
+            }
+            EXPECT(nsent > 0);
+            EXPECT(static_cast<size_t>(nsent) <= count);
+            // The offset has to advance by exactly what was sent, so a short write can be picked up where it left off.
+            EXPECT_EQ(static_cast<size_t>(offset), total_nsent % test_file_size + nsent);
+            if (nsent <= 0)
+                return false;
+            total_nsent += nsent;
+        }
+    };
+
+    // Without a reader, the socket fills up and sendfile() has to say so instead of blocking.
+    EXPECT(!send_some());
+    EXPECT(total_nsent > 0);
+    EXPECT(total_nsent < total_size);
+    // Then send one more copy's worth, which picks up wherever the short write left off.
+    total_size = total_nsent + test_file_size;
+    // With an offset of our own, the file offset stays where it was.
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 0);
+
+    Array<u8, 4096> buffer;
+    size_t total_nread = 0;
+    while (total_nread < total_size) {
+        pollfd fds[2] {};
+        fds[0].fd = receive_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = send_fd;
+        fds[1].events = total_nsent < total_size ? POLLOUT : 0;
+        auto rc = poll(fds, 2, 10000);
+        EXPECT(rc > 0);
+        if (rc <= 0)
+            break;
+
+        if (fds[1].revents & POLLOUT)
+            send_some();
+        if (total_nsent == total_size && send_fd >= 0) {
+            close(send_fd);
+            send_fd = -1;
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP)) {
+            auto nread = read(receive_fd, buffer.data(), buffer.size());
+            EXPECT(nread > 0);
+            if (nread <= 0)
+                break;
+            for (ssize_t i = 0; i < nread; ++i) {
+                if (buffer[i] != test_byte_at((total_nread + i) % test_file_size)) {
+                    FAIL("Data mismatch");
+                    nread = -1;
+                    break;
+                }
+            }
+            if (nread < 0)
+                break;
+            total_nread += nread;
+        }
+    }
+    EXPECT_EQ(total_nsent, total_size);
+    EXPECT_EQ(total_nread, total_size);
+
+    if (send_fd >= 0)
+        close(send_fd);
+    close(receive_fd);
+    close(file_fd);
+    unlink("/tmp/sendfile_test_tcp");
+}
+
+TEST_CASE(file_to_file)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_source");
+    int copy_fd = open("/tmp/sendfile_test_copy", O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(copy_fd >= 0);
+
+    size_t total_nsent = 0;
+    for (;;) {
+        auto nsent = sendfile(copy_fd, file_fd, nullptr, 64 * KiB);
+        EXPECT(nsent >= 0);
+        if (nsent <= 0)
+            break;
+        total_nsent += nsent;
+    }
+    EXPECT_EQ(total_nsent, test_file_size);
+    // Without an offset, sendfile() reads from (and moves) the file offset.
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), static_cast<off_t>(test_file_size));
+
+    EXPECT_EQ(lseek(copy_fd, 0, SEEK_SET), 0);
+    EXPECT_EQ(read_and_verify(copy_fd, 0), test_file_size);
+    close(file_fd);
+    close(copy_fd);
+    unlink("/tmp/sendfile_test_source");
+    unlink("/tmp/sendfile_test_copy");
+}
+
+TEST_CASE(explicit_offset)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_offset");
+    int fds[2];
+    VERIFY(pipe(fds) == 0);
+
+    off_t offset = 1000;
+    EXPECT_EQ(sendfile(fds[1], file_fd, &offset, 3000), 3000);
+    EXPECT_EQ(offset, 4000);
+    // With an offset, the file offset stays where it was.
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 0);
+
+    // Asking for more than there is stops at the end of the file.
+    offset = test_file_size - 100;
+    EXPECT_EQ(sendfile(fds[1], file_fd, &offset, 1000), 100);
+    EXPECT_EQ(offset, static_cast<off_t>(test_file_size));
+    EXPECT_EQ(sendfile(fds[1], file_fd, &offset, 1000), 0);
+
+    close(fds[1]);
+    Array<u8, 3100> buffer;
+    size_t total_nread = 0;
+    while (total_nread < buffer.size()) {
+        auto nread = read(fds[0], buffer.data() + total_nread, buffer.size() - total_nread);
+        EXPECT(nread > 0);
+        if (nread <= 0)
+            break;
+        total_nread += nread;
+    }
+    for (size_t i = 0; i < 3000; ++i)
+        EXPECT_EQ(buffer[i], test_byte_at(1000 + i));
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_EQ(buffer[3000 + i], test_byte_at(test_file_size - 100 + i));
+
+    close(fds[0]);
+    close(file_fd);
+    unlink("/tmp/sendfile_test_offset");
+}
+
+TEST_CASE(errors)
+{
+    int file_fd = create_test_file("/tmp/sendfile_test_errors");
+    int fds[2];
+    VERIFY(pipe(fds) == 0);
+
+    // The data has to come from a file, not a pipe.
+    EXPECT_EQ(sendfile(file_fd, fds[0], nullptr, 10), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(sendfile(fds[0], file_fd, nullptr, 10), -1);
+    EXPECT_EQ(errno, EBADF);
+
+    off_t offset = -1;
+    EXPECT_EQ(sendfile(fds[1], file_fd, &offset, 10), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(fds[0]);
+    close(fds[1]);
+    close(file_fd);
+    unlink("/tmp/sendfile_test_errors");
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/StringView.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr u16 port = 1338;
+static constexpr size_t transfer_size = 512 * KiB;
+static constexpr StringView network_emulation_path = "/sys/kernel/conf/loopback_network_emulation"sv;
+
+static u8 test_byte_at(size_t offset)
+{
+    return static_cast<u8>((offset * 13) ^ (offset >> 10));
+}
+
+// Only root can make the loopback lose packets, so this returns false if we're not allowed to.
+static bool set_loopback_network_emulation(StringView settings)
+{
+    int fd = open(network_emulation_path.characters_without_null_termination(), O_WRONLY);
+    if (fd < 0)
+        return false;
+    // Writing nothing but a newline goes back to a perfect network.
+    if (settings.is_empty())
+        settings = "\n"sv;
+    auto nwritten = write(fd, settings.characters_without_null_termination(), settings.length());
+    close(fd);
+    return nwritten > 0;
+}
+
+// The kernel ignores settings it doesn't understand, so this is how we know the network really is as bad as we asked.
+static ByteString loopback_network_emulation()
+{
+    auto file = MUST(Core::File::open(network_emulation_path, Core::File::OpenMode::Read));
+    auto contents = MUST(file->read_until_eof());
+    return StringView(contents).trim_whitespace();
+}
+
+static Optional<u64> retransmitted_packets_from_port(u16 local_port)
+{
+    auto file = MUST(Core::File::open("/sys/kernel/net/tcp"sv, Core::File::OpenMode::Read));
+    auto file_contents = MUST(file->read_until_eof());
+    auto json = MUST(JsonValue::from_string(file_contents));
+    VERIFY(json.is_array());
+    Optional<u64> retransmitted_packets;
+    json.as_array().for_each([&](auto& value) {
+        auto& socket = value.as_object();
+        if (socket.get_u64("local_port"sv) == local_port && socket.get_u64("peer_port"sv) == port)
+            retransmitted_packets = socket.get_u64("retransmitted_packets"sv);
+    });
+    return retransmitted_packets;
+}
+
+static sockaddr_in loopback_address()
+{
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sin;
+}
+
+static void send_test_data(StringView congestion_control, bool expect_retransmissions)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(fd >= 0);
+    VERIFY(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, congestion_control.characters_without_null_termination(), congestion_control.length()) == 0);
+    auto sin = loopback_address();
+    if (connect(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) < 0)
+        _exit(1);
+
+    Array<u8, 4096> chunk;
+    for (size_t offset = 0; offset < transfer_size; offset += chunk.size()) {
+        for (size_t i = 0; i < chunk.size(); ++i)
+            chunk[i] = test_byte_at(offset + i);
+        size_t total_nwritten = 0;
+        while (total_nwritten < chunk.size()) {
+            auto nwritten = write(fd, chunk.data() + total_nwritten, chunk.size() - total_nwritten);
+            if (nwritten <= 0)
+                _exit(1);
+            total_nwritten += nwritten;
+        }
+    }
+
+    // The receiver only hangs up once it has everything, so by then any lost segments must have been sent again.
+    if (shutdown(fd, SHUT_WR) < 0)
+        _exit(1);
+    if (read(fd, chunk.data(), chunk.size()) != 0)
+        _exit(1);
+
+    sockaddr_in local_address {};
+    socklen_t local_address_length = sizeof(local_address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&local_address), &local_address_length) < 0)
+        _exit(1);
+    auto retransmitted_packets = retransmitted_packets_from_port(ntohs(local_address.sin_port));
+    if (!retransmitted_packets.has_value())
+        _exit(1);
+    // Otherwise the data got through without ever taking the loss recovery paths, and we've tested nothing.
+    if (expect_retransmissions && *retransmitted_packets == 0) {
+        warnln("Nothing was retransmitted over a lossy network");
+        _exit(1);
+    }
+    close(fd);
+    _exit(0);
+}
+
+// Sends data over a loopback connection with the given network emulation settings, and checks that all of it arrives
+// intact. The settings have to be written the way the kernel reports them back.
+static void transfer_over_emulated_network(StringView congestion_control, StringView settings)
+{
+    if (!set_loopback_network_emulation(settings)) {
+        warnln("Skipping, can't change {}", network_emulation_path);
+        return;
+    }
+    EXPECT_EQ(loopback_network_emulation(), settings);
+    bool is_lossy = !settings.starts_with("loss=0 "sv);
+
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(server_fd >= 0);
+    int enable = 1;
+    EXPECT_EQ(setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)), 0);
+    auto sin = loopback_address();
+    EXPECT_EQ(bind(server_fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)), 0);
+    EXPECT_EQ(listen(server_fd, 1), 0);
+
+    pid_t pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0)
+        send_test_data(congestion_control, is_lossy);
+
+    int client_fd = accept(server_fd, nullptr, nullptr);
+    EXPECT(client_fd >= 0);
+
+    Array<u8, 4096> buffer;
+    size_t total_nread = 0;
+    for (;;) {
+        auto nread = read(client_fd, buffer.data(), buffer.size());
+        EXPECT(nread >= 0);
+        if (nread <= 0)
+            break;
+        for (ssize_t i = 0; i < nread; ++i) {
+            if (buffer[i] != test_byte_at(total_nread + i)) {
+                FAIL("Data mismatch");
+                break;
+            }
+        }
+        total_nread += nread;
+    }
+    EXPECT_EQ(total_nread, transfer_size);
+    close(client_fd);
+
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    close(server_fd);
+    EXPECT(set_loopback_network_emulation(""sv));
+}
+
+TEST_CASE(reno_recovers_from_loss)
+{
+    transfer_over_emulated_network("reno"sv, "loss=2 delay=5 mtu=1500"sv);
+}
+
+TEST_CASE(cubic_recovers_from_loss)
+{
+    transfer_over_emulated_network("cubic"sv, "loss=2 delay=5 mtu=1500"sv);
+}
+
+// Small segments mean many more of them in flight, so there's a lot more for SACK to keep track of.
+TEST_CASE(cubic_recovers_from_heavy_loss_with_small_segments)
+{
+    transfer_over_emulated_network("cubic"sv, "loss=5 delay=2 mtu=576"sv);
+}
+
+// Nothing gets lost, but the window has to open up far enough to cover the delay.
+TEST_CASE(reno_over_long_delay)
+{
+    transfer_over_emulated_network("reno"sv, "loss=0 delay=50 mtu=1500"sv);
+}
+
+TEST_CASE(cubic_over_long_delay)
+{
+    transfer_over_emulated_network("cubic"sv, "loss=0 delay=50 mtu=1500"sv);
+}
+
+TEST_CASE(congestion_control_option)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    char name[TCP_CA_NAME_MAX];
+    socklen_t name_length = sizeof(name);
+    EXPECT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "cubic"sv);
+
+    EXPECT_EQ(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "reno", 4), 0);
+    name_length = sizeof(name);
+    EXPECT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "reno"sv);
+
+    EXPECT_EQ(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "bbr", 3), -1);
+    EXPECT_EQ(errno, ENOENT);
+    close(fd);
+}
@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/JsonArray.h>
 #include <LibCore/File.h>
 #include <LibTest/TestCase.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <sys/socket.h>
+#include <unistd.h>
 
 static constexpr u16 port = 1337;
 
@@ -170,3 +173,125 @@ TEST_CASE(socket_connect_after_bind)
     unlink("/tmp/tmp-client.test");
     unlink("/tmp/tmp.test");
 }
+
+static constexpr size_t interleaved_flow_count = 4;
+static constexpr size_t bytes_per_interleaved_flow = 512 * KiB;
+
+static u8 interleaved_stream_byte(size_t flow, size_t offset)
+{
+    return static_cast<u8>(offset * 7 + flow * 101 + (offset >> 11));
+}
+
+static void* interleaved_stream_writer(void* client_fds)
+{
+    auto& fds = *reinterpret_cast<Array<int, interleaved_flow_count>*>(client_fds);
+
+    // A mix of tiny writes, writes of about one segment and writes spanning many segments, so that segments of
+    // different flows end up next to each other in the same batch, and runs of one flow get cut at batch boundaries.
+    static constexpr Array<size_t, 8> write_sizes { 1, 1460, 3, 4096, 700, 65536, 17, 2921 };
+
+    Array<size_t, interleaved_flow_count> sent {};
+    u8 buffer[65536];
+    for (size_t round = 0;; ++round) {
+        bool all_done = true;
+        for (size_t flow = 0; flow < interleaved_flow_count; ++flow) {
+            if (sent[flow] == bytes_per_interleaved_flow)
+                continue;
+            all_done = false;
+            auto size = min(write_sizes[(round + flow) % write_sizes.size()], bytes_per_interleaved_flow - sent[flow]);
+            for (size_t i = 0; i < size; ++i)
+                buffer[i] = interleaved_stream_byte(flow, sent[flow] + i);
+            size_t nsent = 0;
+            while (nsent < size) {
+                auto rc = send(fds[flow], buffer + nsent, size - nsent, 0);
+                VERIFY(rc > 0);
+                nsent += rc;
+            }
+            sent[flow] += size;
+        }
+        if (all_done)
+            break;
+    }
+
+    for (auto fd : fds)
+        EXPECT_EQ(close(fd), 0);
+    return nullptr;
+}
+
+TEST_CASE(tcp_interleaved_streams_arrive_in_order)
+{
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(server_fd >= 0);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = 0;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(bind(server_fd, (sockaddr*)(&sin), sizeof(sin)), 0);
+    EXPECT_EQ(listen(server_fd, interleaved_flow_count), 0);
+    socklen_t sin_length = sizeof(sin);
+    EXPECT_EQ(getsockname(server_fd, (sockaddr*)(&sin), &sin_length), 0);
+
+    Array<int, interleaved_flow_count> client_fds {};
+    Array<u16, interleaved_flow_count> client_ports {};
+    for (size_t flow = 0; flow < interleaved_flow_count; ++flow) {
+        client_fds[flow] = socket(AF_INET, SOCK_STREAM, 0);
+        EXPECT(client_fds[flow] >= 0);
+        EXPECT_EQ(connect(client_fds[flow], (sockaddr*)(&sin), sizeof(sin)), 0);
+
+        sockaddr_in local {};
+        socklen_t local_length = sizeof(local);
+        EXPECT_EQ(getsockname(client_fds[flow], (sockaddr*)(&local), &local_length), 0);
+        client_ports[flow] = local.sin_port;
+    }
+
+    // Accepted connections are matched up with their flow through the client's port.
+    Array<pollfd, interleaved_flow_count> poll_fds {};
+    for (size_t i = 0; i < interleaved_flow_count; ++i) {
+        sockaddr_in peer {};
+        socklen_t peer_length = sizeof(peer);
+        int fd = accept(server_fd, (sockaddr*)(&peer), &peer_length);
+        EXPECT(fd >= 0);
+        auto flow = client_ports.first_index_of(peer.sin_port);
+        VERIFY(flow.has_value());
+        poll_fds[*flow] = { .fd = fd, .events = POLLIN, .revents = 0 };
+    }
+    EXPECT_EQ(close(server_fd), 0);
+
+    pthread_t writer;
+    EXPECT_EQ(pthread_create(&writer, nullptr, interleaved_stream_writer, &client_fds), 0);
+
+    // Read from whichever connection has data, so the writer never waits on a flow we aren't reading.
+    Array<size_t, interleaved_flow_count> received {};
+    size_t open_flows = interleaved_flow_count;
+    u8 buffer[8192];
+    while (open_flows > 0) {
+        auto rc = poll(poll_fds.data(), poll_fds.size(), 10000);
+        EXPECT(rc > 0);
+        if (rc <= 0)
+            break;
+        for (size_t flow = 0; flow < interleaved_flow_count; ++flow) {
+            auto& poll_fd = poll_fds[flow];
+            if (poll_fd.fd < 0 || !(poll_fd.revents & (POLLIN | POLLHUP)))
+                continue;
+            auto nread = read(poll_fd.fd, buffer, sizeof(buffer));
+            EXPECT(nread >= 0);
+            if (nread <= 0) {
+                EXPECT_EQ(received[flow], bytes_per_interleaved_flow);
+                EXPECT_EQ(close(poll_fd.fd), 0);
+                poll_fd.fd = -1;
+                --open_flows;
+                continue;
+            }
+            for (ssize_t i = 0; i < nread; ++i) {
+                if (buffer[i] != interleaved_stream_byte(flow, received[flow] + i)) {
+                    FAIL(ByteString::formatted("Flow {} has the wrong byte at offset {}", flow, received[flow] + i));
+                    return;
+                }
+            }
+            received[flow] += nread;
+        }
+    }
+
+    EXPECT_EQ(pthread_join(writer, nullptr), 0);
+}
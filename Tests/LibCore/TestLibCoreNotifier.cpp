@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(notifier_fires)
+{
+    IGNORE_USE_IN_ESCAPING_LAMBDA Core::EventLoop event_loop;
+    auto fds = TRY_OR_FAIL(Core::System::pipe2(O_CLOEXEC));
+
+    auto notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Read);
+    notifier->on_activation = [&] {
+        event_loop.quit(0);
+    };
+
+    auto reaper = Core::Timer::create_single_shot(1000, [&] {
+        FAIL("The notifier never fired");
+        event_loop.quit(1);
+    });
+    reaper->start();
+
+    TRY_OR_FAIL(Core::System::write(fds[1], "x"sv.bytes()));
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    notifier->close();
+    TRY_OR_FAIL(Core::System::close(fds[0]));
+    TRY_OR_FAIL(Core::System::close(fds[1]));
+}
+
+TEST_CASE(notifier_on_reused_fd_number)
+{
+    IGNORE_USE_IN_ESCAPING_LAMBDA Core::EventLoop event_loop;
+    auto old_fds = TRY_OR_FAIL(Core::System::pipe2(O_CLOEXEC));
+
+    // Keep a notifier around for the old fd, but close the fd behind its back.
+    auto old_notifier = Core::Notifier::construct(old_fds[0], Core::Notifier::Type::Read);
+    old_notifier->on_activation = [] {};
+    TRY_OR_FAIL(Core::System::close(old_fds[0]));
+
+    // The lowest free fd number is handed out again.
+    auto new_fds = TRY_OR_FAIL(Core::System::pipe2(O_CLOEXEC));
+    EXPECT_EQ(new_fds[0], old_fds[0]);
+
+    auto new_notifier = Core::Notifier::construct(new_fds[0], Core::Notifier::Type::Read);
+    new_notifier->on_activation = [&] {
+        event_loop.quit(0);
+    };
+
+    auto reaper = Core::Timer::create_single_shot(1000, [&] {
+        FAIL("The notifier for the reused fd never fired");
+        event_loop.quit(1);
+    });
+    reaper->start();
+
+    TRY_OR_FAIL(Core::System::write(new_fds[1], "x"sv.bytes()));
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    new_notifier->close();
+    old_notifier->close();
+    TRY_OR_FAIL(Core::System::close(new_fds[0]));
+    TRY_OR_FAIL(Core::System::close(new_fds[1]));
+    TRY_OR_FAIL(Core::System::close(old_fds[1]));
+}
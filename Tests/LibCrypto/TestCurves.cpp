@@ -225,6 +225,201 @@ TEST_CASE(test_secp256r1)
     EXPECT_EQ(expected_public_key, generated_public);
 }
 
+TEST_CASE(test_secp256r1_verify)
+{
+    // https://datatracker.ietf.org/doc/html/rfc6979#appendix-A.2.5, SHA-256 of "sample"
+    // clang-format off
+    Array<u8, 65> public_key {
+        0x04,
+        0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31, 0xc9, 0x61, 0xeb, 0x74, 0xc6, 0x35, 0x6d, 0x68,
+        0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c, 0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6,
+        0x79, 0x03, 0xfe, 0x10, 0x08, 0xb8, 0xbc, 0x99, 0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+        0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51, 0x77, 0xa3, 0xc2, 0x94, 0xd4, 0x46, 0x22, 0x99,
+    };
+
+    Array<u8, 32> hash {
+        0xaf, 0x2b, 0xdb, 0xe1, 0xaa, 0x9b, 0x6e, 0xc1, 0xe2, 0xad, 0xe1, 0xd6, 0x94, 0xf4, 0x1f, 0xc7,
+        0x1a, 0x83, 0x1d, 0x02, 0x68, 0xe9, 0x89, 0x15, 0x62, 0x11, 0x3d, 0x8a, 0x62, 0xad, 0xd1, 0xbf,
+    };
+
+    Array<u8, 72> signature {
+        0x30, 0x46,
+        0x02, 0x21, 0x00,
+        0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd, 0x11, 0x40, 0xdd, 0x9c, 0xd4, 0x5e, 0x81, 0xd6,
+        0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91, 0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16,
+        0x02, 0x21, 0x00,
+        0xf7, 0xcb, 0x1c, 0x94, 0x2d, 0x65, 0x7c, 0x41, 0xd4, 0x36, 0xc7, 0xa1, 0xb6, 0xe2, 0x9f, 0x65,
+        0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf, 0xf4, 0x06, 0x4d, 0xc4, 0xab, 0x2f, 0x84, 0x3a, 0xcd, 0xa8,
+    };
+    // clang-format on
+
+    Crypto::Curves::SECP256r1 curve;
+
+    EXPECT(MUST(curve.verify(hash, public_key, signature)));
+
+    hash[0] ^= 1;
+    EXPECT(!MUST(curve.verify(hash, public_key, signature)));
+}
+
+TEST_CASE(test_secp256r1_scalar_multiplication)
+{
+    // Expected results come from a textbook affine double-and-add implementation. The scalars include
+    // ones with long runs of zero windows at either end, and n - 1, whose product is -G.
+    struct TestVector {
+        Array<u8, 32> scalar;
+        Array<u8, 65> expected_point;
+    };
+
+    // clang-format off
+    Array<TestVector, 4> test_vectors {{
+    {
+        {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xab, 0xcd,
+        },
+        {
+            0x04,
+            0x7b, 0xbb, 0x4f, 0x88, 0x40, 0x7c, 0xe0, 0x4e, 0x76, 0x8d, 0x23, 0x85, 0xaa, 0x71, 0x4f, 0xc1,
+            0x0c, 0xc5, 0x49, 0x96, 0x9e, 0xf6, 0x26, 0xcc, 0x68, 0x02, 0xc1, 0x0f, 0x21, 0x77, 0x19, 0x3a,
+            0xae, 0xfc, 0x1b, 0xc0, 0xd2, 0xb1, 0xd5, 0x8b, 0xc7, 0xec, 0x8c, 0x2d, 0xc8, 0xdd, 0x4f, 0x04,
+            0x6f, 0x4c, 0x2b, 0x03, 0xe4, 0xaf, 0xe7, 0x2d, 0x1c, 0x9d, 0x2e, 0x64, 0xaf, 0xe4, 0xc9, 0x54,
+        },
+    },
+    {
+        {
+            0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84, 0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x50,
+        },
+        {
+            0x04,
+            0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47, 0xf8, 0xbc, 0xe6, 0xe5, 0x63, 0xa4, 0x40, 0xf2,
+            0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb, 0x33, 0xa0, 0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96,
+            0xb0, 0x1c, 0xbd, 0x1c, 0x01, 0xe5, 0x80, 0x65, 0x71, 0x18, 0x14, 0xb5, 0x83, 0xf0, 0x61, 0xe9,
+            0xd4, 0x31, 0xcc, 0xa9, 0x94, 0xce, 0xa1, 0x31, 0x34, 0x49, 0xbf, 0x97, 0xc8, 0x40, 0xae, 0x0a,
+        },
+    },
+    {
+        {
+            0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        },
+        {
+            0x04,
+            0xd7, 0xf0, 0xa3, 0x4c, 0xe9, 0x16, 0xc1, 0x82, 0x19, 0x05, 0x6e, 0xf7, 0x69, 0x5e, 0x16, 0x60,
+            0x28, 0x19, 0x10, 0x55, 0x9f, 0xe8, 0x17, 0x75, 0xb6, 0x20, 0xf8, 0x1d, 0x76, 0xb3, 0x1e, 0xc6,
+            0x61, 0xef, 0xb8, 0x6f, 0xd5, 0x0f, 0x58, 0xcf, 0xf9, 0x40, 0x64, 0xf1, 0xa7, 0x06, 0x42, 0x9c,
+            0x99, 0x28, 0x3c, 0x40, 0x50, 0xd4, 0x22, 0x6f, 0x82, 0x4e, 0x6f, 0x7d, 0xbd, 0xb1, 0xc9, 0x56,
+        },
+    },
+    {
+        {
+            0x8b, 0x44, 0x86, 0xc5, 0x99, 0xcb, 0x38, 0x1b, 0x6e, 0xb5, 0x8e, 0xea, 0x34, 0x85, 0x47, 0x02,
+            0xa8, 0xd4, 0x29, 0x34, 0x33, 0xe7, 0x98, 0xa0, 0xe8, 0x1f, 0x9b, 0x0c, 0xbf, 0x4e, 0x7a, 0xf7,
+        },
+        {
+            0x04,
+            0x66, 0xb3, 0x72, 0x4b, 0xd9, 0xf8, 0x92, 0xc7, 0x4a, 0xc1, 0x9d, 0x58, 0xd7, 0x89, 0xd3, 0x0d,
+            0xc5, 0x99, 0x7a, 0xdf, 0x37, 0x16, 0xb4, 0x71, 0xb3, 0xa6, 0xef, 0xe1, 0x99, 0xf9, 0x96, 0x5a,
+            0xe4, 0xdc, 0x16, 0x25, 0xb6, 0x69, 0x0c, 0xd9, 0xc1, 0x6d, 0xa8, 0x38, 0xdf, 0x56, 0xd7, 0x46,
+            0x0e, 0x87, 0x3f, 0x70, 0xd3, 0x8f, 0xca, 0xd9, 0x6a, 0x4f, 0x08, 0x77, 0xb7, 0x04, 0x97, 0xbb,
+        },
+    },
+    }};
+
+    Array<u8, 65> generator_point {
+        0x04,
+        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+    };
+    // clang-format on
+
+    Crypto::Curves::SECP256r1 curve;
+
+    for (auto const& test_vector : test_vectors) {
+        ReadonlyBytes expected_point = test_vector.expected_point;
+
+        // The generator has its own precomputed tables, so check both multiplication paths.
+        auto generator_result = MUST(curve.generate_public_key(test_vector.scalar));
+        EXPECT_EQ(generator_result.bytes(), expected_point);
+
+        auto point_result = MUST(curve.compute_coordinate(test_vector.scalar, generator_point));
+        EXPECT_EQ(point_result.bytes(), expected_point);
+    }
+}
+
+template<typename Curve>
+static void test_random_scalars_agree()
+{
+    Curve curve;
+
+    for (size_t i = 0; i < 16; ++i) {
+        auto alice_private_key = MUST(curve.generate_private_key());
+        auto bob_private_key = MUST(curve.generate_private_key());
+
+        auto alice_public_key = MUST(curve.generate_public_key(alice_private_key));
+        auto bob_public_key = MUST(curve.generate_public_key(bob_private_key));
+
+        // a * (b * G) and b * (a * G) only agree if the generator tables and the generic
+        // point multiplication compute the same thing.
+        auto shared_alice = MUST(curve.compute_coordinate(alice_private_key, bob_public_key));
+        auto shared_bob = MUST(curve.compute_coordinate(bob_private_key, alice_public_key));
+        EXPECT_EQ(shared_alice, shared_bob);
+    }
+}
+
+TEST_CASE(test_secp256r1_random_scalars)
+{
+    test_random_scalars_agree<Crypto::Curves::SECP256r1>();
+}
+
+TEST_CASE(test_secp384r1_random_scalars)
+{
+    test_random_scalars_agree<Crypto::Curves::SECP384r1>();
+}
+
+TEST_CASE(test_secp256r1_ecdh)
+{
+    // NIST CAVS 14.1, ECC CDH primitive test vectors, P-256, COUNT = 0
+    // clang-format off
+    Array<u8, 32> private_key {
+        0x7d, 0x7d, 0xc5, 0xf7, 0x1e, 0xb2, 0x9d, 0xda, 0xf8, 0x0d, 0x62, 0x14, 0x63, 0x2e, 0xea, 0xe0,
+        0x3d, 0x90, 0x58, 0xaf, 0x1f, 0xb6, 0xd2, 0x2e, 0xd8, 0x0b, 0xad, 0xb6, 0x2b, 0xc1, 0xa5, 0x34,
+    };
+
+    Array<u8, 65> public_key {
+        0x04,
+        0xea, 0xd2, 0x18, 0x59, 0x01, 0x19, 0xe8, 0x87, 0x6b, 0x29, 0x14, 0x6f, 0xf8, 0x9c, 0xa6, 0x17,
+        0x70, 0xc4, 0xed, 0xbb, 0xf9, 0x7d, 0x38, 0xce, 0x38, 0x5e, 0xd2, 0x81, 0xd8, 0xa6, 0xb2, 0x30,
+        0x28, 0xaf, 0x61, 0x28, 0x1f, 0xd3, 0x5e, 0x2f, 0xa7, 0x00, 0x25, 0x23, 0xac, 0xc8, 0x5a, 0x42,
+        0x9c, 0xb0, 0x6e, 0xe6, 0x64, 0x83, 0x25, 0x38, 0x9f, 0x59, 0xed, 0xfc, 0xe1, 0x40, 0x51, 0x41,
+    };
+
+    Array<u8, 65> peer_public_key {
+        0x04,
+        0x70, 0x0c, 0x48, 0xf7, 0x7f, 0x56, 0x58, 0x4c, 0x5c, 0xc6, 0x32, 0xca, 0x65, 0x64, 0x0d, 0xb9,
+        0x1b, 0x6b, 0xac, 0xce, 0x3a, 0x4d, 0xf6, 0xb4, 0x2c, 0xe7, 0xcc, 0x83, 0x88, 0x33, 0xd2, 0x87,
+        0xdb, 0x71, 0xe5, 0x09, 0xe3, 0xfd, 0x9b, 0x06, 0x0d, 0xdb, 0x20, 0xba, 0x5c, 0x51, 0xdc, 0xc5,
+        0x94, 0x8d, 0x46, 0xfb, 0xf6, 0x40, 0xdf, 0xe0, 0x44, 0x17, 0x82, 0xca, 0xb8, 0x5f, 0xa4, 0xac,
+    };
+
+    Array<u8, 32> shared_secret {
+        0x46, 0xfc, 0x62, 0x10, 0x64, 0x20, 0xff, 0x01, 0x2e, 0x54, 0xa4, 0x34, 0xfb, 0xdd, 0x2d, 0x25,
+        0xcc, 0xc5, 0x85, 0x20, 0x60, 0x56, 0x1e, 0x68, 0x04, 0x0d, 0xd7, 0x77, 0x89, 0x97, 0xbd, 0x7b,
+    };
+    // clang-format on
+
+    Crypto::Curves::SECP256r1 curve;
+
+    auto generated_public_key = MUST(curve.generate_public_key(private_key));
+    EXPECT_EQ(generated_public_key.bytes(), public_key.span());
+
+    auto shared_point = MUST(curve.compute_coordinate(private_key, peer_public_key));
+    auto premaster_key = MUST(curve.derive_premaster_key(shared_point));
+    EXPECT_EQ(premaster_key.bytes(), shared_secret.span());
+}
+
 TEST_CASE(test_secp384r1)
 {
     // clang-format off
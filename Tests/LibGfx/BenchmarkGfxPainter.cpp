@@ -9,6 +9,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/Painter.h>
+#include <LibGfx/PixelKernels.h>
 #include <stdio.h>
 
 BENCHMARK_CASE(diagonal_lines)
@@ -52,3 +53,71 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    auto source = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }));
+    source->fill(Color(255, 0, 0, 128));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha)
+{
+    int const run_count = 20;
+    int const bitmap_size = 2000;
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }));
+    auto source = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size / 3, bitmap_size / 3 }));
+    source->fill(Color(255, 0, 0, 128));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect(), 1.0f, Gfx::ScalingMode::BilinearBlend);
+    }
+}
+
+// The next two compare the vectorized span blend against the same blend done one Color at a time.
+static constexpr size_t blend_span_pixel_count = 2000 * 2000;
+
+BENCHMARK_CASE(blend_span)
+{
+    int const run_count = 100;
+
+    Vector<Gfx::ARGB32> destination;
+    destination.resize(blend_span_pixel_count);
+    destination.span().fill(Color(Color::Blue).value());
+    Vector<Gfx::ARGB32> source;
+    source.resize(blend_span_pixel_count);
+    source.span().fill(Color(255, 0, 0, 128).value());
+
+    for (int run = 0; run < run_count; run++) {
+        Gfx::PixelKernels::blend_span(destination.data(), source.data(), blend_span_pixel_count, Gfx::PixelKernels::identity_alpha_table, true);
+        AK::taint_for_optimizer(destination);
+    }
+}
+
+BENCHMARK_CASE(blend_span_one_color_at_a_time)
+{
+    int const run_count = 100;
+
+    Vector<Gfx::ARGB32> destination;
+    destination.resize(blend_span_pixel_count);
+    destination.span().fill(Color(Color::Blue).value());
+    Vector<Gfx::ARGB32> source;
+    source.resize(blend_span_pixel_count);
+    source.span().fill(Color(255, 0, 0, 128).value());
+
+    for (int run = 0; run < run_count; run++) {
+        for (size_t i = 0; i < blend_span_pixel_count; ++i)
+            destination[i] = Color::from_rgb(destination[i]).blend(Color::from_argb(source[i])).value();
+        AK::taint_for_optimizer(destination);
+    }
+}
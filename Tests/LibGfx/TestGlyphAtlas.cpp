@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+
+static RefPtr<Gfx::Bitmap> make_glyph_bitmap(Gfx::IntSize size, u8 alpha)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size));
+    bitmap->fill(Gfx::Color(255, 255, 255, alpha));
+    return bitmap;
+}
+
+static Gfx::GlyphAtlasKey make_key(u32 glyph_id)
+{
+    return { .typeface_id = 1, .x_scale = 1, .y_scale = 1, .glyph_id = glyph_id, .subpixel_offset = { 0, 0 } };
+}
+
+TEST_CASE(glyph_is_rasterized_once)
+{
+    Gfx::GlyphAtlas atlas({ 64, 64 }, 2);
+    int rasterize_count = 0;
+    Function<RefPtr<Gfx::Bitmap>()> rasterize = [&] {
+        ++rasterize_count;
+        return make_glyph_bitmap({ 4, 6 }, 0x80);
+    };
+
+    auto first = atlas.find_or_rasterize(make_key(1), rasterize);
+    auto second = atlas.find_or_rasterize(make_key(1), rasterize);
+    EXPECT_EQ(rasterize_count, 1);
+    EXPECT(first.has_value());
+    EXPECT(second.has_value());
+    EXPECT_EQ(first->page.ptr(), second->page.ptr());
+    EXPECT_EQ(first->rect, second->rect);
+    EXPECT_EQ(first->rect.size(), Gfx::IntSize(4, 6));
+    EXPECT_EQ(atlas.glyph_count(), 1u);
+}
+
+TEST_CASE(glyph_coverage_is_alpha_channel)
+{
+    Gfx::GlyphAtlas atlas({ 64, 64 }, 2);
+    auto glyph = atlas.find_or_rasterize(make_key(1), [] { return make_glyph_bitmap({ 3, 3 }, 0x42); });
+    EXPECT(glyph.has_value());
+    for (int y = 0; y < glyph->rect.height(); ++y) {
+        for (int x = 0; x < glyph->rect.width(); ++x)
+            EXPECT_EQ(glyph->page->scanline(glyph->rect.y() + y)[glyph->rect.x() + x], 0x42);
+    }
+}
+
+TEST_CASE(glyphs_do_not_overlap)
+{
+    Gfx::GlyphAtlas atlas({ 64, 64 }, 1);
+    Vector<Gfx::IntRect> rects;
+    for (u32 glyph_id = 0; glyph_id < 16; ++glyph_id) {
+        auto glyph = atlas.find_or_rasterize(make_key(glyph_id), [] { return make_glyph_bitmap({ 10, 10 }, 0xff); });
+        EXPECT(glyph.has_value());
+        for (auto const& rect : rects)
+            EXPECT(!rect.intersects(glyph->rect));
+        rects.append(glyph->rect);
+    }
+    EXPECT_EQ(atlas.page_count(), 1u);
+}
+
+TEST_CASE(least_recently_used_page_is_evicted)
+{
+    Gfx::GlyphAtlas atlas({ 16, 16 }, 2);
+    Function<RefPtr<Gfx::Bitmap>()> rasterize = [] { return make_glyph_bitmap({ 15, 15 }, 0xff); };
+
+    // Every glyph fills a page of its own.
+    auto first = atlas.find_or_rasterize(make_key(1), rasterize);
+    (void)atlas.find_or_rasterize(make_key(2), rasterize);
+    EXPECT_EQ(atlas.page_count(), 2u);
+
+    // Touch the first glyph so the second one's page is the least recently used.
+    (void)atlas.find_or_rasterize(make_key(1), rasterize);
+    (void)atlas.find_or_rasterize(make_key(3), rasterize);
+    EXPECT_EQ(atlas.page_count(), 2u);
+    EXPECT_EQ(atlas.glyph_count(), 2u);
+
+    int rasterize_count = 0;
+    Function<RefPtr<Gfx::Bitmap>()> counting_rasterize = [&] {
+        ++rasterize_count;
+        return rasterize();
+    };
+    (void)atlas.find_or_rasterize(make_key(1), counting_rasterize);
+    EXPECT_EQ(rasterize_count, 0);
+    (void)atlas.find_or_rasterize(make_key(2), counting_rasterize);
+    EXPECT_EQ(rasterize_count, 1);
+
+    // Glyphs that were handed out stay valid after their page has been evicted.
+    EXPECT_EQ(first->page->scanline(first->rect.y())[first->rect.x()], 0xff);
+}
+
+TEST_CASE(oversized_glyph_is_not_cached)
+{
+    Gfx::GlyphAtlas atlas({ 16, 16 }, 2);
+    auto glyph = atlas.find_or_rasterize(make_key(1), [] { return make_glyph_bitmap({ 32, 8 }, 0xff); });
+    EXPECT(glyph.has_value());
+    EXPECT_EQ(glyph->rect.size(), Gfx::IntSize(32, 8));
+    EXPECT_EQ(atlas.glyph_count(), 0u);
+    EXPECT_EQ(atlas.page_count(), 0u);
+}
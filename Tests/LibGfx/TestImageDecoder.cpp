@@ -448,6 +448,55 @@ TEST_CASE(test_jpeg_sof0_several_scans)
     TRY_OR_FAIL(expect_single_frame_of_size(*plugin_decoder, { 592, 800 }));
 }
 
+TEST_CASE(test_jpeg_sof0_scaled_decode)
+{
+    auto file = TRY_OR_FAIL(Core::MappedFile::map(TEST_INPUT("jpg/several_scans.jpg"sv)));
+    auto full_size_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+    auto full_size_frame = TRY_OR_FAIL(full_size_decoder->frame(0));
+
+    struct TestCase {
+        Gfx::IntSize ideal_size;
+        Gfx::IntSize expected_size;
+    };
+    for (auto test_case : Array {
+             TestCase { { 592, 800 }, { 592, 800 } },
+             TestCase { { 296, 400 }, { 296, 400 } },
+             TestCase { { 100, 100 }, { 148, 200 } },
+             TestCase { { 74, 100 }, { 74, 100 } },
+             TestCase { { 1, 1 }, { 74, 100 } },
+         }) {
+        auto plugin_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+        auto frame = TRY_OR_FAIL(plugin_decoder->frame(0, test_case.ideal_size));
+        EXPECT_EQ(frame.image->size(), test_case.expected_size);
+
+        // Scaled pixels should on average be close to the area they cover in the full size image.
+        int const scale = full_size_frame.image->width() / frame.image->width();
+        u64 total_error = 0;
+        for (int y = 0; y < frame.image->height(); ++y) {
+            for (int x = 0; x < frame.image->width(); ++x) {
+                int red = 0, green = 0, blue = 0;
+                for (int dy = 0; dy < scale; ++dy) {
+                    for (int dx = 0; dx < scale; ++dx) {
+                        auto color = full_size_frame.image->get_pixel(x * scale + dx, y * scale + dy);
+                        red += color.red();
+                        green += color.green();
+                        blue += color.blue();
+                    }
+                }
+                auto color = frame.image->get_pixel(x, y);
+                total_error += abs(color.red() - red / (scale * scale));
+                total_error += abs(color.green() - green / (scale * scale));
+                total_error += abs(color.blue() - blue / (scale * scale));
+            }
+        }
+        auto const mean_error = static_cast<double>(total_error) / (3 * frame.image->width() * frame.image->height());
+        EXPECT(mean_error < 2.0);
+
+        // Asking for a bigger frame afterwards should decode the image again.
+        EXPECT_EQ(TRY_OR_FAIL(plugin_decoder->frame(0)).image->size(), Gfx::IntSize(592, 800));
+    }
+}
+
 TEST_CASE(test_jpeg_odd_mcu_restart_interval)
 {
     auto file = TRY_OR_FAIL(Core::MappedFile::map(TEST_INPUT("jpg/odd-restart.jpg"sv)));
@@ -559,6 +608,39 @@ TEST_CASE(test_jpeg_grayscale_with_weird_mcu_and_reset_marker)
     TRY_OR_FAIL(expect_single_frame_of_size(*plugin_decoder, { 320, 240 }));
 }
 
+TEST_CASE(test_jpeg_restart_intervals_in_parallel)
+{
+    Array test_inputs = {
+        TEST_INPUT("jpg/odd-restart.jpg"sv),
+        TEST_INPUT("jpg/grayscale_mcu.jpg"sv),
+    };
+
+    for (auto test_input : test_inputs) {
+        auto file = TRY_OR_FAIL(Core::MappedFile::map(test_input));
+        auto reference_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+        auto reference_frame = TRY_OR_FAIL(expect_single_frame(*reference_decoder));
+
+        // More threads than restart intervals should work too.
+        for (unsigned thread_count : { 2u, 3u, 64u }) {
+            auto plugin_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create_with_options(file->bytes(), { .thread_count = thread_count }));
+            auto frame = TRY_OR_FAIL(expect_single_frame_of_size(*plugin_decoder, reference_frame.image->size()));
+
+            for (int y = 0; y < frame.image->height(); ++y)
+                for (int x = 0; x < frame.image->width(); ++x)
+                    EXPECT_EQ(frame.image->get_pixel(x, y), reference_frame.image->get_pixel(x, y));
+        }
+
+        // This is how the ImageDecoder service asks for more threads.
+        auto decoder = TRY_OR_FAIL(Gfx::ImageDecoder::try_create_for_raw_bytes(file->bytes(), {}, { .thread_count = 4 }));
+        EXPECT(decoder);
+        auto frame = TRY_OR_FAIL(decoder->frame(0));
+        EXPECT_EQ(frame.image->size(), reference_frame.image->size());
+        for (int y = 0; y < frame.image->height(); ++y)
+            for (int x = 0; x < frame.image->width(); ++x)
+                EXPECT_EQ(frame.image->get_pixel(x, y), reference_frame.image->get_pixel(x, y));
+    }
+}
+
 TEST_CASE(test_jpeg_malformed_header)
 {
     Array test_inputs = {
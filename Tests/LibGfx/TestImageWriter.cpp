@@ -201,6 +201,24 @@ TEST_CASE(test_png)
     TRY_OR_FAIL((test_roundtrip<Gfx::PNGWriter, Gfx::PNGImageDecoderPlugin>(TRY_OR_FAIL(create_test_rgba_bitmap()))));
 }
 
+TEST_CASE(test_png_threads)
+{
+    // Large enough to be split into several bands.
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 512, 513 }));
+    for (int y = 0; y < bitmap->height(); ++y)
+        for (int x = 0; x < bitmap->width(); ++x)
+            bitmap->set_pixel(x, y, Gfx::Color(x, y, x ^ y, 255 - (x & y)));
+
+    for (unsigned thread_count : { 1u, 2u, 4u }) {
+        Gfx::PNGWriter::Options options;
+        options.thread_count = thread_count;
+
+        auto encoded_data = TRY_OR_FAIL(encode_bitmap<Gfx::PNGWriter>(bitmap, options));
+        auto decoded_bitmap = TRY_OR_FAIL(expect_single_frame_of_size(*TRY_OR_FAIL(Gfx::PNGImageDecoderPlugin::create(encoded_data)), bitmap->size()));
+        expect_bitmaps_equal(*decoded_bitmap, *bitmap);
+    }
+}
+
 TEST_CASE(test_png_paeth_simd)
 {
     for (int a = 0; a < 256; ++a) {
@@ -425,6 +443,20 @@ TEST_CASE(test_webp_color_cache)
     }
 }
 
+TEST_CASE(test_webp_predictor_search)
+{
+    auto bitmap = TRY_OR_FAIL(create_test_rgba_bitmap());
+    for (unsigned thread_count : { 1u, 3u }) {
+        Gfx::WebPEncoderOptions options;
+        options.vp8l_options.search_predictors = true;
+        options.vp8l_options.thread_count = thread_count;
+
+        auto encoded_data = TRY_OR_FAIL(encode_bitmap<Gfx::WebPWriter>(bitmap, options));
+        auto decoded_bitmap = TRY_OR_FAIL(expect_single_frame_of_size(*TRY_OR_FAIL(Gfx::WebPImageDecoderPlugin::create(encoded_data)), bitmap->size()));
+        expect_bitmaps_equal(*decoded_bitmap, *bitmap);
+    }
+}
+
 TEST_CASE(test_webp_icc)
 {
     auto sRGB_icc_profile = MUST(Gfx::ICC::sRGB());
@@ -61,3 +61,85 @@ TEST_CASE(draw_triangle_wave)
     for (int y = -3; y < bitmap->height() + 3; ++y)
         painter.draw_triangle_wave({ 0, y }, { bitmap->width(), y }, Gfx::Color::Red, 3, 2);
 }
+
+TEST_CASE(draw_line_stays_inside_clip_rect)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 10, 10 }));
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(*bitmap);
+    Gfx::IntRect const clip_rect { 0, 4, 10, 3 };
+    painter.add_clip_rect(clip_rect);
+
+    for (auto style : { Gfx::LineStyle::Solid, Gfx::LineStyle::Dotted, Gfx::LineStyle::Dashed }) {
+        for (int thickness : { 1, 3 }) {
+            painter.draw_line({ 0, 3 }, { 9, 3 }, Color::Black, thickness, style);
+            painter.draw_line({ 5, 0 }, { 5, 9 }, Color::Black, thickness, style);
+            painter.draw_line({ 0, 0 }, { 9, 9 }, Color::Black, thickness, style);
+            painter.draw_triangle_wave({ 0, 4 }, { 9, 4 }, Color::Black, 2, thickness);
+        }
+    }
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x) {
+            if (!clip_rect.contains(x, y))
+                EXPECT_EQ(bitmap->get_pixel(x, y), Color::White);
+        }
+    }
+
+    // A thick line that starts above the clip rect still covers the rows of it that it overlaps.
+    EXPECT_EQ(bitmap->get_pixel(0, 4), Color::Black);
+}
+
+TEST_CASE(fill_path_blends_like_color_blend)
+{
+    Gfx::Path path;
+    path.move_to({ 3, 2 });
+    path.line_to({ 37, 2 });
+    path.line_to({ 37, 8 });
+    path.line_to({ 3, 8 });
+    path.close();
+
+    // An opaque background takes the vectorized blending path, a translucent one does not. Both must match Color::blend().
+    for (auto background : { Color(10, 200, 30), Color(10, 200, 30, 128) }) {
+        for (auto color : { Color(250, 20, 100), Color(250, 20, 100, 77), Color(250, 20, 100, 0) }) {
+            auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 40, 10 }));
+            bitmap->fill(background);
+            Gfx::Painter painter(*bitmap);
+            painter.fill_path(path, color);
+            for (int y = 0; y < bitmap->height(); ++y) {
+                for (int x = 0; x < bitmap->width(); ++x) {
+                    bool inside = x >= 3 && x < 37 && y >= 2 && y < 8;
+                    if (inside && color.alpha() != 0)
+                        EXPECT_EQ(bitmap->get_pixel(x, y), background.blend(color));
+                    else if (!inside)
+                        EXPECT_EQ(bitmap->get_pixel(x, y), background);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(fill_path_partial_coverage)
+{
+    Gfx::Path path;
+    path.move_to({ 0.5f, 0 });
+    path.line_to({ 20.5f, 0 });
+    path.line_to({ 20.5f, 4 });
+    path.line_to({ 0.5f, 4 });
+    path.close();
+
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 24, 4 }));
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(*bitmap);
+    painter.fill_path(path, Color::Black);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        // The pixels at either end of the span are only half covered.
+        for (int x : { 0, 20 }) {
+            EXPECT_NE(bitmap->get_pixel(x, y), Color::White);
+            EXPECT_NE(bitmap->get_pixel(x, y), Color::Black);
+        }
+        for (int x = 1; x < 20; ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Color::Black);
+        for (int x = 21; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Color::White);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibGfx/PixelKernels.h>
+
+// Long enough to cover the vector loop of every implementation, plus a tail that doesn't fill a whole vector.
+static constexpr size_t pixel_count = 1000 + 3;
+
+static Vector<Gfx::ARGB32> random_pixels(bool opaque)
+{
+    Vector<Gfx::ARGB32> pixels;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        auto pixel = get_random<Gfx::ARGB32>();
+        // Make sure the special cases of Color::blend() show up often enough.
+        switch (i % 8) {
+        case 0:
+            pixel &= 0x00ffffff;
+            break;
+        case 1:
+            pixel |= 0xff000000;
+            break;
+        default:
+            break;
+        }
+        pixels.append(opaque ? pixel | 0xff000000 : pixel);
+    }
+    return pixels;
+}
+
+static Gfx::PixelKernels::AlphaTable halving_alpha_table()
+{
+    Gfx::PixelKernels::AlphaTable table;
+    for (size_t alpha = 0; alpha < table.size(); ++alpha)
+        table[alpha] = alpha / 2;
+    return table;
+}
+
+static void expect_blend_span_matches_color_blend(bool destination_is_opaque, bool opaque_destination_pixels, Gfx::PixelKernels::AlphaTable const& alpha_table, Gfx::PixelKernels::SourceOrder order)
+{
+    auto source = random_pixels(false);
+    auto destination = random_pixels(opaque_destination_pixels);
+
+    auto expected = destination;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        auto source_color = Color::from_argb(source[i]);
+        if (order == Gfx::PixelKernels::SourceOrder::RGBA)
+            source_color = Color(source_color.blue(), source_color.green(), source_color.red(), source_color.alpha());
+        auto destination_color = destination_is_opaque ? Color::from_rgb(expected[i]) : Color::from_argb(expected[i]);
+        expected[i] = destination_color.blend(source_color.with_alpha(alpha_table[source_color.alpha()])).value();
+    }
+
+    Gfx::PixelKernels::blend_span(destination.data(), source.data(), pixel_count, alpha_table, destination_is_opaque, order);
+    for (size_t i = 0; i < pixel_count; ++i)
+        EXPECT_EQ(destination[i], expected[i]);
+}
+
+TEST_CASE(blend_span_over_opaque_destination)
+{
+    expect_blend_span_matches_color_blend(false, true, Gfx::PixelKernels::identity_alpha_table, Gfx::PixelKernels::SourceOrder::BGRA);
+    expect_blend_span_matches_color_blend(false, true, halving_alpha_table(), Gfx::PixelKernels::SourceOrder::BGRA);
+}
+
+TEST_CASE(blend_span_over_translucent_destination)
+{
+    expect_blend_span_matches_color_blend(false, false, Gfx::PixelKernels::identity_alpha_table, Gfx::PixelKernels::SourceOrder::BGRA);
+    expect_blend_span_matches_color_blend(false, false, halving_alpha_table(), Gfx::PixelKernels::SourceOrder::BGRA);
+}
+
+TEST_CASE(blend_span_ignores_destination_alpha)
+{
+    expect_blend_span_matches_color_blend(true, false, Gfx::PixelKernels::identity_alpha_table, Gfx::PixelKernels::SourceOrder::BGRA);
+    expect_blend_span_matches_color_blend(true, false, halving_alpha_table(), Gfx::PixelKernels::SourceOrder::BGRA);
+}
+
+TEST_CASE(blend_span_rgba_source)
+{
+    expect_blend_span_matches_color_blend(false, true, halving_alpha_table(), Gfx::PixelKernels::SourceOrder::RGBA);
+    expect_blend_span_matches_color_blend(false, false, halving_alpha_table(), Gfx::PixelKernels::SourceOrder::RGBA);
+}
+
+TEST_CASE(swap_red_and_blue)
+{
+    auto source = random_pixels(false);
+    Vector<Gfx::ARGB32> destination;
+    destination.resize(pixel_count);
+
+    Gfx::PixelKernels::swap_red_and_blue(destination.data(), source.data(), pixel_count);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        auto color = Color::from_argb(source[i]);
+        EXPECT_EQ(destination[i], Color(color.blue(), color.green(), color.red(), color.alpha()).value());
+    }
+
+    // Swapping in place twice gets us back to where we started.
+    Gfx::PixelKernels::swap_red_and_blue(destination.data(), destination.data(), pixel_count);
+    EXPECT_EQ(destination, source);
+}
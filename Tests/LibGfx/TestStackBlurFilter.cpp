@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/StackBlurFilter.h>
+
+TEST_CASE(uniform_bitmap_stays_uniform)
+{
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 37, 23 }));
+    bitmap->fill(Color(10, 200, 30, 128));
+
+    Gfx::StackBlurFilter filter(*bitmap);
+    filter.process_rgba(5);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Color(10, 200, 30, 128));
+    }
+}
+
+TEST_CASE(transparent_pixels_take_fill_color)
+{
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 64, 16 }));
+    bitmap->fill(Color::Transparent);
+    bitmap->set_pixel(0, 0, Color::Red);
+
+    Gfx::StackBlurFilter filter(*bitmap);
+    filter.process_rgba(3, Color::Red);
+    // Far away from the only opaque pixel, nothing but the (transparent) fill color is left.
+    EXPECT_EQ(bitmap->get_pixel(63, 15), Color(Color::Red).with_alpha(0));
+    // Close to it, the blur picks up its color without any of the transparent pixels darkening it.
+    auto near = bitmap->get_pixel(1, 1);
+    EXPECT_NE(near.alpha(), 0);
+    EXPECT_EQ(near.with_alpha(0xff), Color(Color::Red));
+}
+
+TEST_CASE(rows_and_columns_are_blurred_alike)
+{
+    // Blurring a bitmap and its transpose has to give transposed results, since both directions use the same kernel.
+    int const width = 41;
+    int const height = 29;
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { width, height }));
+    auto transposed = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { height, width }));
+    u32 seed = 1;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            auto color = Color::from_argb(seed | 0xff000000);
+            bitmap->set_pixel(x, y, color);
+            transposed->set_pixel(y, x, color);
+        }
+    }
+
+    Gfx::StackBlurFilter(*bitmap).process_rgba(7);
+    Gfx::StackBlurFilter(*transposed).process_rgba(7);
+
+    // The two passes run in opposite orders, which makes the results differ by rounding only.
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            auto a = bitmap->get_pixel(x, y);
+            auto b = transposed->get_pixel(y, x);
+            EXPECT(abs(a.red() - b.red()) <= 2);
+            EXPECT(abs(a.green() - b.green()) <= 2);
+            EXPECT(abs(a.blue() - b.blue()) <= 2);
+            EXPECT_EQ(a.alpha(), b.alpha());
+        }
+    }
+}
@@ -82,3 +82,43 @@ TEST_CASE(test_TLS_hello_handshake)
 
     loop.exec();
 }
+
+static ErrorOr<NonnullOwnPtr<TLS::TLSv12>> connect_to_default_server(Vector<Certificate> const& certificates, bool enable_extended_master_secret = true)
+{
+    TLS::Options options;
+    options.set_root_certificates(certificates);
+    options.set_enable_extended_master_secret(enable_extended_master_secret);
+    return TLS::TLSv12::connect(DEFAULT_SERVER, port, move(options));
+}
+
+TEST_CASE(test_TLS_session_resumption)
+{
+    Core::EventLoop loop;
+    auto certificates = TRY_OR_FAIL(load_certificates());
+
+    // The first connection may already resume a session left behind by another test, so only the second one is
+    // guaranteed to.
+    auto first = TRY_OR_FAIL(connect_to_default_server(certificates));
+    EXPECT(first->is_established());
+    first->close();
+
+    auto second = TRY_OR_FAIL(connect_to_default_server(certificates));
+    EXPECT(second->is_established());
+    EXPECT(second->is_resumed_session());
+    second->close();
+}
+
+TEST_CASE(test_TLS_session_is_not_resumed_with_different_options)
+{
+    Core::EventLoop loop;
+    auto certificates = TRY_OR_FAIL(load_certificates());
+
+    auto first = TRY_OR_FAIL(connect_to_default_server(certificates, true));
+    first->close();
+
+    // A session negotiated under one configuration must not be resumed under another.
+    auto second = TRY_OR_FAIL(connect_to_default_server(certificates, false));
+    EXPECT(second->is_established());
+    EXPECT(!second->is_resumed_session());
+    second->close();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+#include <LibTest/TestCase.h>
+
+static TLS::Session make_session(u8 id, Duration lifetime)
+{
+    TLS::Session session;
+    session.session_id = MUST(ByteBuffer::create_zeroed(32));
+    session.session_id[0] = id;
+    session.master_key = MUST(ByteBuffer::create_zeroed(48));
+    session.cipher = TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+    session.expiry = MonotonicTime::now_coarse() + lifetime;
+    return session;
+}
+
+static TLS::SessionKey make_key(StringView host, u16 port = 443, u8 configuration = 0)
+{
+    TLS::SessionKey key { host, port, {} };
+    key.configuration.data[0] = configuration;
+    return key;
+}
+
+TEST_CASE(store_and_find)
+{
+    auto& cache = TLS::SessionCache::the();
+    auto key = make_key("store-and-find.example"sv);
+    cache.store(key, make_session(1, Duration::from_seconds(60)));
+
+    auto session = cache.find(key);
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id[0], 1);
+    EXPECT_EQ(session->cipher, TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256);
+
+    EXPECT(!cache.find(make_key("other-host.example"sv)).has_value());
+
+    cache.store(key, make_session(2, Duration::from_seconds(60)));
+    EXPECT_EQ(cache.find(key)->session_id[0], 2);
+
+    cache.remove(key);
+    EXPECT(!cache.find(key).has_value());
+}
+
+TEST_CASE(sessions_are_kept_apart_by_port_and_configuration)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.store(make_key("kept-apart.example"sv, 443, 1), make_session(1, Duration::from_seconds(60)));
+    cache.store(make_key("kept-apart.example"sv, 8443, 1), make_session(2, Duration::from_seconds(60)));
+    cache.store(make_key("kept-apart.example"sv, 443, 2), make_session(3, Duration::from_seconds(60)));
+
+    EXPECT_EQ(cache.find(make_key("kept-apart.example"sv, 443, 1))->session_id[0], 1);
+    EXPECT_EQ(cache.find(make_key("kept-apart.example"sv, 8443, 1))->session_id[0], 2);
+    EXPECT_EQ(cache.find(make_key("kept-apart.example"sv, 443, 2))->session_id[0], 3);
+    EXPECT(!cache.find(make_key("kept-apart.example"sv, 8443, 2)).has_value());
+
+    cache.remove(make_key("kept-apart.example"sv, 443, 1));
+    EXPECT(!cache.find(make_key("kept-apart.example"sv, 443, 1)).has_value());
+    EXPECT(cache.find(make_key("kept-apart.example"sv, 8443, 1)).has_value());
+    EXPECT(cache.find(make_key("kept-apart.example"sv, 443, 2)).has_value());
+}
+
+TEST_CASE(expired_sessions_are_not_returned)
+{
+    auto& cache = TLS::SessionCache::the();
+    auto key = make_key("expired.example"sv);
+    cache.store(key, make_session(1, Duration::from_seconds(-1)));
+
+    EXPECT(!cache.find(key).has_value());
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Path.h>
+#include <LibTest/TestCase.h>
+#include <LibWeb/Painting/DisplayList.h>
+#include <LibWeb/Painting/DisplayListPlayerCPU.h>
+#include <LibWeb/Painting/DisplayListRecorder.h>
+
+using namespace Web::Painting;
+
+// Odd, so that the band edges of most band counts don't fall on even rows.
+static constexpr Gfx::IntSize viewport_size { 150, 257 };
+
+static void record_scene(DisplayListRecorder& recorder)
+{
+    Gfx::IntRect const viewport_rect { {}, viewport_size };
+    recorder.fill_rect(viewport_rect, Color::White);
+
+    recorder.fill_rect_with_linear_gradient({ 10, 10, 130, 237 }, LinearGradientData { .gradient_angle = 30, .color_stops = { .list = { { Color::Red, 0 }, { Color::Blue, 1 } } } });
+    recorder.fill_ellipse({ 20, 60, 110, 141 }, Color(0, 160, 0, 180));
+    recorder.fill_rect_with_rounded_corners({ 5, 100, 140, 61 }, Color(255, 128, 0), 20);
+    recorder.draw_rect({ 3, 3, 144, 251 }, Color::Black);
+
+    // Lines whose pixels (or dots and dashes) straddle band edges.
+    recorder.draw_line({ 0, 125 }, { 149, 131 }, Color::Black, 3);
+    recorder.draw_line({ 0, 127 }, { 149, 127 }, Color(0, 0, 0, 128), 4);
+    recorder.draw_line({ 140, 0 }, { 140, 256 }, Color::Black, 3, Gfx::LineStyle::Dashed, Color::Red);
+    recorder.draw_line({ 130, 0 }, { 10, 256 }, Color::Black, 2, Gfx::LineStyle::Dotted);
+    recorder.draw_line({ 0, 84 }, { 149, 86 }, Color::DarkRed, 1, Gfx::LineStyle::Dashed);
+    recorder.draw_triangle_wave({ 0, 64 }, { 149, 64 }, Color::DarkBlue, 4, 2);
+    recorder.draw_triangle_wave({ 0, 130 }, { 149, 130 }, Color::DarkGreen, 3, 1);
+    Gfx::Path curve;
+    curve.move_to({ 0, 0 });
+    curve.cubic_bezier_curve_to({ 200, 40 }, { -50, 210 }, { 150, 257 });
+    recorder.stroke_path({
+        .cap_style = Gfx::Path::CapStyle::Round,
+        .join_style = Gfx::Path::JoinStyle::Round,
+        .miter_limit = 4,
+        .path = curve,
+        .color = Color(40, 40, 40, 200),
+        .thickness = 3,
+    });
+
+    // A translucent stacking context is painted into a region of the band and blended back.
+    recorder.push_stacking_context({
+        .opacity = 0.5f,
+        .is_fixed_position = false,
+        .source_paintable_rect = { 30, 50, 90, 150 },
+        .image_rendering = Web::CSS::ImageRendering::Auto,
+        .transform = { .origin = {}, .matrix = Gfx::FloatMatrix4x4::identity() },
+    });
+    recorder.fill_rect({ 0, 0, 90, 150 }, Color::Magenta);
+    recorder.fill_ellipse({ 10, 30, 70, 90 }, Color::Yellow);
+    recorder.pop_stacking_context();
+
+    // Corner clipping samples the pixels under the corners before painting and restores them afterwards.
+    Gfx::IntRect const clipped_rect { 15, 40, 120, 181 };
+    CornerRadii const corner_radii { { 25, 25 }, { 40, 30 }, { 25, 25 }, { 30, 40 } };
+    recorder.sample_under_corners(1, corner_radii, clipped_rect, CornerClip::Outside);
+    recorder.fill_rect(clipped_rect, Color(0, 200, 200, 220));
+    recorder.blit_corner_clipping(1);
+
+    recorder.save();
+    recorder.translate(7, 9);
+    recorder.add_clip_rect({ 0, 70, 140, 120 });
+    recorder.fill_ellipse({ 10, 60, 120, 140 }, Color(128, 0, 128, 128));
+    recorder.restore();
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_target()
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, viewport_size));
+    bitmap->fill(Color::Transparent);
+    return bitmap;
+}
+
+TEST_CASE(banded_playback_matches_sequential_playback)
+{
+    DisplayList display_list;
+    DisplayListRecorder recorder(display_list);
+    record_scene(recorder);
+    EXPECT(display_list.can_be_played_back_in_bands());
+
+    auto sequential = create_target();
+    DisplayListPlayerCPU player(*sequential);
+    display_list.execute(player);
+
+    for (unsigned band_count : { 2u, 3u, 4u, 7u, 16u }) {
+        auto banded = create_target();
+        DisplayListPlayerCPU::execute_in_bands(display_list, *banded, false, band_count);
+
+        size_t mismatched_pixels = 0;
+        for (int y = 0; y < viewport_size.height(); ++y) {
+            for (int x = 0; x < viewport_size.width(); ++x) {
+                if (banded->scanline(y)[x] != sequential->scanline(y)[x]) {
+                    if (mismatched_pixels == 0)
+                        warnln("{} bands: first mismatch at {},{}", band_count, x, y);
+                    ++mismatched_pixels;
+                }
+            }
+        }
+        EXPECT_EQ(mismatched_pixels, 0u);
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/EventLoop.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+#include <LibWeb/Painting/DisplayList.h>
+#include <WebContent/RenderingThread.h>
+#include <unistd.h>
+
+static NonnullRefPtr<Gfx::Bitmap> create_backing_store()
+{
+    return MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 1, 1 }));
+}
+
+static void wait_until(Atomic<bool> const& flag)
+{
+    for (auto i = 0; i < 500; ++i) {
+        if (flag.load())
+            return;
+        usleep(10'000);
+    }
+    FAIL("Timed out waiting for the rendering thread");
+}
+
+struct DestructionCounter {
+    explicit DestructionCounter(Atomic<int>& count)
+        : count(count)
+    {
+    }
+    ~DestructionCounter() { ++count; }
+
+    Atomic<int>& count;
+};
+
+TEST_CASE(renders_synchronously_until_started)
+{
+    Core::EventLoop event_loop;
+    WebContent::RenderingThread rendering_thread([](Web::Painting::DisplayList&, Gfx::Bitmap& bitmap) {
+        bitmap.set_pixel(0, 0, Color::Red);
+    });
+
+    EXPECT(!rendering_thread.has_backing_stores());
+    auto front = create_backing_store();
+    auto back = create_backing_store();
+    front->fill(Color::Blue);
+    rendering_thread.set_backing_stores(1, front, 2, back);
+    EXPECT(rendering_thread.has_backing_stores());
+
+    Optional<i32> presented_bitmap_id;
+    rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&](Optional<i32> front_bitmap_id) {
+        presented_bitmap_id = front_bitmap_id;
+    });
+
+    EXPECT_EQ(presented_bitmap_id, 2);
+    EXPECT_EQ(back->get_pixel(0, 0), Color(Color::Red));
+    EXPECT_EQ(front->get_pixel(0, 0), Color(Color::Blue));
+}
+
+TEST_CASE(renders_on_thread_and_swaps_backing_stores)
+{
+    Core::EventLoop event_loop;
+    WebContent::RenderingThread rendering_thread([](Web::Painting::DisplayList&, Gfx::Bitmap& bitmap) {
+        bitmap.set_pixel(0, 0, Color::Red);
+    });
+    rendering_thread.start();
+
+    auto front = create_backing_store();
+    auto back = create_backing_store();
+    rendering_thread.set_backing_stores(1, front, 2, back);
+
+    Vector<Optional<i32>> presented_bitmap_ids;
+    for (auto i = 0; i < 3; ++i) {
+        rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&](Optional<i32> front_bitmap_id) {
+            presented_bitmap_ids.append(front_bitmap_id);
+        });
+    }
+    event_loop.spin_until([&] { return presented_bitmap_ids.size() == 3; });
+
+    EXPECT_EQ(presented_bitmap_ids, (Vector<Optional<i32>> { 2, 1, 2 }));
+    EXPECT_EQ(front->get_pixel(0, 0), Color(Color::Red));
+    EXPECT_EQ(back->get_pixel(0, 0), Color(Color::Red));
+}
+
+TEST_CASE(frame_is_dropped_if_backing_stores_are_replaced_while_rendering)
+{
+    Core::EventLoop event_loop;
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<bool> player_started { false };
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<bool> player_may_finish { false };
+    IGNORE_USE_IN_ESCAPING_LAMBDA Vector<Gfx::Bitmap*> painted_bitmaps;
+    WebContent::RenderingThread rendering_thread([&](Web::Painting::DisplayList&, Gfx::Bitmap& bitmap) {
+        painted_bitmaps.append(&bitmap);
+        player_started = true;
+        while (!player_may_finish.load())
+            usleep(1'000);
+    });
+    rendering_thread.start();
+
+    auto old_back = create_backing_store();
+    rendering_thread.set_backing_stores(1, create_backing_store(), 2, old_back);
+
+    Vector<Optional<i32>> presented_bitmap_ids;
+    rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&](Optional<i32> front_bitmap_id) {
+        presented_bitmap_ids.append(front_bitmap_id);
+    });
+
+    // Resize the window while the first frame is still being painted into the old back buffer.
+    wait_until(player_started);
+    auto new_back = create_backing_store();
+    rendering_thread.set_backing_stores(3, create_backing_store(), 4, new_back);
+    player_may_finish = true;
+
+    event_loop.spin_until([&] { return presented_bitmap_ids.size() == 1; });
+    EXPECT(!presented_bitmap_ids[0].has_value());
+
+    rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&](Optional<i32> front_bitmap_id) {
+        presented_bitmap_ids.append(front_bitmap_id);
+    });
+    event_loop.spin_until([&] { return presented_bitmap_ids.size() == 2; });
+    EXPECT_EQ(presented_bitmap_ids[1], 4);
+
+    EXPECT_EQ(painted_bitmaps.size(), 2u);
+    EXPECT_EQ(painted_bitmaps[0], old_back.ptr());
+    EXPECT_EQ(painted_bitmaps[1], new_back.ptr());
+}
+
+TEST_CASE(destroying_with_queued_tasks_does_not_hang_or_leak)
+{
+    Core::EventLoop event_loop;
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<bool> player_started { false };
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<bool> player_may_finish { false };
+    Atomic<int> destroyed_callbacks { 0 };
+    int first_callback_calls = 0;
+    int second_callback_calls = 0;
+    RefPtr<Threading::Thread> releaser;
+
+    {
+        WebContent::RenderingThread rendering_thread([&](Web::Painting::DisplayList&, Gfx::Bitmap&) {
+            player_started = true;
+            while (!player_may_finish.load())
+                usleep(1'000);
+        });
+        rendering_thread.start();
+        rendering_thread.set_backing_stores(1, create_backing_store(), 2, create_backing_store());
+
+        rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&, counter = make<DestructionCounter>(destroyed_callbacks)](Optional<i32>) {
+            ++first_callback_calls;
+        });
+        wait_until(player_started);
+        rendering_thread.enqueue_rendering_task(make<Web::Painting::DisplayList>(), [&, counter = make<DestructionCounter>(destroyed_callbacks)](Optional<i32>) {
+            ++second_callback_calls;
+        });
+
+        // Let the first frame finish only once the destructor is already waiting for the thread.
+        releaser = Threading::Thread::construct([&] {
+            usleep(50'000);
+            player_may_finish = true;
+            return static_cast<intptr_t>(0);
+        });
+        releaser->start();
+    }
+    (void)releaser->join();
+
+    // Callbacks of frames that were rendered before teardown are still delivered on the main thread.
+    while (event_loop.pump(Core::EventLoop::WaitMode::PollForEvents) > 0)
+        ;
+
+    EXPECT_EQ(first_callback_calls, 1);
+    EXPECT(second_callback_calls <= 1);
+    EXPECT_EQ(destroyed_callbacks.load(), 2);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <bits/pthread_cancel.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <syscall.h>
+
+extern "C" {
+
+// https://man7.org/linux/man-pages/man2/epoll_create.2.html
+int epoll_create(int size)
+{
+    // NOTE: The size is only a hint, and has been ignored on Linux for a long time too.
+    if (size <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return epoll_create1(0);
+}
+
+int epoll_create1(int flags)
+{
+    int rc = syscall(SC_epoll_create1, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+// https://man7.org/linux/man-pages/man2/epoll_ctl.2.html
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    int rc = syscall(SC_epoll_ctl, epfd, op, fd, event);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+// https://man7.org/linux/man-pages/man2/epoll_wait.2.html
+int epoll_wait(int epfd, struct epoll_event* events, int max_events, int timeout)
+{
+    __pthread_maybe_cancel();
+
+    int rc = syscall(SC_epoll_wait, epfd, events, max_events, timeout);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+}
@@ -493,7 +493,7 @@ DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    VERIFY(m_finished || m_synced);
 }
 
 ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
@@ -504,6 +504,8 @@ ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
 ErrorOr<size_t> DeflateCompressor::write_some(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
+    if (!bytes.is_empty())
+        m_synced = false;
 
     size_t total_written = 0;
     while (!bytes.is_empty()) {
@@ -970,6 +972,23 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size > 0)
+        TRY(flush());
+
+    // An empty, non-final stored block aligns the output to a byte boundary, like zlib's Z_SYNC_FLUSH.
+    TRY(m_output_stream->write_bits(0b000u, 3));
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+
+    m_synced = true;
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
@@ -176,6 +176,11 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Writes out all pending data followed by an empty stored block, leaving the output byte-aligned.
+    // The stream is not finished, so the output can be concatenated with further deflate blocks.
+    // A compressor that has been synced can be destroyed without calling final_flush().
+    ErrorOr<void> sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
@@ -207,6 +212,7 @@ private:
     ErrorOr<void> flush();
 
     bool m_finished { false };
+    bool m_synced { false };
     CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
@@ -89,7 +89,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+static ZlibHeader create_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -108,6 +108,12 @@ ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_met
 
     // FIXME: Support pre-defined dictionaries.
 
+    return header;
+}
+
+ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+{
+    auto header = create_header(compression_method, compression_level);
     TRY(m_output_stream->write_value(header.as_u16));
 
     return {};
@@ -168,4 +174,23 @@ ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompre
     return output_stream->read_until_eof();
 }
 
+ErrorOr<ByteBuffer> ZlibCompressor::join_deflate_streams(ReadonlySpan<ByteBuffer> deflate_streams, u32 adler32, ZlibCompressionLevel compression_level)
+{
+    auto header = create_header(ZlibCompressionMethod::Deflate, compression_level);
+    NetworkOrdered<u32> adler_sum = adler32;
+
+    size_t total_size = sizeof(header.as_u16) + sizeof(adler_sum);
+    for (auto const& deflate_stream : deflate_streams)
+        total_size += deflate_stream.size();
+
+    ByteBuffer buffer;
+    TRY(buffer.try_ensure_capacity(total_size));
+    TRY(buffer.try_append(&header.as_u16, sizeof(header.as_u16)));
+    for (auto const& deflate_stream : deflate_streams)
+        TRY(buffer.try_append(deflate_stream));
+    TRY(buffer.try_append(&adler_sum, sizeof(adler_sum)));
+
+    return buffer;
+}
+
 }
@@ -75,6 +75,11 @@ public:
 
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
 
+    // Wraps independently compressed deflate streams into a single zlib stream. All streams but the last one
+    // must have been ended with DeflateCompressor::sync_flush(), and the last one with DeflateCompressor::final_flush().
+    // `adler32` is the checksum of the concatenated uncompressed data.
+    static ErrorOr<ByteBuffer> join_deflate_streams(ReadonlySpan<ByteBuffer> deflate_streams, u32 adler32, ZlibCompressionLevel = ZlibCompressionLevel::Default);
+
 private:
     ZlibCompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<Stream> compressor_stream);
     ErrorOr<void> write_header(ZlibCompressionMethod, ZlibCompressionLevel);
@@ -20,6 +20,12 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+// NOTE: Linux has epoll too, but Lagom keeps using poll() there for now.
+#ifdef AK_OS_SERENITY
+#    define EVENT_LOOP_HAS_EPOLL
+#    include <sys/epoll.h>
+#endif
+
 namespace Core {
 
 namespace {
@@ -48,6 +54,25 @@ bool has_flag(int value, int flag)
     return (value & flag) == flag;
 }
 
+#ifdef EVENT_LOOP_HAS_EPOLL
+u32 notification_type_to_epoll_events(NotificationType type)
+{
+    u32 events = 0;
+    if (has_flag(type, NotificationType::Read))
+        events |= EPOLLIN;
+    if (has_flag(type, NotificationType::Write))
+        events |= EPOLLOUT;
+    return events;
+}
+#endif
+
+void post_notifier_activation(Notifier& notifier, NotificationType type)
+{
+    type &= notifier.type();
+    if (type != NotificationType::None)
+        ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
+}
+
 class EventLoopTimeout {
 public:
     static constexpr ssize_t INVALID_INDEX = NumericLimits<ssize_t>::max();
@@ -256,10 +281,17 @@ struct ThreadData {
     {
         pid = getpid();
         initialize_wake_pipe();
+#ifdef EVENT_LOOP_HAS_EPOLL
+        initialize_epoll();
+#endif
     }
 
     ~ThreadData()
     {
+#ifdef EVENT_LOOP_HAS_EPOLL
+        if (epoll_fd != -1)
+            close(epoll_fd);
+#endif
         pthread_rwlock_wrlock(&*s_thread_data_lock);
         s_thread_data.remove(s_thread_id);
         pthread_rwlock_unlock(&*s_thread_data_lock);
@@ -286,6 +318,120 @@ struct ThreadData {
         notifier_by_index.append(nullptr);
     }
 
+    bool uses_epoll() const
+    {
+#ifdef EVENT_LOOP_HAS_EPOLL
+        return epoll_fd != -1;
+#else
+        return false;
+#endif
+    }
+
+    ErrorOr<int> wait_for_fds(int timeout)
+    {
+#ifdef EVENT_LOOP_HAS_EPOLL
+        if (uses_epoll())
+            return System::epoll_wait(epoll_fd, epoll_events, timeout);
+#endif
+        return System::poll(poll_fds, timeout);
+    }
+
+    bool wake_pipe_is_readable([[maybe_unused]] int marked_fd_count) const
+    {
+#ifdef EVENT_LOOP_HAS_EPOLL
+        if (uses_epoll()) {
+            for (int i = 0; i < marked_fd_count; ++i) {
+                if (epoll_events[i].data.fd == wake_pipe_fds[0] && has_flag(epoll_events[i].events, EPOLLIN))
+                    return true;
+            }
+            return false;
+        }
+#endif
+        return has_flag(poll_fds[0].revents, POLLIN);
+    }
+
+    void post_notifier_activations(int marked_fd_count)
+    {
+#ifdef EVENT_LOOP_HAS_EPOLL
+        if (uses_epoll()) {
+            for (int i = 0; i < marked_fd_count; ++i) {
+                auto const& event = epoll_events[i];
+                auto it = notifiers_by_fd.find(event.data.fd);
+                if (it == notifiers_by_fd.end())
+                    continue;
+
+                NotificationType type = NotificationType::None;
+                if (has_flag(event.events, EPOLLIN))
+                    type |= NotificationType::Read;
+                if (has_flag(event.events, EPOLLOUT))
+                    type |= NotificationType::Write;
+                if (has_flag(event.events, EPOLLHUP))
+                    type |= NotificationType::HangUp;
+                if (has_flag(event.events, EPOLLERR))
+                    type |= NotificationType::Error;
+                for (auto* notifier : it->value)
+                    post_notifier_activation(*notifier, type);
+            }
+            return;
+        }
+#endif
+        if (marked_fd_count == 0)
+            return;
+        for (size_t i = 1; i < poll_fds.size(); ++i) {
+            auto& revents = poll_fds[i].revents;
+            auto& notifier = *notifier_by_index[i];
+
+            NotificationType type = NotificationType::None;
+            if (has_flag(revents, POLLIN))
+                type |= NotificationType::Read;
+            if (has_flag(revents, POLLOUT))
+                type |= NotificationType::Write;
+            if (has_flag(revents, POLLHUP))
+                type |= NotificationType::HangUp;
+            if (has_flag(revents, POLLERR))
+                type |= NotificationType::Error;
+            post_notifier_activation(notifier, type);
+        }
+    }
+
+#ifdef EVENT_LOOP_HAS_EPOLL
+    void initialize_epoll()
+    {
+        // NOTE: After a fork, the parent's epoll instance is shared with us, so we need one of our own.
+        if (epoll_fd != -1)
+            close(epoll_fd);
+        epoll_fd = -1;
+        notifiers_by_fd.clear();
+
+        auto result = Core::System::epoll_create1(EPOLL_CLOEXEC);
+        if (result.is_error()) {
+            dbgln("EventLoopImplementationUnix: Falling back to poll(), since we couldn't create an epoll instance: {}", result.error());
+            return;
+        }
+        epoll_fd = result.release_value();
+
+        epoll_event event { .events = EPOLLIN, .data = { .fd = wake_pipe_fds[0] } };
+        MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+    }
+
+    void update_epoll_interest(int fd, int op)
+    {
+        epoll_event event { .events = 0, .data = { .fd = fd } };
+        for (auto* notifier : notifiers_by_fd.find(fd)->value)
+            event.events |= notification_type_to_epoll_events(notifier->type());
+
+        auto result = Core::System::epoll_ctl(epoll_fd, op, fd, &event);
+        if (result.is_error() && result.error().code() == EEXIST)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        // NOTE: Closing an fd drops it from the interest set, even if some notifier for it is still around. If the
+        //       fd number has been reused since, our notifiers think it's registered when it isn't.
+        if (result.is_error() && result.error().code() == ENOENT)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (result.is_error())
+            dbgln("EventLoopImplementationUnix: Failed to update epoll interest for fd {}: {}", fd, result.error());
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
@@ -297,6 +443,15 @@ struct ThreadData {
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
     Array<int, 2> wake_pipe_fds { -1, -1 };
 
+#ifdef EVENT_LOOP_HAS_EPOLL
+    // Where available, notifiers are kept in an epoll interest set instead of poll_fds. The kernel then only tells us
+    // about the fds that are ready, so waiting doesn't get slower with every notifier that's merely registered.
+    // Several notifiers can share an fd, so the interest set has the union of their types.
+    int epoll_fd { -1 };
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+    Array<epoll_event, 64> epoll_events;
+#endif
+
     pid_t pid { 0 };
 };
 }
@@ -383,7 +538,7 @@ retry:
 
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+    ErrorOr<int> error_or_marked_fd_count = thread_data.wait_for_fds(should_wait_forever ? -1 : timeout);
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -395,7 +550,7 @@ try_select_again:
 
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (thread_data.wake_pipe_is_readable(error_or_marked_fd_count.value())) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -424,26 +579,8 @@ try_select_again:
             goto retry;
     }
 
-    if (error_or_marked_fd_count.value() != 0) {
-        // Handle file system notifiers by making them normal events.
-        for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
-            auto& revents = thread_data.poll_fds[i].revents;
-            auto& notifier = *thread_data.notifier_by_index[i];
-
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
-            type &= notifier.type();
-            if (type != NotificationType::None)
-                ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
-        }
-    }
+    // Handle file system notifiers by making them normal events.
+    thread_data.post_notifier_activations(error_or_marked_fd_count.value());
 
     // Handle expired timers.
     thread_data.timeouts.fire_expired(time_after_poll);
@@ -524,6 +661,9 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
     thread_data.initialize_wake_pipe();
+#ifdef EVENT_LOOP_HAS_EPOLL
+    thread_data.initialize_epoll();
+#endif
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
         info->next_signal_id = 0;
@@ -678,6 +818,16 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef EVENT_LOOP_HAS_EPOLL
+    if (thread_data.uses_epoll()) {
+        auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+        notifiers.append(&notifier);
+        thread_data.update_epoll_interest(notifier.fd(), notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+        notifier.set_owner_thread(s_thread_id);
+        return;
+    }
+#endif
+
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -696,6 +846,24 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
         return;
 
     auto& thread_data = *thread_data_ptr;
+
+#ifdef EVENT_LOOP_HAS_EPOLL
+    if (thread_data.uses_epoll()) {
+        auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+        VERIFY(it != thread_data.notifiers_by_fd.end());
+        it->value.remove_first_matching([&](auto* other_notifier) { return other_notifier == &notifier; });
+        if (!it->value.is_empty()) {
+            thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+            return;
+        }
+        thread_data.notifiers_by_fd.remove(it);
+        // NOTE: This fails if the fd has been closed already, which removes it from the interest set anyway.
+        epoll_event event {};
+        (void)Core::System::epoll_ctl(thread_data.epoll_fd, EPOLL_CTL_DEL, notifier.fd(), &event);
+        return;
+    }
+#endif
+
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -33,7 +33,9 @@ private:
     using StorageType = AK::UFixedBigInt<bit_size>;
     using StorageTypeX2 = AK::UFixedBigInt<bit_size * 2>;
 
-    struct JacobianPoint {
+    // Homogeneous projective coordinates, where (X, Y, Z) stands for the affine point (X/Z, Y/Z)
+    // and any point with Z = 0 is the point at infinity.
+    struct ProjectivePoint {
         StorageType x;
         StorageType y;
         StorageType z;
@@ -124,6 +126,15 @@ private:
         return r2 % modulus;
     }
 
+    static constexpr StorageType calculate_montgomery_form(StorageType value, StorageType modulus)
+    {
+        // Calculate the value of value * R mod modulus, where R = 2^bit_size
+        using StorageTypeX2P1 = AK::UFixedBigInt<bit_size * 2 + 1>;
+
+        StorageTypeX2P1 value_r = static_cast<StorageTypeX2P1>(value) << KEY_BIT_SIZE;
+        return value_r % modulus;
+    }
+
     // Verify that A = -3 mod p, which is required for some optimizations
     static_assert(A == PRIME - 3);
 
@@ -134,6 +145,19 @@ private:
     static constexpr StorageType ORDER_INVERSE_MOD_R = StorageType { 0 } - calculate_modular_inverse_mod_r(ORDER);
     static constexpr StorageType R2_MOD_PRIME = calculate_r2_mod(PRIME);
     static constexpr StorageType R2_MOD_ORDER = calculate_r2_mod(ORDER);
+    static constexpr StorageType B_MONTGOMERY = calculate_montgomery_form(B, PRIME);
+
+    // Scalar multiplication processes the scalar in fixed-size windows of WINDOW_BITS bits
+    static constexpr size_t WINDOW_BITS = 4;
+    static constexpr size_t WINDOW_SIZE = 1 << WINDOW_BITS;
+    static constexpr size_t WINDOW_COUNT = KEY_BIT_SIZE / WINDOW_BITS;
+    static_assert(KEY_BIT_SIZE % WINDOW_BITS == 0);
+
+    // table[j] = j * P for some point P
+    using PointTable = Array<ProjectivePoint, WINDOW_SIZE>;
+
+    // table[i][j] = j * 2^(i * WINDOW_BITS) * G, for the generator point G
+    using GeneratorTable = Array<PointTable, WINDOW_COUNT>;
 
 public:
     size_t key_size() override { return POINT_BYTE_SIZE; }
@@ -147,7 +171,12 @@ public:
 
     ErrorOr<ByteBuffer> generate_public_key(ReadonlyBytes a) override
     {
-        return compute_coordinate(a, GENERATOR_POINT);
+        AK::FixedMemoryStream scalar_stream { a };
+
+        StorageType scalar = TRY(scalar_stream.read_value<BigEndian<StorageType>>());
+        ProjectivePoint result = TRY(generate_public_key_internal(scalar));
+
+        return write_uncompressed_point(result);
     }
 
     ErrorOr<ByteBuffer> compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes) override
@@ -156,16 +185,10 @@ public:
         AK::FixedMemoryStream point_stream { point_bytes };
 
         StorageType scalar = TRY(scalar_stream.read_value<BigEndian<StorageType>>());
-        JacobianPoint point = TRY(read_uncompressed_point(point_stream));
-        JacobianPoint result = TRY(compute_coordinate_internal(scalar, point));
+        ProjectivePoint point = TRY(read_uncompressed_point(point_stream));
+        ProjectivePoint result = TRY(compute_coordinate_internal(scalar, point));
 
-        // Export the values into an output buffer
-        auto buf = TRY(ByteBuffer::create_uninitialized(POINT_BYTE_SIZE));
-        AK::FixedMemoryStream buf_stream { buf.bytes() };
-        TRY(buf_stream.write_value<u8>(0x04));
-        TRY(buf_stream.write_value<BigEndian<StorageType>>(result.x));
-        TRY(buf_stream.write_value<BigEndian<StorageType>>(result.y));
-        return buf;
+        return write_uncompressed_point(result);
     }
 
     ErrorOr<ByteBuffer> derive_premaster_key(ReadonlyBytes shared_point) override
@@ -208,7 +231,7 @@ public:
         }
 
         AK::FixedMemoryStream pubkey_stream { pubkey };
-        JacobianPoint pubkey_point = TRY(read_uncompressed_point(pubkey_stream));
+        ProjectivePoint pubkey_point = TRY(read_uncompressed_point(pubkey_stream));
 
         StorageType r_mo = to_montgomery_order(r);
         StorageType s_mo = to_montgomery_order(s);
@@ -222,27 +245,16 @@ public:
         u1 = from_montgomery_order(u1);
         u2 = from_montgomery_order(u2);
 
-        JacobianPoint point1 = TRY(generate_public_key_internal(u1));
-        JacobianPoint point2 = TRY(compute_coordinate_internal(u2, pubkey_point));
-
-        // Convert the input point into Montgomery form
-        point1.x = to_montgomery(point1.x);
-        point1.y = to_montgomery(point1.y);
-        point1.z = to_montgomery(point1.z);
-
-        VERIFY(is_point_on_curve(point1));
-
-        // Convert the input point into Montgomery form
-        point2.x = to_montgomery(point2.x);
-        point2.y = to_montgomery(point2.y);
-        point2.z = to_montgomery(point2.z);
-
-        VERIFY(is_point_on_curve(point2));
+        // Both products stay in projective coordinates, so only the final sum needs a conversion to affine coordinates
+        ProjectivePoint point1 = TRY(multiply_generator(u1));
+        ProjectivePoint point2 = TRY(multiply_point(u2, pubkey_point));
 
-        JacobianPoint result = point_add(point1, point2);
+        ProjectivePoint result = point_add(point1, point2);
+        if (modular_reduce(result.z).is_zero_constant_time())
+            return false;
 
-        // Convert from Jacobian coordinates back to Affine coordinates
-        convert_jacobian_to_affine(result);
+        // Convert from projective coordinates back to Affine coordinates
+        convert_projective_to_affine(result);
 
         // Make sure the resulting point is on the curve
         VERIFY(is_point_on_curve(result));
@@ -258,14 +270,39 @@ public:
     }
 
 private:
-    ErrorOr<JacobianPoint> generate_public_key_internal(StorageType a)
+    ErrorOr<ProjectivePoint> generate_public_key_internal(StorageType scalar)
     {
-        AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT };
-        JacobianPoint point = TRY(read_uncompressed_point(generator_point_stream));
-        return compute_coordinate_internal(a, point);
+        ProjectivePoint result = TRY(multiply_generator(scalar));
+        return convert_to_output_point(result);
     }
 
-    ErrorOr<JacobianPoint> compute_coordinate_internal(StorageType scalar, JacobianPoint point)
+    ErrorOr<ProjectivePoint> compute_coordinate_internal(StorageType scalar, ProjectivePoint point)
+    {
+        ProjectivePoint result = TRY(multiply_point(scalar, point));
+        return convert_to_output_point(result);
+    }
+
+    ErrorOr<ProjectivePoint> multiply_generator(StorageType scalar)
+    {
+        // FIXME: This will slightly bias the distribution of client secrets
+        scalar = modular_reduce_order(scalar);
+        if (scalar.is_zero_constant_time())
+            return Error::from_string_literal("SECPxxxr1: scalar is zero");
+
+        auto const& table = generator_table();
+
+        // Every window of the scalar has its own table of precomputed multiples of G, so the
+        // result is a sum of one table entry per window, without any point doublings.
+        // The addition formulas are complete, so zero windows and the point at infinity take
+        // exactly the same path as every other value.
+        ProjectivePoint result = point_at_infinity();
+        for (size_t i = 0; i < WINDOW_COUNT; i++)
+            result = point_add(result, select_from_table(table[i], window_at(scalar, i)));
+
+        return result;
+    }
+
+    ErrorOr<ProjectivePoint> multiply_point(StorageType scalar, ProjectivePoint point)
     {
         // FIXME: This will slightly bias the distribution of client secrets
         scalar = modular_reduce_order(scalar);
@@ -281,24 +318,26 @@ private:
         if (!is_point_on_curve(point))
             return Error::from_string_literal("SECPxxxr1: point is not on the curve");
 
-        JacobianPoint result { 0, 0, 0 };
-        JacobianPoint temp_result { 0, 0, 0 };
-
-        // Calculate the scalar times point multiplication in constant time
-        for (size_t i = 0; i < KEY_BIT_SIZE; i++) {
-            temp_result = point_add(result, point);
+        PointTable table;
+        build_point_table(point, table);
 
-            auto condition = (scalar & 1u) == 1u;
-            result.x = select(result.x, temp_result.x, condition);
-            result.y = select(result.y, temp_result.y, condition);
-            result.z = select(result.z, temp_result.z, condition);
+        // Calculate the scalar times point multiplication using a fixed window, starting at the most significant window.
+        // Every window performs the same sequence of operations, regardless of the value of the scalar.
+        ProjectivePoint result = point_at_infinity();
+        for (size_t i = WINDOW_COUNT; i > 0; i--) {
+            for (size_t j = 0; j < WINDOW_BITS; j++)
+                result = point_double(result);
 
-            point = point_double(point);
-            scalar >>= 1u;
+            result = point_add(result, select_from_table(table, window_at(scalar, i - 1)));
         }
 
-        // Convert from Jacobian coordinates back to Affine coordinates
-        convert_jacobian_to_affine(result);
+        return result;
+    }
+
+    ProjectivePoint convert_to_output_point(ProjectivePoint result)
+    {
+        // Convert from projective coordinates back to Affine coordinates
+        convert_projective_to_affine(result);
 
         // Make sure the resulting point is on the curve
         VERIFY(is_point_on_curve(result));
@@ -315,13 +354,82 @@ private:
         return result;
     }
 
-    static ErrorOr<JacobianPoint> read_uncompressed_point(Stream& stream)
+    GeneratorTable const& generator_table()
+    {
+        // The table only depends on the curve parameters, so it is computed once and shared between all instances
+        static GeneratorTable const table = build_generator_table();
+        return table;
+    }
+
+    GeneratorTable build_generator_table()
+    {
+        AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT };
+        ProjectivePoint base = MUST(read_uncompressed_point(generator_point_stream));
+
+        // Convert the generator point into Montgomery form
+        base.x = to_montgomery(base.x);
+        base.y = to_montgomery(base.y);
+        base.z = to_montgomery(base.z);
+
+        GeneratorTable table;
+        for (size_t i = 0; i < WINDOW_COUNT; i++) {
+            build_point_table(base, table[i]);
+
+            // The base of the next window is 2^WINDOW_BITS times the base of this window
+            base = point_double(table[i][WINDOW_SIZE / 2]);
+        }
+
+        return table;
+    }
+
+    void build_point_table(ProjectivePoint const& point, PointTable& table)
+    {
+        table[0] = point_at_infinity();
+        table[1] = point;
+        for (size_t i = 2; i < WINDOW_SIZE; i += 2) {
+            table[i] = point_double(table[i / 2]);
+            table[i + 1] = point_add(table[i], point);
+        }
+    }
+
+    static constexpr u8 window_at(StorageType const& scalar, size_t index)
+    {
+        return static_cast<u8>(scalar >> (index * WINDOW_BITS)) & (WINDOW_SIZE - 1);
+    }
+
+    ProjectivePoint select_from_table(PointTable const& table, u8 index)
+    {
+        // Always scan the entire table, so the memory access pattern does not depend on the (secret) index
+        ProjectivePoint result = table[0];
+        for (size_t i = 1; i < WINDOW_SIZE; i++)
+            result = select_point(result, table[i], i == index);
+
+        return result;
+    }
+
+    constexpr ProjectivePoint point_at_infinity()
+    {
+        return ProjectivePoint { 0u, to_montgomery(1u), 0u };
+    }
+
+    static ErrorOr<ByteBuffer> write_uncompressed_point(ProjectivePoint const& point)
+    {
+        // Export the values into an output buffer
+        auto buf = TRY(ByteBuffer::create_uninitialized(POINT_BYTE_SIZE));
+        AK::FixedMemoryStream buf_stream { buf.bytes() };
+        TRY(buf_stream.write_value<u8>(0x04));
+        TRY(buf_stream.write_value<BigEndian<StorageType>>(point.x));
+        TRY(buf_stream.write_value<BigEndian<StorageType>>(point.y));
+        return buf;
+    }
+
+    static ErrorOr<ProjectivePoint> read_uncompressed_point(Stream& stream)
     {
         // Make sure the point is uncompressed
         if (TRY(stream.read_value<u8>()) != 0x04)
             return Error::from_string_literal("SECPxxxr1: point is not uncompressed format");
 
-        JacobianPoint point {
+        ProjectivePoint point {
             TRY(stream.read_value<BigEndian<StorageType>>()),
             TRY(stream.read_value<BigEndian<StorageType>>()),
             1u,
@@ -339,6 +447,16 @@ private:
         return (left & mask) | (right & ~mask);
     }
 
+    constexpr ProjectivePoint select_point(ProjectivePoint const& left, ProjectivePoint const& right, bool condition)
+    {
+        // If condition = 0 return left else right
+        return ProjectivePoint {
+            select(left.x, right.x, condition),
+            select(left.y, right.y, condition),
+            select(left.z, right.z, condition),
+        };
+    }
+
     constexpr StorageType modular_reduce(StorageType const& value)
     {
         // Add -prime % 2^KEY_BIT_SIZE
@@ -522,136 +640,113 @@ private:
         return result;
     }
 
-    JacobianPoint point_double(JacobianPoint const& point)
-    {
-        // Based on "Point Doubling" from http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
-
-        // if (Y == 0)
-        //   return POINT_AT_INFINITY
-        if (point.y.is_zero_constant_time()) {
-            VERIFY_NOT_REACHED();
-        }
-
-        StorageType temp;
-
-        // Y2 = Y^2
-        StorageType y2 = modular_square(point.y);
-
-        // S = 4*X*Y2
-        StorageType s = modular_multiply(point.x, y2);
-        s = modular_add(s, s);
-        s = modular_add(s, s);
-
-        // M = 3*X^2 + a*Z^4 = 3*(X + Z^2)*(X - Z^2)
-        // This specific equation from https://github.com/earlephilhower/bearssl-esp8266/blob/6105635531027f5b298aa656d44be2289b2d434f/src/ec/ec_p256_m64.c#L811-L816
-        // This simplification only works because a = -3 mod p
-        temp = modular_square(point.z);
-        StorageType m = modular_add(point.x, temp);
-        temp = modular_sub(point.x, temp);
-        m = modular_multiply(m, temp);
-        temp = modular_add(m, m);
-        m = modular_add(m, temp);
-
-        // X' = M^2 - 2*S
-        StorageType xp = modular_square(m);
-        xp = modular_sub(xp, s);
-        xp = modular_sub(xp, s);
-
-        // Y' = M*(S - X') - 8*Y2^2
-        StorageType yp = modular_sub(s, xp);
-        yp = modular_multiply(yp, m);
-        temp = modular_square(y2);
-        temp = modular_add(temp, temp);
-        temp = modular_add(temp, temp);
-        temp = modular_add(temp, temp);
-        yp = modular_sub(yp, temp);
-
-        // Z' = 2*Y*Z
-        StorageType zp = modular_multiply(point.y, point.z);
-        zp = modular_add(zp, zp);
-
-        // return (X', Y', Z')
-        return JacobianPoint { xp, yp, zp };
-    }
-
-    JacobianPoint point_add(JacobianPoint const& point_a, JacobianPoint const& point_b)
-    {
-        // Based on "Point Addition" from  http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
-        if (point_a.x.is_zero_constant_time() && point_a.y.is_zero_constant_time() && point_a.z.is_zero_constant_time()) {
-            return point_b;
-        }
-
-        StorageType temp;
-
-        temp = modular_square(point_b.z);
-        // U1 = X1*Z2^2
-        StorageType u1 = modular_multiply(point_a.x, temp);
-        // S1 = Y1*Z2^3
-        StorageType s1 = modular_multiply(point_a.y, temp);
-        s1 = modular_multiply(s1, point_b.z);
-
-        temp = modular_square(point_a.z);
-        // U2 = X2*Z1^2
-        StorageType u2 = modular_multiply(point_b.x, temp);
-        // S2 = Y2*Z1^3
-        StorageType s2 = modular_multiply(point_b.y, temp);
-        s2 = modular_multiply(s2, point_a.z);
-
-        // if (U1 == U2)
-        //   if (S1 != S2)
-        //     return POINT_AT_INFINITY
-        //   else
-        //     return POINT_DOUBLE(X1, Y1, Z1)
-        if (u1.is_equal_to_constant_time(u2)) {
-            if (s1.is_equal_to_constant_time(s2)) {
-                return point_double(point_a);
-            } else {
-                VERIFY_NOT_REACHED();
-            }
-        }
-
-        // H = U2 - U1
-        StorageType h = modular_sub(u2, u1);
-        StorageType h2 = modular_square(h);
-        StorageType h3 = modular_multiply(h2, h);
-        // R = S2 - S1
-        StorageType r = modular_sub(s2, s1);
-        // X3 = R^2 - H^3 - 2*U1*H^2
-        StorageType x3 = modular_square(r);
-        x3 = modular_sub(x3, h3);
-        temp = modular_multiply(u1, h2);
-        temp = modular_add(temp, temp);
-        x3 = modular_sub(x3, temp);
-        // Y3 = R*(U1*H^2 - X3) - S1*H^3
-        StorageType y3 = modular_multiply(u1, h2);
-        y3 = modular_sub(y3, x3);
-        y3 = modular_multiply(y3, r);
-        temp = modular_multiply(s1, h3);
-        y3 = modular_sub(y3, temp);
-        // Z3 = H*Z1*Z2
-        StorageType z3 = modular_multiply(h, point_a.z);
-        z3 = modular_multiply(z3, point_b.z);
-        // return (X3, Y3, Z3)
-        return JacobianPoint { x3, y3, z3 };
-    }
-
-    void convert_jacobian_to_affine(JacobianPoint& point)
-    {
-        StorageType temp;
-        // X' = X/Z^2
-        temp = modular_square(point.z);
-        temp = modular_inverse(temp);
-        point.x = modular_multiply(point.x, temp);
-        // Y' = Y/Z^3
-        temp = modular_square(point.z);
-        temp = modular_multiply(temp, point.z);
-        temp = modular_inverse(temp);
-        point.y = modular_multiply(point.y, temp);
+    ProjectivePoint point_double(ProjectivePoint const& point)
+    {
+        // Complete doubling formula for a = -3, "Algorithm 6" from https://eprint.iacr.org/2015/1060.pdf
+        // It gives the right result for every input, including the point at infinity and points of order two,
+        // so it never needs to branch on the (secret) coordinates.
+        StorageType t0 = modular_square(point.x);
+        StorageType t1 = modular_square(point.y);
+        StorageType t2 = modular_square(point.z);
+        StorageType t3 = modular_multiply(point.x, point.y);
+        t3 = modular_add(t3, t3);
+        StorageType z3 = modular_multiply(point.x, point.z);
+        z3 = modular_add(z3, z3);
+        StorageType y3 = modular_multiply(B_MONTGOMERY, t2);
+        y3 = modular_sub(y3, z3);
+        StorageType x3 = modular_add(y3, y3);
+        y3 = modular_add(x3, y3);
+        x3 = modular_sub(t1, y3);
+        y3 = modular_add(t1, y3);
+        y3 = modular_multiply(x3, y3);
+        x3 = modular_multiply(x3, t3);
+        t3 = modular_add(t2, t2);
+        t2 = modular_add(t2, t3);
+        z3 = modular_multiply(B_MONTGOMERY, z3);
+        z3 = modular_sub(z3, t2);
+        z3 = modular_sub(z3, t0);
+        t3 = modular_add(z3, z3);
+        z3 = modular_add(z3, t3);
+        t3 = modular_add(t0, t0);
+        t0 = modular_add(t3, t0);
+        t0 = modular_sub(t0, t2);
+        t0 = modular_multiply(t0, z3);
+        y3 = modular_add(y3, t0);
+        t0 = modular_multiply(point.y, point.z);
+        t0 = modular_add(t0, t0);
+        z3 = modular_multiply(t0, z3);
+        x3 = modular_sub(x3, z3);
+        z3 = modular_multiply(t0, t1);
+        z3 = modular_add(z3, z3);
+        z3 = modular_add(z3, z3);
+
+        return ProjectivePoint { x3, y3, z3 };
+    }
+
+    ProjectivePoint point_add(ProjectivePoint const& point_a, ProjectivePoint const& point_b)
+    {
+        // Complete addition formula for a = -3, "Algorithm 4" from https://eprint.iacr.org/2015/1060.pdf
+        // It gives the right result for every pair of inputs, including the point at infinity, P + P and P + -P,
+        // so it never needs to branch on the (secret) coordinates.
+        StorageType t0 = modular_multiply(point_a.x, point_b.x);
+        StorageType t1 = modular_multiply(point_a.y, point_b.y);
+        StorageType t2 = modular_multiply(point_a.z, point_b.z);
+        StorageType t3 = modular_add(point_a.x, point_a.y);
+        StorageType t4 = modular_add(point_b.x, point_b.y);
+        t3 = modular_multiply(t3, t4);
+        t4 = modular_add(t0, t1);
+        t3 = modular_sub(t3, t4);
+        t4 = modular_add(point_a.y, point_a.z);
+        StorageType x3 = modular_add(point_b.y, point_b.z);
+        t4 = modular_multiply(t4, x3);
+        x3 = modular_add(t1, t2);
+        t4 = modular_sub(t4, x3);
+        x3 = modular_add(point_a.x, point_a.z);
+        StorageType y3 = modular_add(point_b.x, point_b.z);
+        x3 = modular_multiply(x3, y3);
+        y3 = modular_add(t0, t2);
+        y3 = modular_sub(x3, y3);
+        StorageType z3 = modular_multiply(B_MONTGOMERY, t2);
+        x3 = modular_sub(y3, z3);
+        z3 = modular_add(x3, x3);
+        x3 = modular_add(x3, z3);
+        z3 = modular_sub(t1, x3);
+        x3 = modular_add(t1, x3);
+        y3 = modular_multiply(B_MONTGOMERY, y3);
+        t1 = modular_add(t2, t2);
+        t2 = modular_add(t1, t2);
+        y3 = modular_sub(y3, t2);
+        y3 = modular_sub(y3, t0);
+        t1 = modular_add(y3, y3);
+        y3 = modular_add(t1, y3);
+        t1 = modular_add(t0, t0);
+        t0 = modular_add(t1, t0);
+        t0 = modular_sub(t0, t2);
+        t1 = modular_multiply(t4, y3);
+        t2 = modular_multiply(t0, y3);
+        y3 = modular_multiply(x3, z3);
+        y3 = modular_add(y3, t2);
+        x3 = modular_multiply(t3, x3);
+        x3 = modular_sub(x3, t1);
+        z3 = modular_multiply(t4, z3);
+        t1 = modular_multiply(t3, t0);
+        z3 = modular_add(z3, t1);
+
+        return ProjectivePoint { x3, y3, z3 };
+    }
+
+    void convert_projective_to_affine(ProjectivePoint& point)
+    {
+        StorageType z_inverse = modular_inverse(point.z);
+        // X' = X/Z
+        point.x = modular_multiply(point.x, z_inverse);
+        // Y' = Y/Z
+        point.y = modular_multiply(point.y, z_inverse);
         // Z' = 1
         point.z = to_montgomery(1u);
     }
 
-    bool is_point_on_curve(JacobianPoint const& point)
+    bool is_point_on_curve(ProjectivePoint const& point)
     {
         // This check requires the point to be in Montgomery form, with Z=1
         StorageType temp, temp2;
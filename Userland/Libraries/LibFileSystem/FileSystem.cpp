@@ -193,6 +193,30 @@ static ErrorOr<ByteString> get_duplicate_file_name(StringView path)
     return current_name;
 }
 
+// Has the kernel copy whatever is left of source, so the data doesn't have to come through our buffer.
+// Returns false if the kernel can't do that for these files, before anything has been copied.
+static ErrorOr<bool> copy_file_contents_in_kernel([[maybe_unused]] Core::File& destination, [[maybe_unused]] Core::File& source)
+{
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    static constexpr size_t chunk_size = 16 * MiB;
+    bool copied_anything = false;
+    for (;;) {
+        auto nsent_or_error = Core::System::sendfile(destination.fd(), source.fd(), nullptr, chunk_size);
+        if (nsent_or_error.is_error()) {
+            auto code = nsent_or_error.error().code();
+            if (!copied_anything && (code == EINVAL || code == ENOSYS))
+                return false;
+            return nsent_or_error.release_error();
+        }
+        if (nsent_or_error.value() == 0)
+            return true;
+        copied_anything = true;
+    }
+#else
+    return false;
+#endif
+}
+
 ErrorOr<void> copy_file(StringView destination_path, StringView source_path, struct stat const& source_stat, Core::File& source, PreserveMode preserve_mode)
 {
     auto destination_or_error = Core::File::open(destination_path, Core::File::OpenMode::Write, 0666);
@@ -208,10 +232,12 @@ ErrorOr<void> copy_file(StringView destination_path, StringView source_path, str
     if (source_stat.st_size > 0)
         TRY(destination->truncate(source_stat.st_size));
 
-    ByteBuffer buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
-    while (!source.is_eof()) {
-        auto bytes = TRY(source.read_some(buffer));
-        TRY(destination->write_until_depleted(bytes));
+    if (!TRY(copy_file_contents_in_kernel(*destination, source))) {
+        ByteBuffer buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+        while (!source.is_eof()) {
+            auto bytes = TRY(source.read_some(buffer));
+            TRY(destination->write_until_depleted(bytes));
+        }
     }
 
     auto my_umask = umask(0);
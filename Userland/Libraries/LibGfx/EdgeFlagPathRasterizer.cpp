@@ -7,10 +7,12 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/IntegralMath.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Types.h>
 #include <LibGfx/AntiAliasingPainter.h>
 #include <LibGfx/EdgeFlagPathRasterizer.h>
 #include <LibGfx/Painter.h>
+#include <LibGfx/PixelKernels.h>
 
 #if defined(AK_COMPILER_GCC)
 #    pragma GCC optimize("O3")
@@ -71,10 +73,10 @@ static Vector<Detail::Edge> prepare_edges(ReadonlySpan<FloatLine> lines, unsigne
         auto dxdy = dx / dy;
 
         // Trim off the non-visible portions of the edge.
-        if (min_y < top_clip) {
-            start_x += dxdy * (top_clip - min_y);
-            min_y = top_clip;
-        }
+        // NOTE: The hidden samples are stepped over one by one, like plotting them would, rather than jumped over, so
+        //       that the visible samples land in the same place no matter where the clip starts (e.g. in banded playback).
+        for (; min_y < top_clip; ++min_y)
+            start_x += dxdy;
         if (max_y > bottom_clip)
             max_y = bottom_clip;
 
@@ -140,6 +142,8 @@ void EdgeFlagPathRasterizer<SamplesPerPixel>::fill_internal(Painter& painter, Pa
         return;
 
     m_scanline.resize(scanline_length);
+    m_samples.resize(scanline_length);
+    m_alphas.resize(scanline_length);
 
     if (m_clip.is_empty())
         return;
@@ -357,23 +361,128 @@ auto EdgeFlagPathRasterizer<SamplesPerPixel>::accumulate_scanline(EdgeExtent edg
         return accumulate_non_zero_scanline(edge_extent, init, callback);
 }
 
+// Counts the set bits in each element of the vector.
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE static VectorType popcount(VectorType value)
+{
+    using Element = AK::SIMD::ElementOf<VectorType>;
+    value -= (value >> 1) & static_cast<Element>(0x5555555555555555);
+    value = (value & static_cast<Element>(0x3333333333333333)) + ((value >> 2) & static_cast<Element>(0x3333333333333333));
+    value = (value + (value >> 4)) & static_cast<Element>(0x0f0f0f0f0f0f0f0f);
+    if constexpr (sizeof(Element) >= 2)
+        value += value >> 8;
+    if constexpr (sizeof(Element) >= 4)
+        value += value >> 16;
+    return value & 0xff;
+}
+
+ALWAYS_INLINE static bool is_opaque(BitmapFormat format, AK::SIMD::u32x4 pixels)
+{
+    return format == BitmapFormat::BGRx8888 || AK::SIMD::all(static_cast<AK::SIMD::i32x4>((pixels >> 24) == 0xff));
+}
+
 template<unsigned SamplesPerPixel>
-void EdgeFlagPathRasterizer<SamplesPerPixel>::write_pixel(BitmapFormat format, ARGB32* scanline_ptr, int scanline, int offset, SampleType sample, auto& color_or_function)
+void EdgeFlagPathRasterizer<SamplesPerPixel>::compute_alphas(EdgeExtent extent)
 {
-    if (!sample)
-        return;
-    auto dest_x = offset + m_blit_origin.x();
-    auto coverage = SubpixelSample::compute_coverage(sample);
-    auto paint_color = scanline_color(scanline, offset, coverage_to_alpha(coverage), color_or_function);
-    scanline_ptr[dest_x] = color_for_format(format, scanline_ptr[dest_x]).blend(paint_color).value();
+    using SampleVector = typename SubpixelSample::VectorType;
+    constexpr int samples_per_vector = AK::SIMD::vector_length<SampleVector>;
+    using AlphaVector = Conditional<samples_per_vector == 16, AK::SIMD::u8x16, Conditional<samples_per_vector == 8, AK::SIMD::u8x8, AK::SIMD::u8x4>>;
+    constexpr auto alpha_shift = AK::log2(256 / SamplesPerPixel);
+
+    int x = extent.min_x;
+    for (; x + samples_per_vector - 1 <= extent.max_x; x += samples_per_vector) {
+        auto coverage = popcount(AK::SIMD::load_unaligned<SampleVector>(m_samples.data() + x));
+        // Same as coverage_to_alpha(): (coverage << alpha_shift) - 1, or 0 for no coverage. The comparison is -1 where true.
+        auto alpha = (coverage << alpha_shift) + static_cast<SampleVector>(coverage != 0);
+        AK::SIMD::store_unaligned(m_alphas.data() + x, __builtin_convertvector(alpha, AlphaVector));
+    }
+    for (; x <= extent.max_x; x++)
+        m_alphas.data()[x] = coverage_to_alpha(SubpixelSample::compute_coverage(m_samples.data()[x]));
+}
+
+template<unsigned SamplesPerPixel>
+void EdgeFlagPathRasterizer<SamplesPerPixel>::composite_span(BitmapFormat format, ARGB32* scanline_ptr, int, EdgeExtent extent, Color color)
+{
+    auto* dest = scanline_ptr + m_blit_origin.x();
+    auto const* alphas = m_alphas.data();
+    bool const color_is_opaque = color.alpha() == 255;
+    auto const opaque_color = AK::SIMD::expand4(color.value());
+    auto const color_without_alpha = AK::SIMD::expand4(color.value() & 0xffffff);
+
+    auto blend_pixel = [&](int x) {
+        if (auto alpha = alphas[x]) {
+            auto paint_color = color.with_alpha(color_is_opaque ? alpha : color.alpha() * alpha / 255);
+            dest[x] = color_for_format(format, dest[x]).blend(paint_color).value();
+        }
+    };
+
+    int x = extent.min_x;
+    for (; x + 3 <= extent.max_x; x += 4) {
+        u32 alpha_quad;
+        __builtin_memcpy(&alpha_quad, alphas + x, sizeof(alpha_quad));
+        if (alpha_quad == 0)
+            continue;
+        if (alpha_quad == NumericLimits<u32>::max() && color_is_opaque) {
+            AK::SIMD::store_unaligned(dest + x, opaque_color);
+            continue;
+        }
+
+        auto destination = AK::SIMD::load_unaligned<AK::SIMD::u32x4>(dest + x);
+        if (!is_opaque(format, destination)) {
+            for (int i = 0; i < 4; i++)
+                blend_pixel(x + i);
+            continue;
+        }
+
+        AK::SIMD::u32x4 alpha { alphas[x], alphas[x + 1], alphas[x + 2], alphas[x + 3] };
+        auto paint_alpha = color_is_opaque ? alpha : PixelKernels::divide_by_255(alpha * color.alpha());
+        auto blended = PixelKernels::blend_over_opaque(destination, color_without_alpha | (paint_alpha << 24));
+        // Pixels without any coverage are left untouched.
+        auto covered = static_cast<AK::SIMD::u32x4>(alpha != 0);
+        AK::SIMD::store_unaligned(dest + x, (blended & covered) | (destination & ~covered));
+    }
+    for (; x <= extent.max_x; x++)
+        blend_pixel(x);
 }
 
 template<unsigned SamplesPerPixel>
-void EdgeFlagPathRasterizer<SamplesPerPixel>::fast_fill_solid_color_span(ARGB32* scanline_ptr, int start, int end, Color color)
+void EdgeFlagPathRasterizer<SamplesPerPixel>::composite_span(BitmapFormat format, ARGB32* scanline_ptr, int scanline, EdgeExtent extent, auto& function)
 {
-    auto start_x = start + m_blit_origin.x();
-    auto end_x = end + m_blit_origin.x();
-    fast_u32_fill(scanline_ptr + start_x, color.value(), end_x - start_x + 1);
+    auto* dest = scanline_ptr + m_blit_origin.x();
+    auto const* alphas = m_alphas.data();
+
+    int x = extent.min_x;
+    for (; x + 3 <= extent.max_x; x += 4) {
+        u32 alpha_quad;
+        __builtin_memcpy(&alpha_quad, alphas + x, sizeof(alpha_quad));
+        if (alpha_quad == 0)
+            continue;
+
+        // NOTE: The paint style is only sampled for pixels that are covered.
+        AK::SIMD::u32x4 paint_colors {};
+        for (int i = 0; i < 4; i++) {
+            if (auto alpha = alphas[x + i])
+                paint_colors[i] = scanline_color(scanline, x + i, alpha, function).value();
+        }
+
+        auto destination = AK::SIMD::load_unaligned<AK::SIMD::u32x4>(dest + x);
+        if (!is_opaque(format, destination)) {
+            for (int i = 0; i < 4; i++) {
+                if (alphas[x + i])
+                    dest[x + i] = color_for_format(format, dest[x + i]).blend(Color::from_argb(paint_colors[i])).value();
+            }
+            continue;
+        }
+
+        auto blended = PixelKernels::blend_over_opaque(destination, paint_colors);
+        AK::SIMD::u32x4 alpha { alphas[x], alphas[x + 1], alphas[x + 2], alphas[x + 3] };
+        auto covered = static_cast<AK::SIMD::u32x4>(alpha != 0);
+        AK::SIMD::store_unaligned(dest + x, (blended & covered) | (destination & ~covered));
+    }
+    for (; x <= extent.max_x; x++) {
+        if (auto alpha = alphas[x])
+            dest[x] = color_for_format(format, dest[x]).blend(scanline_color(scanline, x, alpha, function)).value();
+    }
 }
 
 template<unsigned SamplesPerPixel>
@@ -400,37 +509,13 @@ FLATTEN __attribute__((hot)) void EdgeFlagPathRasterizer<SamplesPerPixel>::write
     auto dest_format = painter.target().format();
     auto dest_ptr = painter.target().scanline(scanline + m_blit_origin.y());
 
-    // Simple case: Handle each pixel individually.
-    // Used for PaintStyle fills and semi-transparent colors.
-    auto write_scanline_pixelwise = [&](auto& color_or_function) {
-        accumulate_scanline<WindingRule>(clipped_extent, acc, [&](int x, SampleType sample) {
-            write_pixel(dest_format, dest_ptr, scanline, x, sample, color_or_function);
-        });
-    };
-    // Fast fill case: Track spans of solid color and set the entire span via a fast_u32_fill().
-    // Used for opaque colors (i.e. alpha == 255).
-    auto write_scanline_with_fast_fills = [&](Color color) {
-        if (color.alpha() != 255)
-            return write_scanline_pixelwise(color);
-        constexpr SampleType full_coverage = NumericLimits<SampleType>::max();
-        int full_coverage_count = 0;
-        accumulate_scanline<WindingRule>(clipped_extent, acc, [&](int x, SampleType sample) {
-            if (sample == full_coverage) {
-                full_coverage_count++;
-                return;
-            } else {
-                write_pixel(dest_format, dest_ptr, scanline, x, sample, color);
-            }
-            if (full_coverage_count > 0) {
-                fast_fill_solid_color_span(dest_ptr, x - full_coverage_count, x - 1, color);
-                full_coverage_count = 0;
-            }
-        });
-        if (full_coverage_count > 0)
-            fast_fill_solid_color_span(dest_ptr, clipped_extent.max_x - full_coverage_count + 1, clipped_extent.max_x, color);
-    };
-    switch_on_color_or_function(
-        color_or_function, write_scanline_with_fast_fills, write_scanline_pixelwise);
+    // Resolve the edge flags into the samples covered at each pixel, turn those into alphas in bulk, and then
+    // composite the whole span at once.
+    accumulate_scanline<WindingRule>(clipped_extent, acc, [&](int x, SampleType sample) {
+        m_samples.data()[x] = sample;
+    });
+    compute_alphas(clipped_extent);
+    composite_span(dest_format, dest_ptr, scanline, clipped_extent, color_or_function);
 }
 
 static IntSize path_bounds(Gfx::Path const& path)
@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/GenericShorthands.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Forward.h>
@@ -34,6 +35,7 @@ struct Sample {
 template<>
 struct Sample<8> {
     using Type = u8;
+    using VectorType = AK::SIMD::u8x16;
     static constexpr Array nrooks_subpixel_offsets {
         (5.0f / 8.0f),
         (0.0f / 8.0f),
@@ -54,6 +56,7 @@ struct Sample<8> {
 template<>
 struct Sample<16> {
     using Type = u16;
+    using VectorType = AK::SIMD::u16x8;
     static constexpr Array nrooks_subpixel_offsets {
         (1.0f / 16.0f),
         (8.0f / 16.0f),
@@ -84,6 +87,7 @@ struct Sample<16> {
 template<>
 struct Sample<32> {
     using Type = u32;
+    using VectorType = AK::SIMD::u32x4;
     static constexpr Array nrooks_subpixel_offsets {
         (28.0f / 32.0f),
         (13.0f / 32.0f),
@@ -178,8 +182,9 @@ private:
     template<WindingRule>
     FLATTEN void write_scanline(Painter&, int scanline, EdgeExtent, auto& color_or_function);
     Color scanline_color(int scanline, int offset, u8 alpha, auto& color_or_function);
-    void write_pixel(BitmapFormat format, ARGB32* scanline_ptr, int scanline, int offset, SampleType sample, auto& color_or_function);
-    void fast_fill_solid_color_span(ARGB32* scanline_ptr, int start, int end, Color color);
+    void compute_alphas(EdgeExtent);
+    void composite_span(BitmapFormat, ARGB32* scanline_ptr, int scanline, EdgeExtent, Color);
+    void composite_span(BitmapFormat, ARGB32* scanline_ptr, int scanline, EdgeExtent, auto& function);
 
     template<WindingRule, typename Callback>
     auto accumulate_scanline(EdgeExtent, auto, Callback);
@@ -212,6 +217,10 @@ private:
     Vector<SampleType> m_scanline;
     Vector<WindingCounts> m_windings;
 
+    // The resolved samples of the scanline that's being written, and the alpha that each of them translates to.
+    Vector<SampleType> m_samples;
+    Vector<u8> m_alphas;
+
     class EdgeTable {
     public:
         EdgeTable() = default;
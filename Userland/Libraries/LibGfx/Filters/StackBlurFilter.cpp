@@ -12,6 +12,7 @@
 #include <AK/Array.h>
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 
@@ -39,6 +40,19 @@ constexpr auto mult_table = [] {
     return lut;
 }();
 
+// All four channels of a pixel are blurred at once, in the order they're stored in memory.
+using Channels = AK::SIMD::u32x4;
+
+ALWAYS_INLINE static Channels to_channels(ARGB32 pixel)
+{
+    return __builtin_convertvector(bit_cast<AK::SIMD::u8x4>(pixel), Channels);
+}
+
+ALWAYS_INLINE static ARGB32 from_channels(Channels channels)
+{
+    return bit_cast<ARGB32>(__builtin_convertvector(channels, AK::SIMD::u8x4));
+}
+
 // Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
 struct BlurStack {
     BlurStack(size_t size)
@@ -49,16 +63,11 @@ struct BlurStack {
     struct Iterator {
         friend BlurStack;
 
-        ALWAYS_INLINE Color& operator*()
+        ALWAYS_INLINE ARGB32& operator*()
         {
             return m_data.at(m_idx);
         }
 
-        ALWAYS_INLINE Color* operator->()
-        {
-            return &m_data.at(m_idx);
-        }
-
         ALWAYS_INLINE Iterator operator++()
         {
             // Note: This seemed to profile slightly better than %
@@ -75,14 +84,14 @@ struct BlurStack {
         }
 
     private:
-        Iterator(size_t idx, Span<Color> data)
+        Iterator(size_t idx, Span<ARGB32> data)
             : m_idx(idx)
             , m_data(data)
         {
         }
 
         size_t m_idx;
-        Span<Color> m_data;
+        Span<ARGB32> m_data;
     };
 
     Iterator iterator_from_position(size_t position)
@@ -92,221 +101,176 @@ struct BlurStack {
     }
 
 private:
-    Vector<Color, 512> m_data;
+    Vector<ARGB32, 512> m_data;
 };
 
-// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
-// (Link is to a secondary source as the original site is now down)
-FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
-{
-    // TODO: Implement a plain RGB version of this (if required)
-
-    if (radius == 0)
-        return;
-
-    fill_color = fill_color.with_alpha(0);
-
-    uint width = m_bitmap.width();
-    uint height = m_bitmap.height();
+struct BlurSums {
+    Channels in_sum;
+    Channels out_sum;
+    Channels sum;
+};
 
-    uint div = 2 * radius + 1;
+// Blurs a single row of pixels.
+ALWAYS_INLINE static void blur_row(ARGB32* pixels, uint length, BlurStack& blur_stack, uint radius, ARGB32 fill_color)
+{
     uint radius_plus_1 = radius + 1;
     uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
+    auto const sum_mult = mult_table[radius - 1];
+    auto const sum_shift = shift_table[radius - 1];
 
-    auto get_pixel = [&](int x, int y) {
-        auto color = m_bitmap.get_pixel<StorageFormat::BGRA8888>(x, y);
-        if (color.alpha() == 0)
+    auto get_pixel = [&](uint i) {
+        auto pixel = pixels[i];
+        if ((pixel >> 24) == 0)
             return fill_color;
-        return color;
-    };
-
-    auto set_pixel = [&](int x, int y, Color color) {
-        return m_bitmap.set_pixel<StorageFormat::BGRA8888>(x, y, color);
+        return pixel;
     };
 
-    BlurStack blur_stack { div };
     auto const stack_start = blur_stack.iterator_from_position(0);
     auto const stack_end = blur_stack.iterator_from_position(radius_plus_1);
     auto stack_iterator = stack_start;
 
+    auto pixel = get_pixel(0);
+    for (uint i = 0; i < radius_plus_1; i++)
+        *(stack_iterator++) = pixel;
+
+    // All the sums here work to approximate a gaussian.
+    // Note: Only about 17 bits are actually used in each sum.
+    auto color = to_channels(pixel);
+    BlurSums sums { {}, radius_plus_1 * color, sum_factor * color };
+
+    for (uint i = 1; i <= radius; i++) {
+        auto pixel = get_pixel(min(i, length - 1));
+        auto color = to_channels(pixel);
+
+        auto bias = radius_plus_1 - i;
+        *stack_iterator = pixel;
+        sums.sum += color * bias;
+        sums.in_sum += color;
+
+        ++stack_iterator;
+    }
+
+    auto stack_in_iterator = stack_start;
+    auto stack_out_iterator = stack_end;
+
+    for (uint i = 0; i < length; i++) {
+        auto blurred = (sums.sum * sum_mult) >> sum_shift;
+        pixels[i] = blurred[3] != 0 ? from_channels(blurred) : fill_color;
+
+        sums.sum -= sums.out_sum;
+        sums.out_sum -= to_channels(*stack_in_iterator);
+
+        auto pixel = get_pixel(min(i + radius_plus_1, length - 1));
+        *stack_in_iterator = pixel;
+        sums.in_sum += to_channels(pixel);
+        sums.sum += sums.in_sum;
+
+        ++stack_in_iterator;
+
+        auto color = to_channels(*stack_out_iterator);
+        sums.out_sum += color;
+        sums.in_sum -= color;
+
+        ++stack_out_iterator;
+    }
+}
+
+// Blurs all columns of the bitmap at once, one row at a time. This does exactly what blur_row() does, but walks the
+// bitmap in memory order, which is a lot kinder to the cache than going down one column after the other.
+static void blur_columns(Bitmap& bitmap, uint radius, ARGB32 fill_color)
+{
+    uint width = bitmap.width();
+    uint height = bitmap.height();
+    uint div = 2 * radius + 1;
+    uint radius_plus_1 = radius + 1;
+    uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
     auto const sum_mult = mult_table[radius - 1];
     auto const sum_shift = shift_table[radius - 1];
 
-    for (uint y = 0; y < height; y++) {
-        stack_iterator = stack_start;
+    auto get_pixel = [&](uint x, uint y) {
+        auto pixel = bitmap.scanline(y)[x];
+        if ((pixel >> 24) == 0)
+            return fill_color;
+        return pixel;
+    };
 
-        auto color = get_pixel(0, y);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        // All the sums here work to approximate a gaussian.
-        // Note: Only about 17 bits are actually used in each sum.
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(min(i, width - 1), y);
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+    // Every column moves through its stack in lockstep, so the stacks are laid out as a ring buffer of rows.
+    Vector<ARGB32> stack_rows;
+    stack_rows.resize(div * width);
+    auto stack_row = [&](uint index) { return stack_rows.data() + index * width; };
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
+    Vector<BlurSums> column_sums;
+    column_sums.ensure_capacity(width);
+    for (uint x = 0; x < width; x++) {
+        auto pixel = get_pixel(x, 0);
+        for (uint i = 0; i < radius_plus_1; i++)
+            stack_row(i)[x] = pixel;
+        auto color = to_channels(pixel);
+        column_sums.unchecked_append(BlurSums { {}, radius_plus_1 * color, sum_factor * color });
+    }
 
+    for (uint i = 1; i <= radius; i++) {
+        auto* stack = stack_row(radius + i);
+        auto bias = radius_plus_1 - i;
         for (uint x = 0; x < width; x++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(min(x + radius_plus_1, width - 1), y);
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
+            auto pixel = get_pixel(x, min(i, height - 1));
+            auto color = to_channels(pixel);
+            stack[x] = pixel;
+            column_sums[x].sum += color * bias;
+            column_sums[x].in_sum += color;
         }
     }
 
-    for (uint x = 0; x < width; x++) {
-        stack_iterator = stack_start;
+    uint stack_in_index = 0;
+    uint stack_out_index = radius_plus_1;
 
-        auto color = get_pixel(x, 0);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(x, min(i, height - 1));
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+    for (uint y = 0; y < height; y++) {
+        auto* scanline = bitmap.scanline(y);
+        auto* stack_in = stack_row(stack_in_index);
+        auto const* stack_out = stack_row(stack_out_index);
+        uint next_y = min(y + radius_plus_1, height - 1);
+
+        for (uint x = 0; x < width; x++) {
+            auto& sums = column_sums[x];
+            auto blurred = (sums.sum * sum_mult) >> sum_shift;
+            scanline[x] = blurred[3] != 0 ? from_channels(blurred) : fill_color;
+
+            sums.sum -= sums.out_sum;
+            sums.out_sum -= to_channels(stack_in[x]);
+
+            auto pixel = get_pixel(x, next_y);
+            stack_in[x] = pixel;
+            sums.in_sum += to_channels(pixel);
+            sums.sum += sums.in_sum;
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint y = 0; y < height; y++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(x, min(y + radius_plus_1, height - 1));
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
+            auto color = to_channels(stack_out[x]);
+            sums.out_sum += color;
+            sums.in_sum -= color;
         }
+
+        if (++stack_in_index >= div)
+            stack_in_index = 0;
+        if (++stack_out_index >= div)
+            stack_out_index = 0;
     }
 }
 
+// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
+// (Link is to a secondary source as the original site is now down)
+FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+{
+    // TODO: Implement a plain RGB version of this (if required)
+
+    if (radius == 0)
+        return;
+
+    auto const transparent_fill_color = fill_color.with_alpha(0).value();
+
+    BlurStack blur_stack { 2u * radius + 1 };
+    for (int y = 0; y < m_bitmap.height(); y++)
+        blur_row(m_bitmap.scanline(y), m_bitmap.width(), blur_stack, radius, transparent_fill_color);
+
+    blur_columns(m_bitmap, radius, transparent_fill_color);
+}
+
 }
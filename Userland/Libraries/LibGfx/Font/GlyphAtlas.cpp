@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+
+namespace Gfx {
+
+// Glyphs are kept apart by a pixel of padding, so that sampling at the edge of one never picks up its neighbor.
+static constexpr int glyph_padding = 1;
+
+ErrorOr<NonnullRefPtr<GlyphAtlasPage>> GlyphAtlasPage::create(IntSize size)
+{
+    Vector<u8> coverage;
+    TRY(coverage.try_resize(static_cast<size_t>(size.width()) * size.height()));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) GlyphAtlasPage(size, move(coverage)));
+}
+
+Optional<IntRect> GlyphAtlasPage::allocate(IntSize size)
+{
+    auto padded_width = size.width() + glyph_padding;
+    auto padded_height = size.height() + glyph_padding;
+
+    if (m_shelf_x + padded_width > m_size.width()) {
+        m_shelf_y += m_shelf_height;
+        m_shelf_x = 0;
+        m_shelf_height = 0;
+    }
+    if (padded_width > m_size.width() || m_shelf_y + padded_height > m_size.height())
+        return {};
+
+    IntRect rect { m_shelf_x, m_shelf_y, size.width(), size.height() };
+    m_shelf_x += padded_width;
+    m_shelf_height = max(m_shelf_height, padded_height);
+    return rect;
+}
+
+GlyphAtlas& GlyphAtlas::the()
+{
+    static GlyphAtlas s_the;
+    return s_the;
+}
+
+GlyphAtlas::GlyphAtlas(IntSize page_size, size_t max_page_count)
+    : m_page_size(page_size)
+    , m_max_page_count(max_page_count)
+{
+    VERIFY(m_max_page_count > 0);
+}
+
+Optional<GlyphAtlas::Glyph> GlyphAtlas::find_or_rasterize(GlyphAtlasKey const& key, Function<RefPtr<Bitmap>()> const& rasterize)
+{
+    if (auto glyph = find(key); glyph.has_value())
+        return glyph;
+
+    // NOTE: We rasterize without holding the lock. If another thread beats us to it, we use its copy of the glyph.
+    auto bitmap = rasterize();
+    if (!bitmap)
+        return {};
+
+    Threading::MutexLocker locker(m_lock);
+    if (auto it = m_glyphs.find(key); it != m_glyphs.end())
+        return it->value;
+    auto glyph_or_error = add(key, *bitmap);
+    if (glyph_or_error.is_error())
+        return {};
+    return glyph_or_error.release_value();
+}
+
+Optional<GlyphAtlas::Glyph> GlyphAtlas::find(GlyphAtlasKey const& key)
+{
+    Threading::MutexLocker locker(m_lock);
+    auto it = m_glyphs.find(key);
+    if (it == m_glyphs.end())
+        return {};
+    const_cast<GlyphAtlasPage&>(*it->value.page).m_last_use = ++m_use_counter;
+    return it->value;
+}
+
+ErrorOr<GlyphAtlas::Glyph> GlyphAtlas::add(GlyphAtlasKey const& key, Bitmap const& bitmap)
+{
+    bool const fits_in_atlas = bitmap.width() + glyph_padding <= m_page_size.width() && bitmap.height() + glyph_padding <= m_page_size.height();
+
+    RefPtr<GlyphAtlasPage> page;
+    if (fits_in_atlas) {
+        page = TRY(page_with_room_for(bitmap.size()));
+    } else {
+        // This glyph is too large to ever fit in a page, so it gets a page of its own that we don't hold on to.
+        page = TRY(GlyphAtlasPage::create({ bitmap.width() + glyph_padding, bitmap.height() + glyph_padding }));
+    }
+    auto rect = page->allocate(bitmap.size());
+    VERIFY(rect.has_value());
+
+    for (int y = 0; y < rect->height(); ++y) {
+        auto const* source = bitmap.scanline(y);
+        auto* destination = page->scanline(rect->y() + y) + rect->x();
+        for (int x = 0; x < rect->width(); ++x)
+            destination[x] = Color::from_argb(source[x]).alpha();
+    }
+
+    Glyph glyph { page.release_nonnull(), *rect };
+    if (fits_in_atlas) {
+        auto& atlas_page = const_cast<GlyphAtlasPage&>(*glyph.page);
+        atlas_page.m_last_use = ++m_use_counter;
+        TRY(atlas_page.m_keys.try_append(key));
+        TRY(m_glyphs.try_set(key, glyph));
+    }
+    return glyph;
+}
+
+ErrorOr<NonnullRefPtr<GlyphAtlasPage>> GlyphAtlas::page_with_room_for(IntSize size)
+{
+    // NOTE: Only the most recently added page is filled. Older pages may still have some room at the end, but
+    //       keeping track of that isn't worth it.
+    if (!m_pages.is_empty()) {
+        auto& page = m_pages.last();
+        IntSize padded_size { size.width() + glyph_padding, size.height() + glyph_padding };
+        bool fits_on_current_shelf = page->m_shelf_x + padded_size.width() <= page->m_size.width()
+            && page->m_shelf_y + padded_size.height() <= page->m_size.height();
+        bool fits_on_next_shelf = page->m_shelf_y + page->m_shelf_height + padded_size.height() <= page->m_size.height();
+        if (fits_on_current_shelf || fits_on_next_shelf)
+            return page;
+    }
+
+    if (m_pages.size() >= m_max_page_count)
+        evict_least_recently_used_page();
+
+    auto page = TRY(GlyphAtlasPage::create(m_page_size));
+    TRY(m_pages.try_append(page));
+    return page;
+}
+
+void GlyphAtlas::evict_least_recently_used_page()
+{
+    size_t least_recently_used_index = 0;
+    for (size_t i = 1; i < m_pages.size(); ++i) {
+        if (m_pages[i]->m_last_use < m_pages[least_recently_used_index]->m_last_use)
+            least_recently_used_index = i;
+    }
+
+    // NOTE: Painters that are still using glyphs from this page keep it alive until they're done.
+    auto page = m_pages.take(least_recently_used_index);
+    for (auto const& key : page->m_keys)
+        m_glyphs.remove(key);
+}
+
+size_t GlyphAtlas::page_count() const
+{
+    Threading::MutexLocker locker(m_lock);
+    return m_pages.size();
+}
+
+size_t GlyphAtlas::glyph_count() const
+{
+    Threading::MutexLocker locker(m_lock);
+    return m_glyphs.size();
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+#include <LibGfx/Font/Font.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Rect.h>
+#include <LibThreading/Mutex.h>
+
+namespace Gfx {
+
+struct GlyphAtlasKey {
+    u64 typeface_id { 0 };
+    float x_scale { 0 };
+    float y_scale { 0 };
+    u32 glyph_id { 0 };
+    GlyphSubpixelOffset subpixel_offset { 0, 0 };
+
+    bool operator==(GlyphAtlasKey const&) const = default;
+};
+
+}
+
+namespace AK {
+
+template<>
+struct Traits<Gfx::GlyphAtlasKey> : public DefaultTraits<Gfx::GlyphAtlasKey> {
+    static unsigned hash(Gfx::GlyphAtlasKey const& key)
+    {
+        auto hash = pair_int_hash(u64_hash(key.typeface_id), pair_int_hash(bit_cast<u32>(key.x_scale), bit_cast<u32>(key.y_scale)));
+        return pair_int_hash(hash, pair_int_hash(key.glyph_id, (key.subpixel_offset.x << 8) | key.subpixel_offset.y));
+    }
+};
+
+}
+
+namespace Gfx {
+
+// An alpha-only bitmap that rasterized glyphs are packed into, one shelf at a time.
+class GlyphAtlasPage : public AtomicRefCounted<GlyphAtlasPage> {
+    AK_MAKE_NONCOPYABLE(GlyphAtlasPage);
+    AK_MAKE_NONMOVABLE(GlyphAtlasPage);
+
+public:
+    static ErrorOr<NonnullRefPtr<GlyphAtlasPage>> create(IntSize);
+
+    IntSize size() const { return m_size; }
+    u8 const* scanline(int y) const { return m_coverage.data() + static_cast<size_t>(y) * m_size.width(); }
+
+private:
+    friend class GlyphAtlas;
+
+    GlyphAtlasPage(IntSize size, Vector<u8>&& coverage)
+        : m_size(size)
+        , m_coverage(move(coverage))
+    {
+    }
+
+    u8* scanline(int y) { return m_coverage.data() + static_cast<size_t>(y) * m_size.width(); }
+    Optional<IntRect> allocate(IntSize);
+
+    IntSize m_size;
+    Vector<u8> m_coverage;
+
+    // NOTE: Everything below is guarded by the atlas lock.
+    int m_shelf_x { 0 };
+    int m_shelf_y { 0 };
+    int m_shelf_height { 0 };
+    u64 m_last_use { 0 };
+    Vector<GlyphAtlasKey> m_keys;
+};
+
+// A size-bounded cache of rasterized glyphs shared by all vector fonts, so text painting doesn't have to keep a full
+// color bitmap around for every glyph of every font size it has ever drawn. Once all pages are full, the page that
+// was used least recently is evicted as a whole to make room.
+class GlyphAtlas {
+    AK_MAKE_NONCOPYABLE(GlyphAtlas);
+    AK_MAKE_NONMOVABLE(GlyphAtlas);
+
+public:
+    static constexpr IntSize default_page_size { 512, 512 };
+    static constexpr size_t default_max_page_count = 16;
+
+    static GlyphAtlas& the();
+
+    GlyphAtlas(IntSize page_size = default_page_size, size_t max_page_count = default_max_page_count);
+
+    struct Glyph {
+        NonnullRefPtr<GlyphAtlasPage const> page;
+        IntRect rect;
+    };
+
+    // Returns the glyph from the atlas, calling rasterize to produce it first if necessary. The alpha channel of the
+    // rasterized bitmap is what ends up in the atlas.
+    Optional<Glyph> find_or_rasterize(GlyphAtlasKey const&, Function<RefPtr<Bitmap>()> const& rasterize);
+
+    size_t page_count() const;
+    size_t glyph_count() const;
+
+private:
+    Optional<Glyph> find(GlyphAtlasKey const&);
+    ErrorOr<Glyph> add(GlyphAtlasKey const&, Bitmap const&);
+    ErrorOr<NonnullRefPtr<GlyphAtlasPage>> page_with_room_for(IntSize);
+    void evict_least_recently_used_page();
+
+    IntSize m_page_size;
+    size_t m_max_page_count { 0 };
+
+    mutable Threading::Mutex m_lock;
+    HashMap<GlyphAtlasKey, Glyph> m_glyphs;
+    Vector<NonnullRefPtr<GlyphAtlasPage>> m_pages;
+    u64 m_use_counter { 0 };
+};
+
+}
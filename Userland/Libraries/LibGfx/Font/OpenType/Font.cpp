@@ -706,13 +706,10 @@ u32 Font::glyph_id_for_code_point(u32 code_point) const
 
 Font::GlyphPage const& Font::glyph_page(size_t page_index) const
 {
-    if (page_index == 0) {
-        if (!m_glyph_page_zero) {
-            m_glyph_page_zero = make<GlyphPage>();
-            populate_glyph_page(*m_glyph_page_zero, 0);
-        }
+    if (page_index == 0)
         return *m_glyph_page_zero;
-    }
+
+    Threading::MutexLocker locker(m_glyph_pages_lock);
     if (auto it = m_glyph_pages.find(page_index); it != m_glyph_pages.end()) {
         return *it->value;
     }
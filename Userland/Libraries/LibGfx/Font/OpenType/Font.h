@@ -18,6 +18,7 @@
 #include <LibGfx/Font/OpenType/Glyf.h>
 #include <LibGfx/Font/OpenType/Tables.h>
 #include <LibGfx/Font/VectorFont.h>
+#include <LibThreading/Mutex.h>
 
 namespace OpenType {
 
@@ -142,6 +143,9 @@ private:
         , m_cbdt(move(cbdt))
         , m_gpos(move(gpos))
     {
+        // NOTE: Page zero is populated up front so that looking up its glyphs never has to take m_glyph_pages_lock.
+        m_glyph_page_zero = make<GlyphPage>();
+        populate_glyph_page(*m_glyph_page_zero, 0);
     }
 
     RefPtr<Core::Resource> m_resource;
@@ -172,8 +176,10 @@ private:
     };
 
     // Fast cache for GlyphPage #0 (code points 0-255) to avoid hash lookups for all of ASCII and Latin-1.
-    OwnPtr<GlyphPage> mutable m_glyph_page_zero;
+    OwnPtr<GlyphPage> m_glyph_page_zero;
 
+    // NOTE: Glyph lookups happen both on the main thread and on the threads that rasterize display lists.
+    Threading::Mutex mutable m_glyph_pages_lock;
     HashMap<size_t, NonnullOwnPtr<GlyphPage>> mutable m_glyph_pages;
 
     HashMap<u32, i16> mutable m_kerning_cache;
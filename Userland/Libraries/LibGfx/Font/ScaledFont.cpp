@@ -74,26 +74,45 @@ ALWAYS_INLINE float ScaledFont::unicode_view_width(T const& view) const
 RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
 {
     GlyphIndexWithSubpixelOffset index { glyph_id, subpixel_offset };
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(index);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
+    {
+        Threading::MutexLocker locker(m_glyph_cache_lock);
+        auto glyph_iterator = m_cached_glyph_bitmaps.find(index);
+        if (glyph_iterator != m_cached_glyph_bitmaps.end())
+            return glyph_iterator->value;
+    }
 
+    // NOTE: We rasterize without holding the lock. If another thread beats us to it, we keep its bitmap.
     auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
-    m_cached_glyph_bitmaps.set(index, glyph_bitmap);
-    return glyph_bitmap;
+    Threading::MutexLocker locker(m_glyph_cache_lock);
+    return m_cached_glyph_bitmaps.ensure(index, [&] { return move(glyph_bitmap); });
+}
+
+Optional<GlyphAtlas::Glyph> ScaledFont::glyph_from_atlas(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
+{
+    if (m_font->has_color_bitmaps())
+        return {};
+
+    GlyphAtlasKey key { m_font->unique_id(), m_x_scale, m_y_scale, glyph_id, subpixel_offset };
+    return GlyphAtlas::the().find_or_rasterize(key, [&] {
+        return m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
+    });
 }
 
 bool ScaledFont::append_glyph_path_to(Gfx::Path& path, u32 glyph_id) const
 {
-    auto glyph_iterator = m_glyph_cache.find(glyph_id);
-    if (glyph_iterator != m_glyph_cache.end()) {
-        path.append_path(glyph_iterator->value, Path::AppendRelativeToLastPoint::Yes);
-        return true;
+    {
+        Threading::MutexLocker locker(m_glyph_cache_lock);
+        auto glyph_iterator = m_glyph_cache.find(glyph_id);
+        if (glyph_iterator != m_glyph_cache.end()) {
+            path.append_path(glyph_iterator->value, Path::AppendRelativeToLastPoint::Yes);
+            return true;
+        }
     }
     Gfx::Path glyph_path;
     bool success = m_font->append_glyph_path_to(glyph_path, glyph_id, m_x_scale, m_y_scale);
     if (success) {
         path.append_path(glyph_path, Path::AppendRelativeToLastPoint::Yes);
+        Threading::MutexLocker locker(m_glyph_cache_lock);
         m_glyph_cache.set(glyph_id, move(glyph_path));
     }
     return success;
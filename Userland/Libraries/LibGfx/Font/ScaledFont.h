@@ -10,6 +10,7 @@
 #include <AK/HashMap.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/Font.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Font/VectorFont.h>
 
 namespace Gfx {
@@ -28,6 +29,10 @@ public:
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale, m_point_width, m_point_height); }
     RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset) const;
+
+    // Returns the coverage of the glyph from the shared glyph atlas. Fonts with color bitmaps can't be drawn from the
+    // atlas, so this returns nothing for them.
+    Optional<GlyphAtlas::Glyph> glyph_from_atlas(u32 glyph_id, GlyphSubpixelOffset) const;
     bool append_glyph_path_to(Gfx::Path&, u32 glyph_id) const;
 
     // ^Gfx::Font
@@ -81,6 +86,8 @@ private:
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
 
+    // NOTE: The glyph caches are filled in from whichever thread happens to draw with this font first.
+    mutable Threading::Mutex m_glyph_cache_lock;
     mutable HashMap<u32, Gfx::Path> m_glyph_cache;
     mutable HashMap<GlyphIndexWithSubpixelOffset, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
     Gfx::FontPixelMetrics m_pixel_metrics;
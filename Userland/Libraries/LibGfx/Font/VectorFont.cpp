@@ -4,16 +4,24 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <LibGfx/Font/ScaledFont.h>
 #include <LibGfx/Font/VectorFont.h>
 
 namespace Gfx {
 
-VectorFont::VectorFont() = default;
+static Atomic<u64> s_next_unique_id { 1 };
+
+VectorFont::VectorFont()
+    : m_unique_id(s_next_unique_id.fetch_add(1, AK::MemoryOrder::memory_order_relaxed))
+{
+}
+
 VectorFont::~VectorFont() = default;
 
 NonnullRefPtr<ScaledFont> VectorFont::scaled_font(float point_size) const
 {
+    Threading::MutexLocker locker(m_scaled_fonts_lock);
     auto it = m_scaled_fonts.find(point_size);
     if (it != m_scaled_fonts.end())
         return *it->value;
@@ -6,12 +6,13 @@
 
 #pragma once
 
+#include <AK/AtomicRefCounted.h>
 #include <AK/HashMap.h>
 #include <AK/Noncopyable.h>
-#include <AK/RefCounted.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/Path.h>
+#include <LibThreading/Mutex.h>
 
 #define POINTS_PER_INCH 72.0f
 #define DEFAULT_DPI 96
@@ -39,7 +40,7 @@ struct ScaledGlyphMetrics {
     float left_side_bearing;
 };
 
-class VectorFont : public RefCounted<VectorFont> {
+class VectorFont : public AtomicRefCounted<VectorFont> {
 public:
     virtual ~VectorFont();
     virtual ScaledFontMetrics metrics(float x_scale, float y_scale) const = 0;
@@ -62,10 +63,17 @@ public:
 
     [[nodiscard]] NonnullRefPtr<ScaledFont> scaled_font(float point_size) const;
 
+    // Unique for the lifetime of the process, unlike the address of the font, which may be reused once it's freed.
+    u64 unique_id() const { return m_unique_id; }
+
 protected:
     VectorFont();
 
 private:
+    u64 m_unique_id { 0 };
+
+    // NOTE: Fonts are shared between the main thread and the threads that rasterize display lists.
+    mutable Threading::Mutex m_scaled_fonts_lock;
     mutable HashMap<float, NonnullRefPtr<ScaledFont>> m_scaled_fonts;
 };
 
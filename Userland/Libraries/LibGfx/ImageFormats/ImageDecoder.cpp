@@ -28,8 +28,11 @@
 
 namespace Gfx {
 
-static ErrorOr<OwnPtr<ImageDecoderPlugin>> probe_and_sniff_for_appropriate_plugin(ReadonlyBytes bytes)
+static ErrorOr<OwnPtr<ImageDecoderPlugin>> probe_and_sniff_for_appropriate_plugin(ReadonlyBytes bytes, ImageDecoderOptions const& options)
 {
+    if (options.thread_count > 1 && JPEGImageDecoderPlugin::sniff(bytes))
+        return TRY(JPEGImageDecoderPlugin::create_with_options(bytes, { .thread_count = options.thread_count }));
+
     struct ImagePluginInitializer {
         bool (*sniff)(ReadonlyBytes) = nullptr;
         ErrorOr<NonnullOwnPtr<ImageDecoderPlugin>> (*create)(ReadonlyBytes) = nullptr;
@@ -88,9 +91,9 @@ static ErrorOr<OwnPtr<ImageDecoderPlugin>> probe_and_sniff_for_appropriate_plugi
     return OwnPtr<ImageDecoderPlugin> {};
 }
 
-ErrorOr<RefPtr<ImageDecoder>> ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes bytes, Optional<ByteString> mime_type)
+ErrorOr<RefPtr<ImageDecoder>> ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes bytes, Optional<ByteString> mime_type, ImageDecoderOptions options)
 {
-    if (auto plugin = TRY(probe_and_sniff_for_appropriate_plugin(bytes)); plugin)
+    if (auto plugin = TRY(probe_and_sniff_for_appropriate_plugin(bytes, options)); plugin)
         return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
 
     if (mime_type.has_value()) {
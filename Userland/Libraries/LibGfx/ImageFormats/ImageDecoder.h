@@ -96,9 +96,14 @@ protected:
     ImageDecoderPlugin() = default;
 };
 
+struct ImageDecoderOptions {
+    // Decoders that support it may use up to this many threads to decode a frame. Currently only JPEG does.
+    unsigned thread_count { 1 };
+};
+
 class ImageDecoder : public RefCounted<ImageDecoder> {
 public:
-    static ErrorOr<RefPtr<ImageDecoder>> try_create_for_raw_bytes(ReadonlyBytes, Optional<ByteString> mime_type = {});
+    static ErrorOr<RefPtr<ImageDecoder>> try_create_for_raw_bytes(ReadonlyBytes, Optional<ByteString> mime_type = {}, ImageDecoderOptions = {});
     ~ImageDecoder() = default;
 
     IntSize size() const { return m_plugin->size(); }
@@ -13,6 +13,7 @@
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMDExtras.h>
 #include <AK/String.h>
 #include <AK/Try.h>
 #include <AK/Vector.h>
@@ -20,6 +21,8 @@
 #include <LibGfx/ImageFormats/JPEGShared.h>
 #include <LibGfx/ImageFormats/TIFFLoader.h>
 #include <LibGfx/ImageFormats/TIFFMetadata.h>
+#include <LibThreading/Thread.h>
+#include <string.h>
 
 namespace Gfx {
 
@@ -227,6 +230,40 @@ public:
         return {};
     }
 
+    // Reads entropy-coded data up to the first marker that isn't a restart marker, and saves that marker.
+    // Fill bytes are dropped, while stuffed zero bytes and restart markers are kept as they are.
+    ErrorOr<ByteBuffer> read_entropy_coded_segment()
+    {
+        VERIFY(!m_saved_marker.has_value());
+
+        ByteBuffer segment;
+        while (true) {
+            if (m_byte_offset == m_current_size)
+                TRY(refill_buffer());
+
+            auto const available = m_buffer.span().slice(m_byte_offset, m_current_size - m_byte_offset);
+            auto const* next_ff = static_cast<u8 const*>(memchr(available.data(), 0xFF, available.size()));
+            auto const data_size = next_ff ? static_cast<size_t>(next_ff - available.data()) : available.size();
+            TRY(segment.try_append(available.trim(data_size)));
+            m_byte_offset += data_size;
+            if (!next_ff)
+                continue;
+
+            ++m_byte_offset;
+            u8 next_byte = TRY(read_u8());
+            while (next_byte == 0xFF)
+                next_byte = TRY(read_u8());
+
+            Marker const marker = 0xFF00 | next_byte;
+            if (next_byte != 0x00 && (marker < JPEG_RST0 || marker > JPEG_RST7)) {
+                m_saved_marker = marker;
+                return segment;
+            }
+            TRY(segment.try_append(0xFF));
+            TRY(segment.try_append(next_byte));
+        }
+    }
+
     Optional<u16>& saved_marker(Badge<HuffmanStream>)
     {
         return m_saved_marker;
@@ -404,6 +441,17 @@ struct Scan {
     {
     }
 
+    // Decodes the same scan from another stream, starting with a reset decoder.
+    Scan(Scan const& other, HuffmanStream stream)
+        : components(other.components)
+        , spectral_selection_start(other.spectral_selection_start)
+        , spectral_selection_end(other.spectral_selection_end)
+        , successive_approximation_high(other.successive_approximation_high)
+        , successive_approximation_low(other.successive_approximation_low)
+        , huffman_stream(stream)
+    {
+    }
+
     // B.2.3 - Scan header syntax
     Vector<ScanComponent, 4> components;
 
@@ -416,6 +464,10 @@ struct Scan {
 
     u64 end_of_bands_run_count { 0 };
 
+    // F.2.1.3.1 - Structure of DC code table
+    // The DC predictions are reset at the start of every scan and restart interval.
+    Array<i16, 4> previous_dc_values {};
+
     // See the note on Figure B.4 - Scan header syntax
     bool are_components_interleaved() const
     {
@@ -470,7 +522,6 @@ struct JPEGLoadingContext {
     u16 dc_restart_interval { 0 };
     HashMap<u8, HuffmanTable> dc_tables;
     HashMap<u8, HuffmanTable> ac_tables;
-    Array<i16, 4> previous_dc_values {};
     MacroblockMeta mblock_meta;
     JPEGStream stream;
     JPEGDecoderOptions options;
@@ -481,6 +532,18 @@ struct JPEGLoadingContext {
 
     Optional<ICCMultiChunkState> icc_multi_chunk_state;
     Optional<ByteBuffer> icc_data;
+
+    // The image is decoded at 1/scale_denominator of its size by only keeping the lowest
+    // frequencies of each block. Each 8x8 block then yields a block_size x block_size
+    // area of pixels, stored at the top-left of the block.
+    u8 scale_denominator { 1 };
+
+    u8 block_size() const { return 8 / scale_denominator; }
+
+    IntSize scaled_size() const
+    {
+        return { ceil_div<int, int>(frame.width, scale_denominator), ceil_div<int, int>(frame.height, scale_denominator) };
+    }
 };
 
 static inline auto* get_component(Macroblock& block, unsigned component)
@@ -516,7 +579,7 @@ enum class JPEGDecodingMode {
 };
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_dc(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.dc_tables.get(scan_component.dc_destination_id);
     if (!maybe_table.has_value()) {
@@ -525,7 +588,6 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     }
 
     auto& dc_table = maybe_table.value();
-    auto& scan = *context.current_scan;
 
     auto* select_component = get_component(macroblock, scan_component.component.index);
     auto& coefficient = select_component[0];
@@ -553,7 +615,7 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
         dc_diff -= (1 << dc_length) - 1;
 
-    auto& previous_dc = context.previous_dc_values[scan_component.component.index];
+    auto& previous_dc = scan.previous_dc_values[scan_component.component.index];
     previous_dc += dc_diff;
     coefficient = previous_dc << scan.successive_approximation_low;
 
@@ -597,7 +659,7 @@ static bool is_progressive(StartOfFrame::FrameType frame_type)
 }
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_ac(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.ac_tables.get(scan_component.ac_destination_id);
     if (!maybe_table.has_value()) {
@@ -608,8 +670,6 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
     auto& ac_table = maybe_table.value();
     auto* select_component = get_component(macroblock, scan_component.component.index);
 
-    auto& scan = *context.current_scan;
-
     // Compute the AC coefficients.
 
     // 0th coefficient is the dc, which is already handled
@@ -731,14 +791,14 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static ErrorOr<void> build_macroblocks(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
 {
-    for (auto const& scan_component : context.current_scan->components) {
+    for (auto const& scan_component : scan.components) {
         for (u8 vfactor_i = 0; vfactor_i < scan_component.component.sampling_factors.vertical; vfactor_i++) {
             for (u8 hfactor_i = 0; hfactor_i < scan_component.component.sampling_factors.horizontal; hfactor_i++) {
                 // A.2.3 - Interleaved order
                 u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                if (!context.current_scan->are_components_interleaved()) {
+                if (!scan.are_components_interleaved()) {
                     macroblock_index = vcursor * context.mblock_meta.hpadded_count + (hfactor_i + (hcursor * scan_component.component.sampling_factors.vertical) + (vfactor_i * scan_component.component.sampling_factors.horizontal));
 
                     // A.2.4 Completion of partial MCU
@@ -756,17 +816,17 @@ static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macro
                 Macroblock& block = macroblocks[macroblock_index];
 
                 if constexpr (DecodingMode == JPEGDecodingMode::Sequential) {
-                    TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
                 } else {
-                    if (context.current_scan->spectral_selection_start == 0)
-                        TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    if (context.current_scan->spectral_selection_end != 0)
-                        TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    if (scan.spectral_selection_start == 0)
+                        TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    if (scan.spectral_selection_end != 0)
+                        TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
 
                     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-                    if (context.current_scan->end_of_bands_run_count > 0) {
-                        --context.current_scan->end_of_bands_run_count;
+                    if (scan.end_of_bands_run_count > 0) {
+                        --scan.end_of_bands_run_count;
                         continue;
                     }
                 }
@@ -789,61 +849,173 @@ static bool is_dct_based(StartOfFrame::FrameType frame_type)
         || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT_Arithmetic;
 }
 
-static void reset_decoder(JPEGLoadingContext& context)
+static void reset_decoder(JPEGLoadingContext const& context, Scan& scan)
 {
     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-    context.current_scan->end_of_bands_run_count = 0;
+    scan.end_of_bands_run_count = 0;
 
     // E.2.4 Control procedure for decoding a restart interval
     if (is_dct_based(context.frame.type)) {
-        context.previous_dc_values = {};
+        scan.previous_dc_values = {};
         return;
     }
 
     VERIFY_NOT_REACHED();
 }
 
-static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static ErrorOr<void> decode_mcus(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 first_mcu, u32 end_mcu)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            // FIXME: This is likely wrong for non-interleaved scans.
-            VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
-            u32 number_of_mcus_decoded_so_far = ((vcursor / context.sampling_factors.vertical) * context.mblock_meta.hpadded_count + hcursor) / context.sampling_factors.horizontal;
+    // FIXME: This is likely wrong for non-interleaved scans.
+    VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
+    u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.sampling_factors.horizontal;
 
-            auto& huffman_stream = context.current_scan->huffman_stream;
+    for (u32 mcu = first_mcu; mcu < end_mcu; ++mcu) {
+        u32 const vcursor = (mcu / mcus_per_row) * context.sampling_factors.vertical;
+        u32 const hcursor = (mcu % mcus_per_row) * context.sampling_factors.horizontal;
 
-            if (context.dc_restart_interval > 0) {
-                if (number_of_mcus_decoded_so_far != 0 && number_of_mcus_decoded_so_far % context.dc_restart_interval == 0) {
-                    reset_decoder(context);
+        auto& huffman_stream = scan.huffman_stream;
 
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    TRY(huffman_stream.advance_to_byte_boundary());
+        // The decoder starts out reset, so there is no restart marker before the first MCU.
+        if (context.dc_restart_interval > 0) {
+            if (mcu != first_mcu && mcu % context.dc_restart_interval == 0) {
+                reset_decoder(context, scan);
 
-                    // Skip the restart marker (RSTn).
-                    TRY(huffman_stream.discard_bits(8));
-                }
+                // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                //  the 0th bit of the next byte.
+                TRY(huffman_stream.advance_to_byte_boundary());
+
+                // Skip the restart marker (RSTn).
+                TRY(huffman_stream.discard_bits(8));
             }
+        }
 
-            auto result = [&]() {
-                if (is_progressive(context.frame.type))
-                    return build_macroblocks<JPEGDecodingMode::Progressive>(context, macroblocks, hcursor, vcursor);
-                return build_macroblocks<JPEGDecodingMode::Sequential>(context, macroblocks, hcursor, vcursor);
-            }();
+        auto result = [&]() {
+            if (is_progressive(context.frame.type))
+                return build_macroblocks<JPEGDecodingMode::Progressive>(context, scan, macroblocks, hcursor, vcursor);
+            return build_macroblocks<JPEGDecodingMode::Sequential>(context, scan, macroblocks, hcursor, vcursor);
+        }();
 
-            if (result.is_error()) {
-                if constexpr (JPEG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}: {}", number_of_mcus_decoded_so_far, result.error());
-                    dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
-                }
-                return result.release_error();
+        if (result.is_error()) {
+            if constexpr (JPEG_DEBUG) {
+                dbgln("Failed to build Macroblock {}: {}", mcu, result.error());
+                dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
             }
+            return result.release_error();
         }
     }
     return {};
 }
 
+static u32 mcu_count(JPEGLoadingContext const& context)
+{
+    u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.sampling_factors.horizontal;
+    return mcus_per_row * ceil_div<u32, u32>(context.mblock_meta.vcount, context.sampling_factors.vertical);
+}
+
+static bool can_decode_restart_intervals_in_parallel(JPEGLoadingContext const& context)
+{
+    // Progressive scans carry their end-of-band runs across restart intervals, and scans that
+    // only contain some of the components use a different MCU order, so leave them alone.
+    return context.options.thread_count > 1
+        && context.dc_restart_interval > 0
+        && !is_progressive(context.frame.type)
+        && context.current_scan->components.size() == context.components.size()
+        && mcu_count(context) > context.dc_restart_interval;
+}
+
+static ErrorOr<void> decode_huffman_stream_in_parallel(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    // E.1.4 - Restart interval
+    // Every restart interval can be decoded on its own, as the decoder is reset at its start and the interval
+    // starts on a byte boundary right after a RSTn marker. We read the whole entropy-coded segment, split
+    // it at these markers, and decode groups of consecutive intervals on separate threads.
+    auto const segment = TRY(context.stream.read_entropy_coded_segment());
+
+    u32 const total_mcus = mcu_count(context);
+    u32 const interval_count = ceil_div<u32, u32>(total_mcus, context.dc_restart_interval);
+
+    Vector<size_t> interval_offsets;
+    TRY(interval_offsets.try_ensure_capacity(interval_count));
+    interval_offsets.unchecked_append(0);
+    for (size_t i = 0; i + 1 < segment.size(); ++i) {
+        if (segment[i] != 0xFF)
+            continue;
+        Marker const marker = 0xFF00 | segment[i + 1];
+        if (marker >= JPEG_RST0 && marker <= JPEG_RST7)
+            TRY(interval_offsets.try_append(i + 2));
+        ++i;
+    }
+
+    // With missing or extra restart markers the intervals can't be told apart, so decode the segment in one go.
+    // This fails, or tolerates the damage, exactly like decoding straight from the file does.
+    u32 const maximum_part_count = interval_offsets.size() == interval_count ? min(context.options.thread_count, interval_count) : 1;
+    u32 const intervals_per_part = ceil_div(interval_count, maximum_part_count);
+    u32 const part_count = ceil_div(interval_count, intervals_per_part);
+
+    struct Part {
+        u32 first_mcu { 0 };
+        u32 end_mcu { 0 };
+        ByteBuffer data;
+        Optional<Error> error;
+    };
+
+    Vector<Part> parts;
+    TRY(parts.try_resize(part_count));
+    for (u32 i = 0; i < part_count; ++i) {
+        u32 const first_interval = i * intervals_per_part;
+        u32 const end_interval = min(first_interval + intervals_per_part, interval_count);
+        parts[i].first_mcu = first_interval * context.dc_restart_interval;
+        parts[i].end_mcu = min(end_interval * context.dc_restart_interval, total_mcus);
+
+        // Stop right before the RSTn marker that starts the next part.
+        size_t const first_byte = interval_offsets[first_interval];
+        size_t const end_byte = end_interval == interval_count ? segment.size() : interval_offsets[end_interval] - 2;
+        TRY(parts[i].data.try_append(segment.bytes().slice(first_byte, end_byte - first_byte)));
+
+        // The Huffman stream reads ahead, so end every part with a marker for it to stop at.
+        TRY(parts[i].data.try_append(JPEG_EOI >> 8));
+        TRY(parts[i].data.try_append(JPEG_EOI & 0xFF));
+    }
+
+    auto decode_part = [&context, &macroblocks](Part& part) -> ErrorOr<void> {
+        auto stream = TRY(JPEGStream::create(make<FixedMemoryStream>(part.data.bytes())));
+        Scan scan(*context.current_scan, HuffmanStream { stream });
+        return decode_mcus(context, scan, macroblocks, part.first_mcu, part.end_mcu);
+    };
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    TRY(threads.try_ensure_capacity(part_count - 1));
+    for (u32 i = 0; i < part_count - 1; ++i) {
+        auto thread = Threading::Thread::construct([&part = parts[i], &decode_part]() -> intptr_t {
+            if (auto result = decode_part(part); result.is_error())
+                part.error = result.release_error();
+            return 0;
+        },
+            "JPEG decoder"sv);
+        thread->start();
+        threads.unchecked_append(move(thread));
+    }
+
+    // The calling thread takes care of the last part.
+    auto last_part_result = decode_part(parts.last());
+
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    for (auto& part : parts) {
+        if (part.error.has_value())
+            return part.error.release_value();
+    }
+    return last_part_result;
+}
+
+static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    if (can_decode_restart_intervals_in_parallel(context))
+        return decode_huffman_stream_in_parallel(context, macroblocks);
+    return decode_mcus(context, *context.current_scan, macroblocks, 0, mcu_count(context));
+}
+
 static bool is_frame_marker(Marker const marker)
 {
     // B.1.1.3 - Marker assignments
@@ -1432,10 +1604,11 @@ static void dequantize(JPEGLoadingContext const& context, Component const& compo
         block_component[k] *= quantization_table[k];
 }
 
-static void inverse_dct_8x8(i16* block_component)
+// Does a 1-D IDCT as described in https://unix4lyfe.org/dct-1d/, read aan.cc from bottom to top.
+// T is a vector of floats, so that several IDCTs are done at once.
+template<typename T>
+static ALWAYS_INLINE void inverse_dct_1d(Array<T, 8>& values)
 {
-    // Does a 2-D IDCT by doing two 1-D IDCTs as described in https://unix4lyfe.org/dct/
-    // The 1-D DCT idea is described at https://unix4lyfe.org/dct-1d/, read aan.cc from bottom to top.
     static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
@@ -1451,145 +1624,206 @@ static void inverse_dct_8x8(i16* block_component)
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
-    for (u32 k = 0; k < 8; ++k) {
-        float const g0 = block_component[0 * 8 + k] * s0;
-        float const g1 = block_component[4 * 8 + k] * s4;
-        float const g2 = block_component[2 * 8 + k] * s2;
-        float const g3 = block_component[6 * 8 + k] * s6;
-        float const g4 = block_component[5 * 8 + k] * s5;
-        float const g5 = block_component[1 * 8 + k] * s1;
-        float const g6 = block_component[7 * 8 + k] * s7;
-        float const g7 = block_component[3 * 8 + k] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[0 * 8 + k] = b0 + b7;
-        block_component[1 * 8 + k] = b1 + b6;
-        block_component[2 * 8 + k] = b2 + b5;
-        block_component[3 * 8 + k] = b3 + b4;
-        block_component[4 * 8 + k] = b3 - b4;
-        block_component[5 * 8 + k] = b2 - b5;
-        block_component[6 * 8 + k] = b1 - b6;
-        block_component[7 * 8 + k] = b0 - b7;
-    }
-    for (u32 l = 0; l < 8; ++l) {
-        float const g0 = block_component[l * 8 + 0] * s0;
-        float const g1 = block_component[l * 8 + 4] * s4;
-        float const g2 = block_component[l * 8 + 2] * s2;
-        float const g3 = block_component[l * 8 + 6] * s6;
-        float const g4 = block_component[l * 8 + 5] * s5;
-        float const g5 = block_component[l * 8 + 1] * s1;
-        float const g6 = block_component[l * 8 + 7] * s7;
-        float const g7 = block_component[l * 8 + 3] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[l * 8 + 0] = b0 + b7;
-        block_component[l * 8 + 1] = b1 + b6;
-        block_component[l * 8 + 2] = b2 + b5;
-        block_component[l * 8 + 3] = b3 + b4;
-        block_component[l * 8 + 4] = b3 - b4;
-        block_component[l * 8 + 5] = b2 - b5;
-        block_component[l * 8 + 6] = b1 - b6;
-        block_component[l * 8 + 7] = b0 - b7;
+    T const g0 = values[0] * s0;
+    T const g1 = values[4] * s4;
+    T const g2 = values[2] * s2;
+    T const g3 = values[6] * s6;
+    T const g4 = values[5] * s5;
+    T const g5 = values[1] * s1;
+    T const g6 = values[7] * s7;
+    T const g7 = values[3] * s3;
+
+    T const f0 = g0;
+    T const f1 = g1;
+    T const f2 = g2;
+    T const f3 = g3;
+    T const f4 = g4 - g7;
+    T const f5 = g5 + g6;
+    T const f6 = g5 - g6;
+    T const f7 = g4 + g7;
+
+    T const e0 = f0;
+    T const e1 = f1;
+    T const e2 = f2 - f3;
+    T const e3 = f2 + f3;
+    T const e4 = f4;
+    T const e5 = f5 - f7;
+    T const e6 = f6;
+    T const e7 = f5 + f7;
+    T const e8 = f4 + f6;
+
+    T const d0 = e0;
+    T const d1 = e1;
+    T const d2 = e2 * m1;
+    T const d3 = e3;
+    T const d4 = e4 * m2;
+    T const d5 = e5 * m3;
+    T const d6 = e6 * m4;
+    T const d7 = e7;
+    T const d8 = e8 * m5;
+
+    T const c0 = d0 + d1;
+    T const c1 = d0 - d1;
+    T const c2 = d2 - d3;
+    T const c3 = d3;
+    T const c4 = d4 + d8;
+    T const c5 = d5 + d7;
+    T const c6 = d6 - d8;
+    T const c7 = d7;
+    T const c8 = c5 - c6;
+
+    T const b0 = c0 + c3;
+    T const b1 = c1 + c2;
+    T const b2 = c1 - c2;
+    T const b3 = c0 - c3;
+    T const b4 = c4 - c8;
+    T const b5 = c8;
+    T const b6 = c6 - c7;
+    T const b7 = c7;
+
+    values[0] = b0 + b7;
+    values[1] = b1 + b6;
+    values[2] = b2 + b5;
+    values[3] = b3 + b4;
+    values[4] = b3 - b4;
+    values[5] = b2 - b5;
+    values[6] = b1 - b6;
+    values[7] = b0 - b7;
+}
+
+static ALWAYS_INLINE AK::SIMD::i32x4 truncate_to_i16(AK::SIMD::f32x4 values)
+{
+    // Matches assigning a float to an i16: round towards zero, then keep the low 16 bits.
+    auto truncated = AK::SIMD::simd_cast<AK::SIMD::i32x4>(values);
+    return (truncated << 16) >> 16;
+}
+
+static ALWAYS_INLINE void transpose_4x4(AK::SIMD::f32x4& a, AK::SIMD::f32x4& b, AK::SIMD::f32x4& c, AK::SIMD::f32x4& d)
+{
+    auto const ab_low = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+    auto const ab_high = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    auto const cd_low = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    auto const cd_high = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+    a = __builtin_shufflevector(ab_low, cd_low, 0, 1, 4, 5);
+    b = __builtin_shufflevector(ab_low, cd_low, 2, 3, 6, 7);
+    c = __builtin_shufflevector(ab_high, cd_high, 0, 1, 4, 5);
+    d = __builtin_shufflevector(ab_high, cd_high, 2, 3, 6, 7);
+}
+
+// The block is kept as two halves: left[row] holds columns 0 to 3 of that row, right[row] columns 4 to 7.
+static ALWAYS_INLINE void transpose_8x8(Array<AK::SIMD::f32x4, 8>& left, Array<AK::SIMD::f32x4, 8>& right)
+{
+    transpose_4x4(left[0], left[1], left[2], left[3]);
+    transpose_4x4(right[0], right[1], right[2], right[3]);
+    transpose_4x4(left[4], left[5], left[6], left[7]);
+    transpose_4x4(right[4], right[5], right[6], right[7]);
+    for (u32 i = 0; i < 4; ++i)
+        swap(right[i], left[i + 4]);
+}
+
+static void inverse_dct_8x8(i16* block_component)
+{
+    // Does a 2-D IDCT by doing two 1-D IDCTs as described in https://unix4lyfe.org/dct/
+    // Each 1-D pass transforms four columns at a time. The block is transposed in registers between the passes,
+    // so that the second pass transforms the rows. Like the scalar version this replaced, the result of each pass
+    // is truncated to i16.
+    using AK::SIMD::f32x4;
+    using AK::SIMD::i16x8;
+    using AK::SIMD::i32x4;
+    using AK::SIMD::simd_cast;
+
+    Array<f32x4, 8> left;
+    Array<f32x4, 8> right;
+    for (u32 row = 0; row < 8; ++row) {
+        auto const values = AK::SIMD::load_unaligned<i16x8>(block_component + row * 8);
+        left[row] = simd_cast<f32x4>(simd_cast<i32x4>(__builtin_shufflevector(values, values, 0, 1, 2, 3)));
+        right[row] = simd_cast<f32x4>(simd_cast<i32x4>(__builtin_shufflevector(values, values, 4, 5, 6, 7)));
+    }
+
+    inverse_dct_1d(left);
+    inverse_dct_1d(right);
+    for (u32 row = 0; row < 8; ++row) {
+        left[row] = simd_cast<f32x4>(truncate_to_i16(left[row]));
+        right[row] = simd_cast<f32x4>(truncate_to_i16(right[row]));
+    }
+
+    transpose_8x8(left, right);
+    inverse_dct_1d(left);
+    inverse_dct_1d(right);
+    transpose_8x8(left, right);
+
+    for (u32 row = 0; row < 8; ++row) {
+        // On little-endian targets, the low 16 bits of each i32 lane are the even i16 lanes.
+        auto const low = bit_cast<i16x8>(truncate_to_i16(left[row]));
+        auto const high = bit_cast<i16x8>(truncate_to_i16(right[row]));
+        AK::SIMD::store_unaligned(block_component + row * 8, __builtin_shufflevector(low, high, 0, 2, 4, 6, 8, 10, 12, 14));
+    }
+}
+
+static void inverse_dct_scaled(i16* block_component, u8 size)
+{
+    // Computes a size x size IDCT from the size x size lowest frequencies of the block, which
+    // yields the average of the corresponding 8/size x 8/size areas of the full resolution output.
+    // This is the same idea as libjpeg's jidctred.c.
+    VERIFY(size == 1 || size == 2 || size == 4);
+
+    if (size == 1) {
+        // Only the DC coefficient remains, with the same normalization as in inverse_dct_8x8().
+        block_component[0] = block_component[0] / 8;
+        return;
+    }
+
+    // factors[x * size + u] = C(u) / 2 * cos((2x + 1)uπ / 2size)
+    auto const compute_factors = [](u8 size) {
+        Array<float, 16> factors {};
+        for (u8 x = 0; x < size; ++x) {
+            for (u8 u = 0; u < size; ++u) {
+                float const c = u == 0 ? 1.0f / AK::sqrt(2.0f) : 1.0f;
+                factors[x * size + u] = c / 2.0f * AK::cos((2 * x + 1) * u * AK::Pi<float> / (2 * size));
+            }
+        }
+        return factors;
+    };
+    static auto const factors_2 = compute_factors(2);
+    static auto const factors_4 = compute_factors(4);
+    auto const& factors = size == 2 ? factors_2 : factors_4;
+
+    Array<float, 16> columns {};
+    for (u8 u = 0; u < size; ++u) {
+        for (u8 y = 0; y < size; ++y) {
+            float sum = 0;
+            for (u8 v = 0; v < size; ++v)
+                sum += factors[y * size + v] * block_component[v * 8 + u];
+            columns[y * size + u] = sum;
+        }
+    }
+
+    for (u8 y = 0; y < size; ++y) {
+        for (u8 x = 0; x < size; ++x) {
+            float sum = 0;
+            for (u8 u = 0; u < size; ++u)
+                sum += factors[x * size + u] * columns[y * size + u];
+            block_component[y * 8 + x] = sum;
+        }
+    }
+}
+
+template<CallableAs<void, u8> F>
+static ALWAYS_INLINE void for_each_pixel_of_block(JPEGLoadingContext const& context, F&& callback)
+{
+    auto const block_size = context.block_size();
+    for (u8 row = 0; row < block_size; ++row) {
+        for (u8 column = 0; column < block_size; ++column)
+            callback(row * 8 + column);
     }
 }
 
 static void inverse_dct(JPEGLoadingContext const& context, i16* block_component)
 {
-    inverse_dct_8x8(block_component);
+    if (context.scale_denominator == 1)
+        inverse_dct_8x8(block_component);
+    else
+        inverse_dct_scaled(block_component, context.block_size());
 
     // F.2.1.5 - Inverse DCT (IDCT)
     auto const level_shift = 1 << (context.frame.precision - 1);
@@ -1602,8 +1836,9 @@ static void inverse_dct(JPEGLoadingContext const& context, i16* block_component)
         return static_cast<u8>(color >> 4);
     };
 
-    for (u8 i = 0; i < 64; ++i)
+    for_each_pixel_of_block(context, [&](u8 i) {
         block_component[i] = clamp_to_8_bits(clamp(block_component[i] + level_shift, 0, max_value));
+    });
 }
 
 static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
@@ -1616,6 +1851,7 @@ static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macrobloc
     // FIXME: Allow more combinations of sampling factors.
     // See https://calendar.perfplanet.com/2015/why-arent-your-images-using-chroma-subsampling/ for
     // subsampling factors visble on the web. In PDF files, YCCK 2111 and 2112 and CMYK 2111 and 2112 are also present.
+    u8 const block_size = context.block_size();
     for (u32 component_i = 0; component_i < context.components.size(); component_i++) {
         auto& component = context.components[component_i];
         if (component.sampling_factors == context.sampling_factors)
@@ -1633,12 +1869,13 @@ static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macrobloc
                         u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[macroblock_index];
                         auto* block_component_destination = get_component(block, component_i);
-                        for (u8 i = 7; i < 8; --i) {
-                            for (u8 j = 7; j < 8; --j) {
+                        for (u8 i = block_size - 1; i < block_size; --i) {
+                            for (u8 j = block_size - 1; j < block_size; --j) {
                                 u8 const pixel = i * 8 + j;
-                                // The component is 8x8 subsampled 2x2. Upsample its 2x2 4x4 tiles.
-                                u32 const component_pxrow = (i / context.sampling_factors.vertical) + 4 * vfactor_i;
-                                u32 const component_pxcol = (j / context.sampling_factors.horizontal) + 4 * hfactor_i;
+                                // The component is subsampled, e.g. with factors of 2x2 each quarter of its block
+                                // is upsampled to cover a full block.
+                                u32 const component_pxrow = (i + block_size * vfactor_i) / context.sampling_factors.vertical;
+                                u32 const component_pxcol = (j + block_size * hfactor_i) / context.sampling_factors.horizontal;
                                 u32 const component_pixel = component_pxrow * 8 + component_pxcol;
                                 block_component_destination[pixel] = block_component_source[component_pixel];
                             }
@@ -1650,7 +1887,7 @@ static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macrobloc
     }
 }
 
-static void ycbcr_to_rgb(Vector<Macroblock>& macroblocks)
+static void ycbcr_to_rgb(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
 {
     // Conversion from YCbCr to RGB isn't specified in the first JPEG specification but in the JFIF extension:
     // See: https://www.itu.int/rec/dologin_pub.asp?lang=f&id=T-REC-T.871-201105-I!!PDF-E&type=items
@@ -1659,14 +1896,14 @@ static void ycbcr_to_rgb(Vector<Macroblock>& macroblocks)
         auto* y = macroblock.y;
         auto* cb = macroblock.cb;
         auto* cr = macroblock.cr;
-        for (u8 i = 0; i < 64; ++i) {
+        for_each_pixel_of_block(context, [&](u8 i) {
             int r = y[i] + 1.402f * (cr[i] - 128);
             int g = y[i] - 0.3441f * (cb[i] - 128) - 0.7141f * (cr[i] - 128);
             int b = y[i] + 1.772f * (cb[i] - 128);
             y[i] = clamp(r, 0, 255);
             cb[i] = clamp(g, 0, 255);
             cr[i] = clamp(b, 0, 255);
-        }
+        });
     }
 }
 
@@ -1682,30 +1919,30 @@ static void invert_colors_for_adobe_images(JPEGLoadingContext const& context, Ve
     // This is arguably a bug in Photoshop, but if you need to work with Photoshop
     // CMYK files, you will have to deal with it in your application.
     for (auto& macroblock : macroblocks) {
-        for (u8 i = 0; i < 64; ++i) {
+        for_each_pixel_of_block(context, [&](u8 i) {
             macroblock.r[i] = 255 - macroblock.r[i];
             macroblock.g[i] = 255 - macroblock.g[i];
             macroblock.b[i] = 255 - macroblock.b[i];
             macroblock.k[i] = 255 - macroblock.k[i];
-        }
+        });
     }
 }
 
-static void ycck_to_cmyk(Vector<Macroblock>& macroblocks)
+static void ycck_to_cmyk(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
 {
     // 7 - Conversions between colour encodings
     // YCCK is obtained from CMYK by converting the CMY channels to YCC channel.
 
     // To convert back into RGB, we only need the 3 first components, which are baseline YCbCr
-    ycbcr_to_rgb(macroblocks);
+    ycbcr_to_rgb(context, macroblocks);
 
     // RGB to CMY, as mentioned in https://www.smcm.iqfr.csic.es/docs/intel/ipp/ipp_manual/IPPI/ippi_ch15/functn_YCCKToCMYK_JPEG.htm#functn_YCCKToCMYK_JPEG
     for (auto& macroblock : macroblocks) {
-        for (u8 i = 0; i < 64; ++i) {
+        for_each_pixel_of_block(context, [&](u8 i) {
             macroblock.r[i] = 255 - macroblock.r[i];
             macroblock.g[i] = 255 - macroblock.g[i];
             macroblock.b[i] = 255 - macroblock.b[i];
-        }
+        });
     }
 }
 
@@ -1737,10 +1974,10 @@ static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, V
             }
             break;
         case ColorTransform::YCbCr:
-            ycbcr_to_rgb(macroblocks);
+            ycbcr_to_rgb(context, macroblocks);
             break;
         case ColorTransform::YCCK:
-            ycck_to_cmyk(macroblocks);
+            ycck_to_cmyk(context, macroblocks);
             break;
         }
 
@@ -1752,7 +1989,7 @@ static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, V
     //      - 3 components means YCbCr
     //      - 4 components means CMYK (Nothing to do here).
     if (context.components.size() == 3)
-        ycbcr_to_rgb(macroblocks);
+        ycbcr_to_rgb(context, macroblocks);
 
     if (context.components.size() == 1)
         grayscale_to_rgb(macroblocks);
@@ -1762,18 +1999,20 @@ static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, V
 
 static ErrorOr<void> compose_bitmap(JPEGLoadingContext& context, Vector<Macroblock> const& macroblocks)
 {
-    context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
-
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        u32 const block_row = y / 8;
-        u32 const pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            u32 const block_column = x / 8;
+    auto const size = context.scaled_size();
+    auto const block_size = context.block_size();
+    context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, size));
+
+    for (int y = 0; y < size.height(); y++) {
+        u32 const block_row = y / block_size;
+        u32 const pixel_row = y % block_size;
+        auto* scanline = context.bitmap->scanline(y);
+        for (int x = 0; x < size.width(); x++) {
+            u32 const block_column = x / block_size;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            u32 const pixel_column = x % 8;
+            u32 const pixel_column = x % block_size;
             u32 const pixel_index = pixel_row * 8 + pixel_column;
-            Color const color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = Color((u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index]).value();
         }
     }
 
@@ -1785,15 +2024,17 @@ static ErrorOr<void> compose_cmyk_bitmap(JPEGLoadingContext& context, Vector<Mac
     if (context.options.cmyk == JPEGDecoderOptions::CMYK::Normal)
         invert_colors_for_adobe_images(context, macroblocks);
 
-    context.cmyk_bitmap = TRY(Gfx::CMYKBitmap::create_with_size({ context.frame.width, context.frame.height }));
+    auto const size = context.scaled_size();
+    auto const block_size = context.block_size();
+    context.cmyk_bitmap = TRY(Gfx::CMYKBitmap::create_with_size(size));
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        u32 const block_row = y / 8;
-        u32 const pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            u32 const block_column = x / 8;
+    for (int y = 0; y < size.height(); y++) {
+        u32 const block_row = y / block_size;
+        u32 const pixel_row = y % block_size;
+        for (int x = 0; x < size.width(); x++) {
+            u32 const block_column = x / block_size;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            u32 const pixel_column = x % 8;
+            u32 const pixel_column = x % block_size;
             u32 const pixel_index = pixel_row * 8 + pixel_column;
             context.cmyk_bitmap->scanline(y)[x] = { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index], (u8)block.k[pixel_index] };
         }
@@ -1961,8 +2202,9 @@ static ErrorOr<void> decode_jpeg(JPEGLoadingContext& context)
     return {};
 }
 
-JPEGImageDecoderPlugin::JPEGImageDecoderPlugin(NonnullOwnPtr<JPEGLoadingContext> context)
-    : m_context(move(context))
+JPEGImageDecoderPlugin::JPEGImageDecoderPlugin(ReadonlyBytes data, NonnullOwnPtr<JPEGLoadingContext> context)
+    : m_data(data)
+    , m_context(move(context))
 {
 }
 
@@ -1990,26 +2232,56 @@ ErrorOr<NonnullOwnPtr<ImageDecoderPlugin>> JPEGImageDecoderPlugin::create_with_o
 {
     auto stream = TRY(try_make<FixedMemoryStream>(data));
     auto context = TRY(JPEGLoadingContext::create(move(stream), options));
-    auto plugin = TRY(adopt_nonnull_own_or_enomem(new (nothrow) JPEGImageDecoderPlugin(move(context))));
+    auto plugin = TRY(adopt_nonnull_own_or_enomem(new (nothrow) JPEGImageDecoderPlugin(data, move(context))));
     TRY(decode_header(*plugin->m_context));
     return plugin;
 }
 
-ErrorOr<ImageFrameDescriptor> JPEGImageDecoderPlugin::frame(size_t index, Optional<IntSize>)
+static u8 scale_denominator_for_ideal_size(JPEGLoadingContext const& context, Optional<IntSize> ideal_size)
 {
-    if (index > 0)
-        return Error::from_string_literal("JPEGImageDecoderPlugin: Invalid frame index");
+    if (!ideal_size.has_value())
+        return 1;
+
+    // Pick the largest reduction that still covers the requested size, so callers only ever have to scale down.
+    for (u8 denominator : { 8, 4, 2 }) {
+        if (ceil_div<int, int>(context.frame.width, denominator) >= ideal_size->width()
+            && ceil_div<int, int>(context.frame.height, denominator) >= ideal_size->height())
+            return denominator;
+    }
+    return 1;
+}
 
+ErrorOr<void> JPEGImageDecoderPlugin::decode_with_scale_denominator(u8 scale_denominator)
+{
     if (m_context->state == JPEGLoadingContext::State::Error)
         return Error::from_string_literal("JPEGImageDecoderPlugin: Decoding failed");
 
-    if (m_context->state < JPEGLoadingContext::State::BitmapDecoded) {
-        if (auto result = decode_jpeg(*m_context); result.is_error()) {
-            m_context->state = JPEGLoadingContext::State::Error;
-            return result.release_error();
-        }
-        m_context->state = JPEGLoadingContext::State::BitmapDecoded;
+    if (m_context->state == JPEGLoadingContext::State::BitmapDecoded) {
+        if (m_context->scale_denominator <= scale_denominator)
+            return {};
+
+        // The image has previously been decoded at a lower resolution, start over from the header.
+        auto stream = TRY(try_make<FixedMemoryStream>(m_data));
+        auto context = TRY(JPEGLoadingContext::create(move(stream), m_context->options));
+        TRY(decode_header(*context));
+        m_context = move(context);
+    }
+
+    m_context->scale_denominator = scale_denominator;
+    if (auto result = decode_jpeg(*m_context); result.is_error()) {
+        m_context->state = JPEGLoadingContext::State::Error;
+        return result.release_error();
     }
+    m_context->state = JPEGLoadingContext::State::BitmapDecoded;
+    return {};
+}
+
+ErrorOr<ImageFrameDescriptor> JPEGImageDecoderPlugin::frame(size_t index, Optional<IntSize> ideal_size)
+{
+    if (index > 0)
+        return Error::from_string_literal("JPEGImageDecoderPlugin: Invalid frame index");
+
+    TRY(decode_with_scale_denominator(scale_denominator_for_ideal_size(*m_context, ideal_size)));
 
     if (m_context->cmyk_bitmap && !m_context->bitmap)
         return ImageFrameDescriptor { TRY(m_context->cmyk_bitmap->to_low_quality_rgb()), 0 };
@@ -2047,13 +2319,7 @@ ErrorOr<NonnullRefPtr<CMYKBitmap>> JPEGImageDecoderPlugin::cmyk_frame()
 {
     VERIFY(natural_frame_format() == NaturalFrameFormat::CMYK);
 
-    if (m_context->state < JPEGLoadingContext::State::BitmapDecoded) {
-        if (auto result = decode_jpeg(*m_context); result.is_error()) {
-            m_context->state = JPEGLoadingContext::State::Error;
-            return result.release_error();
-        }
-        m_context->state = JPEGLoadingContext::State::BitmapDecoded;
-    }
+    TRY(decode_with_scale_denominator(1));
 
     return *m_context->cmyk_bitmap;
 }
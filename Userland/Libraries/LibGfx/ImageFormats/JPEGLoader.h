@@ -25,6 +25,10 @@ struct JPEGDecoderOptions {
         PDF,
     };
     CMYK cmyk { CMYK::Normal };
+
+    // If larger than 1, sequential scans that use restart intervals are split into groups of intervals
+    // that are entropy decoded on separate threads. Intact images decode to the same pixels either way.
+    unsigned thread_count { 1 };
 };
 
 class JPEGImageDecoderPlugin : public ImageDecoderPlugin {
@@ -36,6 +40,8 @@ public:
     virtual ~JPEGImageDecoderPlugin() override;
     virtual IntSize size() override;
 
+    // If ideal_size is provided, the frame may be decoded at 1/2, 1/4 or 1/8 of the image size,
+    // whichever is the smallest size that is still larger than ideal_size.
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index, Optional<IntSize> ideal_size = {}) override;
 
     virtual Optional<Metadata const&> metadata() override;
@@ -46,8 +52,11 @@ public:
     virtual ErrorOr<NonnullRefPtr<CMYKBitmap>> cmyk_frame() override;
 
 private:
-    JPEGImageDecoderPlugin(NonnullOwnPtr<JPEGLoadingContext>);
+    JPEGImageDecoderPlugin(ReadonlyBytes, NonnullOwnPtr<JPEGLoadingContext>);
+
+    ErrorOr<void> decode_with_scale_denominator(u8);
 
+    ReadonlyBytes m_data;
     NonnullOwnPtr<JPEGLoadingContext> m_context;
 };
 
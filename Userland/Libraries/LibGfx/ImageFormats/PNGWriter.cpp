@@ -12,10 +12,13 @@
 #include <AK/MemoryStream.h>
 #include <AK/SIMDExtras.h>
 #include <AK/String.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageFormats/PNGWriter.h>
+#include <LibThreading/Thread.h>
 
 namespace Gfx {
 
@@ -215,15 +218,15 @@ union [[gnu::packed]] Pixel {
 static_assert(AssertSize<Pixel, 4>());
 
 template<bool include_alpha, bool include_colors>
-static ErrorOr<void> add_image_data_to_chunk_impl(Gfx::Bitmap const& bitmap, PNGChunk& png_chunk, Compress::ZlibCompressionLevel compression_level)
+static ErrorOr<void> filter_rows(Gfx::Bitmap const& bitmap, int first_row, int end_row, ByteBuffer& uncompressed_block_data)
 {
-    ByteBuffer uncompressed_block_data;
-    TRY(uncompressed_block_data.try_ensure_capacity(bitmap.size_in_bytes() + bitmap.height()));
+    constexpr size_t bytes_per_pixel = (include_colors ? 3 : 1) + (include_alpha ? 1 : 0);
+    TRY(uncompressed_block_data.try_ensure_capacity((end_row - first_row) * (bitmap.width() * bytes_per_pixel + 1)));
 
     auto dummy_scanline = TRY(FixedArray<Pixel>::create(bitmap.width()));
-    auto const* scanline_minus_1 = dummy_scanline.data();
+    auto const* scanline_minus_1 = first_row == 0 ? dummy_scanline.data() : reinterpret_cast<Pixel const*>(bitmap.scanline(first_row - 1));
 
-    for (int y = 0; y < bitmap.height(); ++y) {
+    for (int y = first_row; y < end_row; ++y) {
         auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
 
         struct Filter {
@@ -332,41 +335,128 @@ static ErrorOr<void> add_image_data_to_chunk_impl(Gfx::Bitmap const& bitmap, PNG
         scanline_minus_1 = scanline;
     }
 
+    return {};
+}
+
+// Each band should be large enough that the lost back-references at band boundaries don't matter much,
+// and that the cost of spawning a thread is amortized.
+static constexpr size_t minimum_band_size_in_bytes = 256 * KiB;
+
+template<bool include_alpha, bool include_colors>
+static ErrorOr<void> add_image_data_to_chunk_in_bands(Gfx::Bitmap const& bitmap, PNGChunk& png_chunk, Compress::ZlibCompressionLevel compression_level, unsigned band_count)
+{
+    // Every band is filtered and deflated on its own thread. All bands but the last end in a sync flush,
+    // so the resulting deflate streams can simply be concatenated. Filtering still looks at the last row
+    // of the previous band, so the filtered data is identical to what a single-threaded encode produces.
+    struct Band {
+        int first_row { 0 };
+        int end_row { 0 };
+        ByteBuffer uncompressed_data;
+        ByteBuffer compressed_data;
+        Optional<Error> error;
+    };
+
+    Vector<Band> bands;
+    TRY(bands.try_resize(band_count));
+    int rows_per_band = ceil_div(bitmap.height(), static_cast<int>(band_count));
+    for (unsigned i = 0; i < band_count; ++i) {
+        bands[i].first_row = min(static_cast<int>(i) * rows_per_band, bitmap.height());
+        bands[i].end_row = min(bands[i].first_row + rows_per_band, bitmap.height());
+    }
+
+    auto deflate_level = static_cast<Compress::DeflateCompressor::CompressionLevel>(compression_level);
+    auto process_band = [&bitmap, deflate_level](Band& band, bool is_last_band) -> ErrorOr<void> {
+        TRY((filter_rows<include_alpha, include_colors>(bitmap, band.first_row, band.end_row, band.uncompressed_data)));
+
+        AllocatingMemoryStream output_stream;
+        auto deflate_stream = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), deflate_level));
+        TRY(deflate_stream->write_until_depleted(band.uncompressed_data));
+        if (is_last_band)
+            TRY(deflate_stream->final_flush());
+        else
+            TRY(deflate_stream->sync_flush());
+        band.compressed_data = TRY(output_stream.read_until_eof());
+        return {};
+    };
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    TRY(threads.try_ensure_capacity(band_count - 1));
+    for (unsigned i = 0; i < band_count - 1; ++i) {
+        auto thread = Threading::Thread::construct([&band = bands[i], &process_band]() -> intptr_t {
+            if (auto result = process_band(band, false); result.is_error())
+                band.error = result.release_error();
+            return 0;
+        },
+            "PNG encoder"sv);
+        thread->start();
+        threads.unchecked_append(move(thread));
+    }
+
+    // The calling thread takes care of the last band.
+    auto last_band_result = process_band(bands.last(), true);
+
+    for (auto& thread : threads)
+        (void)thread->join();
+    TRY(last_band_result);
+
+    Crypto::Checksum::Adler32 adler32;
+    Vector<ByteBuffer> deflate_streams;
+    TRY(deflate_streams.try_ensure_capacity(band_count));
+    for (auto& band : bands) {
+        if (band.error.has_value())
+            return band.error.release_value();
+        adler32.update(band.uncompressed_data);
+        deflate_streams.unchecked_append(move(band.compressed_data));
+    }
+
+    return png_chunk.add(TRY(Compress::ZlibCompressor::join_deflate_streams(deflate_streams, adler32.digest(), compression_level)));
+}
+
+template<bool include_alpha, bool include_colors>
+static ErrorOr<void> add_image_data_to_chunk_impl(Gfx::Bitmap const& bitmap, PNGChunk& png_chunk, Compress::ZlibCompressionLevel compression_level, unsigned thread_count)
+{
+    auto band_count = min<size_t>(thread_count, bitmap.size_in_bytes() / minimum_band_size_in_bytes);
+    band_count = min<size_t>(band_count, bitmap.height());
+    if (band_count > 1)
+        return add_image_data_to_chunk_in_bands<include_alpha, include_colors>(bitmap, png_chunk, compression_level, band_count);
+
+    ByteBuffer uncompressed_block_data;
+    TRY((filter_rows<include_alpha, include_colors>(bitmap, 0, bitmap.height(), uncompressed_block_data)));
     return png_chunk.compress_and_add(uncompressed_block_data, compression_level);
 }
 
-static ErrorOr<void> add_image_data_to_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, PNGChunk& png_chunk, Compress::ZlibCompressionLevel compression_level)
+static ErrorOr<void> add_image_data_to_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, PNGChunk& png_chunk, Compress::ZlibCompressionLevel compression_level, unsigned thread_count)
 {
     switch (color_type) {
     case PNG::ColorType::Greyscale:
-        return add_image_data_to_chunk_impl<false, false>(bitmap, png_chunk, compression_level);
+        return add_image_data_to_chunk_impl<false, false>(bitmap, png_chunk, compression_level, thread_count);
     case PNG::ColorType::Truecolor:
-        return add_image_data_to_chunk_impl<false, true>(bitmap, png_chunk, compression_level);
+        return add_image_data_to_chunk_impl<false, true>(bitmap, png_chunk, compression_level, thread_count);
     case PNG::ColorType::IndexedColor:
         VERIFY_NOT_REACHED();
     case PNG::ColorType::GreyscaleWithAlpha:
-        return add_image_data_to_chunk_impl<true, false>(bitmap, png_chunk, compression_level);
+        return add_image_data_to_chunk_impl<true, false>(bitmap, png_chunk, compression_level, thread_count);
     case PNG::ColorType::TruecolorWithAlpha:
-        return add_image_data_to_chunk_impl<true, true>(bitmap, png_chunk, compression_level);
+        return add_image_data_to_chunk_impl<true, true>(bitmap, png_chunk, compression_level, thread_count);
     }
     VERIFY_NOT_REACHED();
 }
 
-ErrorOr<void> PNGWriter::add_fdAT_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, u32 sequence_number, Compress::ZlibCompressionLevel compression_level)
+ErrorOr<void> PNGWriter::add_fdAT_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, u32 sequence_number, Compress::ZlibCompressionLevel compression_level, unsigned thread_count)
 {
     // https://www.w3.org/TR/png/#fdAT-chunk
     PNGChunk png_chunk { "fdAT"_string };
     TRY(png_chunk.reserve(bitmap.size_in_bytes() + 4));
     TRY(png_chunk.add_as_big_endian(sequence_number));
-    TRY(add_image_data_to_chunk(bitmap, color_type, png_chunk, compression_level));
+    TRY(add_image_data_to_chunk(bitmap, color_type, png_chunk, compression_level, thread_count));
     return add_chunk(png_chunk);
 }
 
-ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, Compress::ZlibCompressionLevel compression_level)
+ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, PNG::ColorType color_type, Compress::ZlibCompressionLevel compression_level, unsigned thread_count)
 {
     PNGChunk png_chunk { "IDAT"_string };
     TRY(png_chunk.reserve(bitmap.size_in_bytes()));
-    TRY(add_image_data_to_chunk(bitmap, color_type, png_chunk, compression_level));
+    TRY(add_image_data_to_chunk(bitmap, color_type, png_chunk, compression_level, thread_count));
     return add_chunk(png_chunk);
 }
 
@@ -410,7 +500,7 @@ ErrorOr<void> PNGWriter::encode(Stream& stream, Bitmap const& bitmap, Options co
     TRY(writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, color_type, 0, 0, 0));
     if (options.icc_data.has_value())
         TRY(writer.add_iCCP_chunk(options.icc_data.value(), options.compression_level));
-    TRY(writer.add_IDAT_chunk(bitmap, color_type, options.compression_level));
+    TRY(writer.add_IDAT_chunk(bitmap, color_type, options.compression_level, options.thread_count));
     TRY(writer.add_IEND_chunk());
     return {};
 }
@@ -503,9 +593,9 @@ ErrorOr<void> PNGAnimationWriter::add_frame(Bitmap& bitmap, int duration_ms, Int
     m_sequence_number++;
 
     if (is_first_frame) {
-        TRY(m_writer.add_IDAT_chunk(bitmap, PNG::ColorType::TruecolorWithAlpha, m_options.compression_level));
+        TRY(m_writer.add_IDAT_chunk(bitmap, PNG::ColorType::TruecolorWithAlpha, m_options.compression_level, m_options.thread_count));
     } else {
-        TRY(m_writer.add_fdAT_chunk(bitmap, PNG::ColorType::TruecolorWithAlpha, m_sequence_number, m_options.compression_level));
+        TRY(m_writer.add_fdAT_chunk(bitmap, PNG::ColorType::TruecolorWithAlpha, m_sequence_number, m_options.compression_level, m_options.thread_count));
         m_sequence_number++;
     }
 
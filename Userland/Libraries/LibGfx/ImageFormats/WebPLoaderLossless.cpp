@@ -438,74 +438,6 @@ private:
     {
     }
 
-    // These capitalized functions are all from the spec:
-    static u8 Average2(u8 a, u8 b)
-    {
-        return (a + b) / 2;
-    }
-
-    static u32 Select(u32 L, u32 T, u32 TL)
-    {
-        // "L = left pixel, T = top pixel, TL = top left pixel."
-
-#define ALPHA(x) ((x >> 24) & 0xff)
-#define RED(x) ((x >> 16) & 0xff)
-#define GREEN(x) ((x >> 8) & 0xff)
-#define BLUE(x) (x & 0xff)
-
-        // "ARGB component estimates for prediction."
-        int pAlpha = ALPHA(L) + ALPHA(T) - ALPHA(TL);
-        int pRed = RED(L) + RED(T) - RED(TL);
-        int pGreen = GREEN(L) + GREEN(T) - GREEN(TL);
-        int pBlue = BLUE(L) + BLUE(T) - BLUE(TL);
-
-        // "Manhattan distances to estimates for left and top pixels."
-        int pL = abs(pAlpha - (int)ALPHA(L)) + abs(pRed - (int)RED(L)) + abs(pGreen - (int)GREEN(L)) + abs(pBlue - (int)BLUE(L));
-        int pT = abs(pAlpha - (int)ALPHA(T)) + abs(pRed - (int)RED(T)) + abs(pGreen - (int)GREEN(T)) + abs(pBlue - (int)BLUE(T));
-
-        // "Return either left or top, the one closer to the prediction."
-        if (pL < pT) {
-            return L;
-        } else {
-            return T;
-        }
-
-#undef BLUE
-#undef GREEN
-#undef RED
-#undef ALPHA
-    }
-
-    // "Clamp the input value between 0 and 255."
-    static int Clamp(int a)
-    {
-        return clamp(a, 0, 255);
-    }
-
-    static int ClampAddSubtractFull(int a, int b, int c)
-    {
-        return Clamp(a + b - c);
-    }
-
-    static int ClampAddSubtractHalf(int a, int b)
-    {
-        return Clamp(a + (a - b) / 2);
-    }
-
-    // ...and we're back from the spec!
-    static Color average2(Color a, Color b)
-    {
-        return Color(Average2(a.red(), b.red()),
-            Average2(a.green(), b.green()),
-            Average2(a.blue(), b.blue()),
-            Average2(a.alpha(), b.alpha()));
-    }
-
-    static ARGB32 average2(ARGB32 a, ARGB32 b)
-    {
-        return average2(Color::from_argb(a), Color::from_argb(b)).value();
-    }
-
     static ErrorOr<ARGB32> predict(u8 predictor, ARGB32 TL, ARGB32 T, ARGB32 TR, ARGB32 L);
 
     int m_size_bits;
@@ -587,67 +519,9 @@ ErrorOr<NonnullRefPtr<Bitmap>> PredictorTransform::transform(NonnullRefPtr<Bitma
 
 ErrorOr<ARGB32> PredictorTransform::predict(u8 predictor, ARGB32 TL, ARGB32 T, ARGB32 TR, ARGB32 L)
 {
-    switch (predictor) {
-    case 0:
-        // "0xff000000 (represents solid black color in ARGB)"
-        return 0xff000000;
-    case 1:
-        // "L"
-        return L;
-    case 2:
-        // "T"
-        return T;
-    case 3:
-        // "TR"
-        return TR;
-    case 4:
-        // "TL"
-        return TL;
-    case 5:
-        // "Average2(Average2(L, TR), T)"
-        return average2(average2(L, TR), T);
-    case 6:
-        // "Average2(L, TL)"
-        return average2(L, TL);
-    case 7:
-        // "Average2(L, T)"
-        return average2(L, T);
-    case 8:
-        // "Average2(TL, T)"
-        return average2(TL, T);
-    case 9:
-        // "Average2(T, TR)"
-        return average2(T, TR);
-    case 10:
-        // "Average2(Average2(L, TL), Average2(T, TR))"
-        return average2(average2(L, TL), average2(T, TR));
-    case 11:
-        // "Select(L, T, TL)"
-        return Select(L, T, TL);
-    case 12: {
-        // "ClampAddSubtractFull(L, T, TL)"
-        auto color_L = Color::from_argb(L);
-        auto color_T = Color::from_argb(T);
-        auto color_TL = Color::from_argb(TL);
-        return Color(ClampAddSubtractFull(color_L.red(), color_T.red(), color_TL.red()),
-            ClampAddSubtractFull(color_L.green(), color_T.green(), color_TL.green()),
-            ClampAddSubtractFull(color_L.blue(), color_T.blue(), color_TL.blue()),
-            ClampAddSubtractFull(color_L.alpha(), color_T.alpha(), color_TL.alpha()))
-            .value();
-    }
-    case 13: {
-        // "ClampAddSubtractHalf(Average2(L, T), TL)"
-        auto color_L = Color::from_argb(L);
-        auto color_T = Color::from_argb(T);
-        auto color_TL = Color::from_argb(TL);
-        return Color(ClampAddSubtractHalf(Average2(color_L.red(), color_T.red()), color_TL.red()),
-            ClampAddSubtractHalf(Average2(color_L.green(), color_T.green()), color_TL.green()),
-            ClampAddSubtractHalf(Average2(color_L.blue(), color_T.blue()), color_TL.blue()),
-            ClampAddSubtractHalf(Average2(color_L.alpha(), color_T.alpha()), color_TL.alpha()))
-            .value();
-    }
-    }
-    return Error::from_string_literal("WebPImageDecoderPlugin: invalid predictor");
+    if (predictor > 13)
+        return Error::from_string_literal("WebPImageDecoderPlugin: invalid predictor");
+    return LosslessPredictors::predict(predictor, TL, T, TR, L);
 }
 
 // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#42_color_transform
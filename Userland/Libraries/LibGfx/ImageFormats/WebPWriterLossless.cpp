@@ -18,6 +18,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageFormats/WebPSharedLossless.h>
 #include <LibGfx/ImageFormats/WebPWriterLossless.h>
+#include <LibThreading/Thread.h>
 
 namespace Gfx {
 
@@ -527,11 +528,83 @@ static ARGB32 sub_argb32(ARGB32 a, ARGB32 b)
         .value();
 }
 
-static ErrorOr<NonnullRefPtr<Bitmap>> maybe_write_predictor_transform(LittleEndianOutputBitStream& bit_stream, NonnullRefPtr<Bitmap> bitmap)
+// Calls `function(first_row, end_row)` for disjoint ranges covering [0, row_count), on up to `thread_count` threads.
+static void for_each_row_range_in_parallel(int row_count, unsigned thread_count, Function<void(int first_row, int end_row)> const& function)
+{
+    auto range_count = clamp<int>(thread_count, 1, row_count);
+    int rows_per_range = ceil_div(row_count, range_count);
+
+    Vector<NonnullRefPtr<Threading::Thread>, 16> threads;
+    for (int first_row = rows_per_range; first_row < row_count; first_row += rows_per_range) {
+        auto thread = Threading::Thread::construct([&function, first_row, end_row = min(first_row + rows_per_range, row_count)]() -> intptr_t {
+            function(first_row, end_row);
+            return 0;
+        },
+            "WebP encoder"sv);
+        thread->start();
+        threads.append(move(thread));
+    }
+
+    // The calling thread takes care of the first range.
+    function(0, min(rows_per_range, row_count));
+
+    for (auto& thread : threads)
+        (void)thread->join();
+}
+
+static ALWAYS_INLINE ARGB32 predict_pixel(Bitmap const& bitmap, u8 predictor, int x, int y)
+{
+    // "There are special handling rules for some border pixels. If there is a prediction transform, regardless of the mode [0..13] for these pixels,
+    //  the predicted value for the left-topmost pixel of the image is 0xff000000, all pixels on the top row are L-pixel,
+    //  and all pixels on the leftmost column are T-pixel.
+    if (y == 0)
+        return x == 0 ? 0xff000000 : bitmap.scanline(0)[x - 1];
+    if (x == 0)
+        return bitmap.scanline(y - 1)[0];
+
+    auto const* scanline = bitmap.scanline(y);
+    auto const* previous_scanline = bitmap.scanline(y - 1);
+
+    // "Addressing the TR-pixel for pixels on the rightmost column is exceptional.
+    //  The pixels on the rightmost column are predicted by using the modes [0..13] just like pixels not on the border,
+    //  but the leftmost pixel on the same row as the current pixel is instead used as the TR-pixel."
+    ARGB32 TR = x + 1 < bitmap.width() ? previous_scanline[x + 1] : previous_scanline[0];
+    return LosslessPredictors::predict(predictor, previous_scanline[x - 1], previous_scanline[x], TR, scanline[x - 1]);
+}
+
+static u32 residual_cost(ARGB32 residual)
+{
+    // Small residuals, in either direction, are what make the transformed image compress well.
+    u32 cost = 0;
+    for (int i = 0; i < 4; ++i)
+        cost += abs(static_cast<i8>(residual >> (8 * i)));
+    return cost;
+}
+
+static u8 find_best_predictor(Bitmap const& bitmap, IntRect const& block)
+{
+    Array<u32, 14> costs {};
+    for (int y = block.top(); y < block.bottom(); ++y) {
+        auto const* scanline = bitmap.scanline(y);
+        for (int x = block.left(); x < block.right(); ++x) {
+            for (u8 predictor = 0; predictor < costs.size(); ++predictor)
+                costs[predictor] += residual_cost(sub_argb32(scanline[x], predict_pixel(bitmap, predictor, x, y)));
+        }
+    }
+
+    u8 best_predictor = 1; // Prefer "L" on ties, since that's what we used to always pick.
+    for (u8 predictor = 0; predictor < costs.size(); ++predictor) {
+        if (costs[predictor] < costs[best_predictor])
+            best_predictor = predictor;
+    }
+    return best_predictor;
+}
+
+static ErrorOr<NonnullRefPtr<Bitmap>> maybe_write_predictor_transform(LittleEndianOutputBitStream& bit_stream, NonnullRefPtr<Bitmap> bitmap, VP8LEncoderOptions const& options)
 {
     // https://developers.google.com/speed/webp/docs/webp_lossless_bitstream_specification#41_predictor_transform
 
-    // FIXME: Check if it's worth it to do this transform first, and use more than just the "L" predictor.
+    // FIXME: Check if it's worth it to do this transform first.
 
     dbgln_if(WEBP_DEBUG, "WebP: Writing predictor transform");
     TRY(bit_stream.write_bits(1u, 1u)); // Transform present.
@@ -543,39 +616,47 @@ static ErrorOr<NonnullRefPtr<Bitmap>> maybe_write_predictor_transform(LittleEndi
     //      int block_height = (1 << size_bits);
     //      #define DIV_ROUND_UP(num, den) (((num) + (den) - 1) / (den))
     //      int transform_width = DIV_ROUND_UP(image_width, 1 << size_bits);"
-    // We're always predicting to the left. Constant-value bitmaps encode in constant size with WebP's huffman tables,
-    // so it makes no difference which tile size we pick (...until we use more than one prediction mode).
-    unsigned size_bits = 0b111 + 2;
+    // Without a predictor search, we're always predicting to the left. Constant-value bitmaps encode in constant size
+    // with WebP's huffman tables, so it makes no difference which tile size we pick in that case.
+    // With a search, smaller tiles adapt better to the image, but make the subresolution image larger.
+    unsigned size_bits = options.search_predictors ? 4 : 0b111 + 2;
     TRY(bit_stream.write_bits(size_bits - 2, 3u));
 
     // "The transform data contains the prediction mode for each block of the image.
     //  It is a subresolution image where the green component of a pixel defines which of the 14 predictors is used
     //  for all the block_width * block_height pixels within a particular block of the ARGB image.
     //  This subresolution image is encoded using the same techniques described in Chapter 5."
-    unsigned block_size = 1 << size_bits;
+    int block_size = 1 << size_bits;
     auto subresolution_bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, { ceil_div(bitmap->width(), block_size), ceil_div(bitmap->height(), block_size) }));
-    subresolution_bitmap->fill(Color(0, 1 /* 1 is the "L" predictor */, 0, 0));
+    if (options.search_predictors) {
+        // Every block is independent, so the search can be split across threads by rows of blocks.
+        for_each_row_range_in_parallel(subresolution_bitmap->height(), options.thread_count, [&](int first_row, int end_row) {
+            for (int block_y = first_row; block_y < end_row; ++block_y) {
+                for (int block_x = 0; block_x < subresolution_bitmap->width(); ++block_x) {
+                    IntRect block { block_x * block_size, block_y * block_size, block_size, block_size };
+                    u8 predictor = find_best_predictor(*bitmap, block.intersected(bitmap->rect()));
+                    subresolution_bitmap->scanline(block_y)[block_x] = Color(0, predictor, 0, 0).value();
+                }
+            }
+        });
+    } else {
+        subresolution_bitmap->fill(Color(0, 1 /* 1 is the "L" predictor */, 0, 0));
+    }
     IsOpaque dont_care;
     TRY(write_VP8L_coded_image(ImageKind::EntropyCoded, bit_stream, *subresolution_bitmap, dont_care, {}));
 
     auto new_bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, bitmap->size()));
-    for (int y = 0; y < new_bitmap->height(); ++y) {
-        auto* old_scanline = bitmap->scanline(y);
-        auto* new_scanline = new_bitmap->scanline(y);
-
-        // "There are special handling rules for some border pixels. If there is a prediction transform, regardless of the mode [0..13] for these pixels,
-        //  the predicted value for the left-topmost pixel of the image is 0xff000000, all pixels on the top row are L-pixel,
-        //  and all pixels on the leftmost column are T-pixel.
-        ARGB32 top = y == 0 ? 0xff000000 : bitmap->scanline(y - 1)[0];
-        ARGB32 current = old_scanline[0];
-        new_scanline[0] = sub_argb32(current, top);
-
-        for (int x = 1; x < new_bitmap->width(); ++x) {
-            ARGB32 left = old_scanline[x - 1];
-            ARGB32 current = old_scanline[x];
-            new_scanline[x] = sub_argb32(current, left);
+    for_each_row_range_in_parallel(new_bitmap->height(), options.thread_count, [&](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            auto const* old_scanline = bitmap->scanline(y);
+            auto* new_scanline = new_bitmap->scanline(y);
+            auto const* predictor_scanline = subresolution_bitmap->scanline(y >> size_bits);
+            for (int x = 0; x < new_bitmap->width(); ++x) {
+                u8 predictor = Color::from_argb(predictor_scanline[x >> size_bits]).green();
+                new_scanline[x] = sub_argb32(old_scanline[x], predict_pixel(*bitmap, predictor, x, y));
+            }
         }
-    }
+    });
 
     return new_bitmap;
 }
@@ -732,7 +813,7 @@ static ErrorOr<void> write_VP8L_image_data(Stream& stream, NonnullRefPtr<Bitmap>
         }
 
         if (options.allowed_transforms & (1u << PREDICTOR_TRANSFORM))
-            bitmap = TRY(maybe_write_predictor_transform(bit_stream, bitmap));
+            bitmap = TRY(maybe_write_predictor_transform(bit_stream, bitmap, options));
     }
 
     TRY(bit_stream.write_bits(0u, 1u)); // No further transforms for now.
@@ -19,6 +19,13 @@ struct VP8LEncoderOptions {
     // Even if this set, if the encoder decides that a color cache would not be useful, it may not use one
     // (e.g. for images that use a color indexing transform already).
     Optional<unsigned> color_cache_bits { 6 };
+
+    // If set, the predictor transform picks the best of all 14 predictors for every block of the image.
+    // Else, it always uses the "L" predictor, which is faster but usually produces larger output.
+    bool search_predictors { false };
+
+    // The predictor search and the predictor transform are split across this many threads.
+    unsigned thread_count { 1 };
 };
 
 ErrorOr<ByteBuffer> compress_VP8L_image_data(Bitmap const&, VP8LEncoderOptions const&, bool& is_fully_opaque);
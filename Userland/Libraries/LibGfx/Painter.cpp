@@ -14,6 +14,7 @@
 #include "Bitmap.h"
 #include "Font/Emoji.h"
 #include "Font/Font.h"
+#include "Font/ScaledFont.h"
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
@@ -29,6 +30,7 @@
 #include <LibGfx/CharacterBitmap.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/Path.h>
+#include <LibGfx/PixelKernels.h>
 #include <LibGfx/Quad.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextLayout.h>
@@ -806,60 +808,18 @@ void Painter::draw_triangle(IntPoint a, IntPoint b, IntPoint c, Color color)
     }
 }
 
-struct BlitState {
-    enum AlphaState {
-        NoAlpha = 0,
-        SrcAlpha = 1,
-        DstAlpha = 2,
-        BothAlpha = SrcAlpha | DstAlpha
-    };
-
-    ARGB32 const* src;
-    ARGB32* dst;
-    size_t src_pitch;
-    size_t dst_pitch;
-    int row_count;
-    int column_count;
-    float opacity;
-    BitmapFormat src_format;
-};
-
-// FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
-//        Ideally we'd have a more generic solution that allows any source format.
-static void swap_red_and_blue_channels(Color& color)
-{
-    u32 rgba = color.value();
-    u32 bgra = (rgba & 0xff00ff00)
-        | ((rgba & 0x000000ff) << 16)
-        | ((rgba & 0x00ff0000) >> 16);
-    color = Color::from_argb(bgra);
-}
-
-// FIXME: This function is very unoptimized.
-template<BlitState::AlphaState has_alpha>
-static void do_blit_with_opacity(BlitState& state)
-{
-    for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            }
+static PixelKernels::AlphaTable alpha_table_for_opacity(float opacity, bool apply_source_alpha)
+{
+    PixelKernels::AlphaTable table;
+    for (size_t alpha = 0; alpha < table.size(); ++alpha) {
+        if (apply_source_alpha) {
+            float pixel_opacity = alpha / 255.0;
+            table[alpha] = 255 * (opacity * pixel_opacity);
+        } else {
+            table[alpha] = opacity * 255;
         }
-        state.dst += state.dst_pitch;
-        state.src += state.src_pitch;
     }
+    return table;
 }
 
 void Painter::blit_with_opacity(IntPoint position, Gfx::Bitmap const& source, IntRect const& a_src_rect, float opacity, bool apply_alpha)
@@ -888,27 +848,18 @@ void Painter::blit_with_opacity(IntPoint position, Gfx::Bitmap const& source, In
     int const first_column = clipped_rect.left() - dst_rect.left();
     int const last_column = clipped_rect.right() - dst_rect.left();
 
-    BlitState blit_state {
-        .src = source.scanline(src_rect.top() + first_row) + src_rect.left() + first_column,
-        .dst = target().scanline(clipped_rect.y()) + clipped_rect.x(),
-        .src_pitch = source.pitch() / sizeof(ARGB32),
-        .dst_pitch = target().pitch() / sizeof(ARGB32),
-        .row_count = last_row - first_row,
-        .column_count = last_column - first_column,
-        .opacity = opacity,
-        .src_format = source.format(),
-    };
+    ARGB32 const* src = source.scanline(src_rect.top() + first_row) + src_rect.left() + first_column;
+    ARGB32* dst = target().scanline(clipped_rect.y()) + clipped_rect.x();
+    size_t const src_skip = source.pitch() / sizeof(ARGB32);
+    size_t const dst_skip = target().pitch() / sizeof(ARGB32);
+    auto const alpha_table = alpha_table_for_opacity(opacity, source.has_alpha_channel() && apply_alpha);
+    bool const dst_is_opaque = !target().has_alpha_channel();
+    auto const src_order = source.format() == BitmapFormat::RGBA8888 ? PixelKernels::SourceOrder::RGBA : PixelKernels::SourceOrder::BGRA;
 
-    if (source.has_alpha_channel() && apply_alpha) {
-        if (target().has_alpha_channel())
-            do_blit_with_opacity<BlitState::BothAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::SrcAlpha>(blit_state);
-    } else {
-        if (target().has_alpha_channel())
-            do_blit_with_opacity<BlitState::DstAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::NoAlpha>(blit_state);
+    for (int row = first_row; row < last_row; ++row) {
+        PixelKernels::blend_span(dst, src, last_column - first_column, alpha_table, dst_is_opaque, src_order);
+        dst += dst_skip;
+        src += src_skip;
     }
 }
 
@@ -1091,13 +1042,7 @@ void Painter::blit(IntPoint position, Gfx::Bitmap const& source, IntRect const&
         u32 const* src = source.scanline(src_rect.top() + first_row) + src_rect.left() + first_column;
         size_t const src_skip = source.pitch() / sizeof(u32);
         for (int row = first_row; row < last_row; ++row) {
-            for (int i = 0; i < clipped_rect.width(); ++i) {
-                u32 rgba = src[i];
-                u32 bgra = (rgba & 0xff00ff00)
-                    | ((rgba & 0x000000ff) << 16)
-                    | ((rgba & 0x00ff0000) >> 16);
-                dst[i] = bgra;
-            }
+            PixelKernels::swap_red_and_blue(dst, src, clipped_rect.width());
             dst += dst_skip;
             src += src_skip;
         }
@@ -1138,6 +1083,9 @@ ALWAYS_INLINE static void do_draw_box_sampled_scaled_bitmap(Gfx::Bitmap& target,
     float source_pixel_height = src_rect.height() / dst_rect.height();
     float source_pixel_area = source_pixel_width * source_pixel_height;
     FloatRect const pixel_box = { 0.f, 0.f, 1.f, 1.f };
+    Vector<ARGB32> row_pixels;
+    if constexpr (has_alpha_channel)
+        row_pixels.resize(clipped_rect.width());
 
     for (int y = clipped_rect.top(); y < clipped_rect.bottom(); ++y) {
         auto* scanline = reinterpret_cast<Color*>(target.scanline(y));
@@ -1178,10 +1126,12 @@ ALWAYS_INLINE static void do_draw_box_sampled_scaled_bitmap(Gfx::Bitmap& target,
             };
 
             if constexpr (has_alpha_channel)
-                scanline[x] = scanline[x].blend(src_pixel);
+                row_pixels[x - clipped_rect.left()] = src_pixel.value();
             else
                 scanline[x] = src_pixel;
         }
+        if constexpr (has_alpha_channel)
+            PixelKernels::blend_span(target.scanline(y) + clipped_rect.left(), row_pixels.data(), row_pixels.size(), PixelKernels::identity_alpha_table, false);
     }
 }
 
@@ -1220,6 +1170,11 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 src_left = src_rect.left() * shift;
     i64 src_top = src_rect.top() * shift;
 
+    // NOTE: Each row is sampled into a buffer first, so that it can be blended onto the target all at once.
+    Vector<ARGB32> row_pixels;
+    if constexpr (has_alpha_channel)
+        row_pixels.resize(clipped_rect.width());
+
     for (int y = clipped_rect.top(); y < clipped_rect.bottom(); ++y) {
         auto* scanline = reinterpret_cast<Color*>(target.scanline(y));
         auto desired_y = (y - dst_rect.y()) * vscale + src_top;
@@ -1280,10 +1235,12 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
 
             if constexpr (has_alpha_channel)
-                scanline[x] = scanline[x].blend(src_pixel);
+                row_pixels[x - clipped_rect.left()] = src_pixel.value();
             else
                 scanline[x] = src_pixel;
         }
+        if constexpr (has_alpha_channel)
+            PixelKernels::blend_span(target.scanline(y) + clipped_rect.left(), row_pixels.data(), row_pixels.size(), PixelKernels::identity_alpha_table, false);
     }
 }
 
@@ -1386,6 +1343,63 @@ FLATTEN void Painter::draw_glyph(FloatPoint point, u32 code_point, Font const& f
     }
 }
 
+void Painter::draw_glyph_from_atlas(FloatPoint point, u32 code_point, ScaledFont const& font, Color color)
+{
+    auto glyph_id = font.glyph_id_for_code_point(code_point);
+    auto top_left = point + FloatPoint(font.glyph_metrics(glyph_id).left_side_bearing, 0);
+    auto glyph_position = Gfx::GlyphRasterPosition::get_nearest_fit_for(top_left);
+    auto glyph = font.glyph_from_atlas(glyph_id, glyph_position.subpixel_offset);
+    if (!glyph.has_value())
+        return;
+
+    auto dst_rect = IntRect(glyph_position.blit_position, glyph->rect.size()).translated(translation());
+    auto clipped_rect = dst_rect.intersected(clip_rect());
+    if (clipped_rect.is_empty())
+        return;
+
+    int const first_row = clipped_rect.top() - dst_rect.top();
+    int const first_column = clipped_rect.left() - dst_rect.left();
+    ARGB32* dst = target().scanline(clipped_rect.y()) + clipped_rect.x();
+    size_t const dst_skip = target().pitch() / sizeof(ARGB32);
+    auto dst_format = target().format();
+
+    for (int row = 0; row < clipped_rect.height(); ++row) {
+        u8 const* coverage = glyph->page->scanline(glyph->rect.y() + first_row + row) + glyph->rect.x() + first_column;
+        for (int x = 0; x < clipped_rect.width(); ++x) {
+            if (coverage[x] == 0)
+                continue;
+            u8 alpha = color.alpha() * coverage[x] / 255;
+            if (alpha == 0xff)
+                dst[x] = color.value();
+            else
+                dst[x] = color_for_format(dst_format, dst[x]).blend(color.with_alpha(alpha)).value();
+        }
+        dst += dst_skip;
+    }
+}
+
+void Painter::draw_glyph_run(ReadonlySpan<DrawGlyphOrEmoji> glyphs, Font const& font, Color color, FloatPoint translation, float position_scale)
+{
+    // NOTE: The atlas only holds coverage at 1x, so anything else goes through the regular glyph drawing path.
+    auto const* scaled_font = is<ScaledFont>(font) ? static_cast<ScaledFont const*>(&font) : nullptr;
+    bool const can_draw_from_atlas = scaled_font && !font.has_color_bitmaps() && scale() == 1;
+
+    for (auto const& glyph_or_emoji : glyphs) {
+        glyph_or_emoji.visit(
+            [&](DrawGlyph const& glyph) {
+                auto position = glyph.position.scaled(position_scale).translated(translation);
+                if (can_draw_from_atlas)
+                    draw_glyph_from_atlas(position, glyph.code_point, *scaled_font, color);
+                else
+                    draw_glyph(position, glyph.code_point, font, color);
+            },
+            [&](DrawEmoji const& emoji) {
+                auto position = emoji.position.scaled(position_scale).translated(translation);
+                draw_emoji(position.to_type<int>(), *emoji.emoji, font);
+            });
+    }
+}
+
 void Painter::draw_emoji(IntPoint point, Gfx::Bitmap const& emoji, Font const& font)
 {
     IntRect dst_rect {
@@ -1906,6 +1920,8 @@ void Painter::draw_physical_pixel(IntPoint physical_position, Color color, int t
         return;
 
     if (thickness == 1) { // Implies scale() == 1.
+        if (!clip_rect().contains(physical_position))
+            return;
         auto& pixel = target().scanline(physical_position.y())[physical_position.x()];
         return set_physical_pixel_with_draw_op(pixel, color_for_format(target().format(), pixel).blend(color));
     }
@@ -1939,35 +1955,34 @@ void Painter::draw_line(IntPoint a_p1, IntPoint a_p2, Color color, int thickness
 
     auto alternate_color_is_transparent = alternate_color == Color::Transparent;
 
+    // NOTE: Dots and dashes are laid out from the start of the line rather than from the edge of the clip rect, and
+    //       every pixel of a thick line is clipped on its own, so that clipping never changes what ends up inside it.
+
     // Special case: vertical line.
     if (point1.x() == point2.x()) {
         int const x = point1.x();
-        if (x < clip_rect.left() || x >= clip_rect.right())
-            return;
         if (point1.y() > point2.y())
             swap(point1, point2);
-        if (point1.y() >= clip_rect.bottom())
+        auto line_rect = IntRect { x, point1.y(), thickness, point2.y() - point1.y() + thickness }.intersected(clip_rect);
+        if (line_rect.is_empty())
             return;
-        if (point2.y() < clip_rect.top())
-            return;
-        int min_y = max(point1.y(), clip_rect.top());
-        int max_y = min(point2.y(), clip_rect.bottom() - 1);
+        int const max_y = min(point2.y(), clip_rect.bottom() - 1);
         if (style == LineStyle::Dotted) {
-            for (int y = min_y; y <= max_y; y += thickness * 2)
+            for (int y = point1.y(); y <= max_y; y += thickness * 2)
                 draw_physical_pixel({ x, y }, color, thickness);
         } else if (style == LineStyle::Dashed) {
-            for (int y = min_y; y <= max_y; y += thickness * 6) {
+            for (int y = point1.y(); y <= max_y; y += thickness * 6) {
                 draw_physical_pixel({ x, y }, color, thickness);
-                draw_physical_pixel({ x, min(y + thickness, max_y) }, color, thickness);
-                draw_physical_pixel({ x, min(y + thickness * 2, max_y) }, color, thickness);
+                draw_physical_pixel({ x, min(y + thickness, point2.y()) }, color, thickness);
+                draw_physical_pixel({ x, min(y + thickness * 2, point2.y()) }, color, thickness);
                 if (!alternate_color_is_transparent) {
-                    draw_physical_pixel({ x, min(y + thickness * 3, max_y) }, alternate_color, thickness);
-                    draw_physical_pixel({ x, min(y + thickness * 4, max_y) }, alternate_color, thickness);
-                    draw_physical_pixel({ x, min(y + thickness * 5, max_y) }, alternate_color, thickness);
+                    draw_physical_pixel({ x, min(y + thickness * 3, point2.y()) }, alternate_color, thickness);
+                    draw_physical_pixel({ x, min(y + thickness * 4, point2.y()) }, alternate_color, thickness);
+                    draw_physical_pixel({ x, min(y + thickness * 5, point2.y()) }, alternate_color, thickness);
                 }
             }
         } else {
-            fill_physical_rect({ x, min_y, thickness, max_y - min_y + thickness }, color);
+            fill_physical_rect(line_rect, color);
         }
         return;
     }
@@ -1975,32 +1990,28 @@ void Painter::draw_line(IntPoint a_p1, IntPoint a_p2, Color color, int thickness
     // Special case: horizontal line.
     if (point1.y() == point2.y()) {
         int const y = point1.y();
-        if (y < clip_rect.top() || y >= clip_rect.bottom())
-            return;
         if (point1.x() > point2.x())
             swap(point1, point2);
-        if (point1.x() >= clip_rect.right())
-            return;
-        if (point2.x() < clip_rect.left())
+        auto line_rect = IntRect { point1.x(), y, point2.x() - point1.x() + thickness, thickness }.intersected(clip_rect);
+        if (line_rect.is_empty())
             return;
-        int min_x = max(point1.x(), clip_rect.left());
-        int max_x = min(point2.x(), clip_rect.right() - 1);
+        int const max_x = min(point2.x(), clip_rect.right() - 1);
         if (style == LineStyle::Dotted) {
-            for (int x = min_x; x <= max_x; x += thickness * 2)
+            for (int x = point1.x(); x <= max_x; x += thickness * 2)
                 draw_physical_pixel({ x, y }, color, thickness);
         } else if (style == LineStyle::Dashed) {
-            for (int x = min_x; x <= max_x; x += thickness * 6) {
+            for (int x = point1.x(); x <= max_x; x += thickness * 6) {
                 draw_physical_pixel({ x, y }, color, thickness);
-                draw_physical_pixel({ min(x + thickness, max_x), y }, color, thickness);
-                draw_physical_pixel({ min(x + thickness * 2, max_x), y }, color, thickness);
+                draw_physical_pixel({ min(x + thickness, point2.x()), y }, color, thickness);
+                draw_physical_pixel({ min(x + thickness * 2, point2.x()), y }, color, thickness);
                 if (!alternate_color_is_transparent) {
-                    draw_physical_pixel({ min(x + thickness * 3, max_x), y }, alternate_color, thickness);
-                    draw_physical_pixel({ min(x + thickness * 4, max_x), y }, alternate_color, thickness);
-                    draw_physical_pixel({ min(x + thickness * 5, max_x), y }, alternate_color, thickness);
+                    draw_physical_pixel({ min(x + thickness * 3, point2.x()), y }, alternate_color, thickness);
+                    draw_physical_pixel({ min(x + thickness * 4, point2.x()), y }, alternate_color, thickness);
+                    draw_physical_pixel({ min(x + thickness * 5, point2.x()), y }, alternate_color, thickness);
                 }
             }
         } else {
-            fill_physical_rect({ min_x, y, max_x - min_x + thickness, thickness }, color);
+            fill_physical_rect(line_rect, color);
         }
         return;
     }
@@ -2042,8 +2053,7 @@ void Painter::draw_line(IntPoint a_p1, IntPoint a_p2, Color color, int thickness
         int const delta_error = 2 * abs(dy);
         int y = point1.y();
         for (int x = point1.x(); x <= point2.x(); ++x) {
-            if (clip_rect.contains(x, y))
-                draw_pixel_in_line(x, y);
+            draw_pixel_in_line(x, y);
             error += delta_error;
             if (error >= dx) {
                 y += y_step;
@@ -2055,8 +2065,7 @@ void Painter::draw_line(IntPoint a_p1, IntPoint a_p2, Color color, int thickness
         int const delta_error = 2 * abs(dx);
         int x = point1.x();
         for (int y = point1.y(); y <= point2.y(); ++y) {
-            if (clip_rect.contains(x, y))
-                draw_pixel_in_line(x, y);
+            draw_pixel_in_line(x, y);
             error += delta_error;
             if (error >= dy) {
                 x += x_step;
@@ -25,6 +25,7 @@
 #include <LibGfx/TextAlignment.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextElision.h>
+#include <LibGfx/TextLayout.h>
 #include <LibGfx/TextWrapping.h>
 #include <LibGfx/WindingRule.h>
 
@@ -115,6 +116,8 @@ public:
     void draw_glyph(FloatPoint, u32, Font const&, Color);
     void draw_glyph_or_emoji(FloatPoint, u32, Font const&, Color);
     void draw_glyph_or_emoji(FloatPoint, Utf8CodePointIterator&, Font const&, Color);
+    // Draws each glyph at its position scaled by position_scale and then offset by translation.
+    void draw_glyph_run(ReadonlySpan<DrawGlyphOrEmoji>, Font const&, Color, FloatPoint translation = {}, float position_scale = 1.0f);
     void draw_circle_arc_intersecting(IntRect const&, IntPoint, int radius, Color, int thickness);
 
     // Streamlined text drawing routine that does no wrapping/elision/alignment.
@@ -207,6 +210,7 @@ protected:
     State const& state() const { return m_state_stack.last(); }
 
     void fill_physical_rect(IntRect const&, Color);
+    void draw_glyph_from_atlas(FloatPoint, u32 code_point, ScaledFont const&, Color);
 
     IntRect m_clip_origin;
     NonnullRefPtr<Gfx::Bitmap> m_target;
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CPUFeatures.h>
+#include <AK/SIMDExtras.h>
+#include <LibGfx/PixelKernels.h>
+
+namespace Gfx::PixelKernels {
+
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE static VectorType swap_red_and_blue_lanes(VectorType pixels)
+{
+    return (pixels & 0xff00ff00) | ((pixels & 0xff) << 16) | ((pixels >> 16) & 0xff);
+}
+
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE static bool all_lanes_opaque(VectorType pixels)
+{
+    u32 combined = NumericLimits<u32>::max();
+    for (size_t lane = 0; lane < AK::SIMD::vector_length<VectorType>; ++lane)
+        combined &= pixels[lane];
+    return (combined >> 24) == 0xff;
+}
+
+ALWAYS_INLINE static ARGB32 swap_red_and_blue_pixel(ARGB32 pixel)
+{
+    return (pixel & 0xff00ff00) | ((pixel & 0xff) << 16) | ((pixel >> 16) & 0xff);
+}
+
+ALWAYS_INLINE static ARGB32 blend_pixel(ARGB32 destination, ARGB32 source, AlphaTable const& alpha_table, bool destination_is_opaque)
+{
+    auto destination_color = destination_is_opaque ? Color::from_rgb(destination) : Color::from_argb(destination);
+    auto source_color = Color::from_argb(source);
+    return destination_color.blend(source_color.with_alpha(alpha_table[source_color.alpha()])).value();
+}
+
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE static void blend_span_with(ARGB32* destination, ARGB32 const* source, size_t count, AlphaTable const& alpha_table, bool destination_is_opaque, SourceOrder order)
+{
+    constexpr size_t lanes = AK::SIMD::vector_length<VectorType>;
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        auto source_pixels = AK::SIMD::load_unaligned<VectorType>(source + i);
+        if (order == SourceOrder::RGBA)
+            source_pixels = swap_red_and_blue_lanes(source_pixels);
+
+        auto destination_pixels = AK::SIMD::load_unaligned<VectorType>(destination + i);
+        if (!destination_is_opaque && !all_lanes_opaque(destination_pixels)) {
+            // NOTE: Blending over a translucent destination needs a division per channel, so we leave that to Color.
+            for (size_t lane = 0; lane < lanes; ++lane)
+                destination[i + lane] = blend_pixel(destination_pixels[lane], source_pixels[lane], alpha_table, false);
+            continue;
+        }
+
+        VectorType alpha;
+        for (size_t lane = 0; lane < lanes; ++lane)
+            alpha[lane] = alpha_table[source_pixels[lane] >> 24];
+
+        auto blended = blend_over_opaque(destination_pixels, (source_pixels & 0xffffff) | (alpha << 24));
+        AK::SIMD::store_unaligned(destination + i, blended);
+    }
+
+    for (; i < count; ++i) {
+        auto source_pixel = order == SourceOrder::RGBA ? swap_red_and_blue_pixel(source[i]) : source[i];
+        destination[i] = blend_pixel(destination[i], source_pixel, alpha_table, destination_is_opaque);
+    }
+}
+
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE static void swap_red_and_blue_with(ARGB32* destination, ARGB32 const* source, size_t count)
+{
+    constexpr size_t lanes = AK::SIMD::vector_length<VectorType>;
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes)
+        AK::SIMD::store_unaligned(destination + i, swap_red_and_blue_lanes(AK::SIMD::load_unaligned<VectorType>(source + i)));
+    for (; i < count; ++i)
+        destination[i] = swap_red_and_blue_pixel(source[i]);
+}
+
+template<CPUFeatures>
+void blend_span_impl(ARGB32*, ARGB32 const*, size_t, AlphaTable const&, bool, SourceOrder);
+template<CPUFeatures>
+void swap_red_and_blue_impl(ARGB32*, ARGB32 const*, size_t);
+
+template<>
+void blend_span_impl<CPUFeatures::None>(ARGB32* destination, ARGB32 const* source, size_t count, AlphaTable const& alpha_table, bool destination_is_opaque, SourceOrder order)
+{
+    blend_span_with<AK::SIMD::u32x4>(destination, source, count, alpha_table, destination_is_opaque, order);
+}
+
+template<>
+void swap_red_and_blue_impl<CPUFeatures::None>(ARGB32* destination, ARGB32 const* source, size_t count)
+{
+    swap_red_and_blue_with<AK::SIMD::u32x4>(destination, source, count);
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] void blend_span_impl<CPUFeatures::X86_AVX2>(ARGB32* destination, ARGB32 const* source, size_t count, AlphaTable const& alpha_table, bool destination_is_opaque, SourceOrder order)
+{
+    blend_span_with<AK::SIMD::u32x8>(destination, source, count, alpha_table, destination_is_opaque, order);
+}
+
+template<>
+[[gnu::target("avx2")]] void swap_red_and_blue_impl<CPUFeatures::X86_AVX2>(ARGB32* destination, ARGB32 const* source, size_t count)
+{
+    swap_red_and_blue_with<AK::SIMD::u32x8>(destination, source, count);
+}
+#endif
+
+static decltype(&blend_span_impl<CPUFeatures::None>) const s_blend_span = [] {
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(detect_cpu_features(), CPUFeatures::X86_AVX2))
+            return &blend_span_impl<CPUFeatures::X86_AVX2>;
+    }
+    return &blend_span_impl<CPUFeatures::None>;
+}();
+
+static decltype(&swap_red_and_blue_impl<CPUFeatures::None>) const s_swap_red_and_blue = [] {
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(detect_cpu_features(), CPUFeatures::X86_AVX2))
+            return &swap_red_and_blue_impl<CPUFeatures::X86_AVX2>;
+    }
+    return &swap_red_and_blue_impl<CPUFeatures::None>;
+}();
+
+void blend_span(ARGB32* destination, ARGB32 const* source, size_t count, AlphaTable const& alpha_table, bool destination_is_opaque, SourceOrder order)
+{
+    s_blend_span(destination, source, count, alpha_table, destination_is_opaque, order);
+}
+
+void swap_red_and_blue(ARGB32* destination, ARGB32 const* source, size_t count)
+{
+    s_swap_red_and_blue(destination, source, count);
+}
+
+}
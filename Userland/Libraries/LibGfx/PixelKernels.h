@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/SIMD.h>
+#include <AK/Types.h>
+#include <LibGfx/Color.h>
+
+// Span-at-a-time pixel kernels for the hot loops of Painter. They're written against AK::SIMD's generic vectors and
+// pick the widest implementation the CPU supports at runtime, while producing exactly the same pixels as doing the
+// same thing one Color at a time.
+
+namespace Gfx::PixelKernels {
+
+// Maps the alpha of a source pixel to the alpha it's blended with, which is how callers apply an opacity.
+using AlphaTable = Array<u8, 256>;
+
+constexpr AlphaTable identity_alpha_table = [] {
+    AlphaTable table {};
+    for (size_t alpha = 0; alpha < table.size(); ++alpha)
+        table[alpha] = alpha;
+    return table;
+}();
+
+enum class SourceOrder {
+    BGRA,
+    RGBA,
+};
+
+// Blends source over destination like Color::blend(), after passing the alpha of every source pixel through
+// alpha_table. If destination_is_opaque is set, the alpha channel of the destination is ignored and taken to be 255.
+void blend_span(ARGB32* destination, ARGB32 const* source, size_t count, AlphaTable const& alpha_table, bool destination_is_opaque, SourceOrder = SourceOrder::BGRA);
+
+// Converts between BGRA and RGBA by swapping the red and blue channels. destination and source may be the same.
+void swap_red_and_blue(ARGB32* destination, ARGB32 const* source, size_t count);
+
+// Divides by 255, rounding down. This is exact for anything up to 255 * 255 + 255.
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE VectorType divide_by_255(VectorType value)
+{
+    return (value + 1 + (value >> 8)) >> 8;
+}
+
+// Color::blend() for a destination that's known to be opaque, which is by far the most common case. The result is
+// then opaque too, and each channel reduces to (destination * (255 - alpha) + source * alpha) / 255.
+template<AK::SIMD::SIMDVector VectorType>
+ALWAYS_INLINE VectorType blend_over_opaque(VectorType destination, VectorType source)
+{
+    auto alpha = source >> 24;
+    auto inverse_alpha = 255 - alpha;
+    auto blend_channel = [&](int shift) {
+        return divide_by_255(((destination >> shift) & 0xff) * inverse_alpha + ((source >> shift) & 0xff) * alpha) << shift;
+    };
+    return 0xff000000 | blend_channel(16) | blend_channel(8) | blend_channel(0);
+}
+
+}
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/AtomicRefCounted.h>
 #include <AK/ByteString.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Forward.h>
@@ -99,7 +100,7 @@ struct DrawEmoji {
 
 using DrawGlyphOrEmoji = Variant<DrawGlyph, DrawEmoji>;
 
-class GlyphRun : public RefCounted<GlyphRun> {
+class GlyphRun : public AtomicRefCounted<GlyphRun> {
 public:
     enum class TextType {
         Common,
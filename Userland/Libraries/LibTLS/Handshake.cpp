@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/Memory.h>
 #include <AK/Random.h>
 
 #include <LibCore/Timer.h>
@@ -15,10 +16,20 @@
 
 namespace TLS {
 
+// RFC 5246 section 7.4.9: "In previous versions of TLS, the verify_data was always 12 octets
+//                          long.  In the current version of TLS, it depends on the cipher
+//                          suite.  Any cipher suite which does not explicitly specify
+//                          verify_data_length has a verify_data_length equal to 12."
+// Simplification: Assume that verify_data_length is always 12.
+static constexpr u32 finished_verify_data_length = 12;
+
 ByteBuffer TLSv12::build_hello()
 {
     fill_with_random(m_context.local_random);
 
+    if (!m_context.is_server && m_context.connection_status == ConnectionStatus::Disconnected)
+        offer_cached_session();
+
     auto packet_version = (u16)m_context.options.version;
     auto version = (u16)m_context.options.version;
     PacketBuilder builder { ContentType::HANDSHAKE, packet_version };
@@ -75,6 +86,10 @@ ByteBuffer TLSv12::build_hello()
     auto supported_ec_point_formats_length = m_context.options.supported_ec_point_formats.size();
     bool supports_elliptic_curves = elliptic_curves_length && supported_ec_point_formats_length;
     bool enable_extended_master_secret = m_context.options.enable_extended_master_secret;
+    bool enable_session_ticket = m_context.options.enable_session_resumption;
+    size_t session_ticket_length = 0;
+    if (m_context.offered_session.has_value())
+        session_ticket_length = m_context.offered_session->session_ticket.size();
 
     // signature_algorithms: 2b extension ID, 2b extension length, 2b vector length, 2xN signatures and hashes
     extension_length += 2 + 2 + 2 + 2 * m_context.options.supported_signature_algorithms.size();
@@ -89,6 +104,9 @@ ByteBuffer TLSv12::build_hello()
     if (enable_extended_master_secret)
         extension_length += 4;
 
+    if (enable_session_ticket)
+        extension_length += 4 + session_ticket_length;
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -139,6 +157,14 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u16)0);
     }
 
+    if (enable_session_ticket) {
+        // session_ticket extension, empty unless we have a ticket to resume with (RFC 5077 section 3.2)
+        builder.append((u16)ExtensionType::SESSION_TICKET);
+        builder.append((u16)session_ticket_length);
+        if (session_ticket_length)
+            builder.append(m_context.offered_session->session_ticket.bytes());
+    }
+
     if (alpn_length) {
         // TODO
         VERIFY_NOT_REACHED();
@@ -173,22 +199,17 @@ ByteBuffer TLSv12::build_handshake_finished()
 {
     PacketBuilder builder { ContentType::HANDSHAKE, m_context.options.version, 12 + 64 };
     builder.append((u8)HandshakeType::FINISHED);
+    builder.append_u24(finished_verify_data_length);
 
-    // RFC 5246 section 7.4.9: "In previous versions of TLS, the verify_data was always 12 octets
-    //                          long.  In the current version of TLS, it depends on the cipher
-    //                          suite.  Any cipher suite which does not explicitly specify
-    //                          verify_data_length has a verify_data_length equal to 12."
-    // Simplification: Assume that verify_data_length is always 12.
-    constexpr u32 verify_data_length = 12;
-
-    builder.append_u24(verify_data_length);
-
-    u8 out[verify_data_length];
-    auto outbuffer = Bytes { out, verify_data_length };
+    u8 out[finished_verify_data_length];
+    auto outbuffer = Bytes { out, finished_verify_data_length };
     ByteBuffer dummy;
 
-    auto digest = m_context.handshake_hash.digest();
-    auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
+    // NOTE: Our Finished message goes into the hash as well, since the server's Finished message covers it.
+    //       Hash a copy so that the transcript stays intact.
+    Crypto::Hash::Manager handshake_hash_copy = m_context.handshake_hash.copy();
+    auto digest = handshake_hash_copy.digest();
+    auto hashbuf = ReadonlyBytes { digest.immutable_data(), handshake_hash_copy.digest_size() };
     pseudorandom_function(outbuffer, m_context.master_key, (u8 const*)"client finished", 15, hashbuf, dummy);
 
     builder.append(outbuffer);
@@ -215,20 +236,39 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     u32 size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
 
-    if (size < 12) {
-        dbgln_if(TLS_DEBUG, "finished packet smaller than minimum size: {}", size);
+    if (size != finished_verify_data_length) {
+        dbgln_if(TLS_DEBUG, "finished packet has unexpected size: {}", size);
         return (i8)Error::BrokenPacket;
     }
 
-    if (size < buffer.size() - index) {
+    if (size > buffer.size() - index) {
         dbgln_if(TLS_DEBUG, "not enough data after length: {} > {}", size, buffer.size() - index);
         return (i8)Error::NeedMoreData;
     }
 
-    // TODO: Compare Hashes
-    dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+    // RFC 5246 section 7.4.9: "Recipients of Finished messages MUST verify that the contents are correct."
+    // This is what proves that the server knows the master secret, which matters all the more when resuming a session,
+    // as there are no certificates to vouch for the server then.
+    u8 expected_verify_data[finished_verify_data_length];
+    ByteBuffer dummy;
+    Crypto::Hash::Manager handshake_hash_copy = m_context.handshake_hash.copy();
+    auto digest = handshake_hash_copy.digest();
+    auto hashbuf = ReadonlyBytes { digest.immutable_data(), handshake_hash_copy.digest_size() };
+    pseudorandom_function(Bytes { expected_verify_data, finished_verify_data_length }, m_context.master_key, (u8 const*)"server finished", 15, hashbuf, dummy);
+    if (!timing_safe_compare(expected_verify_data, buffer.offset_pointer(index), finished_verify_data_length)) {
+        dbgln("Server Finished message does not match the handshake");
+        return (i8)Error::NotSafe;
+    }
+
     m_context.connection_status = ConnectionStatus::Established;
 
+    // RFC 5246 section 7.3: In an abbreviated handshake the server sends its Finished message first,
+    //                       and we still have to send ours.
+    if (m_context.is_resumed_session)
+        write_packets = WritePacketStage::Finished;
+
+    store_session();
+
     if (m_handshake_timeout_timer) {
         // Disable the handshake timeout timer as handshake has been established.
         m_handshake_timeout_timer->stop();
@@ -308,6 +348,25 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case HandshakeType::NEW_SESSION_TICKET:
+            // RFC 5077 section 3.3: The server sends at most one NewSessionTicket message per handshake.
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.is_server) {
+                dbgln("unsupported: server mode");
+                VERIFY_NOT_REACHED();
+            }
+            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            } else {
+                payload_res = (i8)Error::UnexpectedMessage;
+            }
+            break;
         case HandshakeType::CERTIFICATE:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/Hex.h>
+#include <AK/QuickSort.h>
 #include <AK/Random.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
@@ -418,4 +419,148 @@ ByteBuffer TLSv12::build_client_key_exchange()
     return packet;
 }
 
+SessionKey const& TLSv12::session_key()
+{
+    if (m_context.session_key.has_value())
+        return *m_context.session_key;
+
+    auto& options = m_context.options;
+    Crypto::Hash::SHA256 configuration;
+    auto add_u16 = [&](u16 value) {
+        u8 bytes[] = { static_cast<u8>(value >> 8), static_cast<u8>(value) };
+        configuration.update(bytes, sizeof(bytes));
+    };
+    add_u16(to_underlying(options.version));
+    add_u16(options.validate_certificates);
+    add_u16(options.allow_self_signed_certificates);
+    add_u16(options.enable_extended_master_secret);
+    add_u16(options.usable_cipher_suites.size());
+    for (auto cipher : options.usable_cipher_suites)
+        add_u16(to_underlying(cipher));
+
+    // Without root certificates of their own, every connection trusts the same default ones.
+    add_u16(options.root_certificates.has_value());
+    if (options.root_certificates.has_value()) {
+        // The order in which the root certificates were given doesn't change what is trusted.
+        Vector<Crypto::Hash::SHA256::DigestType> certificate_digests;
+        certificate_digests.ensure_capacity(options.root_certificates->size());
+        for (auto const& certificate : *options.root_certificates)
+            certificate_digests.unchecked_append(Crypto::Hash::SHA256::hash(certificate.original_asn1));
+        quick_sort(certificate_digests, [](auto const& a, auto const& b) {
+            return memcmp(a.immutable_data(), b.immutable_data(), a.data_length()) < 0;
+        });
+        for (auto const& digest : certificate_digests)
+            configuration.update(digest.immutable_data(), digest.data_length());
+    }
+
+    m_context.session_key = SessionKey { m_context.extensions.SNI, m_context.port, configuration.digest() };
+    return *m_context.session_key;
+}
+
+void TLSv12::offer_cached_session()
+{
+    m_context.offered_session.clear();
+    m_context.is_resumed_session = false;
+
+    if (!m_context.options.enable_session_resumption || m_context.extensions.SNI.is_empty())
+        return;
+
+    auto session = SessionCache::the().find(session_key());
+    if (!session.has_value())
+        return;
+
+    if (!session->session_ticket.is_empty()) {
+        // RFC 5077 section 3.4: When presenting a ticket, the client MAY generate and include a Session ID in the TLS ClientHello.
+        //                       If the server accepts the ticket and the Session ID is not empty, then it MUST respond with the
+        //                       same Session ID present in the ClientHello.
+        // We rely on this to tell whether the server accepted the ticket.
+        auto session_id = ByteBuffer::create_uninitialized(sizeof(m_context.session_id));
+        if (session_id.is_error())
+            return;
+        session->session_id = session_id.release_value();
+        fill_with_random(session->session_id);
+    }
+
+    if (session->session_id.is_empty() || session->session_id.size() > sizeof(m_context.session_id))
+        return;
+
+    dbgln_if(TLS_DEBUG, "Offering cached session for {}", m_context.extensions.SNI);
+    memcpy(m_context.session_id, session->session_id.data(), session->session_id.size());
+    m_context.session_id_size = session->session_id.size();
+    m_context.offered_session = session.release_value();
+}
+
+ssize_t TLSv12::try_resume_offered_session()
+{
+    auto& session = *m_context.offered_session;
+
+    // The server indicates that it is resuming the session by echoing the session ID we sent.
+    if (ReadonlyBytes { m_context.session_id, m_context.session_id_size } != session.session_id.bytes()) {
+        dbgln_if(TLS_DEBUG, "Server declined to resume the session, performing a full handshake");
+        SessionCache::the().remove(session_key());
+        m_context.offered_session.clear();
+        return 0;
+    }
+
+    // RFC 5246 section 7.4.1.3: The server MUST select the cipher suite of the session being resumed.
+    // RFC 7627 section 5.3: The server MUST NOT change whether the extended master secret is used.
+    if (m_context.cipher != session.cipher || m_context.extensions.extended_master_secret != session.extended_master_secret) {
+        dbgln("Server resumed a session with different parameters");
+        SessionCache::the().remove(session_key());
+        return (i8)Error::NotSafe;
+    }
+
+    auto master_key = ByteBuffer::copy(session.master_key);
+    if (master_key.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.master_key = master_key.release_value();
+
+    if (!expand_key())
+        return (i8)Error::UnknownError;
+
+    dbgln_if(TLS_DEBUG, "Resuming cached session for {}", m_context.extensions.SNI);
+
+    // The server skips straight to ChangeCipherSpec and Finished.
+    m_context.is_resumed_session = true;
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    return 0;
+}
+
+void TLSv12::store_session()
+{
+    if (m_context.is_server || !m_context.options.enable_session_resumption || m_context.extensions.SNI.is_empty())
+        return;
+
+    // Resuming skips certificate validation, so only remember sessions whose certificates were actually validated.
+    if (!m_context.options.validate_certificates)
+        return;
+
+    Session session;
+    session.cipher = m_context.cipher;
+    session.extended_master_secret = m_context.extensions.extended_master_secret;
+
+    auto lifetime = SessionCache::default_session_lifetime;
+    if (!m_context.session_ticket.is_empty()) {
+        session.session_ticket = move(m_context.session_ticket);
+        if (m_context.session_ticket_lifetime_hint != 0)
+            lifetime = min(lifetime, Duration::from_seconds(m_context.session_ticket_lifetime_hint));
+    } else if (m_context.is_resumed_session) {
+        // Nothing changed about the session we just resumed, so keep it around as it was.
+        return;
+    } else if (m_context.session_id_size == 0) {
+        // The server does not support resumption.
+        return;
+    }
+    session.expiry = MonotonicTime::now_coarse() + lifetime;
+
+    auto session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    if (session_id.is_error() || master_key.is_error())
+        return;
+    session.session_id = session_id.release_value();
+    session.master_key = master_key.release_value();
+
+    SessionCache::the().store(session_key(), move(session));
+}
+
 }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+SessionCache& SessionCache::the()
+{
+    static SessionCache s_the;
+    return s_the;
+}
+
+Optional<Session> SessionCache::find(SessionKey const& key)
+{
+    return m_sessions.with_locked([&](auto& sessions) -> Optional<Session> {
+        auto it = sessions.find(key);
+        if (it == sessions.end())
+            return {};
+
+        if (it->value.expiry <= MonotonicTime::now_coarse()) {
+            sessions.remove(it);
+            return {};
+        }
+
+        return it->value;
+    });
+}
+
+void SessionCache::store(SessionKey const& key, Session session)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        if (sessions.size() >= MaximumSessionCount && !sessions.contains(key)) {
+            auto now = MonotonicTime::now_coarse();
+            sessions.remove_all_matching([&](auto&, auto& entry) { return entry.expiry <= now; });
+
+            // Still full, so make room by dropping the session that would have expired first.
+            if (sessions.size() >= MaximumSessionCount) {
+                auto oldest = sessions.begin();
+                for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+                    if (it->value.expiry < oldest->value.expiry)
+                        oldest = it;
+                }
+                sessions.remove(oldest);
+            }
+        }
+
+        sessions.set(key, move(session));
+    });
+}
+
+void SessionCache::remove(SessionKey const& key)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        sessions.remove(key);
+    });
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteReader.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTLS/Extensions.h>
+#include <LibThreading/MutexProtected.h>
+
+namespace TLS {
+
+// Everything needed to resume a previously negotiated session with an abbreviated handshake (RFC 5246 section 7.3).
+struct Session {
+    // Either the session ID chosen by the server, or the ID we generated to detect whether a ticket was accepted.
+    ByteBuffer session_id;
+    // An opaque ticket issued by the server, see RFC 5077. Takes precedence over the session ID when present.
+    ByteBuffer session_ticket;
+    ByteBuffer master_key;
+    CipherSuite cipher { CipherSuite::TLS_NULL_WITH_NULL_NULL };
+    bool extended_master_secret { false };
+    MonotonicTime expiry { MonotonicTime::now_coarse() };
+};
+
+// Resuming a session skips certificate validation, so a session may only be resumed by a connection to the same server
+// that would have trusted the same certificates.
+struct SessionKey {
+    ByteString host;
+    // Zero if we don't know the port, e.g. because the caller brought their own socket.
+    u16 port { 0 };
+    // A digest of everything in the connection options that affects what is trusted and negotiated, including the
+    // root certificates. See TLSv12::session_key().
+    Crypto::Hash::SHA256::DigestType configuration {};
+
+    bool operator==(SessionKey const&) const = default;
+};
+
+// A process-wide client-side cache of resumable sessions.
+class SessionCache {
+public:
+    static SessionCache& the();
+
+    Optional<Session> find(SessionKey const&);
+    void store(SessionKey const&, Session);
+    void remove(SessionKey const&);
+
+    static constexpr Duration default_session_lifetime = Duration::from_seconds(60 * 60);
+
+private:
+    SessionCache() = default;
+
+    static constexpr size_t MaximumSessionCount = 256;
+
+    Threading::MutexProtected<HashMap<SessionKey, Session>> m_sessions;
+};
+
+}
+
+template<>
+struct AK::Traits<TLS::SessionKey> : public DefaultTraits<TLS::SessionKey> {
+    static unsigned hash(TLS::SessionKey const& key)
+    {
+        return pair_int_hash(pair_int_hash(key.host.hash(), Traits<u16>::hash(key.port)), ByteReader::load32(key.configuration.immutable_data()));
+    }
+};
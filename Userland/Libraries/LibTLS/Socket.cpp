@@ -82,6 +82,7 @@ Coroutine<ErrorOr<NonnullOwnPtr<TLSv12>>> TLSv12::async_connect(ByteString const
     CO_TRY(tcp_socket->set_blocking(false));
     auto tls_socket = make<TLSv12>(move(tcp_socket), move(options));
     tls_socket->set_sni(host);
+    tls_socket->m_context.port = port;
     tls_socket->on_connected = [promise] { promise->resolve(); };
     tls_socket->on_tls_error = [&tls_socket = *tls_socket, promise](auto alert) {
         tls_socket.try_disambiguate_error();
@@ -280,6 +281,10 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        // RFC 5246 section 7.2.2: Any connection terminated with a fatal alert MUST NOT be resumed.
+        if (!m_context.is_server && m_context.session_key.has_value())
+            SessionCache::the().remove(*m_context.session_key);
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
@@ -353,8 +358,9 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
+    // NOTE: close_notify is a warning; a fatal alert would make the server forget the session (RFC 5246 section 7.2.2).
     if (underlying_stream().is_open())
-        alert(AlertLevel::FATAL, AlertDescription::CLOSE_NOTIFY);
+        alert(AlertLevel::WARNING, AlertDescription::CLOSE_NOTIFY);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
@@ -20,6 +20,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -194,6 +195,7 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
     OPTION_WITH_DEFAULTS(bool, enable_extended_master_secret, true)
+    OPTION_WITH_DEFAULTS(bool, enable_session_resumption, true)
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -298,7 +300,7 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[12] { 0 };
     ByteBuffer user_data;
     HashMap<ByteString, Certificate> root_certificates;
 
@@ -316,6 +318,15 @@ struct Context {
     } server_diffie_hellman_params;
 
     OwnPtr<Crypto::Curves::EllipticCurve> server_key_exchange_curve;
+
+    // Session resumption (RFC 5246 section 7.3, RFC 5077)
+    // The port we're connected to, if we know it. Only used to tell cached sessions apart.
+    u16 port { 0 };
+    Optional<SessionKey> session_key;
+    Optional<Session> offered_session;
+    bool is_resumed_session { false };
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
 };
 
 class TLSv12 final : public Core::Socket {
@@ -367,6 +378,7 @@ public:
     explicit TLSv12(StreamVariantType, Options);
 
     bool is_established() const { return m_context.connection_status == ConnectionStatus::Established; }
+    bool is_resumed_session() const { return m_context.is_resumed_session; }
 
     void set_sni(StringView sni)
     {
@@ -450,6 +462,7 @@ private:
     ssize_t handle_ecdhe_ecdsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
 
@@ -528,6 +541,11 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    SessionKey const& session_key();
+    void offer_cached_session();
+    ssize_t try_resume_offered_session();
+    void store_session();
+
     void try_disambiguate_error() const;
 
     bool m_eof { false };
@@ -997,8 +997,16 @@ void KeyframeEffect::update_style_properties()
         }
     }
 
-    if (invalidation.relayout)
-        document.set_needs_layout();
+    if (invalidation.relayout) {
+        // NOTE: Marking the target's layout node also covers the descendants that inherited animated values.
+        JS::GCPtr<Layout::Node> layout_node = target->layout_node();
+        if (pseudo_element_type().has_value())
+            layout_node = target->get_pseudo_element_node(pseudo_element_type().value());
+        if (layout_node)
+            layout_node->set_needs_layout_update();
+        else
+            document.set_needs_layout();
+    }
     if (invalidation.rebuild_layout_tree)
         document.invalidate_layout_tree();
     if (invalidation.repaint)
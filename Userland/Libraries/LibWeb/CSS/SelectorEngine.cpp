@@ -132,7 +132,7 @@ static inline bool matches_has_pseudo_class(CSS::Selector const& selector, Optio
 }
 
 // https://html.spec.whatwg.org/multipage/semantics-other.html#selector-link
-static inline bool matches_link_pseudo_class(DOM::Element const& element)
+bool matches_link_pseudo_class(DOM::Element const& element)
 {
     // All a elements that have an href attribute, and all area elements that have an href attribute, must match one of :link and :visited.
     if (!is<HTML::HTMLAnchorElement>(element) && !is<HTML::HTMLAreaElement>(element))
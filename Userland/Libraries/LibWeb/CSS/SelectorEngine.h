@@ -22,5 +22,6 @@ bool matches(CSS::Selector const&, Optional<CSS::CSSStyleSheet const&> style_she
 [[nodiscard]] bool can_use_fast_matches(CSS::Selector const&);
 
 [[nodiscard]] bool matches_hover_pseudo_class(DOM::Element const&);
+[[nodiscard]] bool matches_link_pseudo_class(DOM::Element const&);
 
 }
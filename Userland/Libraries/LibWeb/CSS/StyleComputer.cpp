@@ -69,6 +69,7 @@
 #include <LibWeb/DOM/Attr.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/DOM/NamedNodeMap.h>
 #include <LibWeb/DOM/ShadowRoot.h>
 #include <LibWeb/HTML/HTMLBRElement.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
@@ -359,6 +360,56 @@ StyleComputer::RuleCache const& StyleComputer::rule_cache_for_cascade_origin(Cas
     return true;
 }
 
+// Rules whose rightmost compound selector has one of these pseudo-classes (and nothing better to bucket on) are only
+// considered for the few elements that are currently in the corresponding state.
+static bool is_bucketable_pseudo_class(PseudoClass pseudo_class)
+{
+    switch (pseudo_class) {
+    case PseudoClass::Active:
+    case PseudoClass::AnyLink:
+    case PseudoClass::Focus:
+    case PseudoClass::FocusVisible:
+    case PseudoClass::FocusWithin:
+    case PseudoClass::Hover:
+    case PseudoClass::Link:
+    case PseudoClass::LocalLink:
+    case PseudoClass::Target:
+    case PseudoClass::Visited:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// NOTE: This must never return false for an element that SelectorEngine would match against the pseudo-class.
+static bool element_may_match_bucketed_pseudo_class(DOM::Element const& element, PseudoClass pseudo_class)
+{
+    switch (pseudo_class) {
+    case PseudoClass::Active:
+        return element.is_active();
+    case PseudoClass::AnyLink:
+    case PseudoClass::Link:
+    case PseudoClass::LocalLink:
+        return SelectorEngine::matches_link_pseudo_class(element);
+    case PseudoClass::Focus:
+    case PseudoClass::FocusVisible:
+        return element.is_focused();
+    case PseudoClass::FocusWithin: {
+        auto* focused_element = element.document().focused_element();
+        return focused_element && element.is_inclusive_ancestor_of(*focused_element);
+    }
+    case PseudoClass::Hover:
+        return SelectorEngine::matches_hover_pseudo_class(element);
+    case PseudoClass::Target:
+        return element.is_target();
+    case PseudoClass::Visited:
+        // NOTE: SelectorEngine never matches :visited.
+        return false;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 bool StyleComputer::should_reject_with_ancestor_filter(Selector const& selector) const
 {
     for (u32 hash : selector.ancestor_hashes()) {
@@ -370,7 +421,7 @@ bool StyleComputer::should_reject_with_ancestor_filter(Selector const& selector)
     return false;
 }
 
-Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& element, CascadeOrigin cascade_origin, Optional<CSS::Selector::PseudoElement::Type> pseudo_element, FlyString const& qualified_layer_name) const
+Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& element, CascadeOrigin cascade_origin, Optional<CSS::Selector::PseudoElement::Type> pseudo_element, FlyString const& qualified_layer_name, bool* prevents_style_sharing) const
 {
     auto const& root_node = element.root();
     auto shadow_root = is<DOM::ShadowRoot>(root_node) ? static_cast<DOM::ShadowRoot const*>(&root_node) : nullptr;
@@ -432,6 +483,11 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         }
     });
 
+    for (auto const& it : rule_cache.rules_by_pseudo_class) {
+        if (element_may_match_bucketed_pseudo_class(element, it.key))
+            add_rules_to_run(it.value);
+    }
+
     add_rules_to_run(rule_cache.other_rules);
 
     size_t maximum_match_count = 0;
@@ -462,6 +518,9 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
             continue;
         }
 
+        if (rule_to_run.prevents_style_sharing && prevents_style_sharing)
+            *prevents_style_sharing = true;
+
         ++maximum_match_count;
     }
 
@@ -1442,22 +1501,22 @@ void StyleComputer::start_needed_transitions(StyleProperties const& previous_sty
 
 // https://www.w3.org/TR/css-cascade/#cascading
 // https://drafts.csswg.org/css-cascade-5/#layering
-void StyleComputer::compute_cascaded_values(StyleProperties& style, DOM::Element& element, Optional<CSS::Selector::PseudoElement::Type> pseudo_element, bool& did_match_any_pseudo_element_rules, ComputeStyleMode mode) const
+void StyleComputer::compute_cascaded_values(StyleProperties& style, DOM::Element& element, Optional<CSS::Selector::PseudoElement::Type> pseudo_element, bool& did_match_any_pseudo_element_rules, bool& prevents_style_sharing, ComputeStyleMode mode) const
 {
     // First, we collect all the CSS rules whose selectors match `element`:
     MatchingRuleSet matching_rule_set;
-    matching_rule_set.user_agent_rules = collect_matching_rules(element, CascadeOrigin::UserAgent, pseudo_element);
+    matching_rule_set.user_agent_rules = collect_matching_rules(element, CascadeOrigin::UserAgent, pseudo_element, {}, &prevents_style_sharing);
     sort_matching_rules(matching_rule_set.user_agent_rules);
-    matching_rule_set.user_rules = collect_matching_rules(element, CascadeOrigin::User, pseudo_element);
+    matching_rule_set.user_rules = collect_matching_rules(element, CascadeOrigin::User, pseudo_element, {}, &prevents_style_sharing);
     sort_matching_rules(matching_rule_set.user_rules);
     // @layer-ed author rules
     for (auto const& layer_name : m_qualified_layer_names_in_order) {
-        auto layer_rules = collect_matching_rules(element, CascadeOrigin::Author, pseudo_element, layer_name);
+        auto layer_rules = collect_matching_rules(element, CascadeOrigin::Author, pseudo_element, layer_name, &prevents_style_sharing);
         sort_matching_rules(layer_rules);
         matching_rule_set.author_rules.append({ layer_name, layer_rules });
     }
     // Un-@layer-ed author rules
-    auto unlayered_author_rules = collect_matching_rules(element, CascadeOrigin::Author, pseudo_element);
+    auto unlayered_author_rules = collect_matching_rules(element, CascadeOrigin::Author, pseudo_element, {}, &prevents_style_sharing);
     sort_matching_rules(unlayered_author_rules);
     matching_rule_set.author_rules.append({ {}, unlayered_author_rules });
 
@@ -2309,10 +2368,16 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
 
     ScopeGuard guard { [&element]() { element.set_needs_style_update(false); } };
 
+    if (!pseudo_element.has_value()) {
+        if (auto shared_style = find_shareable_style(element))
+            return shared_style;
+    }
+
     auto style = StyleProperties::create();
     // 1. Perform the cascade. This produces the "specified style"
     bool did_match_any_pseudo_element_rules = false;
-    compute_cascaded_values(style, element, pseudo_element, did_match_any_pseudo_element_rules, mode);
+    bool prevents_style_sharing = false;
+    compute_cascaded_values(style, element, pseudo_element, did_match_any_pseudo_element_rules, prevents_style_sharing, mode);
 
     if (mode == ComputeStyleMode::CreatePseudoElementStyleIfNeeded) {
         // NOTE: If we're computing style for a pseudo-element, we look for a number of reasons to bail early.
@@ -2371,9 +2436,128 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
         start_needed_transitions(*previous_style, style, element, pseudo_element);
     }
 
+    if (!pseudo_element.has_value() && !prevents_style_sharing)
+        add_style_sharing_candidate(element, style);
+
     return style;
 }
 
+void StyleComputer::set_style_sharing_enabled(Badge<DOM::Document>, bool enabled)
+{
+    m_style_sharing_enabled = enabled;
+    m_style_sharing_candidates.clear();
+    m_style_sharing_parents.clear();
+}
+
+bool StyleComputer::can_element_take_part_in_style_sharing(DOM::Element const& element) const
+{
+    if (!m_style_sharing_enabled)
+        return false;
+
+    // The root element is matched by :root rules, and shadow hosts are matched by :host rules from their shadow tree,
+    // neither of which are bucketed in a way we can see here.
+    if (element.is_document_element() || element.is_shadow_host())
+        return false;
+
+    if (element.inline_style())
+        return false;
+
+    auto const* parent = element.parent_or_shadow_host_element();
+    if (!parent || !parent->computed_css_values())
+        return false;
+
+    // Elements in one of these states may match rules that a candidate in the same position doesn't. Rules that test
+    // these states further up the tree are safe, as the ancestors of two sharing elements are either the same elements
+    // or have themselves shared their style (which they couldn't while in one of these states).
+    if (element.is_active() || element.is_focused() || element.is_target() || SelectorEngine::matches_hover_pseudo_class(element))
+        return false;
+    if (auto* focused_element = element.document().focused_element(); focused_element && element.is_inclusive_ancestor_of(*focused_element))
+        return false;
+
+    // CSS animations and transitions are started and cancelled as a side effect of computing style.
+    if (element.has_associated_animations() || element.cached_animation_name_animation({}) || element.cached_transition_property_source())
+        return false;
+
+    return true;
+}
+
+DOM::Element const* StyleComputer::style_sharing_parent_for(DOM::Element const& element) const
+{
+    auto const* parent = element.parent_or_shadow_host_element();
+    if (!parent)
+        return nullptr;
+    if (auto shared_with = m_style_sharing_parents.get(*parent); shared_with.has_value())
+        return shared_with->ptr();
+    return parent;
+}
+
+bool StyleComputer::can_share_style(DOM::Element const& element, DOM::Element const& candidate, DOM::Element const& candidate_parent) const
+{
+    if (element.local_name() != candidate.local_name() || element.namespace_uri() != candidate.namespace_uri())
+        return false;
+
+    if (style_sharing_parent_for(element) != &candidate_parent)
+        return false;
+
+    // Inherited values come from the parent, so the parents must not only be equivalent but actually share their style.
+    auto const& parent_style = *element.parent_or_shadow_host_element()->computed_css_values();
+    auto const& candidate_parent_style = *candidate.parent_or_shadow_host_element()->computed_css_values();
+    if (!parent_style.has_same_data_as(candidate_parent_style))
+        return false;
+
+    if (&element.root() != &candidate.root())
+        return false;
+
+    if (element.class_names() != candidate.class_names())
+        return false;
+
+    // NOTE: This also covers the id, and any attribute that feeds into presentational hints.
+    auto const* attributes = element.attributes();
+    auto const* candidate_attributes = candidate.attributes();
+    auto attribute_count = attributes ? attributes->length() : 0;
+    if (attribute_count != (candidate_attributes ? candidate_attributes->length() : 0))
+        return false;
+    for (size_t i = 0; i < attribute_count; ++i) {
+        auto const* attribute = attributes->item(i);
+        auto const* candidate_attribute = candidate_attributes->item(i);
+        if (attribute->local_name() != candidate_attribute->local_name()
+            || attribute->namespace_uri() != candidate_attribute->namespace_uri()
+            || attribute->value() != candidate_attribute->value())
+            return false;
+    }
+
+    return true;
+}
+
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element& element) const
+{
+    if (!can_element_take_part_in_style_sharing(element))
+        return nullptr;
+
+    // NOTE: Similar elements tend to be styled one after another, so we look at the most recent candidates first.
+    for (size_t i = m_style_sharing_candidates.size(); i > 0; --i) {
+        auto const& candidate = m_style_sharing_candidates.at(i - 1);
+        if (!can_share_style(element, candidate.element, candidate.parent))
+            continue;
+
+        m_style_sharing_parents.set(element, candidate.element);
+        element.set_custom_properties({}, candidate.element->custom_properties({}));
+        return candidate.style->clone();
+    }
+    return nullptr;
+}
+
+void StyleComputer::add_style_sharing_candidate(DOM::Element const& element, StyleProperties const& style) const
+{
+    if (!can_element_take_part_in_style_sharing(element))
+        return;
+    if (style.animation_name_source() || style.transition_property_source())
+        return;
+
+    // NOTE: We keep a copy, as the caller may still make changes to the style it was given.
+    m_style_sharing_candidates.enqueue({ element, *style_sharing_parent_for(element), style.clone() });
+}
+
 void StyleComputer::build_rule_cache_if_needed() const
 {
     if (m_author_rule_cache && m_user_rule_cache && m_user_agent_rule_cache)
@@ -2417,7 +2601,55 @@ static Optional<SimplifiedSelectorForBucketing> is_roundabout_selector_bucketabl
     return {};
 }
 
-NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_cascade_origin(CascadeOrigin cascade_origin)
+// Returns whether matching the selector could depend on anything but the tag names, classes and attributes of the
+// element and its ancestors, or on the dynamic states that style sharing already checks for.
+static bool selector_prevents_style_sharing(CSS::Selector const& selector)
+{
+    for (auto const& compound_selector : selector.compound_selectors()) {
+        if (first_is_one_of(compound_selector.combinator, CSS::Selector::Combinator::NextSibling, CSS::Selector::Combinator::SubsequentSibling, CSS::Selector::Combinator::Column))
+            return true;
+
+        for (auto const& simple_selector : compound_selector.simple_selectors) {
+            if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Nesting)
+                return true;
+            if (simple_selector.type != CSS::Selector::SimpleSelector::Type::PseudoClass)
+                continue;
+
+            auto const& pseudo_class = simple_selector.pseudo_class();
+            switch (pseudo_class.type) {
+            case CSS::PseudoClass::Active:
+            case CSS::PseudoClass::AnyLink:
+            case CSS::PseudoClass::Focus:
+            case CSS::PseudoClass::FocusVisible:
+            case CSS::PseudoClass::FocusWithin:
+            case CSS::PseudoClass::Host:
+            case CSS::PseudoClass::Hover:
+            case CSS::PseudoClass::Lang:
+            case CSS::PseudoClass::Link:
+            case CSS::PseudoClass::LocalLink:
+            case CSS::PseudoClass::Root:
+            case CSS::PseudoClass::Scope:
+            case CSS::PseudoClass::Target:
+            case CSS::PseudoClass::Visited:
+                break;
+            case CSS::PseudoClass::Is:
+            case CSS::PseudoClass::Not:
+            case CSS::PseudoClass::Where:
+                for (auto const& argument_selector : pseudo_class.argument_selector_list) {
+                    if (selector_prevents_style_sharing(*argument_selector))
+                        return true;
+                }
+                break;
+            default:
+                // Structural pseudo-classes, :has(), and states that depend on more than the element's attributes.
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_cascade_origin(CascadeOrigin cascade_origin, StyleInvalidationData& style_invalidation_data)
 {
     auto rule_cache = make<RuleCache>();
 
@@ -2427,6 +2659,7 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
     size_t num_pseudo_element_rules = 0;
     size_t num_root_rules = 0;
     size_t num_attribute_rules = 0;
+    size_t num_pseudo_class_rules = 0;
     size_t num_hover_rules = 0;
 
     Vector<MatchingRule> matching_rules;
@@ -2455,8 +2688,11 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
                     false,
                     SelectorEngine::can_use_fast_matches(selector),
                     false,
+                    selector_prevents_style_sharing(selector),
                 };
 
+                style_invalidation_data.build_invalidation_sets_for_selector(selector);
+
                 bool contains_root_pseudo_class = false;
                 Optional<CSS::Selector::PseudoElement::Type> pseudo_element;
 
@@ -2562,6 +2798,12 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
                         rule_cache->root_rules.append(move(matching_rule));
                     } else {
                         for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
+                            if (simple_selector.type == CSS::Selector::SimpleSelector::Type::PseudoClass && is_bucketable_pseudo_class(simple_selector.pseudo_class().type)) {
+                                rule_cache->rules_by_pseudo_class.ensure(simple_selector.pseudo_class().type).append(move(matching_rule));
+                                ++num_pseudo_class_rules;
+                                added_to_bucket = true;
+                                break;
+                            }
                             if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Attribute) {
                                 rule_cache->rules_by_attribute_name.ensure(simple_selector.attribute().qualified_name.name.lowercase_name).append(move(matching_rule));
                                 ++num_attribute_rules;
@@ -2616,7 +2858,7 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
         ++style_sheet_index;
     });
 
-    size_t total_rules = num_class_rules + num_id_rules + num_tag_name_rules + num_pseudo_element_rules + num_root_rules + num_attribute_rules + rule_cache->other_rules.size();
+    size_t total_rules = num_class_rules + num_id_rules + num_tag_name_rules + num_pseudo_element_rules + num_root_rules + num_attribute_rules + num_pseudo_class_rules + rule_cache->other_rules.size();
     if constexpr (LIBWEB_CSS_DEBUG) {
         dbgln("Built rule cache!");
         dbgln("           ID: {}", num_id_rules);
@@ -2625,6 +2867,7 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
         dbgln("PseudoElement: {}", num_pseudo_element_rules);
         dbgln("         Root: {}", num_root_rules);
         dbgln("    Attribute: {}", num_attribute_rules);
+        dbgln("  PseudoClass: {}", num_pseudo_class_rules);
         dbgln("        Other: {}", rule_cache->other_rules.size());
         dbgln("        Total: {}", total_rules);
     }
@@ -2708,9 +2951,11 @@ void StyleComputer::build_rule_cache()
 
     build_qualified_layer_names_cache();
 
-    m_author_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::Author);
-    m_user_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::User);
-    m_user_agent_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::UserAgent);
+    auto style_invalidation_data = make<StyleInvalidationData>();
+    m_author_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::Author, *style_invalidation_data);
+    m_user_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::User, *style_invalidation_data);
+    m_user_agent_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::UserAgent, *style_invalidation_data);
+    m_style_invalidation_data = move(style_invalidation_data);
 
     m_has_has_selectors = m_author_rule_cache->has_has_selectors || m_user_rule_cache->has_has_selectors || m_user_agent_rule_cache->has_has_selectors;
 }
@@ -2728,6 +2973,14 @@ void StyleComputer::invalidate_rule_cache()
     // NOTE: It might not be necessary to throw away the UA rule cache.
     //       If we are sure that it's safe, we could keep it as an optimization.
     m_user_agent_rule_cache = nullptr;
+
+    m_style_invalidation_data = nullptr;
+}
+
+StyleInvalidationData const& StyleComputer::style_invalidation_data() const
+{
+    build_rule_cache_if_needed();
+    return *m_style_invalidation_data;
 }
 
 void StyleComputer::did_load_font(FlyString const&)
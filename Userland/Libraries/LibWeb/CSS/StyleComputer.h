@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/CircularQueue.h>
 #include <AK/HashMap.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
@@ -16,6 +17,7 @@
 #include <LibWeb/CSS/CSSKeyframesRule.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/Selector.h>
+#include <LibWeb/CSS/StyleInvalidation.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -93,6 +95,7 @@ struct MatchingRule {
     bool contains_pseudo_element { false };
     bool can_use_fast_matches { false };
     bool must_be_hovered { false };
+    bool prevents_style_sharing { false };
     bool skip { false };
 
     // Helpers to deal with the fact that `rule` might be a CSSStyleRule or a CSSNestedDeclarations
@@ -139,7 +142,7 @@ public:
     NonnullRefPtr<StyleProperties> compute_style(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type> = {}) const;
     RefPtr<StyleProperties> compute_pseudo_element_style_if_needed(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>) const;
 
-    Vector<MatchingRule> collect_matching_rules(DOM::Element const&, CascadeOrigin, Optional<CSS::Selector::PseudoElement::Type>, FlyString const& qualified_layer_name = {}) const;
+    Vector<MatchingRule> collect_matching_rules(DOM::Element const&, CascadeOrigin, Optional<CSS::Selector::PseudoElement::Type>, FlyString const& qualified_layer_name = {}, bool* prevents_style_sharing = nullptr) const;
 
     void invalidate_rule_cache();
 
@@ -156,6 +159,14 @@ public:
 
     void set_viewport_rect(Badge<DOM::Document>, CSSPixelRect const& viewport_rect) { m_viewport_rect = viewport_rect; }
 
+    // Lengths in rem and rlh units anywhere in the document are resolved against these.
+    [[nodiscard]] Length::FontMetrics const& root_element_font_metrics() const { return m_root_element_font_metrics; }
+
+    // Style sharing lets an element reuse the computed style of a recently styled sibling or cousin that is
+    // indistinguishable to every selector that could match it. It's only safe while the DOM can't change underneath
+    // us, so the document enables it for the duration of a style update.
+    void set_style_sharing_enabled(Badge<DOM::Document>, bool);
+
     enum class AnimationRefresh {
         No,
         Yes,
@@ -164,6 +175,9 @@ public:
 
     [[nodiscard]] bool has_has_selectors() const { return m_has_has_selectors; }
 
+    // Tells which elements need their style recomputed when something about a single element changes.
+    [[nodiscard]] StyleInvalidationData const& style_invalidation_data() const;
+
 private:
     enum class ComputeStyleMode {
         Normal,
@@ -175,7 +189,13 @@ private:
     [[nodiscard]] bool should_reject_with_ancestor_filter(Selector const&) const;
 
     RefPtr<StyleProperties> compute_style_impl(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, ComputeStyleMode) const;
-    void compute_cascaded_values(StyleProperties&, DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, bool& did_match_any_pseudo_element_rules, ComputeStyleMode) const;
+    void compute_cascaded_values(StyleProperties&, DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, bool& did_match_any_pseudo_element_rules, bool& prevents_style_sharing, ComputeStyleMode) const;
+
+    [[nodiscard]] bool can_element_take_part_in_style_sharing(DOM::Element const&) const;
+    [[nodiscard]] bool can_share_style(DOM::Element const&, DOM::Element const& candidate, DOM::Element const& candidate_parent) const;
+    [[nodiscard]] DOM::Element const* style_sharing_parent_for(DOM::Element const&) const;
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+    void add_style_sharing_candidate(DOM::Element const&, StyleProperties const&) const;
     static RefPtr<Gfx::FontCascadeList const> find_matching_font_weight_ascending(Vector<MatchingFontCandidate> const& candidates, int target_weight, float font_size_in_pt, bool inclusive);
     static RefPtr<Gfx::FontCascadeList const> find_matching_font_weight_descending(Vector<MatchingFontCandidate> const& candidates, int target_weight, float font_size_in_pt, bool inclusive);
     RefPtr<Gfx::FontCascadeList const> font_matching_algorithm(FontFaceKey const& key, float font_size_in_pt) const;
@@ -225,6 +245,7 @@ private:
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
         HashMap<FlyString, Vector<MatchingRule>, AK::ASCIICaseInsensitiveFlyStringTraits> rules_by_attribute_name;
         Array<Vector<MatchingRule>, to_underlying(CSS::Selector::PseudoElement::Type::KnownPseudoElementCount)> rules_by_pseudo_element;
+        HashMap<PseudoClass, Vector<MatchingRule>> rules_by_pseudo_class;
         Vector<MatchingRule> root_rules;
         Vector<MatchingRule> other_rules;
 
@@ -233,11 +254,13 @@ private:
         bool has_has_selectors { false };
     };
 
-    NonnullOwnPtr<RuleCache> make_rule_cache_for_cascade_origin(CascadeOrigin);
+    NonnullOwnPtr<RuleCache> make_rule_cache_for_cascade_origin(CascadeOrigin, StyleInvalidationData&);
 
     RuleCache const& rule_cache_for_cascade_origin(CascadeOrigin) const;
 
     bool m_has_has_selectors { false };
+
+    OwnPtr<StyleInvalidationData> m_style_invalidation_data;
     OwnPtr<RuleCache> m_author_rule_cache;
     OwnPtr<RuleCache> m_user_rule_cache;
     OwnPtr<RuleCache> m_user_agent_rule_cache;
@@ -252,6 +275,19 @@ private:
     CSSPixelRect m_viewport_rect;
 
     CountingBloomFilter<u8, 14> m_ancestor_filter;
+
+    struct StyleSharingCandidate {
+        JS::NonnullGCPtr<DOM::Element const> element;
+        JS::NonnullGCPtr<DOM::Element const> parent;
+        NonnullRefPtr<StyleProperties const> style;
+    };
+    static constexpr size_t style_sharing_cache_size = 32;
+    bool m_style_sharing_enabled { false };
+    mutable CircularQueue<StyleSharingCandidate, style_sharing_cache_size> m_style_sharing_candidates;
+
+    // Elements that took their style from a candidate during the current style update, mapped to the element whose
+    // style they share. Two elements whose parents map to the same element have equivalent ancestor chains.
+    mutable HashMap<JS::NonnullGCPtr<DOM::Element const>, JS::NonnullGCPtr<DOM::Element const>> m_style_sharing_parents;
 };
 
 class FontLoader : public ResourceClient {
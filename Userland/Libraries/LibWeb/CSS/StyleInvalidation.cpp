@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/CSS/Selector.h>
 #include <LibWeb/CSS/StyleInvalidation.h>
 #include <LibWeb/CSS/StyleProperties.h>
+#include <LibWeb/DOM/Element.h>
 
 namespace Web::CSS {
 
@@ -58,4 +60,256 @@ RequiredInvalidationAfterStyleChange compute_property_invalidation(CSS::Property
     return invalidation;
 }
 
+void InvalidationSet::include_all_from(InvalidationSet const& other)
+{
+    invalidate_self |= other.invalidate_self;
+    invalidate_whole_subtree |= other.invalidate_whole_subtree;
+    invalidate_siblings |= other.invalidate_siblings;
+    invalidate_whole_document |= other.invalidate_whole_document;
+    for (auto const& property : other.descendant_properties)
+        descendant_properties.set(property);
+}
+
+bool InvalidationSet::is_empty() const
+{
+    return !invalidate_self && !invalidate_whole_subtree && !invalidate_siblings && !invalidate_whole_document && descendant_properties.is_empty();
+}
+
+bool InvalidationSet::needs_invalidation_of_descendant(DOM::Element const& element) const
+{
+    for (auto const& property : descendant_properties) {
+        switch (property.type) {
+        case InvalidationProperty::Type::Class:
+            if (element.has_class(property.name, CaseSensitivity::CaseInsensitive))
+                return true;
+            break;
+        case InvalidationProperty::Type::Id:
+            if (element.id().has_value() && element.id()->equals_ignoring_ascii_case(property.name))
+                return true;
+            break;
+        case InvalidationProperty::Type::Attribute: {
+            bool has_attribute = false;
+            element.for_each_attribute([&](FlyString const& name, String const&) {
+                if (name.equals_ignoring_ascii_case(property.name))
+                    has_attribute = true;
+            });
+            if (has_attribute)
+                return true;
+            break;
+        }
+        case InvalidationProperty::Type::TagName:
+            if (element.local_name().equals_ignoring_ascii_case(property.name))
+                return true;
+            break;
+        }
+    }
+    return false;
+}
+
+// Returns something an element needs to have in order to be matched by the compound selector, preferring whatever is
+// likely to be the rarest.
+static Optional<InvalidationProperty> required_property_for_compound_selector(Selector::CompoundSelector const& compound_selector)
+{
+    Optional<InvalidationProperty> result;
+    for (auto const& simple_selector : compound_selector.simple_selectors) {
+        switch (simple_selector.type) {
+        case Selector::SimpleSelector::Type::Id:
+            return InvalidationProperty { InvalidationProperty::Type::Id, simple_selector.lowercase_name() };
+        case Selector::SimpleSelector::Type::Class:
+            if (!result.has_value() || result->type != InvalidationProperty::Type::Class)
+                result = InvalidationProperty { InvalidationProperty::Type::Class, simple_selector.lowercase_name() };
+            break;
+        case Selector::SimpleSelector::Type::Attribute:
+            if (!result.has_value() || result->type == InvalidationProperty::Type::TagName)
+                result = InvalidationProperty { InvalidationProperty::Type::Attribute, simple_selector.attribute().qualified_name.name.lowercase_name };
+            break;
+        case Selector::SimpleSelector::Type::TagName:
+            if (!result.has_value())
+                result = InvalidationProperty { InvalidationProperty::Type::TagName, simple_selector.qualified_name().name.lowercase_name };
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+
+// The attributes that can change whether an element matches the given pseudo-class, if it's one we know about.
+static Optional<ReadonlySpan<StringView>> attributes_driving_pseudo_class(PseudoClass pseudo_class)
+{
+    static constexpr Array checked_attributes { "checked"sv, "selected"sv, "type"sv };
+    static constexpr Array disabled_attributes { "disabled"sv, "type"sv };
+    static constexpr Array link_attributes { "href"sv };
+    static constexpr Array open_attributes { "open"sv };
+    static constexpr Array placeholder_shown_attributes { "placeholder"sv, "value"sv, "type"sv };
+    static constexpr Array read_only_attributes { "readonly"sv, "disabled"sv, "contenteditable"sv, "type"sv };
+
+    switch (pseudo_class) {
+    case PseudoClass::Checked:
+        return checked_attributes.span();
+    case PseudoClass::Disabled:
+    case PseudoClass::Enabled:
+        return disabled_attributes.span();
+    case PseudoClass::AnyLink:
+    case PseudoClass::Link:
+    case PseudoClass::LocalLink:
+        return link_attributes.span();
+    case PseudoClass::Open:
+        return open_attributes.span();
+    case PseudoClass::PlaceholderShown:
+        return placeholder_shown_attributes.span();
+    case PseudoClass::ReadOnly:
+    case PseudoClass::ReadWrite:
+        return read_only_attributes.span();
+    default:
+        return {};
+    }
+}
+
+// Pseudo-classes whose state never depends on attributes, or only on attributes that we always invalidate broadly for.
+// Whatever else changes their state is responsible for invalidating style itself.
+static bool is_attribute_independent_pseudo_class(PseudoClass pseudo_class)
+{
+    switch (pseudo_class) {
+    case PseudoClass::Active:
+    case PseudoClass::Empty:
+    case PseudoClass::FirstChild:
+    case PseudoClass::FirstOfType:
+    case PseudoClass::Focus:
+    case PseudoClass::FocusVisible:
+    case PseudoClass::FocusWithin:
+    case PseudoClass::Host:
+    case PseudoClass::Hover:
+    case PseudoClass::Lang:
+    case PseudoClass::LastChild:
+    case PseudoClass::LastOfType:
+    case PseudoClass::NthChild:
+    case PseudoClass::NthLastChild:
+    case PseudoClass::NthLastOfType:
+    case PseudoClass::NthOfType:
+    case PseudoClass::OnlyChild:
+    case PseudoClass::OnlyOfType:
+    case PseudoClass::Root:
+    case PseudoClass::Scope:
+    case PseudoClass::Target:
+    case PseudoClass::TargetWithin:
+    case PseudoClass::Visited:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void build_invalidation_sets_for_compound_selector(StyleInvalidationData&, Selector::CompoundSelector const&, InvalidationSet const&);
+
+static void build_invalidation_sets_for_argument_selectors(StyleInvalidationData& data, SelectorList const& argument_selectors, InvalidationSet const& invalidation_set)
+{
+    for (auto const& argument_selector : argument_selectors) {
+        auto const& compound_selectors = argument_selector->compound_selectors();
+        if (compound_selectors.size() == 1) {
+            build_invalidation_sets_for_compound_selector(data, compound_selectors.first(), invalidation_set);
+            continue;
+        }
+
+        // NOTE: Combinators inside the argument only ever lead from an element to its descendants or following
+        //       siblings, or to those of the elements it's related to, so invalidating all of them is enough.
+        auto broad_invalidation_set = invalidation_set;
+        broad_invalidation_set.invalidate_self = true;
+        broad_invalidation_set.invalidate_whole_subtree = true;
+        broad_invalidation_set.invalidate_siblings = true;
+        for (auto const& compound_selector : compound_selectors)
+            build_invalidation_sets_for_compound_selector(data, compound_selector, broad_invalidation_set);
+    }
+}
+
+static void build_invalidation_sets_for_compound_selector(StyleInvalidationData& data, Selector::CompoundSelector const& compound_selector, InvalidationSet const& invalidation_set)
+{
+    for (auto const& simple_selector : compound_selector.simple_selectors) {
+        switch (simple_selector.type) {
+        case Selector::SimpleSelector::Type::Id:
+            data.invalidation_sets.ensure({ InvalidationProperty::Type::Id, simple_selector.lowercase_name() }).include_all_from(invalidation_set);
+            break;
+        case Selector::SimpleSelector::Type::Class:
+            data.invalidation_sets.ensure({ InvalidationProperty::Type::Class, simple_selector.lowercase_name() }).include_all_from(invalidation_set);
+            break;
+        case Selector::SimpleSelector::Type::Attribute:
+            data.invalidation_sets.ensure({ InvalidationProperty::Type::Attribute, simple_selector.attribute().qualified_name.name.lowercase_name }).include_all_from(invalidation_set);
+            break;
+        case Selector::SimpleSelector::Type::PseudoClass: {
+            auto const& pseudo_class = simple_selector.pseudo_class();
+            switch (pseudo_class.type) {
+            case PseudoClass::Is:
+            case PseudoClass::Where:
+            case PseudoClass::Not:
+            case PseudoClass::Host:
+                build_invalidation_sets_for_argument_selectors(data, pseudo_class.argument_selector_list, invalidation_set);
+                break;
+            case PseudoClass::Has:
+            case PseudoClass::NthChild:
+            case PseudoClass::NthLastChild: {
+                // FIXME: :has() looks at descendants and siblings, and :nth-child(An+B of S) at all siblings, which
+                //        we have no narrower way to invalidate for yet.
+                InvalidationSet whole_document_invalidation_set;
+                whole_document_invalidation_set.invalidate_whole_document = true;
+                build_invalidation_sets_for_argument_selectors(data, pseudo_class.argument_selector_list, whole_document_invalidation_set);
+                break;
+            }
+            default:
+                if (auto attribute_names = attributes_driving_pseudo_class(pseudo_class.type); attribute_names.has_value()) {
+                    auto attribute_invalidation_set = invalidation_set;
+                    // NOTE: A disabled <fieldset> disables its descendants, and contenteditable is inherited.
+                    if (first_is_one_of(pseudo_class.type, PseudoClass::Disabled, PseudoClass::Enabled, PseudoClass::ReadOnly, PseudoClass::ReadWrite)) {
+                        attribute_invalidation_set.invalidate_self = true;
+                        attribute_invalidation_set.invalidate_whole_subtree = true;
+                    }
+                    for (auto attribute_name : *attribute_names)
+                        data.invalidation_sets.ensure({ InvalidationProperty::Type::Attribute, MUST(FlyString::from_utf8(attribute_name)) }).include_all_from(attribute_invalidation_set);
+                } else if (!is_attribute_independent_pseudo_class(pseudo_class.type)) {
+                    data.pseudo_class_invalidation_set.include_all_from(invalidation_set);
+                }
+                break;
+            }
+            break;
+        }
+        default:
+            // NOTE: Tag names can't change, and anything else can't be affected by a change to a single element.
+            break;
+        }
+    }
+}
+
+void StyleInvalidationData::build_invalidation_sets_for_selector(Selector const& selector)
+{
+    auto const& compound_selectors = selector.compound_selectors();
+    auto descendant_property = required_property_for_compound_selector(compound_selectors.last());
+
+    for (size_t i = 0; i < compound_selectors.size(); ++i) {
+        InvalidationSet invalidation_set;
+        if (i == compound_selectors.size() - 1) {
+            invalidation_set.invalidate_self = true;
+        } else {
+            // The combinator right after a compound selector tells us where the subject is, relative to the elements
+            // the compound selector matches. Sibling combinators further to the right never leave that subtree.
+            switch (compound_selectors[i + 1].combinator) {
+            case Selector::Combinator::ImmediateChild:
+            case Selector::Combinator::Descendant:
+                if (descendant_property.has_value())
+                    invalidation_set.descendant_properties.set(*descendant_property);
+                else
+                    invalidation_set.invalidate_whole_subtree = true;
+                break;
+            case Selector::Combinator::NextSibling:
+            case Selector::Combinator::SubsequentSibling:
+                invalidation_set.invalidate_siblings = true;
+                break;
+            case Selector::Combinator::Column:
+            case Selector::Combinator::None:
+                invalidation_set.invalidate_whole_document = true;
+                break;
+            }
+        }
+        build_invalidation_sets_for_compound_selector(*this, compound_selectors[i], invalidation_set);
+    }
+}
+
 }
@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <LibWeb/CSS/PropertyID.h>
+#include <LibWeb/Forward.h>
 
 namespace Web::CSS {
 
@@ -31,4 +35,61 @@ struct RequiredInvalidationAfterStyleChange {
 
 RequiredInvalidationAfterStyleChange compute_property_invalidation(CSS::PropertyID property_id, RefPtr<CSSStyleValue const> const& old_value, RefPtr<CSSStyleValue const> const& new_value);
 
+// Something about an element that selectors can test for, and that we can tell has changed when an attribute changes.
+// NOTE: Names are stored in lowercase, as class names and ids match case-insensitively in quirks mode.
+struct InvalidationProperty {
+    enum class Type : u8 {
+        Class,
+        Id,
+        Attribute,
+        TagName,
+    };
+
+    Type type;
+    FlyString name;
+
+    bool operator==(InvalidationProperty const&) const = default;
+};
+
+}
+
+namespace AK {
+
+template<>
+struct Traits<Web::CSS::InvalidationProperty> : public DefaultTraits<Web::CSS::InvalidationProperty> {
+    static unsigned hash(Web::CSS::InvalidationProperty const& property) { return pair_int_hash(to_underlying(property.type), property.name.hash()); }
+};
+
+}
+
+namespace Web::CSS {
+
+// Describes which elements need their style recomputed when an element gains or loses an InvalidationProperty.
+struct InvalidationSet {
+    bool invalidate_self { false };
+    bool invalidate_whole_subtree { false };
+    // Following siblings, along with their subtrees.
+    bool invalidate_siblings { false };
+    bool invalidate_whole_document { false };
+
+    // Descendants with any of these properties need their style recomputed.
+    HashTable<InvalidationProperty> descendant_properties;
+
+    void include_all_from(InvalidationSet const&);
+    [[nodiscard]] bool is_empty() const;
+    [[nodiscard]] bool needs_invalidation_of_descendant(DOM::Element const&) const;
+};
+
+// Derived from the selectors of all style rules that apply to a document. This lets us tell which elements' style can
+// change when something about a single element changes, instead of invalidating everything around it.
+struct StyleInvalidationData {
+    HashMap<InvalidationProperty, InvalidationSet> invalidation_sets;
+
+    // Attributes also drive pseudo-classes like :checked or :disabled, so any attribute change has to be treated as a
+    // potential change in the element's pseudo-class state.
+    InvalidationSet pseudo_class_invalidation_set;
+
+    void build_invalidation_sets_for_selector(Selector const&);
+};
+
 }
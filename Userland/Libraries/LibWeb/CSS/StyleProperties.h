@@ -51,6 +51,9 @@ public:
     static NonnullRefPtr<StyleProperties> create() { return adopt_ref(*new StyleProperties); }
     NonnullRefPtr<StyleProperties> clone() const;
 
+    // Whether the two share the same underlying data, i.e. one is an unmodified clone of the other.
+    [[nodiscard]] bool has_same_data_as(StyleProperties const& other) const { return m_data.ptr() == other.m_data.ptr(); }
+
     template<typename Callback>
     inline void for_each_property(Callback callback) const
     {
@@ -974,6 +974,7 @@ WebIDL::ExceptionOr<void> Document::set_title(String const& title)
 
 void Document::tear_down_layout_tree()
 {
+    m_previous_layout_state = nullptr;
     m_layout_root = nullptr;
     m_paintable = nullptr;
 }
@@ -1075,6 +1076,15 @@ URL::URL Document::parse_url(StringView url) const
 }
 
 void Document::set_needs_layout()
+{
+    m_needs_to_reset_cached_intrinsic_sizes = true;
+    if (m_needs_layout)
+        return;
+    m_needs_layout = true;
+    schedule_layout_update();
+}
+
+void Document::set_needs_layout_update(Badge<Layout::Node>)
 {
     if (m_needs_layout)
         return;
@@ -1162,7 +1172,20 @@ void Document::update_layout()
         }
     }
 
-    Layout::LayoutState layout_state;
+    if (m_needs_to_reset_cached_intrinsic_sizes) {
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([](auto& box) {
+            box.reset_cached_intrinsic_sizes();
+            return TraversalDecision::Continue;
+        });
+        m_needs_to_reset_cached_intrinsic_sizes = false;
+
+        // Anything may have changed, so none of the previous used values can be trusted either.
+        m_previous_layout_state = nullptr;
+    }
+
+    auto layout_state_ptr = make<Layout::LayoutState>();
+    auto& layout_state = *layout_state_ptr;
+    layout_state.m_previous_layout = m_previous_layout_state.ptr();
 
     {
         Layout::BlockFormattingContext root_formatting_context(layout_state, Layout::LayoutMode::Normal, *m_layout_root, nullptr);
@@ -1185,6 +1208,9 @@ void Document::update_layout()
 
     layout_state.commit(*m_layout_root);
 
+    layout_state.m_previous_layout = nullptr;
+    m_previous_layout_state = move(layout_state_ptr);
+
     // Broadcast the current viewport rect to any new paintables, so they know whether they're visible or not.
     inform_all_viewport_clients_about_the_current_viewport_rect();
 
@@ -1202,6 +1228,7 @@ void Document::update_layout()
 
     paintable()->update_selection();
 
+    m_layout_root->clear_needs_layout_update_in_subtree();
     m_needs_layout = false;
 
     // Scrolling by zero offset will clamp scroll offset back to valid range if it was out of bounds
@@ -1285,11 +1312,15 @@ void Document::update_style()
 
     style_computer().reset_ancestor_filter();
 
+    style_computer().set_style_sharing_enabled({}, true);
     auto invalidation = update_style_recursively(*this, style_computer());
+    style_computer().set_style_sharing_enabled({}, false);
     if (invalidation.rebuild_layout_tree) {
         invalidate_layout_tree();
     } else {
-        if (invalidation.relayout)
+        // NOTE: Elements whose style change requires relayout have already marked their layout nodes,
+        //       so we only need to fall back to a full relayout if none of them had one.
+        if (invalidation.relayout && !m_needs_layout)
             set_needs_layout();
         if (invalidation.rebuild_stacking_context_tree)
             invalidate_stacking_context_tree();
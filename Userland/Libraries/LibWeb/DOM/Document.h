@@ -241,7 +241,10 @@ public:
     void update_paint_and_hit_testing_properties_if_needed();
     void update_animated_style_if_needed();
 
+    // Schedules a layout that also drops all cached intrinsic sizes. Prefer Layout::Node::set_needs_layout_update()
+    // when the change is confined to a known subtree.
     void set_needs_layout();
+    void set_needs_layout_update(Badge<Layout::Node>);
 
     void invalidate_layout_tree();
     void invalidate_stacking_context_tree();
@@ -855,6 +858,10 @@ private:
     Vector<WeakPtr<CSS::MediaQueryList>> m_media_query_lists;
 
     bool m_needs_layout { false };
+    bool m_needs_to_reset_cached_intrinsic_sizes { false };
+
+    // The last committed layout. Subtrees that haven't changed since can have their used values copied from it.
+    OwnPtr<Layout::LayoutState> m_previous_layout_state;
 
     bool m_needs_full_style_update { false };
 
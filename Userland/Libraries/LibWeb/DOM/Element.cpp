@@ -450,7 +450,7 @@ void Element::run_attribute_change_steps(FlyString const& local_name, Optional<S
     attribute_changed(local_name, old_value, value);
 
     if (old_value != value) {
-        invalidate_style_after_attribute_change(local_name);
+        invalidate_style_after_attribute_change(local_name, old_value, value);
         document().bump_dom_tree_version();
     }
 }
@@ -512,6 +512,18 @@ void Element::attribute_changed(FlyString const& name, Optional<String> const&,
     }
 }
 
+static bool custom_properties_are_equal(HashMap<FlyString, CSS::StyleProperty> const& a, HashMap<FlyString, CSS::StyleProperty> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (auto const& it : a) {
+        auto other = b.get(it.key);
+        if (!other.has_value() || other->important != it.value.important || *other->value != *it.value.value)
+            return false;
+    }
+    return true;
+}
+
 static CSS::RequiredInvalidationAfterStyleChange compute_required_invalidation(CSS::StyleProperties const& old_style, CSS::StyleProperties const& new_style)
 {
     CSS::RequiredInvalidationAfterStyleChange invalidation;
@@ -536,8 +548,21 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
     VERIFY(parent());
 
     auto& style_computer = document().style_computer();
+    auto old_custom_properties = m_custom_properties;
+    auto old_root_element_font_metrics = style_computer.root_element_font_metrics();
     auto new_computed_css_values = style_computer.compute_style(*this);
 
+    // Our children inherit from us, so if our style changes, theirs might change too.
+    // NOTE: This runs before we return below, as custom properties aren't part of the computed values.
+    if (!custom_properties_are_equal(old_custom_properties, m_custom_properties))
+        invalidate_inherited_style_of_children(InheritedStyleChange::CustomProperties);
+
+    // Computing the style of the root element updates the font metrics that rem lengths are resolved against. Those
+    // can change without changing the computed values of anything in between, e.g. below an element with a fixed
+    // font-size, so the whole document has to be restyled.
+    if (is<HTML::HTMLHtmlElement>(*this) && old_root_element_font_metrics != style_computer.root_element_font_metrics())
+        invalidate_inherited_style_of_children(InheritedStyleChange::RootElementFontMetrics);
+
     // Tables must not inherit -libweb-* values for text-align.
     // FIXME: Find the spec for this.
     if (is<HTML::HTMLTableElement>(*this)) {
@@ -552,8 +577,10 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
     else
         invalidation = CSS::RequiredInvalidationAfterStyleChange::full();
 
-    if (!invalidation.is_none())
+    if (!invalidation.is_none()) {
         set_computed_css_values(move(new_computed_css_values));
+        invalidate_inherited_style_of_children(InheritedStyleChange::Properties);
+    }
 
     // Any document change that can cause this element's style to change, could also affect its pseudo-elements.
     auto recompute_pseudo_element_style = [&](CSS::Selector::PseudoElement::Type pseudo_element) {
@@ -585,6 +612,8 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
     if (!invalidation.rebuild_layout_tree && layout_node()) {
         // If we're keeping the layout tree, we can just apply the new style to the existing layout tree.
         layout_node()->apply_style(*m_computed_css_values);
+        if (invalidation.relayout)
+            layout_node()->set_needs_layout_update();
         if (invalidation.repaint && paintable())
             paintable()->set_needs_display();
 
@@ -601,6 +630,8 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
 
             if (auto* node_with_style = dynamic_cast<Layout::NodeWithStyle*>(pseudo_element->layout_node.ptr())) {
                 node_with_style->apply_style(*pseudo_element_style);
+                if (invalidation.relayout)
+                    node_with_style->set_needs_layout_update();
                 if (invalidation.repaint && node_with_style->paintable())
                     node_with_style->paintable()->set_needs_display();
             }
@@ -1929,13 +1960,58 @@ ErrorOr<void> Element::scroll_into_view(Optional<Variant<bool, ScrollIntoViewOpt
     // FIXME: 8. Optionally perform some other action that brings the element to the user’s attention.
 }
 
-void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name)
+void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name, Optional<String> const& old_value, Optional<String> const& new_value)
 {
-    // FIXME: Only invalidate if the attribute can actually affect style.
-    (void)attribute_name;
+    // NOTE: Disconnected elements get their style computed from scratch once they're inserted anyway.
+    if (!is_connected() || !document().browsing_context() || document().needs_full_style_update()) {
+        invalidate_style(StyleInvalidationReason::ElementAttributeChange);
+        return;
+    }
+
+    // These affect the language and directionality of all descendants, and the presentational hints of <body> and
+    // <table> are applied to other elements too (links and table cells, respectively).
+    if (attribute_name.is_one_of(HTML::AttributeNames::lang, HTML::AttributeNames::dir, HTML::AttributeNames::slot)
+        || (attribute_name != HTML::AttributeNames::class_ && attribute_name != HTML::AttributeNames::id && (is<HTML::HTMLBodyElement>(*this) || is<HTML::HTMLTableElement>(*this)))) {
+        invalidate_style(StyleInvalidationReason::ElementAttributeChange);
+        return;
+    }
 
-    // FIXME: This will need to become smarter when we implement the :has() selector.
-    invalidate_style(StyleInvalidationReason::ElementAttributeChange);
+    auto const& style_invalidation_data = document().style_computer().style_invalidation_data();
+    CSS::InvalidationSet invalidation_set;
+
+    auto include_invalidation_set_for = [&](CSS::InvalidationProperty::Type type, FlyString const& name) {
+        if (auto it = style_invalidation_data.invalidation_sets.find(CSS::InvalidationProperty { type, name.to_ascii_lowercase() }); it != style_invalidation_data.invalidation_sets.end())
+            invalidation_set.include_all_from(it->value);
+    };
+
+    include_invalidation_set_for(CSS::InvalidationProperty::Type::Attribute, attribute_name);
+
+    if (attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were actually added or removed matter.
+        Vector<StringView> old_classes;
+        if (old_value.has_value())
+            old_classes = old_value->bytes_as_string_view().split_view_if(Infra::is_ascii_whitespace);
+        for (auto old_class : old_classes) {
+            auto old_class_name = MUST(FlyString::from_utf8(old_class));
+            if (!has_class(old_class_name))
+                include_invalidation_set_for(CSS::InvalidationProperty::Type::Class, old_class_name);
+        }
+        for (auto const& new_class : m_classes) {
+            if (!old_classes.contains_slow(new_class.bytes_as_string_view()))
+                include_invalidation_set_for(CSS::InvalidationProperty::Type::Class, new_class);
+        }
+    } else if (attribute_name == HTML::AttributeNames::id) {
+        if (old_value.has_value())
+            include_invalidation_set_for(CSS::InvalidationProperty::Type::Id, *old_value);
+        if (new_value.has_value())
+            include_invalidation_set_for(CSS::InvalidationProperty::Type::Id, *new_value);
+    } else {
+        // Other attributes may feed into presentational hints, and can change which pseudo-classes the element matches.
+        invalidation_set.invalidate_self = true;
+        invalidation_set.include_all_from(style_invalidation_data.pseudo_class_invalidation_set);
+    }
+
+    invalidate_style(StyleInvalidationReason::ElementAttributeChange, invalidation_set);
 }
 
 // https://www.w3.org/TR/wai-aria-1.2/#tree_exclusion
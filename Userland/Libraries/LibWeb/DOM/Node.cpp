@@ -421,40 +421,117 @@ void Node::invalidate_style(StyleInvalidationReason reason)
     // - all of its subsequent siblings and their descendants
     // FIXME: This is a lot of invalidation and we should implement more sophisticated invalidation to do less work!
 
-    auto invalidate_entire_subtree = [&](Node& subtree_root) {
-        subtree_root.for_each_in_inclusive_subtree([&](Node& node) {
-            node.m_needs_style_update = true;
-            if (node.has_children())
-                node.m_child_needs_style_update = true;
-            if (auto shadow_root = node.is_element() ? static_cast<DOM::Element&>(node).shadow_root() : nullptr) {
-                node.m_child_needs_style_update = true;
-                shadow_root->m_needs_style_update = true;
-                if (shadow_root->has_children())
-                    shadow_root->m_child_needs_style_update = true;
-            }
-            return TraversalDecision::Continue;
-        });
-    };
-
-    invalidate_entire_subtree(*this);
+    mark_inclusive_subtree_as_needing_style_update();
 
     if (reason == StyleInvalidationReason::NodeInsertBefore || reason == StyleInvalidationReason::NodeRemove) {
         for (auto* sibling = previous_sibling(); sibling; sibling = sibling->previous_sibling()) {
             if (sibling->is_element())
-                invalidate_entire_subtree(*sibling);
+                sibling->mark_inclusive_subtree_as_needing_style_update();
         }
     }
 
     for (auto* sibling = next_sibling(); sibling; sibling = sibling->next_sibling()) {
         if (sibling->is_element())
-            invalidate_entire_subtree(*sibling);
+            sibling->mark_inclusive_subtree_as_needing_style_update();
     }
 
-    for (auto* ancestor = parent_or_shadow_host(); ancestor; ancestor = ancestor->parent_or_shadow_host())
-        ancestor->m_child_needs_style_update = true;
+    mark_ancestors_as_having_children_needing_style_update();
+    document().schedule_style_update();
+}
+
+void Node::invalidate_style(StyleInvalidationReason reason, CSS::InvalidationSet const& invalidation_set)
+{
+    if (invalidation_set.is_empty())
+        return;
+
+    if (invalidation_set.invalidate_whole_document) {
+        document().invalidate_style(reason);
+        return;
+    }
+
+    if (is_character_data() || document().needs_full_style_update())
+        return;
+
+    dbgln_if(STYLE_INVALIDATION_DEBUG, "Invalidate style ({}, self: {}, subtree: {}, siblings: {}, descendants with {} properties): {}", to_string(reason), invalidation_set.invalidate_self, invalidation_set.invalidate_whole_subtree, invalidation_set.invalidate_siblings, invalidation_set.descendant_properties.size(), debug_description());
+
+    if (invalidation_set.invalidate_whole_subtree) {
+        mark_inclusive_subtree_as_needing_style_update();
+    } else {
+        if (invalidation_set.invalidate_self)
+            m_needs_style_update = true;
+
+        if (!invalidation_set.descendant_properties.is_empty()) {
+            // NOTE: This includes our own shadow tree, where :host() rules can match descendants based on the host.
+            for_each_shadow_including_inclusive_descendant([&](Node& descendant) {
+                if (&descendant != this && descendant.is_element() && invalidation_set.needs_invalidation_of_descendant(static_cast<Element&>(descendant))) {
+                    descendant.m_needs_style_update = true;
+                    descendant.mark_ancestors_as_having_children_needing_style_update();
+                }
+                return TraversalDecision::Continue;
+            });
+        }
+    }
+
+    if (invalidation_set.invalidate_siblings) {
+        for (auto* sibling = next_sibling(); sibling; sibling = sibling->next_sibling()) {
+            if (sibling->is_element())
+                sibling->mark_inclusive_subtree_as_needing_style_update();
+        }
+    }
+
+    mark_ancestors_as_having_children_needing_style_update();
     document().schedule_style_update();
 }
 
+void Node::invalidate_inherited_style_of_children(InheritedStyleChange change)
+{
+    auto invalidate_child = [&](Node& child) {
+        if (!child.is_element())
+            return IterationDecision::Continue;
+        if (change != InheritedStyleChange::Properties)
+            child.mark_inclusive_subtree_as_needing_style_update();
+        else
+            child.m_needs_style_update = true;
+        return IterationDecision::Continue;
+    };
+
+    if (has_children()) {
+        m_child_needs_style_update = true;
+        for_each_child(invalidate_child);
+    }
+
+    if (auto shadow_root = is_element() ? static_cast<DOM::Element&>(*this).shadow_root() : nullptr; shadow_root && shadow_root->has_children()) {
+        m_child_needs_style_update = true;
+        shadow_root->m_child_needs_style_update = true;
+        shadow_root->for_each_child(invalidate_child);
+    }
+}
+
+void Node::mark_inclusive_subtree_as_needing_style_update()
+{
+    for_each_in_inclusive_subtree([&](Node& node) {
+        node.m_needs_style_update = true;
+        if (node.has_children())
+            node.m_child_needs_style_update = true;
+        if (auto shadow_root = node.is_element() ? static_cast<DOM::Element&>(node).shadow_root() : nullptr) {
+            node.m_child_needs_style_update = true;
+            shadow_root->m_needs_style_update = true;
+            if (shadow_root->has_children())
+                shadow_root->m_child_needs_style_update = true;
+        }
+        return TraversalDecision::Continue;
+    });
+}
+
+void Node::mark_ancestors_as_having_children_needing_style_update()
+{
+    for (auto* ancestor = parent_or_shadow_host(); ancestor; ancestor = ancestor->parent_or_shadow_host()) {
+        if (ancestor->m_child_needs_style_update)
+            break;
+        ancestor->m_child_needs_style_update = true;
+    }
+}
+
 String Node::child_text_content() const
 {
     if (!is<ParentNode>(*this))
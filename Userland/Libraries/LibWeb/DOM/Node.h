@@ -261,6 +261,19 @@ public:
     void set_child_needs_style_update(bool b) { m_child_needs_style_update = b; }
 
     void invalidate_style(StyleInvalidationReason);
+    void invalidate_style(StyleInvalidationReason, CSS::InvalidationSet const&);
+
+    // Marks the children of this node (including those in its shadow tree) as needing a style update, as they inherit
+    // from this node's computed style, which has just changed. Custom properties are looked up through all ancestors,
+    // and rem lengths are resolved against the root element's font, so a change to those affects entire subtrees.
+    // NOTE: This is meant to be called while the style of this node is being updated, when the ancestors of this node
+    //       are already marked as having children needing a style update.
+    enum class InheritedStyleChange {
+        Properties,
+        CustomProperties,
+        RootElementFontMetrics,
+    };
+    void invalidate_inherited_style_of_children(InheritedStyleChange);
 
     void set_document(Badge<Document>, Document&);
 
@@ -718,6 +731,9 @@ protected:
     bool m_needs_style_update { false };
     bool m_child_needs_style_update { false };
 
+    void mark_inclusive_subtree_as_needing_style_update();
+    void mark_ancestors_as_having_children_needing_style_update();
+
     i32 m_unique_id {};
 
     // https://dom.spec.whatwg.org/#registered-observer-list
@@ -27,6 +27,7 @@ enum class TraversalDecision;
 }
 
 namespace Web::Painting {
+class DisplayList;
 class DisplayListRecorder;
 class SVGGradientPaintStyle;
 using PaintStyle = RefPtr<SVGGradientPaintStyle>;
@@ -225,6 +226,8 @@ enum class PropertyID;
 
 struct BackgroundLayerData;
 struct CSSStyleSheetInit;
+struct InvalidationSet;
+struct StyleInvalidationData;
 struct StyleSheetIdentifier;
 }
 
@@ -116,6 +116,7 @@ WebIDL::ExceptionOr<void> HTMLCanvasElement::set_width(unsigned value)
 {
     TRY(set_attribute(HTML::AttributeNames::width, String::number(value)));
     m_bitmap = nullptr;
+    did_modify_bitmap();
     reset_context_to_default_state();
     return {};
 }
@@ -124,6 +125,7 @@ WebIDL::ExceptionOr<void> HTMLCanvasElement::set_height(unsigned value)
 {
     TRY(set_attribute(HTML::AttributeNames::height, String::number(value)));
     m_bitmap = nullptr;
+    did_modify_bitmap();
     reset_context_to_default_state();
     return {};
 }
@@ -209,6 +211,7 @@ bool HTMLCanvasElement::create_bitmap(size_t minimum_width, size_t minimum_heigh
     auto size = bitmap_size_for_canvas(*this, minimum_width, minimum_height);
     if (size.is_empty()) {
         m_bitmap = nullptr;
+        did_modify_bitmap();
         return false;
     }
     if (!m_bitmap || m_bitmap->size() != size) {
@@ -216,10 +219,19 @@ bool HTMLCanvasElement::create_bitmap(size_t minimum_width, size_t minimum_heigh
         if (bitmap_or_error.is_error())
             return false;
         m_bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
+        did_modify_bitmap();
     }
     return m_bitmap;
 }
 
+ErrorOr<NonnullRefPtr<Gfx::Bitmap>> HTMLCanvasElement::bitmap_snapshot() const
+{
+    VERIFY(m_bitmap);
+    if (!m_bitmap_snapshot)
+        m_bitmap_snapshot = TRY(m_bitmap->clone());
+    return *m_bitmap_snapshot;
+}
+
 struct SerializeBitmapResult {
     ByteBuffer buffer;
     StringView mime_type;
@@ -245,7 +257,9 @@ static ErrorOr<SerializeBitmapResult> serialize_bitmap(Gfx::Bitmap const& bitmap
 
     // User agents must support PNG ("image/png"). User agents may support other types.
     // If the user agent does not support the requested type, then it must create the file using the PNG format. [PNG]
-    return SerializeBitmapResult { TRY(Gfx::PNGWriter::encode(bitmap)), "image/png"sv };
+    // Large canvases are encoded in bands on separate threads. The band count is fixed rather than taken from the core
+    // count, so that the encoded bytes are the same on every machine.
+    return SerializeBitmapResult { TRY(Gfx::PNGWriter::encode(bitmap, { .thread_count = 4 })), "image/png"sv };
 }
 
 // https://html.spec.whatwg.org/multipage/canvas.html#dom-canvas-todataurl
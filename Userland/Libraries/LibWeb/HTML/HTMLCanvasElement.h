@@ -26,6 +26,11 @@ public:
     Gfx::Bitmap* bitmap() { return m_bitmap; }
     bool create_bitmap(size_t minimum_width = 0, size_t minimum_height = 0);
 
+    // Display lists may be played back on another thread while script keeps drawing into the canvas, so they get a
+    // copy of the bitmap instead. The copy is shared by every frame until the canvas bitmap is modified.
+    ErrorOr<NonnullRefPtr<Gfx::Bitmap>> bitmap_snapshot() const;
+    void did_modify_bitmap() { m_bitmap_snapshot = nullptr; }
+
     JS::ThrowCompletionOr<RenderingContext> get_context(String const& type, JS::Value options);
 
     unsigned width() const;
@@ -59,6 +64,7 @@ private:
     void reset_context_to_default_state();
 
     RefPtr<Gfx::Bitmap> m_bitmap;
+    mutable RefPtr<Gfx::Bitmap> m_bitmap_snapshot;
 
     Variant<JS::NonnullGCPtr<HTML::CanvasRenderingContext2D>, JS::NonnullGCPtr<WebGL::WebGLRenderingContext>, Empty> m_context;
 };
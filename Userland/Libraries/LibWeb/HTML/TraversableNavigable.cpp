@@ -1352,10 +1352,10 @@ JS::GCPtr<DOM::Node> TraversableNavigable::currently_focused_area()
     return candidate;
 }
 
-void TraversableNavigable::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::PaintOptions paint_options)
+NonnullOwnPtr<Painting::DisplayList> TraversableNavigable::record_display_list_for_painting(Web::DevicePixelRect const& content_rect, Web::PaintOptions paint_options)
 {
-    Painting::DisplayList display_list;
-    Painting::DisplayListRecorder display_list_recorder(display_list);
+    auto display_list = make<Painting::DisplayList>();
+    Painting::DisplayListRecorder display_list_recorder(*display_list);
 
     Gfx::IntRect bitmap_rect { {}, content_rect.size().to_type<int>() };
     display_list_recorder.fill_rect(bitmap_rect, Web::CSS::SystemColor::canvas());
@@ -1365,12 +1365,18 @@ void TraversableNavigable::paint(Web::DevicePixelRect const& content_rect, Gfx::
     paint_config.should_show_line_box_borders = paint_options.should_show_line_box_borders;
     paint_config.has_focus = paint_options.has_focus;
     record_display_list(display_list_recorder, paint_config);
+    return display_list;
+}
+
+void TraversableNavigable::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::PaintOptions paint_options)
+{
+    auto display_list = record_display_list_for_painting(content_rect, paint_options);
 
     auto display_list_player_type = page().client().display_list_player_type();
     if (display_list_player_type == DisplayListPlayerType::GPU) {
 #ifdef HAS_ACCELERATED_GRAPHICS
         Web::Painting::DisplayListPlayerGPU player(*paint_options.accelerated_graphics_context, target);
-        display_list.execute(player);
+        display_list->execute(player);
 #else
         static bool has_warned_about_configuration = false;
 
@@ -1380,8 +1386,7 @@ void TraversableNavigable::paint(Web::DevicePixelRect const& content_rect, Gfx::
         }
 #endif
     } else {
-        Web::Painting::DisplayListPlayerCPU player(target, display_list_player_type == DisplayListPlayerType::CPUWithExperimentalTransformSupport);
-        display_list.execute(player);
+        Web::Painting::DisplayListPlayerCPU::execute_in_bands(*display_list, target, display_list_player_type == DisplayListPlayerType::CPUWithExperimentalTransformSupport);
     }
 }
 
@@ -87,6 +87,9 @@ public:
 
     void paint(Web::DevicePixelRect const&, Gfx::Bitmap&, Web::PaintOptions);
 
+    // Records what paint() would draw, so that it can be played back later (possibly on another thread).
+    [[nodiscard]] NonnullOwnPtr<Painting::DisplayList> record_display_list_for_painting(Web::DevicePixelRect const&, Web::PaintOptions);
+
     enum class CheckIfUnloadingIsCanceledResult {
         CanceledByBeforeUnload,
         CanceledByNavigate,
@@ -698,9 +698,17 @@ void BlockFormattingContext::layout_block_level_box(Box const& box, BlockContain
         left_space_before_children_formatted = space_used_before_children_formatted.left;
     }
 
+    bool did_reuse_previous_layout_inside = false;
     if (independent_formatting_context) {
-        // This box establishes a new formatting context. Pass control to it.
-        independent_formatting_context->run(box_state.available_inner_space_or_constraints_from(available_space));
+        // This box establishes a new formatting context. Pass control to it, unless its insides haven't changed.
+        auto available_space_inside = box_state.available_inner_space_or_constraints_from(available_space);
+        if (m_layout_mode == LayoutMode::Normal && try_to_reuse_previous_layout_inside(box, available_space_inside)) {
+            did_reuse_previous_layout_inside = true;
+        } else {
+            independent_formatting_context->run(available_space_inside);
+            if (m_layout_mode == LayoutMode::Normal && !m_state.m_parent)
+                m_state.available_space_for_layout_inside.set(box, available_space_inside);
+        }
     } else {
         // This box participates in the current block container's flow.
         if (box.children_are_inline()) {
@@ -748,7 +756,7 @@ void BlockFormattingContext::layout_block_level_box(Box const& box, BlockContain
 
     bottom_of_lowest_margin_box = max(bottom_of_lowest_margin_box, box_state.offset.y() + box_state.content_height() + box_state.margin_box_bottom());
 
-    if (independent_formatting_context)
+    if (independent_formatting_context && !did_reuse_previous_layout_inside)
         independent_formatting_context->parent_context_did_dimension_child_root_box();
 }
 
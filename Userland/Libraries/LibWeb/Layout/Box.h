@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibJS/Heap/Cell.h>
@@ -54,6 +55,23 @@ public:
 
     bool is_user_scrollable() const;
 
+    // Intrinsic sizes only depend on the box's subtree, so they are cached across layouts until
+    // Node::set_needs_layout_update() is called on this box or something that may affect it.
+    struct IntrinsicSizes {
+        // Min-content and max-content widths are computed with the box's own height as the available height, so a
+        // definite height (e.g. a percentage of an ancestor's height) gets a slot of its own.
+        Optional<CSSPixels> min_content_width;
+        Optional<CSSPixels> max_content_width;
+        HashMap<CSSPixels, Optional<CSSPixels>> min_content_width_for_definite_height;
+        HashMap<CSSPixels, Optional<CSSPixels>> max_content_width_for_definite_height;
+
+        HashMap<CSSPixels, Optional<CSSPixels>> min_content_height;
+        HashMap<CSSPixels, Optional<CSSPixels>> max_content_height;
+    };
+
+    IntrinsicSizes& cached_intrinsic_sizes() const;
+    void reset_cached_intrinsic_sizes() const { m_cached_intrinsic_sizes = nullptr; }
+
 protected:
     Box(DOM::Document&, DOM::Node*, NonnullRefPtr<CSS::StyleProperties>);
     Box(DOM::Document&, DOM::Node*, NonnullOwnPtr<CSS::ComputedValues>);
@@ -64,6 +82,8 @@ private:
     Optional<CSSPixels> m_natural_width;
     Optional<CSSPixels> m_natural_height;
     Optional<CSSPixelFraction> m_natural_aspect_ratio;
+
+    mutable OwnPtr<IntrinsicSizes> m_cached_intrinsic_sizes;
 };
 
 template<>
@@ -228,15 +228,97 @@ OwnPtr<FormattingContext> FormattingContext::layout_inside(Box const& child_box,
     if (!child_box.can_have_children())
         return {};
 
+    if (layout_mode == LayoutMode::Normal && try_to_reuse_previous_layout_inside(child_box, available_space))
+        return nullptr;
+
     auto independent_formatting_context = create_independent_formatting_context_if_needed(m_state, layout_mode, child_box);
     if (independent_formatting_context)
         independent_formatting_context->run(available_space);
     else
         run(available_space);
 
+    if (layout_mode == LayoutMode::Normal && !m_state.m_parent)
+        m_state.available_space_for_layout_inside.set(child_box, available_space);
+
     return independent_formatting_context;
 }
 
+bool FormattingContext::try_to_reuse_previous_layout_inside(Box const& box, AvailableSpace const& available_space)
+{
+    // OPTIMIZATION: If nothing inside `box` has changed since the previous layout, and `box` establishes an independent
+    //               formatting context that gets the same definite size and available space as last time, the previous
+    //               used values of its subtree are still correct and we can copy them instead of doing layout.
+    //               Only the top-level state is ever committed, so throwaway states have nothing to reuse.
+    if (m_state.m_parent || !m_state.m_previous_layout || box.needs_layout_update())
+        return false;
+    auto const& previous_layout = *m_state.m_previous_layout;
+
+    auto previous_available_space = previous_layout.available_space_for_layout_inside.get(box);
+    if (!previous_available_space.has_value() || *previous_available_space != available_space)
+        return false;
+
+    auto const* previous_box_state = previous_layout.used_values_per_layout_node.get(box).value_or(nullptr);
+    if (!previous_box_state)
+        return false;
+
+    auto& box_state = m_state.get_mutable(box);
+    if (!box_state.has_definite_width() || !box_state.has_definite_height()
+        || !previous_box_state->has_definite_width() || !previous_box_state->has_definite_height()
+        || box_state.content_width() != previous_box_state->content_width()
+        || box_state.content_height() != previous_box_state->content_height())
+        return false;
+
+    // NOTE: Table layout also writes to the table box itself, and committing a layout moves SVG paths out of the
+    //       used values, so neither can be copied.
+    auto type = formatting_context_type_created_by_box(box);
+    if (!type.has_value() || *type == Type::Table || *type == Type::SVG)
+        return false;
+
+    bool can_reuse = true;
+    box.for_each_in_subtree([&](Node const& node) {
+        // Boxes whose containing block is outside of `box` are positioned and sized against something that may have
+        // changed, even if they didn't.
+        if (node.is_svg_box() || node.is_svg_svg_box()
+            || (node.is_absolutely_positioned() && !box.is_inclusive_ancestor_of(*node.containing_block()))) {
+            can_reuse = false;
+            return TraversalDecision::Break;
+        }
+        return TraversalDecision::Continue;
+    });
+    if (!can_reuse)
+        return false;
+
+    // The insides of `box` contribute line boxes and floats to its own used values. Everything else there was set by
+    // the parent formatting context during this layout.
+    box_state.line_boxes = previous_box_state->line_boxes;
+    for (auto const& floating_box : previous_box_state->floating_descendants())
+        box_state.add_floating_descendant(*floating_box);
+
+    // NOTE: Descendants are visited before their own descendants, so containing blocks inside `box` always have
+    //       their new used values by the time we re-point their contents at them. Existing used values are
+    //       overwritten in place, since other used values may already point at them.
+    box.for_each_in_subtree([&](Node const& node) {
+        if (!is<NodeWithStyle>(node))
+            return TraversalDecision::Continue;
+        auto const* previous_used_values = previous_layout.used_values_per_layout_node.get(node).value_or(nullptr);
+        if (!previous_used_values)
+            return TraversalDecision::Continue;
+
+        auto& used_values = m_state.get_mutable(static_cast<NodeWithStyle const&>(node));
+        used_values = *previous_used_values;
+        used_values.set_containing_block_used_values(&m_state.get(*node.containing_block()));
+
+        if (is<Box>(node)) {
+            if (auto previous_available_space_inside = previous_layout.available_space_for_layout_inside.get(static_cast<Box const&>(node)); previous_available_space_inside.has_value())
+                m_state.available_space_for_layout_inside.set(static_cast<Box const&>(node), *previous_available_space_inside);
+        }
+        return TraversalDecision::Continue;
+    });
+
+    m_state.available_space_for_layout_inside.set(box, available_space);
+    return true;
+}
+
 CSSPixels FormattingContext::greatest_child_width(Box const& box) const
 {
     CSSPixels max_width = 0;
@@ -1450,11 +1532,16 @@ CSSPixels FormattingContext::calculate_min_content_width(Layout::Box const& box)
     if (box.has_natural_width())
         return *box.natural_width();
 
-    auto& root_state = m_state.m_root;
+    auto const& outer_box_state = m_state.get(box);
+    auto get_cache_slot = [&]() -> Optional<CSSPixels>& {
+        auto& cache = box.cached_intrinsic_sizes();
+        if (outer_box_state.has_definite_height())
+            return cache.min_content_width_for_definite_height.ensure(outer_box_state.content_height());
+        return cache.min_content_width;
+    };
 
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-    if (cache.min_content_width.has_value())
-        return *cache.min_content_width;
+    if (auto& cache_slot = get_cache_slot(); cache_slot.has_value())
+        return *cache_slot;
 
     LayoutState throwaway_state(&m_state);
 
@@ -1474,15 +1561,16 @@ CSSPixels FormattingContext::calculate_min_content_width(Layout::Box const& box)
 
     context->run(AvailableSpace(available_width, available_height));
 
-    cache.min_content_width = context->automatic_content_width();
+    auto min_content_width = context->automatic_content_width();
 
-    if (cache.min_content_width->might_be_saturated()) {
+    if (min_content_width.might_be_saturated()) {
         // HACK: If layout calculates a non-finite result, something went wrong. Force it to zero and log a little whine.
         dbgln("FIXME: Calculated non-finite min-content width for {}", box.debug_description());
-        cache.min_content_width = 0;
+        min_content_width = 0;
     }
 
-    return *cache.min_content_width;
+    get_cache_slot() = min_content_width;
+    return min_content_width;
 }
 
 CSSPixels FormattingContext::calculate_max_content_width(Layout::Box const& box) const
@@ -1490,11 +1578,16 @@ CSSPixels FormattingContext::calculate_max_content_width(Layout::Box const& box)
     if (box.has_natural_width())
         return *box.natural_width();
 
-    auto& root_state = m_state.m_root;
+    auto const& outer_box_state = m_state.get(box);
+    auto get_cache_slot = [&]() -> Optional<CSSPixels>& {
+        auto& cache = box.cached_intrinsic_sizes();
+        if (outer_box_state.has_definite_height())
+            return cache.max_content_width_for_definite_height.ensure(outer_box_state.content_height());
+        return cache.max_content_width;
+    };
 
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-    if (cache.max_content_width.has_value())
-        return *cache.max_content_width;
+    if (auto& cache_slot = get_cache_slot(); cache_slot.has_value())
+        return *cache_slot;
 
     LayoutState throwaway_state(&m_state);
 
@@ -1514,15 +1607,16 @@ CSSPixels FormattingContext::calculate_max_content_width(Layout::Box const& box)
 
     context->run(AvailableSpace(available_width, available_height));
 
-    cache.max_content_width = context->automatic_content_width();
+    auto max_content_width = context->automatic_content_width();
 
-    if (cache.max_content_width->might_be_saturated()) {
+    if (max_content_width.might_be_saturated()) {
         // HACK: If layout calculates a non-finite result, something went wrong. Force it to zero and log a little whine.
         dbgln("FIXME: Calculated non-finite max-content width for {}", box.debug_description());
-        cache.max_content_width = 0;
+        max_content_width = 0;
     }
 
-    return *cache.max_content_width;
+    get_cache_slot() = max_content_width;
+    return max_content_width;
 }
 
 // https://www.w3.org/TR/css-sizing-3/#min-content-block-size
@@ -1536,9 +1630,7 @@ CSSPixels FormattingContext::calculate_min_content_height(Layout::Box const& box
         return *box.natural_height();
 
     auto get_cache_slot = [&]() -> Optional<CSSPixels>* {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-        return &cache.min_content_height.ensure(width);
+        return &box.cached_intrinsic_sizes().min_content_height.ensure(width);
     };
 
     if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value())
@@ -1580,9 +1672,7 @@ CSSPixels FormattingContext::calculate_max_content_height(Layout::Box const& box
         return *box.natural_height();
 
     auto get_cache_slot = [&]() -> Optional<CSSPixels>* {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
-        return &cache.max_content_height.ensure(width);
+        return &box.cached_intrinsic_sizes().max_content_height.ensure(width);
     };
 
     if (auto* cache_slot = get_cache_slot(); cache_slot && cache_slot->has_value())
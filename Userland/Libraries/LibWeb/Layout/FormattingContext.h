@@ -122,6 +122,7 @@ protected:
     [[nodiscard]] bool should_treat_max_height_as_none(Box const&, AvailableSize const&) const;
 
     OwnPtr<FormattingContext> layout_inside(Box const&, LayoutMode, AvailableSpace const&);
+    [[nodiscard]] bool try_to_reuse_previous_layout_inside(Box const&, AvailableSpace const&);
 
     struct SpaceUsedByFloats {
         CSSPixels left { 0 };
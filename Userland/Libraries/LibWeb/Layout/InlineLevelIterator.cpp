@@ -170,12 +170,10 @@ Gfx::GlyphRun::TextType InlineLevelIterator::resolve_text_direction_from_context
     VERIFY(m_text_node_context.has_value());
 
     Optional<Gfx::GlyphRun::TextType> next_known_direction;
-    for (size_t i = 0;; ++i) {
-        auto peek = m_text_node_context->chunk_iterator.peek(i);
-        if (!peek.has_value())
-            break;
-        if (peek->text_type == Gfx::GlyphRun::TextType::Ltr || peek->text_type == Gfx::GlyphRun::TextType::Rtl) {
-            next_known_direction = peek->text_type;
+    for (size_t i = m_text_node_context->next_chunk_index; i < m_text_node_context->chunks.size(); ++i) {
+        auto text_type = m_text_node_context->chunks[i].chunk.text_type;
+        if (text_type == Gfx::GlyphRun::TextType::Ltr || text_type == Gfx::GlyphRun::TextType::Rtl) {
+            next_known_direction = text_type;
             break;
         }
     }
@@ -209,17 +207,17 @@ Optional<InlineLevelIterator::Item> InlineLevelIterator::next_without_lookahead(
         if (!m_text_node_context.has_value())
             enter_text_node(text_node);
 
-        auto chunk_opt = m_text_node_context->chunk_iterator.next();
-        if (!chunk_opt.has_value()) {
+        if (m_text_node_context->next_chunk_index >= m_text_node_context->chunks.size()) {
             m_text_node_context = {};
             skip_to_next();
             return next_without_lookahead();
         }
 
-        if (!m_text_node_context->chunk_iterator.peek(0).has_value())
+        auto const& shaped_chunk = m_text_node_context->chunks[m_text_node_context->next_chunk_index++];
+        if (m_text_node_context->next_chunk_index == m_text_node_context->chunks.size())
             m_text_node_context->is_last_chunk = true;
 
-        auto& chunk = chunk_opt.value();
+        auto const& chunk = shaped_chunk.chunk;
         auto text_type = chunk.text_type;
         if (text_type == Gfx::GlyphRun::TextType::Ltr || text_type == Gfx::GlyphRun::TextType::Rtl)
             m_text_node_context->last_known_direction = text_type;
@@ -239,14 +237,8 @@ Optional<InlineLevelIterator::Item> InlineLevelIterator::next_without_lookahead(
             };
         }
 
-        Vector<Gfx::DrawGlyphOrEmoji> glyph_run;
-        float glyph_run_width = 0;
-        Gfx::for_each_glyph_position(
-            { 0, 0 }, chunk.view, chunk.font, [&](Gfx::DrawGlyphOrEmoji const& glyph_or_emoji) {
-                glyph_run.append(glyph_or_emoji);
-                return IterationDecision::Continue;
-            },
-            Gfx::IncludeLeftBearing::No, glyph_run_width);
+        auto glyph_run = shaped_chunk.glyphs;
+        auto glyph_run_width = shaped_chunk.width;
 
         if (!m_text_node_context->is_last_chunk)
             glyph_run_width += text_node.first_available_font().glyph_spacing();
@@ -368,7 +360,7 @@ void InlineLevelIterator::enter_text_node(Layout::TextNode const& text_node)
         .do_respect_linebreaks = do_respect_linebreaks,
         .is_first_chunk = true,
         .is_last_chunk = false,
-        .chunk_iterator = TextNode::ChunkIterator { text_node, do_wrap_lines, do_respect_linebreaks },
+        .chunks = text_node.shaped_chunks(do_wrap_lines, do_respect_linebreaks),
     };
 }
 
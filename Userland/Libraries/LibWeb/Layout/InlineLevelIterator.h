@@ -84,7 +84,8 @@ private:
         bool do_respect_linebreaks {};
         bool is_first_chunk {};
         bool is_last_chunk {};
-        TextNode::ChunkIterator chunk_iterator;
+        ReadonlySpan<TextNode::ShapedChunk> chunks;
+        size_t next_chunk_index { 0 };
         Optional<Gfx::GlyphRun::TextType> last_known_direction {};
     };
 
@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <LibGfx/Point.h>
+#include <LibWeb/Layout/AvailableSpace.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/LineBox.h>
 #include <LibWeb/Painting/PaintableBox.h>
@@ -21,9 +22,6 @@ enum class SizeConstraint {
     MaxContent,
 };
 
-class AvailableSize;
-class AvailableSpace;
-
 struct LayoutState {
     LayoutState()
         : m_root(*this)
@@ -46,6 +44,7 @@ struct LayoutState {
         void set_node(NodeWithStyle&, UsedValues const* containing_block_used_values);
 
         UsedValues const* containing_block_used_values() const { return m_containing_block_used_values; }
+        void set_containing_block_used_values(UsedValues const* containing_block_used_values) { m_containing_block_used_values = containing_block_used_values; }
 
         CSSPixels content_width() const { return m_content_width; }
         CSSPixels content_height() const { return m_content_height; }
@@ -178,21 +177,16 @@ struct LayoutState {
 
     HashMap<JS::NonnullGCPtr<Layout::Node const>, NonnullOwnPtr<UsedValues>> used_values_per_layout_node;
 
-    // We cache intrinsic sizes once determined, as they will not change over the course of a full layout.
-    // This avoids computing them several times while performing flex layout.
-    struct IntrinsicSizes {
-        Optional<CSSPixels> min_content_width;
-        Optional<CSSPixels> max_content_width;
-
-        HashMap<CSSPixels, Optional<CSSPixels>> min_content_height;
-        HashMap<CSSPixels, Optional<CSSPixels>> max_content_height;
-    };
-
-    HashMap<JS::GCPtr<NodeWithStyle const>, NonnullOwnPtr<IntrinsicSizes>> mutable intrinsic_sizes;
+    // The available space each box's insides were last laid out with. Together with the box's size, this tells
+    // the next layout whether the used values of the box's subtree can be reused if nothing inside it changed.
+    HashMap<JS::NonnullGCPtr<Box const>, AvailableSpace> available_space_for_layout_inside;
 
     LayoutState const* m_parent { nullptr };
     LayoutState const& m_root;
 
+    // The previously committed layout of the same layout tree, if it can be reused for clean subtrees.
+    LayoutState const* m_previous_layout { nullptr };
+
 private:
     void resolve_relative_positions();
 };
@@ -1045,6 +1045,48 @@ void NodeWithStyle::transfer_table_box_computed_values_to_wrapper_computed_value
     reset_table_box_computed_values_used_by_wrapper_to_init_values();
 }
 
+static void reset_cached_intrinsic_sizes_in_subtree(Node& node)
+{
+    node.for_each_in_inclusive_subtree_of_type<Box>([](Box& box) {
+        box.reset_cached_intrinsic_sizes();
+        return TraversalDecision::Continue;
+    });
+}
+
+void Node::set_needs_layout_update()
+{
+    // The intrinsic sizes of this node's own subtree may have changed in any way.
+    reset_cached_intrinsic_sizes_in_subtree(*this);
+
+    // Ancestors contain this node, so their intrinsic sizes may have changed too. Once we reach an ancestor that
+    // was already marked, everything above it has been taken care of as well.
+    for (auto* node = this; node && !node->m_needs_layout_update; node = node->parent()) {
+        node->m_needs_layout_update = true;
+        if (node == this)
+            continue;
+        if (is<Box>(*node))
+            static_cast<Box const&>(*node).reset_cached_intrinsic_sizes();
+
+        // Flex, grid and table items can get definite sizes from their siblings (e.g. through stretching or shared
+        // column widths), which in turn may affect the intrinsic sizes of everything inside them.
+        auto display = node->display();
+        if (display.is_flex_inside() || display.is_grid_inside() || display.is_table_inside())
+            reset_cached_intrinsic_sizes_in_subtree(*node);
+    }
+
+    document().set_needs_layout_update({});
+}
+
+void Node::clear_needs_layout_update_in_subtree()
+{
+    // Marked nodes always have marked ancestors, so we only need to descend into marked children.
+    if (!m_needs_layout_update)
+        return;
+    m_needs_layout_update = false;
+    for (auto* child = first_child(); child; child = child->next_sibling())
+        child->clear_needs_layout_update_in_subtree();
+}
+
 void Node::set_paintable(JS::GCPtr<Painting::Paintable> paintable)
 {
     m_paintable = move(paintable);
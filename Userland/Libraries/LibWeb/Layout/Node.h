@@ -172,6 +172,12 @@ public:
     // https://www.w3.org/TR/CSS22/visuren.html#positioning-scheme
     bool is_in_flow() const { return !is_out_of_flow(); }
 
+    // Marks this node as changed since the last layout. The cached intrinsic sizes of every box that may depend on
+    // this node are dropped, and all other boxes keep theirs for the next layout.
+    void set_needs_layout_update();
+    bool needs_layout_update() const { return m_needs_layout_update; }
+    void clear_needs_layout_update_in_subtree();
+
 protected:
     Node(DOM::Document&, DOM::Node*);
 
@@ -194,6 +200,8 @@ private:
     bool m_is_flex_item { false };
     bool m_is_grid_item { false };
 
+    bool m_needs_layout_update { false };
+
     GeneratedFor m_generated_for { GeneratedFor::NotGenerated };
 
     u32 m_initial_quote_nesting_level { 0 };
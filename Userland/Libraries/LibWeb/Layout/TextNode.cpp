@@ -305,6 +305,7 @@ void TextNode::invalidate_text_for_rendering()
 {
     m_text_for_rendering = {};
     m_grapheme_segmenter.clear();
+    m_shaped_chunks_cache.clear();
 }
 
 String const& TextNode::text_for_rendering() const
@@ -402,6 +403,40 @@ Locale::Segmenter& TextNode::grapheme_segmenter() const
     return *m_grapheme_segmenter;
 }
 
+ReadonlySpan<TextNode::ShapedChunk> TextNode::shaped_chunks(bool wrap_lines, bool respect_linebreaks) const
+{
+    // NOTE: The font list is compared by identity, and the cache holds on to it so that its address can't be reused
+    //       for a different one while we still think it's the same.
+    auto const& font_list = computed_values().font_list();
+    if (m_shaped_chunks_cache.has_value()
+        && m_shaped_chunks_cache->font_list.ptr() == &font_list
+        && m_shaped_chunks_cache->wrap_lines == wrap_lines
+        && m_shaped_chunks_cache->respect_linebreaks == respect_linebreaks) {
+        return m_shaped_chunks_cache->chunks;
+    }
+
+    Vector<ShapedChunk> shaped_chunks;
+    ChunkIterator chunk_iterator { *this, wrap_lines, respect_linebreaks };
+    for (auto chunk = chunk_iterator.next(); chunk.has_value(); chunk = chunk_iterator.next()) {
+        ShapedChunk shaped_chunk { .chunk = chunk.release_value(), .glyphs = {} };
+        Gfx::for_each_glyph_position(
+            { 0, 0 }, shaped_chunk.chunk.view, shaped_chunk.chunk.font, [&](Gfx::DrawGlyphOrEmoji const& glyph_or_emoji) {
+                shaped_chunk.glyphs.append(glyph_or_emoji);
+                return IterationDecision::Continue;
+            },
+            Gfx::IncludeLeftBearing::No, shaped_chunk.width);
+        shaped_chunks.append(move(shaped_chunk));
+    }
+
+    m_shaped_chunks_cache = ShapedChunksCache {
+        .font_list = font_list,
+        .wrap_lines = wrap_lines,
+        .respect_linebreaks = respect_linebreaks,
+        .chunks = move(shaped_chunks),
+    };
+    return m_shaped_chunks_cache->chunks;
+}
+
 TextNode::ChunkIterator::ChunkIterator(TextNode const& text_node, bool wrap_lines, bool respect_linebreaks)
     : m_wrap_lines(wrap_lines)
     , m_respect_linebreaks(respect_linebreaks)
@@ -59,6 +59,18 @@ public:
         Vector<Chunk> m_peek_queue;
     };
 
+    // A chunk of text along with the glyphs it was shaped into. The glyph positions are relative to the start of
+    // the chunk, and width is the sum of the glyph advances.
+    struct ShapedChunk {
+        Chunk chunk;
+        Vector<Gfx::DrawGlyphOrEmoji> glyphs;
+        float width { 0 };
+    };
+
+    // Returns the chunks of text_for_rendering() along with their glyphs. These are cached until the text or the
+    // font list changes, so that laying out the same text again doesn't have to segment and shape it again.
+    ReadonlySpan<ShapedChunk> shaped_chunks(bool wrap_lines, bool respect_linebreaks) const;
+
     void invalidate_text_for_rendering();
     void compute_text_for_rendering();
 
@@ -71,6 +83,14 @@ private:
 
     Optional<String> m_text_for_rendering;
     mutable OwnPtr<Locale::Segmenter> m_grapheme_segmenter;
+
+    struct ShapedChunksCache {
+        NonnullRefPtr<Gfx::FontCascadeList const> font_list;
+        bool wrap_lines { false };
+        bool respect_linebreaks { false };
+        Vector<ShapedChunk> chunks;
+    };
+    mutable Optional<ShapedChunksCache> m_shaped_chunks_cache;
 };
 
 template<>
@@ -39,8 +39,14 @@ void CanvasPaintable::paint(PaintContext& context, PaintPhase phase) const
         if (layout_box().dom_node().bitmap()) {
             // FIXME: Remove this const_cast.
             const_cast<HTML::HTMLCanvasElement&>(layout_box().dom_node()).present();
-            auto scaling_mode = to_gfx_scaling_mode(computed_values().image_rendering(), layout_box().dom_node().bitmap()->rect(), canvas_rect.to_type<int>());
-            context.display_list_recorder().draw_scaled_bitmap(canvas_rect.to_type<int>(), *layout_box().dom_node().bitmap(), layout_box().dom_node().bitmap()->rect(), scaling_mode);
+            auto snapshot_or_error = layout_box().dom_node().bitmap_snapshot();
+            if (snapshot_or_error.is_error()) {
+                dbgln("Failed to snapshot canvas bitmap for painting: {}", snapshot_or_error.error());
+                return;
+            }
+            auto snapshot = snapshot_or_error.release_value();
+            auto scaling_mode = to_gfx_scaling_mode(computed_values().image_rendering(), snapshot->rect(), canvas_rect.to_type<int>());
+            context.display_list_recorder().draw_scaled_bitmap(canvas_rect.to_type<int>(), *snapshot, snapshot->rect(), scaling_mode);
         }
     }
 }
@@ -76,6 +76,23 @@ void DisplayList::mark_unnecessary_commands()
     VERIFY(sample_blit_ranges.is_empty());
 }
 
+bool DisplayList::can_be_played_back_in_bands() const
+{
+    for (auto const& command_with_scroll_id : m_commands) {
+        if (command_with_scroll_id.skip)
+            continue;
+        auto const& command = command_with_scroll_id.command;
+        if (command.has<ApplyBackdropFilter>())
+            return false;
+        if (command.has<PushStackingContext>()) {
+            auto const& push_stacking_context = command.get<PushStackingContext>();
+            if (!Gfx::extract_2d_affine_transform(push_stacking_context.transform.matrix).is_identity_or_translation())
+                return false;
+        }
+    }
+    return true;
+}
+
 void DisplayList::execute(DisplayListPlayer& executor)
 {
     executor.prepare_to_execute(m_corner_clip_max_depth);
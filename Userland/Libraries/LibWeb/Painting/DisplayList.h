@@ -92,6 +92,10 @@ public:
     void mark_unnecessary_commands();
     void execute(DisplayListPlayer&);
 
+    // Returns false if any command reads back pixels it did not paint itself (e.g. backdrop filters or
+    // scaled stacking contexts), which would make the result depend on how the target is split up.
+    bool can_be_played_back_in_bands() const;
+
     size_t corner_clip_max_depth() const { return m_corner_clip_max_depth; }
     void set_corner_clip_max_depth(size_t depth) { m_corner_clip_max_depth = depth; }
 
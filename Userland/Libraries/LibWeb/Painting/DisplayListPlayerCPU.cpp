@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/System.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 #include <LibGfx/StylePainter.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/ThreadPool.h>
 #include <LibWeb/CSS/ComputedValues.h>
 #include <LibWeb/Painting/BorderRadiusCornerClipper.h>
 #include <LibWeb/Painting/DisplayListPlayerCPU.h>
@@ -25,27 +28,78 @@ DisplayListPlayerCPU::DisplayListPlayerCPU(Gfx::Bitmap& bitmap, bool enable_affi
         .scaling_mode = {} });
 }
 
+DisplayListPlayerCPU::DisplayListPlayerCPU(Gfx::Bitmap& band, Gfx::IntPoint band_origin, bool enable_affine_command_executor)
+    : DisplayListPlayerCPU(band, enable_affine_command_executor)
+{
+    m_origin = band_origin;
+    painter().translate(-band_origin);
+}
+
 DisplayListPlayerCPU::~DisplayListPlayerCPU() = default;
 
+// Bands shorter than this aren't worth the cost of replaying the display list once more.
+static constexpr int min_band_height = 64;
+
+static Threading::ThreadPool<Function<void()>>& band_thread_pool()
+{
+    // NOTE: The calling thread always plays back one band itself, so we need one worker less than there are cores.
+    static Threading::ThreadPool<Function<void()>> s_pool {
+        [](Function<void()> work) { work(); },
+        max(Core::System::hardware_concurrency(), 2u) - 1,
+    };
+    return s_pool;
+}
+
+void DisplayListPlayerCPU::execute_in_bands(DisplayList& display_list, Gfx::Bitmap& bitmap, bool enable_affine_command_executor, Optional<unsigned> requested_band_count)
+{
+    auto band_count = requested_band_count.has_value()
+        ? min(*requested_band_count, static_cast<unsigned>(bitmap.physical_height()))
+        : min(Core::System::hardware_concurrency(), static_cast<unsigned>(bitmap.physical_height() / min_band_height));
+    if (band_count <= 1 || bitmap.scale() != 1 || !display_list.can_be_played_back_in_bands()) {
+        DisplayListPlayerCPU player(bitmap, enable_affine_command_executor);
+        display_list.execute(player);
+        return;
+    }
+
+    Threading::Mutex completion_mutex;
+    Threading::ConditionVariable band_completed { completion_mutex };
+    unsigned remaining_band_count = band_count - 1;
+
+    auto play_back_band = [&](unsigned band_index) {
+        auto band_top = static_cast<int>(static_cast<u64>(bitmap.height()) * band_index / band_count);
+        auto band_bottom = static_cast<int>(static_cast<u64>(bitmap.height()) * (band_index + 1) / band_count);
+
+        // Each band gets a bitmap of its own that aliases its rows of the target, so that nothing painted
+        // (or sampled back) by one band can ever reach into the rows of another.
+        auto band_or_error = Gfx::Bitmap::create_wrapper(bitmap.format(), { bitmap.width(), band_bottom - band_top }, 1, bitmap.pitch(), bitmap.scanline(band_top));
+        if (band_or_error.is_error()) {
+            dbgln("Failed to create bitmap for display list band {}: {}", band_index, band_or_error.error());
+            return;
+        }
+        DisplayListPlayerCPU player(*band_or_error.value(), { 0, band_top }, enable_affine_command_executor);
+        display_list.execute(player);
+    };
+
+    for (unsigned band_index = 1; band_index < band_count; ++band_index) {
+        band_thread_pool().submit([&, band_index] {
+            play_back_band(band_index);
+            Threading::MutexLocker locker(completion_mutex);
+            --remaining_band_count;
+            band_completed.signal();
+        });
+    }
+
+    play_back_band(0);
+
+    Threading::MutexLocker locker(completion_mutex);
+    band_completed.wait_while([&] { return remaining_band_count > 0; });
+}
+
 CommandResult DisplayListPlayerCPU::draw_glyph_run(DrawGlyphRun const& command)
 {
-    auto& painter = this->painter();
-    auto const& glyphs = command.glyph_run->glyphs();
     auto const& font = command.glyph_run->font();
     auto scaled_font = font.with_size(font.point_size() * static_cast<float>(command.scale));
-    for (auto const& glyph_or_emoji : glyphs) {
-        auto transformed_glyph = glyph_or_emoji;
-        transformed_glyph.visit([&](auto& glyph) {
-            glyph.position = glyph.position.scaled(command.scale).translated(command.translation);
-        });
-        if (glyph_or_emoji.has<Gfx::DrawGlyph>()) {
-            auto& glyph = transformed_glyph.get<Gfx::DrawGlyph>();
-            painter.draw_glyph(glyph.position, glyph.code_point, *scaled_font, command.color);
-        } else {
-            auto& emoji = transformed_glyph.get<Gfx::DrawEmoji>();
-            painter.draw_emoji(emoji.position.to_type<int>(), *emoji.emoji, *scaled_font);
-        }
-    }
+    painter().draw_glyph_run(command.glyph_run->glyphs(), *scaled_font, command.color, command.translation, static_cast<float>(command.scale));
     return CommandResult::Continue;
 }
 
@@ -125,7 +179,7 @@ CommandResult DisplayListPlayerCPU::push_stacking_context(PushStackingContext co
     auto affine_transform = Gfx::extract_2d_affine_transform(command.transform.matrix);
 
     if (m_enable_affine_command_executor && !affine_transform.is_identity_or_translation()) {
-        auto offset = command.is_fixed_position ? Gfx::IntPoint {} : painter().translation();
+        auto offset = command.is_fixed_position ? -m_origin : painter().translation();
         m_affine_display_list_player = AffineDisplayListPlayerCPU(painter().target(),
             Gfx::AffineTransform {}.set_translation(offset.to_type<float>()), painter().clip_rect());
         if (m_affine_display_list_player->push_stacking_context(command) == CommandResult::SkipStackingContext)
@@ -135,7 +189,7 @@ CommandResult DisplayListPlayerCPU::push_stacking_context(PushStackingContext co
 
     painter().save();
     if (command.is_fixed_position)
-        painter().translate(-painter().translation());
+        painter().translate(-painter().translation() - m_origin);
 
     if (command.mask.has_value()) {
         // TODO: Support masks and other stacking context features at the same time.
@@ -279,22 +333,9 @@ CommandResult DisplayListPlayerCPU::paint_text_shadow(PaintTextShadow const& com
     // FIXME: "Spread" the shadow somehow.
     Gfx::IntPoint const baseline_start(command.text_rect.x(), command.text_rect.y());
     shadow_painter.translate(baseline_start);
-    auto const& glyphs = command.glyph_run->glyphs();
     auto const& font = command.glyph_run->font();
     auto scaled_font = font.with_size(font.point_size() * static_cast<float>(command.glyph_run_scale));
-    for (auto const& glyph_or_emoji : glyphs) {
-        auto transformed_glyph = glyph_or_emoji;
-        transformed_glyph.visit([&](auto& glyph) {
-            glyph.position = glyph.position.scaled(command.glyph_run_scale);
-        });
-        if (glyph_or_emoji.has<Gfx::DrawGlyph>()) {
-            auto& glyph = transformed_glyph.get<Gfx::DrawGlyph>();
-            shadow_painter.draw_glyph(glyph.position, glyph.code_point, *scaled_font, command.color);
-        } else {
-            auto& emoji = transformed_glyph.get<Gfx::DrawEmoji>();
-            shadow_painter.draw_emoji(emoji.position.to_type<int>(), *emoji.emoji, *scaled_font);
-        }
-    }
+    shadow_painter.draw_glyph_run(command.glyph_run->glyphs(), *scaled_font, command.color, {}, static_cast<float>(command.glyph_run_scale));
 
     // Blur
     Gfx::StackBlurFilter filter(*shadow_bitmap);
@@ -56,15 +56,26 @@ public:
     DisplayListPlayerCPU(Gfx::Bitmap& bitmap, bool enable_affine_command_executor = false);
     ~DisplayListPlayerCPU();
 
+    // Splits the bitmap into horizontal bands and plays the display list back into each of them on a separate thread.
+    // Every band sees the whole display list, commands that fall outside of it are culled by the band's clip rect.
+    // Display lists that cannot be played back in bands are executed on the calling thread instead.
+    // There is one band per core unless requested_band_count is given.
+    static void execute_in_bands(DisplayList&, Gfx::Bitmap&, bool enable_affine_command_executor = false, Optional<unsigned> requested_band_count = {});
+
     DisplayListPlayer& nested_player() override
     {
         return *m_affine_display_list_player;
     }
 
 private:
+    DisplayListPlayerCPU(Gfx::Bitmap& band, Gfx::IntPoint band_origin, bool enable_affine_command_executor);
+
     Gfx::Bitmap& m_target_bitmap;
     bool m_enable_affine_command_executor { false };
 
+    // Position of the target bitmap within the viewport, non-zero when playing back a single band.
+    Gfx::IntPoint m_origin;
+
     Vector<RefPtr<BorderRadiusCornerClipper>> m_corner_clippers_stack;
 
     struct StackingContext {
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <AK/RefCounted.h>
+#include <AK/AtomicRefCounted.h>
 #include <AK/Variant.h>
 #include <LibGfx/PaintStyle.h>
 
@@ -18,7 +18,7 @@ struct ColorStop {
     Optional<float> transition_hint = {};
 };
 
-class SVGGradientPaintStyle : public RefCounted<SVGGradientPaintStyle> {
+class SVGGradientPaintStyle : public AtomicRefCounted<SVGGradientPaintStyle> {
 public:
     virtual NonnullRefPtr<Gfx::SVGGradientPaintStyle> create_gfx_paint_style() const { VERIFY_NOT_REACHED(); }
 
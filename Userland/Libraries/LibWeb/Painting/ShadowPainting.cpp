@@ -6,11 +6,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashMap.h>
 #include <AK/NumericLimits.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Painter.h>
+#include <LibThreading/Mutex.h>
 #include <LibWeb/Layout/LineBoxFragment.h>
 #include <LibWeb/Layout/Node.h>
 #include <LibWeb/Painting/BorderPainting.h>
@@ -305,6 +308,134 @@ Gfx::IntRect get_outer_box_shadow_bounding_rect(PaintBoxShadowParams params)
     };
 }
 
+// The blurred nine-patch of an outer box-shadow only depends on its size, corners, blur radius and color, and not on
+// where the box is. Lots of pages have many boxes with the same shadow, and every box is painted again every frame,
+// so we hold on to recently used shadow bitmaps instead of rasterizing and blurring them every time.
+struct OuterBoxShadowBitmapKey {
+    Gfx::IntSize size;
+    int blur_radius { 0 };
+    Gfx::Color color;
+    Array<int, 8> corner_radii {};
+
+    bool operator==(OuterBoxShadowBitmapKey const&) const = default;
+};
+
+}
+
+template<>
+struct AK::Traits<Web::Painting::OuterBoxShadowBitmapKey> : public DefaultTraits<Web::Painting::OuterBoxShadowBitmapKey> {
+    static unsigned hash(Web::Painting::OuterBoxShadowBitmapKey const& key)
+    {
+        auto hash = pair_int_hash(key.size.width(), key.size.height());
+        hash = pair_int_hash(hash, pair_int_hash(key.blur_radius, key.color.value()));
+        for (auto radius : key.corner_radii)
+            hash = pair_int_hash(hash, radius);
+        return hash;
+    }
+};
+
+namespace Web::Painting {
+
+class OuterBoxShadowBitmapCache {
+public:
+    static OuterBoxShadowBitmapCache& the()
+    {
+        static OuterBoxShadowBitmapCache s_the;
+        return s_the;
+    }
+
+    RefPtr<Gfx::Bitmap const> find(OuterBoxShadowBitmapKey const& key)
+    {
+        Threading::MutexLocker locker(m_lock);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return nullptr;
+        it->value.last_use = ++m_use_counter;
+        return it->value.bitmap;
+    }
+
+    void set(OuterBoxShadowBitmapKey const& key, NonnullRefPtr<Gfx::Bitmap const> bitmap)
+    {
+        auto byte_size = bitmap->data_size();
+        if (byte_size > max_byte_size / 4)
+            return;
+
+        Threading::MutexLocker locker(m_lock);
+        if (m_entries.contains(key))
+            return;
+        while (m_byte_size + byte_size > max_byte_size)
+            evict_least_recently_used_entry();
+        m_entries.set(key, { move(bitmap), ++m_use_counter });
+        m_byte_size += byte_size;
+    }
+
+private:
+    static constexpr size_t max_byte_size = 16 * MiB;
+
+    struct Entry {
+        NonnullRefPtr<Gfx::Bitmap const> bitmap;
+        u64 last_use { 0 };
+    };
+
+    void evict_least_recently_used_entry()
+    {
+        VERIFY(!m_entries.is_empty());
+        auto least_recently_used = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->value.last_use < least_recently_used->value.last_use)
+                least_recently_used = it;
+        }
+        m_byte_size -= least_recently_used->value.bitmap->data_size();
+        m_entries.remove(least_recently_used);
+    }
+
+    Threading::Mutex m_lock;
+    HashMap<OuterBoxShadowBitmapKey, Entry> m_entries;
+    size_t m_byte_size { 0 };
+    u64 m_use_counter { 0 };
+};
+
+static RefPtr<Gfx::Bitmap const> outer_box_shadow_bitmap(PaintBoxShadowParams const& params, OuterBoxShadowMetrics const& shadow_config)
+{
+    auto const& shadow_bitmap_rect = shadow_config.shadow_bitmap_rect;
+    auto const& top_left = shadow_config.top_left_shadow_corner;
+    auto const& top_right = shadow_config.top_right_shadow_corner;
+    auto const& bottom_right = shadow_config.bottom_right_shadow_corner;
+    auto const& bottom_left = shadow_config.bottom_left_shadow_corner;
+
+    OuterBoxShadowBitmapKey key {
+        .size = shadow_bitmap_rect.size(),
+        .blur_radius = shadow_config.blur_radius,
+        .color = params.color,
+        .corner_radii = {
+            top_left.horizontal_radius, top_left.vertical_radius,
+            top_right.horizontal_radius, top_right.vertical_radius,
+            bottom_right.horizontal_radius, bottom_right.vertical_radius,
+            bottom_left.horizontal_radius, bottom_left.vertical_radius },
+    };
+    if (auto bitmap = OuterBoxShadowBitmapCache::the().find(key))
+        return bitmap;
+
+    auto shadows_bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, shadow_bitmap_rect.size());
+    if (shadows_bitmap.is_error()) {
+        dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", shadow_bitmap_rect, shadows_bitmap.error());
+        return nullptr;
+    }
+    auto shadow_bitmap = shadows_bitmap.release_value();
+    Gfx::Painter corner_painter { *shadow_bitmap };
+    Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
+
+    auto double_radius = shadow_config.double_radius;
+    aa_corner_painter.fill_rect_with_rounded_corners(
+        shadow_bitmap_rect.shrunken(double_radius, double_radius, double_radius, double_radius),
+        params.color, top_left, top_right, bottom_right, bottom_left);
+    Gfx::StackBlurFilter filter(*shadow_bitmap);
+    filter.process_rgba(shadow_config.blur_radius, params.color);
+
+    OuterBoxShadowBitmapCache::the().set(key, shadow_bitmap);
+    return shadow_bitmap;
+}
+
 void paint_outer_box_shadow(Gfx::Painter& painter, PaintBoxShadowParams params)
 {
     auto const& device_content_rect = params.device_content_rect;
@@ -319,7 +450,6 @@ void paint_outer_box_shadow(Gfx::Painter& painter, PaintBoxShadowParams params)
 
     auto shadow_config = get_outer_box_shadow_configuration(params);
 
-    auto const& shadow_bitmap_rect = shadow_config.shadow_bitmap_rect;
     auto const& non_blurred_shadow_rect = shadow_config.non_blurred_shadow_rect;
     auto const& inner_bounding_rect = shadow_config.inner_bounding_rect;
     auto const& blurred_edge_thickness = shadow_config.blurred_edge_thickness;
@@ -351,11 +481,6 @@ void paint_outer_box_shadow(Gfx::Painter& painter, PaintBoxShadowParams params)
     auto const& top_edge_rect = shadow_config.top_edge_rect;
     auto const& bottom_edge_rect = shadow_config.bottom_edge_rect;
 
-    auto const& top_left_shadow_corner = shadow_config.top_left_shadow_corner;
-    auto const& top_right_shadow_corner = shadow_config.top_right_shadow_corner;
-    auto const& bottom_right_shadow_corner = shadow_config.bottom_right_shadow_corner;
-    auto const& bottom_left_shadow_corner = shadow_config.bottom_left_shadow_corner;
-
     auto fill_rect_masked = [](auto& painter, auto fill_rect, auto mask_rect, auto color) {
         Gfx::DisjointRectSet<int> rect_set;
         rect_set.add(fill_rect);
@@ -421,20 +546,10 @@ void paint_outer_box_shadow(Gfx::Painter& painter, PaintBoxShadowParams params)
         painter.fill_rect(inner, params.color);
     };
 
-    auto shadows_bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, shadow_bitmap_rect.size());
-    if (shadows_bitmap.is_error()) {
-        dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", shadow_bitmap_rect, shadows_bitmap.error());
+    auto shadow_bitmap_or_null = outer_box_shadow_bitmap(params, shadow_config);
+    if (!shadow_bitmap_or_null)
         return;
-    }
-    auto shadow_bitmap = shadows_bitmap.release_value();
-    Gfx::Painter corner_painter { *shadow_bitmap };
-    Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
-
-    aa_corner_painter.fill_rect_with_rounded_corners(
-        shadow_bitmap_rect.shrunken(double_radius, double_radius, double_radius, double_radius),
-        params.color, top_left_shadow_corner, top_right_shadow_corner, bottom_right_shadow_corner, bottom_left_shadow_corner);
-    Gfx::StackBlurFilter filter(*shadow_bitmap);
-    filter.process_rgba(blur_radius, params.color);
+    auto const& shadow_bitmap = *shadow_bitmap_or_null;
 
     auto paint_shadow = [&](Gfx::IntRect clip_rect) {
         Gfx::PainterStateSaver save { painter };
@@ -144,7 +144,9 @@ Optional<Painting::PaintStyle> SVGLinearGradientElement::to_gfx_paint_style(SVGP
         };
     }
 
-    if (!m_paint_style) {
+    // NOTE: A display list recorded for an earlier frame may still be played back on the rendering thread, so only
+    //       update the cached paint style in place if nothing else holds on to it.
+    if (!m_paint_style || m_paint_style->ref_count() > 1) {
         m_paint_style = Painting::SVGLinearGradientPaintStyle::create(start_point, end_point);
         // FIXME: Update stops in DOM changes:
         add_color_stops(*m_paint_style);
@@ -200,7 +200,9 @@ Optional<Painting::PaintStyle> SVGRadialGradientElement::to_gfx_paint_style(SVGP
         end_radius = end_circle_radius().resolve_relative_to(paint_context.viewport.width());
     }
 
-    if (!m_paint_style) {
+    // NOTE: A display list recorded for an earlier frame may still be played back on the rendering thread, so only
+    //       update the cached paint style in place if nothing else holds on to it.
+    if (!m_paint_style || m_paint_style->ref_count() > 1) {
         m_paint_style = Painting::SVGRadialGradientPaintStyle::create(start_center, start_radius, end_center, end_radius);
         // FIXME: Update stops in DOM changes:
         add_color_stops(*m_paint_style);
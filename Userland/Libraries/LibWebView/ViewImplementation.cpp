@@ -8,6 +8,7 @@
 #include <AK/String.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
 #include <LibGfx/ImageFormats/PNGWriter.h>
 #include <LibWeb/Infra/Strings.h>
 #include <LibWebView/ViewImplementation.h>
@@ -520,7 +521,7 @@ static ErrorOr<LexicalPath> save_screenshot(Gfx::ShareableBitmap const& bitmap)
     LexicalPath path { Core::StandardPaths::downloads_directory() };
     path = path.append(TRY(Core::DateTime::now().to_string("screenshot-%Y-%m-%d-%H-%M-%S.png"sv)));
 
-    auto encoded = TRY(Gfx::PNGWriter::encode(*bitmap.bitmap()));
+    auto encoded = TRY(Gfx::PNGWriter::encode(*bitmap.bitmap(), { .thread_count = Core::System::hardware_concurrency() }));
 
     auto dump_file = TRY(Core::File::open(path.string(), Core::File::OpenMode::Write));
     TRY(dump_file->write_until_depleted(encoded));
@@ -7,6 +7,7 @@
 #include <AK/Debug.h>
 #include <ImageDecoder/ConnectionFromClient.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
+#include <LibCore/System.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageFormats/ImageDecoder.h>
 #include <LibGfx/ImageFormats/TIFFMetadata.h>
@@ -48,7 +49,9 @@ void decode_image_to_bitmaps_and_durations_with_decoder(Gfx::ImageDecoder const&
 
 ErrorOr<ConnectionFromClient::DecodeResult> decode_image_to_details(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> ideal_size, Optional<ByteString> const& known_mime_type)
 {
-    auto decoder = TRY(Gfx::ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, known_mime_type));
+    // Images are decoded one at a time on the background thread, so let a single image use all cores.
+    Gfx::ImageDecoderOptions options { .thread_count = Core::System::hardware_concurrency() };
+    auto decoder = TRY(Gfx::ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, known_mime_type, options));
 
     if (!decoder)
         return Error::from_string_literal("Could not find suitable image decoder plugin for data");
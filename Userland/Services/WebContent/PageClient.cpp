@@ -20,6 +20,8 @@
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/TraversableNavigable.h>
 #include <LibWeb/Layout/Viewport.h>
+#include <LibWeb/Painting/DisplayList.h>
+#include <LibWeb/Painting/DisplayListPlayerCPU.h>
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Painting/ViewportPaintable.h>
 #include <LibWebView/Attribute.h>
@@ -59,6 +61,7 @@ PageClient::PageClient(PageHost& owner, u64 id)
     : m_owner(owner)
     , m_page(Web::Page::create(Web::Bindings::main_thread_vm(), *this))
     , m_id(id)
+    , m_rendering_thread([this](auto& display_list, auto& target) { play_back_display_list(display_list, target); })
 {
     setup_palette();
 
@@ -72,6 +75,10 @@ PageClient::PageClient(PageHost& owner, u64 id)
         m_accelerated_graphics_context = context.release_value();
     }
 #endif
+
+    // NOTE: The GPU painter's context is bound to the thread that created it, so it keeps painting synchronously.
+    if (!s_use_gpu_painter)
+        m_rendering_thread.start();
 }
 
 PageClient::~PageClient() = default;
@@ -102,10 +109,9 @@ void PageClient::ready_to_paint()
 
 void PageClient::add_backing_store(i32 front_bitmap_id, Gfx::ShareableBitmap const& front_bitmap, i32 back_bitmap_id, Gfx::ShareableBitmap const& back_bitmap)
 {
-    m_backing_stores.front_bitmap_id = front_bitmap_id;
-    m_backing_stores.back_bitmap_id = back_bitmap_id;
-    m_backing_stores.front_bitmap = *const_cast<Gfx::ShareableBitmap&>(front_bitmap).bitmap();
-    m_backing_stores.back_bitmap = *const_cast<Gfx::ShareableBitmap&>(back_bitmap).bitmap();
+    m_rendering_thread.set_backing_stores(
+        front_bitmap_id, *const_cast<Gfx::ShareableBitmap&>(front_bitmap).bitmap(),
+        back_bitmap_id, *const_cast<Gfx::ShareableBitmap&>(back_bitmap).bitmap());
 }
 
 void PageClient::visit_edges(JS::Cell::Visitor& visitor)
@@ -222,30 +228,53 @@ void PageClient::paint_next_frame()
         }
     }
 
-    if (!m_backing_stores.back_bitmap) {
+    if (!m_rendering_thread.has_backing_stores())
         return;
-    }
 
-    auto& back_bitmap = *m_backing_stores.back_bitmap;
     auto viewport_rect = page().css_to_device_rect(page().top_level_traversable()->viewport_rect());
-    paint(viewport_rect, back_bitmap);
-
-    auto& backing_stores = m_backing_stores;
-    swap(backing_stores.front_bitmap, backing_stores.back_bitmap);
-    swap(backing_stores.front_bitmap_id, backing_stores.back_bitmap_id);
+    Web::PaintOptions paint_options;
+    fill_in_paint_options(paint_options);
+    auto display_list = page().top_level_traversable()->record_display_list_for_painting(viewport_rect, paint_options);
 
     m_paint_state = PaintState::WaitingForClient;
-    client().async_did_paint(m_id, viewport_rect.to_type<int>(), backing_stores.front_bitmap_id);
+    m_rendering_thread.enqueue_rendering_task(move(display_list), [this, protector = JS::make_handle(*this), viewport_rect](Optional<i32> front_bitmap_id) {
+        if (!front_bitmap_id.has_value()) {
+            // The frame was painted into a backing store the client has since replaced, so paint again into the new one.
+            m_paint_state = PaintState::Ready;
+            page().top_level_traversable()->set_needs_display();
+            return;
+        }
+        client().async_did_paint(m_id, viewport_rect.to_type<int>(), *front_bitmap_id);
+    });
 }
 
 void PageClient::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::PaintOptions paint_options)
+{
+    fill_in_paint_options(paint_options);
+    page().top_level_traversable()->paint(content_rect, target, paint_options);
+}
+
+void PageClient::fill_in_paint_options(Web::PaintOptions& paint_options) const
 {
     paint_options.should_show_line_box_borders = m_should_show_line_box_borders;
     paint_options.has_focus = m_has_focus;
 #ifdef HAS_ACCELERATED_GRAPHICS
     paint_options.accelerated_graphics_context = m_accelerated_graphics_context.ptr();
 #endif
-    page().top_level_traversable()->paint(content_rect, target, paint_options);
+}
+
+// NOTE: Unless the GPU painter is in use, this runs on the rendering thread.
+void PageClient::play_back_display_list(Web::Painting::DisplayList& display_list, Gfx::Bitmap& target)
+{
+    auto display_list_player_type = this->display_list_player_type();
+    if (display_list_player_type == Web::DisplayListPlayerType::GPU) {
+#ifdef HAS_ACCELERATED_GRAPHICS
+        Web::Painting::DisplayListPlayerGPU player(*m_accelerated_graphics_context, target);
+        display_list.execute(player);
+#endif
+        return;
+    }
+    Web::Painting::DisplayListPlayerCPU::execute_in_bands(display_list, target, display_list_player_type == Web::DisplayListPlayerType::CPUWithExperimentalTransformSupport);
 }
 
 void PageClient::set_viewport_size(Web::DevicePixelSize const& size)
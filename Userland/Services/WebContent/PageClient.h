@@ -16,6 +16,7 @@
 #include <LibWeb/Page/Page.h>
 #include <LibWeb/PixelUnits.h>
 #include <WebContent/Forward.h>
+#include <WebContent/RenderingThread.h>
 
 #ifdef HAS_ACCELERATED_GRAPHICS
 #    include <LibAccelGfx/Context.h>
@@ -99,6 +100,9 @@ private:
 
     virtual void visit_edges(JS::Cell::Visitor&) override;
 
+    void fill_in_paint_options(Web::PaintOptions&) const;
+    void play_back_display_list(Web::Painting::DisplayList&, Gfx::Bitmap&);
+
     // ^PageClient
     virtual bool is_connection_open() const override;
     virtual Gfx::Palette palette() const override;
@@ -210,13 +214,7 @@ private:
     OwnPtr<AccelGfx::Context> m_accelerated_graphics_context;
 #endif
 
-    struct BackingStores {
-        i32 front_bitmap_id { -1 };
-        i32 back_bitmap_id { -1 };
-        RefPtr<Gfx::Bitmap> front_bitmap;
-        RefPtr<Gfx::Bitmap> back_bitmap;
-    };
-    BackingStores m_backing_stores;
+    RenderingThread m_rendering_thread;
 
     WeakPtr<WebContentConsoleClient> m_top_level_document_console_client;
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibWeb/Painting/DisplayList.h>
+#include <WebContent/RenderingThread.h>
+
+namespace WebContent {
+
+RenderingThread::RenderingThread(DisplayListPlayer display_list_player)
+    : m_display_list_player(move(display_list_player))
+    , m_main_thread_event_loop(Core::EventLoop::current())
+{
+}
+
+RenderingThread::~RenderingThread()
+{
+    if (!m_thread)
+        return;
+
+    {
+        Threading::MutexLocker const locker(m_mutex);
+        m_exit = true;
+        m_task_available.signal();
+    }
+    (void)m_thread->join();
+}
+
+void RenderingThread::start()
+{
+    VERIFY(!m_thread);
+    m_thread = Threading::Thread::construct([this] {
+        rendering_thread_loop();
+        return static_cast<intptr_t>(0);
+    },
+        "Renderer"sv);
+    m_thread->start();
+}
+
+void RenderingThread::rendering_thread_loop()
+{
+    while (true) {
+        Optional<Task> task;
+        {
+            Threading::MutexLocker const locker(m_mutex);
+            m_task_available.wait_while([this] { return m_tasks.is_empty() && !m_exit; });
+            if (m_exit)
+                return;
+            task = m_tasks.dequeue();
+        }
+
+        auto front_bitmap_id = render(*task->display_list);
+
+        // NOTE: The callback holds on to GC handles, which may only be dropped on the main thread, so the task is
+        //       handed back and destroyed there.
+        m_main_thread_event_loop.deferred_invoke([task = task.release_value(), front_bitmap_id]() mutable {
+            task.callback(front_bitmap_id);
+        });
+        m_main_thread_event_loop.wake();
+    }
+}
+
+void RenderingThread::set_backing_stores(i32 front_bitmap_id, NonnullRefPtr<Gfx::Bitmap> front_bitmap, i32 back_bitmap_id, NonnullRefPtr<Gfx::Bitmap> back_bitmap)
+{
+    Threading::MutexLocker const locker(m_mutex);
+    m_backing_stores.front_bitmap_id = front_bitmap_id;
+    m_backing_stores.back_bitmap_id = back_bitmap_id;
+    m_backing_stores.front_bitmap = move(front_bitmap);
+    m_backing_stores.back_bitmap = move(back_bitmap);
+}
+
+bool RenderingThread::has_backing_stores() const
+{
+    Threading::MutexLocker const locker(m_mutex);
+    return m_backing_stores.back_bitmap;
+}
+
+void RenderingThread::enqueue_rendering_task(NonnullOwnPtr<Web::Painting::DisplayList> display_list, PaintCallback&& callback)
+{
+    if (!m_thread) {
+        auto front_bitmap_id = render(*display_list);
+        callback(front_bitmap_id);
+        return;
+    }
+
+    Threading::MutexLocker const locker(m_mutex);
+    m_tasks.enqueue({ move(display_list), move(callback) });
+    m_task_available.signal();
+}
+
+Optional<i32> RenderingThread::render(Web::Painting::DisplayList& display_list)
+{
+    RefPtr<Gfx::Bitmap> back_bitmap;
+    i32 back_bitmap_id;
+    {
+        Threading::MutexLocker const locker(m_mutex);
+        back_bitmap = m_backing_stores.back_bitmap;
+        back_bitmap_id = m_backing_stores.back_bitmap_id;
+    }
+    if (!back_bitmap)
+        return {};
+
+    m_display_list_player(display_list, *back_bitmap);
+
+    Threading::MutexLocker const locker(m_mutex);
+    // If the client handed us new backing stores while we were painting, the bitmap we just painted into is no longer
+    // one the client knows about, so the frame is dropped.
+    if (m_backing_stores.back_bitmap_id != back_bitmap_id)
+        return {};
+
+    swap(m_backing_stores.front_bitmap, m_backing_stores.back_bitmap);
+    swap(m_backing_stores.front_bitmap_id, m_backing_stores.back_bitmap_id);
+    return m_backing_stores.front_bitmap_id;
+}
+
+}
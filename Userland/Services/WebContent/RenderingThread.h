@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Queue.h>
+#include <LibCore/Forward.h>
+#include <LibGfx/Bitmap.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+#include <LibWeb/Forward.h>
+
+namespace WebContent {
+
+// Plays back recorded display lists into the back buffer on a dedicated thread, so that the main thread can go back
+// to running script, style and layout while the previous frame is still being rasterized.
+class RenderingThread {
+    AK_MAKE_NONCOPYABLE(RenderingThread);
+    AK_MAKE_NONMOVABLE(RenderingThread);
+
+public:
+    using DisplayListPlayer = Function<void(Web::Painting::DisplayList&, Gfx::Bitmap&)>;
+
+    // Called on the main thread once a frame has been played back. front_bitmap_id is empty if the backing stores
+    // were replaced while the frame was being rendered, in which case the frame was discarded.
+    using PaintCallback = Function<void(Optional<i32> front_bitmap_id)>;
+
+    explicit RenderingThread(DisplayListPlayer);
+    ~RenderingThread();
+
+    // Until this is called, rendering tasks are played back synchronously on the calling thread.
+    void start();
+
+    void set_backing_stores(i32 front_bitmap_id, NonnullRefPtr<Gfx::Bitmap> front_bitmap, i32 back_bitmap_id, NonnullRefPtr<Gfx::Bitmap> back_bitmap);
+    bool has_backing_stores() const;
+
+    void enqueue_rendering_task(NonnullOwnPtr<Web::Painting::DisplayList>, PaintCallback&&);
+
+private:
+    struct Task {
+        NonnullOwnPtr<Web::Painting::DisplayList> display_list;
+        PaintCallback callback;
+    };
+
+    struct BackingStores {
+        i32 front_bitmap_id { -1 };
+        i32 back_bitmap_id { -1 };
+        RefPtr<Gfx::Bitmap> front_bitmap;
+        RefPtr<Gfx::Bitmap> back_bitmap;
+    };
+
+    Optional<i32> render(Web::Painting::DisplayList&);
+    void rendering_thread_loop();
+
+    DisplayListPlayer m_display_list_player;
+    Core::EventLoop& m_main_thread_event_loop;
+    RefPtr<Threading::Thread> m_thread;
+
+    mutable Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_task_available { m_mutex };
+    Queue<Task> m_tasks;
+    BackingStores m_backing_stores;
+    bool m_exit { false };
+};
+
+}
@@ -177,6 +177,23 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
 }
 
 ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
+    TRY(send_response_body(response));
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(Core::File& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
+    if (!TRY(send_file_in_kernel(response, content_info.length)))
+        TRY(send_response_body(response));
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response_headers(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -194,7 +211,11 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     auto builder_contents = TRY(builder.to_byte_buffer());
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
+    return {};
+}
 
+ErrorOr<void> Client::send_response_body(Stream& response)
+{
     char buffer[PAGE_SIZE];
     do {
         auto size = TRY(response.read_some({ buffer, sizeof(buffer) })).size();
@@ -212,7 +233,39 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
             write_buffer = write_buffer.slice(nwritten);
         }
     } while (true);
+    return {};
+}
 
+// Has the kernel move the file straight into the socket, which saves copying all of it through our buffer.
+// Returns false if the kernel can't do that, before anything has been sent.
+ErrorOr<bool> Client::send_file_in_kernel([[maybe_unused]] Core::File& file, [[maybe_unused]] u64 length)
+{
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto socket_fd = m_socket->fd();
+    if (!socket_fd.has_value())
+        return false;
+
+    off_t offset = 0;
+    while (static_cast<u64>(offset) < length) {
+        auto nsent_or_error = Core::System::sendfile(socket_fd.value(), file.fd(), &offset, length - offset);
+        if (nsent_or_error.is_error()) {
+            auto code = nsent_or_error.error().code();
+            if (offset == 0 && (code == EINVAL || code == ENOSYS))
+                return false;
+            return nsent_or_error.release_error();
+        }
+        // The file got shorter since we looked at its size, so the client will notice that it's truncated.
+        if (nsent_or_error.value() == 0)
+            break;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Client::finish_response(HTTP::HttpRequest const& request)
+{
     auto keep_alive = false;
     if (auto it = request.headers().headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
         if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
@@ -220,8 +273,6 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     }
     if (!keep_alive)
         m_socket->close();
-
-    return {};
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
@@ -151,7 +151,7 @@ static ErrorOr<OwnPtr<Core::MappedFile>> convert_image_profile(LoadedImage& imag
     return icc_file;
 }
 
-static ErrorOr<void> save_image(LoadedImage& image, StringView out_path, bool force_alpha, bool ppm_ascii, u8 jpeg_quality, Optional<unsigned> webp_allowed_transforms, unsigned webp_color_cache_bits, Compress::ZlibCompressionLevel png_compression_level)
+static ErrorOr<void> save_image(LoadedImage& image, StringView out_path, bool force_alpha, bool ppm_ascii, u8 jpeg_quality, Optional<unsigned> webp_allowed_transforms, unsigned webp_color_cache_bits, bool webp_search_predictors, Compress::ZlibCompressionLevel png_compression_level, unsigned thread_count)
 {
     auto stream = [out_path]() -> ErrorOr<NonnullOwnPtr<Core::OutputBufferedFile>> {
         auto output_stream = TRY(Core::File::open(out_path, Core::File::OpenMode::Write));
@@ -180,7 +180,7 @@ static ErrorOr<void> save_image(LoadedImage& image, StringView out_path, bool fo
         return {};
     }
     if (out_path.ends_with(".png"sv, CaseSensitivity::CaseInsensitive)) {
-        TRY(Gfx::PNGWriter::encode(*TRY(stream()), *frame, { .compression_level = png_compression_level, .force_alpha = force_alpha, .icc_data = image.icc_data }));
+        TRY(Gfx::PNGWriter::encode(*TRY(stream()), *frame, { .compression_level = png_compression_level, .thread_count = thread_count, .force_alpha = force_alpha, .icc_data = image.icc_data }));
         return {};
     }
     if (out_path.ends_with(".ppm"sv, CaseSensitivity::CaseInsensitive)) {
@@ -197,6 +197,8 @@ static ErrorOr<void> save_image(LoadedImage& image, StringView out_path, bool fo
             options.vp8l_options.color_cache_bits = {};
         else
             options.vp8l_options.color_cache_bits = webp_color_cache_bits;
+        options.vp8l_options.search_predictors = webp_search_predictors;
+        options.vp8l_options.thread_count = thread_count;
         TRY(Gfx::WebPWriter::encode(*TRY(stream()), *frame, options));
         return {};
     }
@@ -232,6 +234,8 @@ struct Options {
     u8 quality = 75;
     unsigned webp_color_cache_bits = 6;
     Optional<unsigned> webp_allowed_transforms;
+    bool webp_search_predictors = false;
+    unsigned thread_count = 1;
 };
 
 template<class T>
@@ -298,6 +302,8 @@ static ErrorOr<Options> parse_options(Main::Arguments arguments)
     args_parser.add_option(options.webp_color_cache_bits, "Size of the webp color cache (in [0, 11], higher values tend to be slower and produce smaller output, default: 6)", "webp-color-cache-bits", {}, {});
     StringView webp_allowed_transforms = "default"sv;
     args_parser.add_option(webp_allowed_transforms, "Comma-separated list of allowed transforms (predictor,p,color,c,subtract-green,sg,color-indexing,ci) for WebP output (default: all allowed)", "webp-allowed-transforms", {}, {});
+    args_parser.add_option(options.webp_search_predictors, "Pick the best predictor for every block of a WebP image, slower but usually produces smaller output", "webp-search-predictors", {});
+    args_parser.add_option(options.thread_count, "Number of threads used by the PNG and WebP encoders (default: 1)", "threads", {}, {});
     args_parser.parse(arguments);
 
     if (options.out_path.is_empty() ^ options.no_output)
@@ -358,7 +364,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (options.no_output)
         return 0;
 
-    TRY(save_image(image, options.out_path, options.force_alpha, options.ppm_ascii, options.quality, options.webp_allowed_transforms, options.webp_color_cache_bits, options.png_compression_level));
+    TRY(save_image(image, options.out_path, options.force_alpha, options.ppm_ascii, options.quality, options.webp_allowed_transforms, options.webp_color_cache_bits, options.webp_search_predictors, options.png_compression_level, options.thread_count));
 
     return 0;
 }
@@ -45,6 +45,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     u64 physical_uncommitted = json.get_u64("physical_uncommitted"sv).value_or(0);
     u32 kmalloc_call_count = json.get_u32("kmalloc_call_count"sv).value_or(0);
     u32 kfree_call_count = json.get_u32("kfree_call_count"sv).value_or(0);
+    u64 kmalloc_magazine_hits = json.get_u64("kmalloc_magazine_hits"sv).value_or(0);
+    u64 kmalloc_magazine_misses = json.get_u64("kmalloc_magazine_misses"sv).value_or(0);
+    u64 physical_page_magazine_hits = json.get_u64("physical_page_magazine_hits"sv).value_or(0);
+    u64 physical_page_magazine_misses = json.get_u64("physical_page_magazine_misses"sv).value_or(0);
+    u64 kmalloc_magazine_drains = json.get_u64("kmalloc_magazine_drains"sv).value_or(0);
+    u64 physical_page_magazine_drains = json.get_u64("physical_page_magazine_drains"sv).value_or(0);
 
     u64 kmalloc_bytes_total = kmalloc_allocated + kmalloc_available;
     u64 physical_pages_total = physical_allocated + physical_available;
@@ -66,5 +72,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     outln("Kmalloc call count: {}", kmalloc_call_count);
     outln("Kfree call count: {}", kfree_call_count);
     outln("Kmalloc/Kfree delta: {}", TRY(String::formatted("{:+}", kmalloc_call_count - kfree_call_count)));
+    outln("Kmalloc magazine hits/misses/drains: {}/{}/{}", kmalloc_magazine_hits, kmalloc_magazine_misses, kmalloc_magazine_drains);
+    outln("Physical page magazine hits/misses/drains: {}/{}/{}", physical_page_magazine_hits, physical_page_magazine_misses, physical_page_magazine_drains);
     return 0;
 }